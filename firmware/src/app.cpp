@@ -11,11 +11,15 @@
 #include "heater/heater.hpp"
 #include "logger.hpp"
 #include "app_states/adrc_test.hpp"
+#include "app_states/batch_cooldown.hpp"
 #include "app_states/bonding.hpp"
 #include "app_states/idle.hpp"
 #include "app_states/reflow.hpp"
+#include "app_states/relay_tune.hpp"
 #include "app_states/sensor_bake.hpp"
+#include "app_states/state_scratch.hpp"
 #include "app_states/step_response.hpp"
+#include "app_states/tcr_calibration.hpp"
 
 App application;
 
@@ -31,9 +35,14 @@ etl::fsm_state_pack<
     SensorBake_State,
     AdrcTest_State,
     StepResponse_State,
-    Bonding_State
+    Bonding_State,
+    BatchCooldown_State,
+    RelayTune_State,
+    TcrCalibration_State
 > app_states;
 
+StateScratch state_scratch{};
+
 void App::setup() {
     blinker.setup();
     fan.off();
@@ -89,6 +98,10 @@ void App::showReflowStart() {
     blinker.once({{LCD_OFF, 200}, {LCD_WARM_COLOR, 300}, {LCD_OFF, 200}});
 }
 
+void App::showBatchReadyLoop() {
+    blinker.loop({{LCD_OK_COLOR, 500}, {LCD_OFF, 500}});
+}
+
 void App::showStartup() {
     blinker.once({
         {LCD_OK_COLOR, 150},
@@ -118,6 +131,10 @@ void App::beepTaskTerminated() {
     buzzer.play(":d=32,o=6,b=200:g,f#,f,e,d#,8d"_rtttl2tones);
 }
 
+void App::beepBatchReady() {
+    buzzer.play(":d=16,o=6,b=200:c,p,c"_rtttl2tones);
+}
+
 void App::beepStartup() {
     buzzer.play(":d=32,o=5,b=300:c6,c7"_rtttl2tones);
 }
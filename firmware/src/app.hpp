@@ -2,6 +2,8 @@
 
 #include "etl/fsm.h"
 #include "components/button.hpp"
+#include "lib/batch_cycle.hpp"
+#include "lib/tcr_calibration.hpp"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "freertos/queue.h"
@@ -17,7 +19,13 @@ namespace _id {
         ADRC_TEST,
         STEP_RESPONSE,
         BOND_OFF,
-        BUTTON
+        BUTTON,
+        BATCH,
+        BATCH_TICK,
+        RELAY_TUNE,
+        TCR_CALIBRATE,
+        TCR_REFERENCE,
+        TCR_TICK
     };
 }
 
@@ -45,6 +53,32 @@ DEFINE_PARAM_MSG(StepResponse, _id::STEP_RESPONSE, float, watts);
 DEFINE_SIMPLE_MSG(BondOff, _id::BOND_OFF);
 DEFINE_PARAM_MSG(Button, _id::BUTTON, ButtonEventId, type);
 
+class Batch : public etl::message<_id::BATCH> {
+public:
+    Batch(uint32_t count, bool auto_start) : count{count}, auto_start{auto_start} {}
+    const uint32_t count;
+    const bool auto_start;
+};
+
+DEFINE_SIMPLE_MSG(BatchTick, _id::BATCH_TICK);
+
+class RelayTune : public etl::message<_id::RELAY_TUNE> {
+public:
+    RelayTune(float temperature, float watts) : temperature{temperature}, watts{watts} {}
+    const float temperature;
+    const float watts;
+};
+
+class TcrCalibrate : public etl::message<_id::TCR_CALIBRATE> {
+public:
+    TcrCalibrate(float watts, uint32_t steps) : watts{watts}, steps{steps} {}
+    const float watts;
+    const uint32_t steps;
+};
+
+DEFINE_PARAM_MSG(TcrReference, _id::TCR_REFERENCE, float, temperature);
+DEFINE_SIMPLE_MSG(TcrTick, _id::TCR_TICK);
+
 using Packet = etl::message_packet<
     AppCmd::Stop,
     AppCmd::Reflow,
@@ -52,7 +86,13 @@ using Packet = etl::message_packet<
     AppCmd::AdrcTest,
     AppCmd::StepResponse,
     AppCmd::BondOff,
-    AppCmd::Button
+    AppCmd::Button,
+    AppCmd::Batch,
+    AppCmd::BatchTick,
+    AppCmd::RelayTune,
+    AppCmd::TcrCalibrate,
+    AppCmd::TcrReference,
+    AppCmd::TcrTick
 >;
 
 } // namespace AppCmd
@@ -80,12 +120,35 @@ public:
     }
 
     float last_cmd_data{0};
+    float last_cmd_watts{0};
+
+    // Batch production context, shared by Idle/Reflow/BatchCooldown states.
+    // Access from other tasks via get_batch_snapshot() only.
+    BatchCycle batch{};
+
+    auto get_batch_snapshot() -> BatchCycle {
+        xSemaphoreTake(message_lock, portMAX_DELAY);
+        BatchCycle snapshot = batch;
+        xSemaphoreGive(message_lock);
+        return snapshot;
+    }
+
+    // TCR calibration sweep context, same access rules as for batch.
+    TcrCalibration tcr_calibration{};
+
+    auto get_tcr_calibration_snapshot() -> TcrCalibration {
+        xSemaphoreTake(message_lock, portMAX_DELAY);
+        TcrCalibration snapshot = tcr_calibration;
+        xSemaphoreGive(message_lock);
+        return snapshot;
+    }
 
     // UI signals
     void showIdleBackground();
     void showLongPressProgress();
     void showBondingLoop();
     void showReflowStart();
+    void showBatchReadyLoop();
     void showStartup();
     void showOff();
 
@@ -93,6 +156,7 @@ public:
     void beepTaskStarted();
     void beepTaskSucceeded();
     void beepTaskTerminated();
+    void beepBatchReady();
     void beepStartup();
 
 private:
@@ -0,0 +1,86 @@
+#include "batch_cooldown.hpp"
+#include "components/time.hpp"
+#include "heater/heater.hpp"
+#include "logger.hpp"
+
+auto BatchCooldown_State::on_enter_state() -> etl::fsm_state_id_t {
+    APP_LOGI("State => Batch cooldown");
+
+    // Reflow history of the finished run is left intact, ticks come from
+    // timer instead of heater task.
+    xTickTimer = xTimerCreate("BatchTick", pdMS_TO_TICKS(TICK_PERIOD_MS), pdTRUE, (void *)0,
+        [](TimerHandle_t){
+            application.enqueue_message(AppCmd::BatchTick{});
+        });
+
+    if (!xTickTimer || xTimerStart(xTickTimer, 0) != pdPASS) {
+        get_fsm_context().batch.finish();
+        get_fsm_context().beepTaskTerminated();
+        return DeviceActivityStatus_IDLE;
+    }
+
+    // Fan is owned by heater control, ask it to go below its idle edge
+    heater.set_forced_cooling(true);
+    return No_State_Change;
+}
+
+auto BatchCooldown_State::on_event(const AppCmd::BatchTick&) -> etl::fsm_state_id_t {
+    auto& app = get_fsm_context();
+
+    const auto temperature_x10 = static_cast<int32_t>(heater.get_temperature() * 10);
+    if (!app.batch.update_cooling(Time::now(), temperature_x10)) { return No_State_Change; }
+
+    const auto& stats = app.batch.get_stats();
+    APP_LOGI("Batch: ready for run {}/{}", stats.completed + 1, stats.total);
+    heater.set_forced_cooling(false);
+
+    if (app.batch.is_auto_start()) { return DeviceActivityStatus_REFLOW; }
+
+    app.beepBatchReady();
+    app.showBatchReadyLoop();
+    return No_State_Change;
+}
+
+auto BatchCooldown_State::on_event(const AppCmd::Stop&) -> etl::fsm_state_id_t {
+    auto& app = get_fsm_context();
+
+    app.batch.finish();
+    app.beepTaskTerminated();
+    return DeviceActivityStatus_IDLE;
+}
+
+auto BatchCooldown_State::on_event(const AppCmd::Button& event) -> etl::fsm_state_id_t {
+    auto& app = get_fsm_context();
+
+    switch (event.type) {
+        // Start next run, when ready
+        case ButtonEventId::BUTTON_PRESSED_1X:
+            if (app.batch.get_phase() == BatchCycle::Phase::Idle) { return DeviceActivityStatus_REFLOW; }
+            break;
+
+        // Abort batch
+        case ButtonEventId::BUTTON_LONG_PRESS:
+            app.batch.finish();
+            app.beepTaskTerminated();
+            return DeviceActivityStatus_IDLE;
+
+        default:
+            break;
+    }
+    return No_State_Change;
+}
+
+auto BatchCooldown_State::on_event_unknown(const etl::imessage& event) -> etl::fsm_state_id_t {
+    get_fsm_context().LogUnknownEvent(event);
+    return No_State_Change;
+}
+
+void BatchCooldown_State::on_exit_state() {
+    if (xTickTimer) {
+        xTimerStop(xTickTimer, 0);
+        xTimerDelete(xTickTimer, 0);
+        xTickTimer = nullptr;
+    }
+    heater.set_forced_cooling(false);
+    get_fsm_context().showOff();
+}
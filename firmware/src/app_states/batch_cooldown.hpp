@@ -0,0 +1,24 @@
+#pragma once
+
+#include "app.hpp"
+#include "proto/generated/types.pb.h"
+
+// Between batch runs: force-cool with fan, then auto-start next run or wait
+// for single button press.
+class BatchCooldown_State : public etl::fsm_state<App, BatchCooldown_State, DeviceActivityStatus_BATCH_COOLDOWN,
+    AppCmd::BatchTick, AppCmd::Stop, AppCmd::Button> {
+public:
+    static constexpr int32_t TICK_PERIOD_MS = 500;
+
+    auto on_enter_state() -> etl::fsm_state_id_t override;
+
+    auto on_event(const AppCmd::BatchTick& event) -> etl::fsm_state_id_t;
+    auto on_event(const AppCmd::Stop& event) -> etl::fsm_state_id_t;
+    auto on_event(const AppCmd::Button& event) -> etl::fsm_state_id_t;
+    auto on_event_unknown(const etl::imessage& event) -> etl::fsm_state_id_t;
+
+    void on_exit_state() override;
+
+private:
+    TimerHandle_t xTickTimer{nullptr};
+};
@@ -25,6 +25,23 @@ auto Idle_State::on_event(const AppCmd::StepResponse& event) -> etl::fsm_state_i
     return DeviceActivityStatus_STEP_RESPONSE;
 }
 
+auto Idle_State::on_event(const AppCmd::RelayTune& event) -> etl::fsm_state_id_t {
+    auto& app = get_fsm_context();
+    app.last_cmd_data = event.temperature;
+    app.last_cmd_watts = event.watts;
+    return DeviceActivityStatus_RELAY_TUNE;
+}
+
+auto Idle_State::on_event(const AppCmd::TcrCalibrate& event) -> etl::fsm_state_id_t {
+    if (!get_fsm_context().tcr_calibration.start(event.watts, event.steps)) { return No_State_Change; }
+    return DeviceActivityStatus_TCR_CALIBRATION;
+}
+
+auto Idle_State::on_event(const AppCmd::Batch& event) -> etl::fsm_state_id_t {
+    if (!get_fsm_context().batch.start(event.count, event.auto_start)) { return No_State_Change; }
+    return DeviceActivityStatus_REFLOW;
+}
+
 auto Idle_State::on_event(const AppCmd::Button& event) -> etl::fsm_state_id_t {
     auto& app = get_fsm_context();
 
@@ -4,7 +4,7 @@
 #include "proto/generated/types.pb.h"
 
 class Idle_State : public etl::fsm_state<App, Idle_State, DeviceActivityStatus_IDLE,
-    AppCmd::Reflow, AppCmd::SensorBake, AppCmd::AdrcTest, AppCmd::StepResponse, AppCmd::Button, AppCmd::Stop> {
+    AppCmd::Reflow, AppCmd::SensorBake, AppCmd::AdrcTest, AppCmd::StepResponse, AppCmd::RelayTune, AppCmd::TcrCalibrate, AppCmd::Batch, AppCmd::Button, AppCmd::Stop> {
 public:
     auto on_enter_state() -> etl::fsm_state_id_t override;
 
@@ -12,6 +12,9 @@ public:
     auto on_event(const AppCmd::SensorBake& event) -> etl::fsm_state_id_t;
     auto on_event(const AppCmd::AdrcTest& event) -> etl::fsm_state_id_t;
     auto on_event(const AppCmd::StepResponse& event) -> etl::fsm_state_id_t;
+    auto on_event(const AppCmd::RelayTune& event) -> etl::fsm_state_id_t;
+    auto on_event(const AppCmd::TcrCalibrate& event) -> etl::fsm_state_id_t;
+    auto on_event(const AppCmd::Batch& event) -> etl::fsm_state_id_t;
     auto on_event(const AppCmd::Button& event) -> etl::fsm_state_id_t;
     auto on_event(const AppCmd::Stop& event) -> etl::fsm_state_id_t;
 
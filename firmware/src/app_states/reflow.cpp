@@ -1,111 +1,65 @@
-#include <etl/algorithm.h>
-
 #include "components/profiles_config.hpp"
+#include "components/time.hpp"
 #include "heater/heater.hpp"
 #include "logger.hpp"
 #include "reflow.hpp"
+#include "state_scratch.hpp"
 
+// Share of heater's max acceleration, used to round profile corners.
+// 0 disables trajectory shaping.
+static constexpr float TRAJECTORY_ACCEL_SCALE = 0.5f;
 
-void Timeline::load(const Profile& profile) {
-    profilePoints.clear();
-    segmentRates_c_per_s.clear();
-
-    profilePoints.push_back({
-        0 * x_axis_multiplier,
-        SharedConstants::START_TEMPERATURE * y_axis_multiplier
-    });
-
-    for (size_t i = 0; i < profile.segments_count; ++i) {
-        const auto& segment = profile.segments[i];
-        profilePoints.push_back({
-            profilePoints[i].time_x1000 + segment.duration * x_axis_multiplier,
-            segment.target * y_axis_multiplier
-        });
-    }
-
-    if (profilePoints.size() <= 1) { return; }
-
-    for (size_t i = 1; i < profilePoints.size(); ++i) {
-        const auto& p0 = profilePoints[i - 1];
-        const auto& p1 = profilePoints[i];
-
-        float delta_time = static_cast<float>(p1.time_x1000 - p0.time_x1000) / x_axis_multiplier;
-        float delta_value = static_cast<float>(p1.value_x100 - p0.value_x100) / y_axis_multiplier;
-        float rate_c_per_s = 0.0f;
-
-        if (delta_time > 0.001f) {
-            rate_c_per_s = delta_value / delta_time;
-        } else {
-            if (delta_value > 0.0f) { rate_c_per_s = 100.0f; }
-            else if (delta_value < 0.0f) { rate_c_per_s = -100.0f; }
-        }
-
-        segmentRates_c_per_s.push_back(etl::clamp(rate_c_per_s, -100.0f, 100.0f));
-    }
-}
-
-auto Timeline::get_max_time_x1000() const -> int32_t {
-    if (profilePoints.size() <= 1) { return 0; }
-    return profilePoints.back().time_x1000;
-}
-
-auto Timeline::get_target(int32_t offset_x1000) const -> float {
-    if (offset_x1000 < 0) { return 0; }
-
-    for (size_t i = 1; i < profilePoints.size(); ++i) {
-        const auto& p0 = profilePoints[i - 1];
-        const auto& p1 = profilePoints[i];
-
-        if (p0.time_x1000 <= offset_x1000 && p1.time_x1000 >= offset_x1000) {
-            int32_t delta_time_x1000 = p1.time_x1000 - p0.time_x1000;
-            if (delta_time_x1000 <= 0) {
-                return static_cast<float>(p1.value_x100) * y_axis_multiplier_inv;
-            }
-            int32_t scaled_y = p0.value_x100
-                + (p1.value_x100 - p0.value_x100)
-                    * (offset_x1000 - p0.time_x1000)
-                    / delta_time_x1000;
-            return static_cast<float>(scaled_y) * y_axis_multiplier_inv;
-        }
-    }
-
-    return 0;
-}
+// Max heating rate is b0 * max_power. Controller reaches it in about
+// 1/ω_c = τ/N, that gives max "acceleration" the head can follow.
+auto Reflow_State::get_trajectory_accel_x100() -> int32_t {
+    HeadParams params = HeadParams_init_zero;
+    if (!heater.get_head_params(params)) { return 0; }
+    if (params.adrc_response <= 0 || params.adrc_b0 <= 0) { return 0; }
 
-auto Timeline::get_rate(int32_t offset_x1000) const -> float {
-    if (offset_x1000 < 0) { return 0; }
+    const float max_power = heater.get_max_power();
+    const float accel = TRAJECTORY_ACCEL_SCALE * params.adrc_b0 * max_power
+        * params.adrc_n_coeff / params.adrc_response;
 
-    for (size_t i = 1; i < profilePoints.size(); ++i) {
-        if (profilePoints[i].time_x1000 >= offset_x1000) {
-            return segmentRates_c_per_s[i - 1];
-        }
-    }
-
-    return 0;
+    return static_cast<int32_t>(accel * 100.0f);
 }
 
-
 auto Reflow_State::on_enter_state() -> etl::fsm_state_id_t {
     auto& app = get_fsm_context();
     APP_LOGI("State => Reflow");
 
+    scratch = &state_scratch.acquire<Scratch>();
+
     // Pick the active profile and terminate on failure.
     Profile profile{};
     if (!profiles_config.get_selected_profile(profile)) {
+        app.batch.finish();
         app.beepTaskTerminated();
         return DeviceActivityStatus_IDLE;
     }
 
     // Load the timeline and try to execute the task.
-    timeline.load(profile);
-    auto status = heater.task_start(profile.id, [this](int32_t time_ms) {
-        task_iterator(time_ms);
-    });
+    const auto accel_x100 = get_trajectory_accel_x100();
+    APP_LOGI("Reflow: trajectory corner acceleration {} x0.01°C/s²", accel_x100);
+    scratch->timeline.load(profile, accel_x100);
+    auto status = heater.task_start(profile.id,
+        HeaterTaskIteratorFn::create<Reflow_State, &Reflow_State::task_iterator>(*this));
     if (!status) {
+        app.batch.finish();
         app.beepTaskTerminated();
         return DeviceActivityStatus_IDLE;
     }
 
+    // Profile may override default (SAC305) liquidus
+    const auto liquidus_x10 = profile.has_liquidus
+        ? static_cast<int32_t>(lroundf(profile.liquidus * 10))
+        : ReflowMetrics::LIQUIDUS_DEFAULT_X10;
+    heater.reflow_metrics_start(ReflowMetrics::default_config(liquidus_x10));
+
+    if (app.batch.is_active()) {
+        app.batch.on_heat_start(Time::now());
+        APP_LOGI("Batch: run {}/{}", app.batch.get_stats().completed + 1, app.batch.get_stats().total);
+    }
+
     // Enable ADRC and signal success with the LED.
     heater.temperature_control_on();
     app.showReflowStart();
@@ -117,7 +71,18 @@ auto Reflow_State::on_enter_state() -> etl::fsm_state_id_t {
 auto Reflow_State::on_event(const AppCmd::Stop& event) -> etl::fsm_state_id_t {
     auto& app = get_fsm_context();
 
-    event.succeeded ? app.beepTaskSucceeded() : app.beepTaskTerminated();
+    // Completed run with out-of-tolerance metrics is reported as failure, to
+    // catch bad boards immediately.
+    const auto metrics = heater.reflow_metrics_stop(event.succeeded);
+    APP_LOGI("Reflow: peak {} x0.1°C, TAL {} ms, ramp +{}/-{} x0.01°C/s, failures 0x{:x}",
+        metrics.peak_x10, metrics.tal_ms, metrics.ramp_up_max_x100, metrics.ramp_down_max_x100, metrics.failures);
+
+    metrics.passed ? app.beepTaskSucceeded() : app.beepTaskTerminated();
+
+    // In batch mode, cool down for the next run. Failed run stops the batch.
+    if (app.batch.is_active() && app.batch.on_heat_end(Time::now(), metrics)) {
+        return DeviceActivityStatus_BATCH_COOLDOWN;
+    }
     return DeviceActivityStatus_IDLE;
 }
 
@@ -125,6 +90,9 @@ auto Reflow_State::on_event(const AppCmd::Button& event) -> etl::fsm_state_id_t
     auto& app = get_fsm_context();
 
     if (event.type == ButtonEventId::BUTTON_PRESSED_1X) {
+        // Aborted run is not completed, metrics report it as failed
+        const auto metrics = heater.reflow_metrics_stop(false);
+        if (app.batch.is_active()) { app.batch.on_heat_end(Time::now(), metrics); }
         app.beepTaskTerminated();
         return DeviceActivityStatus_IDLE;
     }
@@ -139,10 +107,16 @@ auto Reflow_State::on_event_unknown(const etl::imessage& event) -> etl::fsm_stat
 void Reflow_State::on_exit_state() {
     profile_selector.set_power_strategy(ProfileSelector::ST_UNKNOWN);
     heater.task_stop();
+    // No-op if already stopped with result
+    heater.reflow_metrics_stop(false);
+
+    state_scratch.release();
+    scratch = nullptr;
 }
 
 void Reflow_State::task_iterator(int32_t time_ms) {
     auto& app = get_fsm_context();
+    auto& timeline = scratch->timeline;  // Lookups move the cursor
 
     if (time_ms >= timeline.get_max_time_x1000()) {
         heater.task_stop();
@@ -153,14 +127,15 @@ void Reflow_State::task_iterator(int32_t time_ms) {
     // NOTE: We probably should not modify ProfileSelector directly, and this
     // should be a property of Power to avoid races.
 
-    auto rate = timeline.get_rate(time_ms);
-    if (rate > 0.01f) {
+    const auto rate_x100 = timeline.get_rate_x100(time_ms);
+    if (rate_x100 > 1) {
         profile_selector.set_power_strategy(ProfileSelector::ST_UP);
-    } else if (rate < -0.01f) {
+    } else if (rate_x100 < -1) {
         profile_selector.set_power_strategy(ProfileSelector::ST_DOWN);
     } else {
         profile_selector.set_power_strategy(ProfileSelector::ST_HOLD);
     }
 
-    heater.set_temperature(timeline.get_target(time_ms), rate);
+    heater.set_temperature(static_cast<float>(timeline.get_target_x100(time_ms)) * 0.01f,
+                           static_cast<float>(rate_x100) * 0.01f);
 }
@@ -0,0 +1,119 @@
+#include "relay_tune.hpp"
+#include "state_scratch.hpp"
+#include <etl/format_spec.h>
+#include <etl/string.h>
+#include <etl/to_string.h>
+
+#include "heater/heater.hpp"
+#include "logger.hpp"
+
+auto RelayTune_State::on_enter_state() -> etl::fsm_state_id_t {
+    APP_LOGI("State => RelayTune");
+
+    auto& app = get_fsm_context();
+
+    scratch = &state_scratch.acquire<Scratch>();
+
+    last_sample_ms = 0;
+    scratch->tuner.start({
+        .setpoint = app.last_cmd_data,
+        .hysteresis = HYSTERESIS,
+        .power_high = app.last_cmd_watts,
+        .power_low = 0,
+        .ambient = heater.get_temperature()
+    });
+
+    auto status = heater.task_start(HISTORY_ID_RELAY_TUNE,
+        HeaterTaskIteratorFn::create<RelayTune_State, &RelayTune_State::task_iterator>(*this));
+    if (!status) { return DeviceActivityStatus_IDLE; }
+
+    heater.set_power(app.last_cmd_watts);
+    app.beepTaskStarted();
+
+    return No_State_Change;
+}
+
+auto RelayTune_State::on_event(const AppCmd::Stop& event) -> etl::fsm_state_id_t {
+    auto& app = get_fsm_context();
+
+    event.succeeded ? app.beepTaskSucceeded() : app.beepTaskTerminated();
+    return DeviceActivityStatus_IDLE;
+}
+
+auto RelayTune_State::on_event(const AppCmd::Button& event) -> etl::fsm_state_id_t {
+    if (event.type == ButtonEventId::BUTTON_PRESSED_1X) { return DeviceActivityStatus_IDLE; }
+    return No_State_Change;
+}
+
+auto RelayTune_State::on_event_unknown(const etl::imessage& event) -> etl::fsm_state_id_t {
+    get_fsm_context().LogUnknownEvent(event);
+    return No_State_Change;
+}
+
+void RelayTune_State::on_exit_state() {
+    heater.task_stop();
+    state_scratch.release();
+    scratch = nullptr;
+}
+
+void RelayTune_State::task_iterator(int32_t time_ms) {
+    auto& app = get_fsm_context();
+    auto& tuner = scratch->tuner;
+
+    if (time_ms < last_sample_ms + SAMPLE_INTERVAL_MS) { return; }
+    // Result is already reported, wait for Stop
+    if (tuner.get_status() != RelayTune::Status::Running) { return; }
+
+    if (time_ms >= MAX_DURATION_MS) {
+        APP_LOGE("Relay tune: no stable oscillation, cycles = {}", tuner.get_cycles());
+        app.enqueue_message(AppCmd::Stop{});
+        return;
+    }
+
+    const float dt = static_cast<float>(time_ms - last_sample_ms) * 0.001f;
+    last_sample_ms = time_ms;
+
+    heater.set_power(tuner.update(dt, heater.get_temperature()));
+
+    switch (tuner.get_status()) {
+        case RelayTune::Status::Running:
+            return;
+        case RelayTune::Status::Failed:
+            APP_LOGE("Relay tune: can not identify head params");
+            app.enqueue_message(AppCmd::Stop{});
+            return;
+        case RelayTune::Status::Done:
+            break;
+    }
+
+    const auto& r = tuner.get_result();
+
+    etl::format_spec decimal_format;
+    decimal_format.precision(6);
+
+    etl::string<16> τ_str;
+    etl::string<16> L_str;
+    etl::string<16> b0_str;
+    etl::to_string(r.tau, τ_str, decimal_format);
+    etl::to_string(r.delay, L_str, decimal_format);
+    etl::to_string(r.b0, b0_str, decimal_format);
+
+    APP_LOGI("Relay tune analysis ({} sec):", time_ms / 1000);
+    APP_LOGI("  period = {}s, amplitude = {}°C x100",
+        static_cast<int>(r.period), static_cast<int>(r.amplitude * 100));
+    APP_LOGI("  response = {}s, effective delay = {}s", τ_str.c_str(), L_str.c_str());
+    APP_LOGI("  b0 = {}", b0_str.c_str());
+
+    HeadParams p = HeadParams_init_zero;
+    if (!heater.get_head_params(p)) {
+        APP_LOGE("Relay tune: can't read head params, result not stored");
+        app.enqueue_message(AppCmd::Stop{});
+        return;
+    }
+
+    p.adrc_response = r.tau;
+    p.adrc_b0 = r.b0;
+
+    heater.set_head_params(p);
+    app.enqueue_message(AppCmd::Stop{true});
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "app.hpp"
+#include "lib/relay_tune.hpp"
+#include "proto/generated/types.pb.h"
+
+class RelayTune_State : public etl::fsm_state<App, RelayTune_State, DeviceActivityStatus_RELAY_TUNE,
+    AppCmd::Stop, AppCmd::Button> {
+public:
+    static constexpr int32_t SAMPLE_INTERVAL_MS = 100;
+    static constexpr int32_t MAX_DURATION_MS = 600'000;  // 10 minutes max
+    static constexpr float HYSTERESIS = 0.5f;  // °C, above sensor noise
+
+    auto on_enter_state() -> etl::fsm_state_id_t override;
+
+    auto on_event(const AppCmd::Stop& event) -> etl::fsm_state_id_t;
+    auto on_event(const AppCmd::Button& event) -> etl::fsm_state_id_t;
+    auto on_event_unknown(const etl::imessage& event) -> etl::fsm_state_id_t;
+
+    void on_exit_state() override;
+
+    struct Scratch {
+        RelayTune tuner{};
+    };
+
+private:
+    Scratch* scratch{nullptr};
+    int32_t last_sample_ms{0};
+
+    void task_iterator(int32_t time_ms);
+};
@@ -1,4 +1,5 @@
 #include "sensor_bake.hpp"
+#include <cmath>
 #include "heater/heater.hpp"
 #include "logger.hpp"
 
@@ -6,11 +7,8 @@ auto SensorBake_State::on_enter_state() -> etl::fsm_state_id_t {
     auto& app = get_fsm_context();
     APP_LOGI("State => SensorBake");
 
-    last_temperature = heater.get_temperature();
-
-    auto status = heater.task_start(HISTORY_ID_SENSOR_BAKE_MODE, [this](int32_t time_ms) {
-        task_iterator(time_ms);
-    });
+    auto status = heater.task_start(HISTORY_ID_SENSOR_BAKE_MODE,
+        HeaterTaskIteratorFn::create<SensorBake_State, &SensorBake_State::task_iterator>(*this));
     if (!status) {
         app.beepTaskTerminated();
         return DeviceActivityStatus_IDLE;
@@ -53,11 +51,10 @@ void SensorBake_State::on_exit_state() {
 }
 
 void SensorBake_State::task_iterator(int32_t /*time_ms*/) {
-    // Check for abnormal temperature jitter
-    const float current_temp = heater.get_temperature();
-    if (std::abs(current_temp - last_temperature) > 5.0f) {
-        APP_LOGE("Abnormal temperature jitter detected: {} -> {}",
-            static_cast<int>(last_temperature), static_cast<int>(current_temp));
+    // Check for abnormal temperature jitter (sample far from recent trend)
+    const float residual = heater.get_temperature_residual();
+    if (std::abs(residual) > HeaterControlBase::MAX_TEMPERATURE_RESIDUAL) {
+        APP_LOGE("Abnormal temperature jitter detected: {} off trend at {}",
+            static_cast<int>(residual), static_cast<int>(heater.get_temperature()));
     }
-    last_temperature = current_temp;
 }
@@ -16,7 +16,5 @@ public:
     void on_exit_state() override;
 
 private:
-    float last_temperature = 0.0f;
-
     void task_iterator(int32_t time_ms);
 };
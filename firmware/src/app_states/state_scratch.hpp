@@ -0,0 +1,17 @@
+#pragma once
+
+#include "lib/scratch_arena.hpp"
+#include "reflow.hpp"
+#include "relay_tune.hpp"
+#include "step_response.hpp"
+
+// Working data of App states. Only one state is active at a time, so big
+// objects are borrowed from the single arena on enter and returned on exit.
+// RAM budget is the largest state's needs, instead of the sum.
+using StateScratch = ScratchArena<
+    Reflow_State::Scratch,
+    StepResponse_State::Scratch,
+    RelayTune_State::Scratch
+>;
+
+extern StateScratch state_scratch;
@@ -1,4 +1,6 @@
 #include "step_response.hpp"
+#include "state_scratch.hpp"
+#include <cmath>
 #include <etl/format_spec.h>
 #include <etl/string.h>
 #include <etl/to_string.h>
@@ -11,22 +13,17 @@ auto StepResponse_State::on_enter_state() -> etl::fsm_state_id_t {
 
     auto& app = get_fsm_context();
 
-    log_entries_.reset(new LOG_STORE());
-    auto& log = *log_entries_;
-
-    log.push_back({
-        .temperature_x10 = static_cast<int16_t>(heater.get_temperature() * 10.0f),
-        .power_x10 = static_cast<uint16_t>(heater.get_power() * 10.0f),
-        .time_x50 = 0
-    });
-
-    auto status = heater.task_start(HISTORY_ID_STEP_RESPONSE, [this](int32_t time_ms) {
-        task_iterator(time_ms);
-    });
-    if (!status) {
-        log_entries_.reset();
-        return DeviceActivityStatus_IDLE;
-    }
+    scratch = &state_scratch.acquire<Scratch>();
+
+    const float temperature = heater.get_temperature();
+    last_sample_ms = 0;
+    converged_count = 0;
+    scratch->fit.reset(temperature);
+    scratch->fit.add(0, temperature, app.last_cmd_data);
+
+    auto status = heater.task_start(HISTORY_ID_STEP_RESPONSE,
+        HeaterTaskIteratorFn::create<StepResponse_State, &StepResponse_State::task_iterator>(*this));
+    if (!status) { return DeviceActivityStatus_IDLE; }
 
     heater.set_power(app.last_cmd_data);
     app.beepTaskStarted();
@@ -53,156 +50,85 @@ auto StepResponse_State::on_event_unknown(const etl::imessage& event) -> etl::fs
 
 void StepResponse_State::on_exit_state() {
     heater.task_stop();
-    log_entries_.reset();
+    state_scratch.release();
+    scratch = nullptr;
 }
 
 static constexpr int32_t MAX_TRANSPORT_DELAY_MS = 10'000;  // 10 seconds max transport delay
-static constexpr int32_t STABILITY_CHECK_PERIOD_MS = 30'000;  // 30 seconds stability check period
-static constexpr float STABILITY_THRESHOLD_TEMP = 1.0f;  // 1 degree Celsius
+// Fit is accepted when relative standard deviation of τ and b0 stays below
+// threshold for a while. Response should pass 63% point at least, to make
+// curvature (τ) observable.
+static constexpr float CONVERGED_REL_SD = 0.02f;
+static constexpr uint32_t CONVERGED_CHECKS = 10;  // 5 seconds
 
 void StepResponse_State::task_iterator(int32_t time_ms) {
-    if (!log_entries_) { return; }
-    auto& log = *log_entries_;
-
-    // Check for abnormal temperature jitter
-    const float current_temp = heater.get_temperature();
-    const float last_temp = log.back().temperature_x10 * 0.1f;
-    if (std::abs(current_temp - last_temp) > 5.0f) {
-        APP_LOGE("Abnormal temperature jitter detected: {} -> {}",
-            static_cast<int>(last_temp), static_cast<int>(current_temp));
-    }
-
-    // Check if it's time to record a new log entry
-    const int32_t last_log_time_ms = (log.back().time_x50 * 1000) / 50;
-    if (time_ms < last_log_time_ms + LOG_INTERVAL_MS) { return; }
-
     auto& app = get_fsm_context();
+    auto& fit = scratch->fit;
+
+    if (time_ms < last_sample_ms + SAMPLE_INTERVAL_MS) { return; }
 
-    // Check if the max log size has been reached.
-    if (log.size() >= MAX_LOG_SIZE) {
+    if (time_ms >= MAX_DURATION_MS) {
         app.enqueue_message(AppCmd::Stop{});
         return;
     }
 
-    // Record new log entry
-    log.push_back({
-        .temperature_x10 = static_cast<int16_t>(heater.get_temperature() * 10.0f),
-        .power_x10 = static_cast<uint16_t>(heater.get_power() * 10.0f),
-        .time_x50 = static_cast<uint16_t>(time_ms / 20)  // seconds * 50 = ms / 20
-    });
+    // Check for abnormal temperature jitter (sample far from recent trend)
+    const float temperature = heater.get_temperature();
+    const float residual = heater.get_temperature_residual();
+    if (std::abs(residual) > HeaterControlBase::MAX_TEMPERATURE_RESIDUAL) {
+        APP_LOGE("Abnormal temperature jitter detected: {} off trend at {}",
+            static_cast<int>(residual), static_cast<int>(temperature));
+    }
+
+    fit.add(static_cast<float>(time_ms - last_sample_ms) * 0.001f, temperature, heater.get_power());
+    last_sample_ms = time_ms;
 
     // Skip transport delay period
     if (time_ms < MAX_TRANSPORT_DELAY_MS) { return; }
 
-    // Check stability: temperature change < 1°C over stability period
-    constexpr size_t offset = STABILITY_CHECK_PERIOD_MS / LOG_INTERVAL_MS;
-    if (log.size() <= offset) { return; }
+    FopdtFit::Result r{};
+    const bool converged = fit.solve(r) &&
+        fit.get_elapsed() >= r.tau + r.delay &&
+        r.tau_rel_sd <= CONVERGED_REL_SD &&
+        r.b0_rel_sd <= CONVERGED_REL_SD;
 
-    const LogEntry& old_entry = log[log.size() - offset - 1];
-    if (std::abs(log.back().temperature_x10 - old_entry.temperature_x10) > STABILITY_THRESHOLD_TEMP * 10) {
-        return;
-    }
+    converged_count = converged ? converged_count + 1 : 0;
+    if (converged_count < CONVERGED_CHECKS) { return; }
 
     //
-    // Analyze the log to find the response time and b0.
+    // Store the fit results.
     //
 
-    // - Heater has long tail. Early window (28/63) use is preferable over S-K (35/85)
     // - L/τ ratio is about 0.04 => predictive model will not give benefits,
     //   ADRC is enough
 
-    // Alternate two points for shorter log
-    uint32_t idx_28 = find_t_idx_of(0.28f);
-    uint32_t idx_63 = find_t_idx_of(0.63f);
-
-    float c_28 = log[idx_28].temperature_x10 * 0.1f;
-    float t_28 = log[idx_28].time_x50 / 50.0f;
-    float c_63 = log[idx_63].temperature_x10 * 0.1f;
-    float t_63 = log[idx_63].time_x50 / 50.0f;
-
-    float τ = 1.502069f * (t_63 - t_28);
-    float L = 1.493523f * t_28 - 0.493523f * t_63;
-
     etl::format_spec decimal_format;
     decimal_format.precision(6);
 
     etl::string<16> τ_str;
     etl::string<16> L_str;
-    etl::to_string(τ, τ_str, decimal_format);
-    etl::to_string(L, L_str, decimal_format);
-
-    float t_max = log[find_t_idx_of(1.0f)].temperature_x10 * 0.1f;
-
-    APP_LOGI("Step response analysis:");
-    APP_LOGI("  t max = {}°C", static_cast<int>(t_max));
+    etl::string<16> b0_str;
+    etl::to_string(r.tau, τ_str, decimal_format);
+    etl::to_string(r.delay, L_str, decimal_format);
+    etl::to_string(r.b0, b0_str, decimal_format);
 
-    APP_LOGI("  28% point = {}°C, {} sec", static_cast<int>(c_28), static_cast<int>(t_28));
-    APP_LOGI("  63% point = {}°C, {} sec", static_cast<int>(c_63), static_cast<int>(t_63));
+    APP_LOGI("Step response analysis ({} sec):", time_ms / 1000);
     APP_LOGI("  response = {}s, effective delay = {}s", τ_str.c_str(), L_str.c_str());
-
-    // Step is 0 => constant power.
-    float du = (log[idx_63].power_x10 * 0.1f - 0);
-
-    float b0 = (c_63 - c_28) / ((0.63f - 0.28f) * τ * du);
-    // Linear fit over edge points gives twice lower value
-    // float b0 = (c_63 - c_28) / ((t_63 - t_28) * du);
-
-    etl::string<16> b0_str;
-    etl::to_string(b0, b0_str, decimal_format);
     APP_LOGI("  b0 = {}", b0_str.c_str());
+    APP_LOGI("  rel. SD: τ {}‰, b0 {}‰", static_cast<int>(r.tau_rel_sd * 1000), static_cast<int>(r.b0_rel_sd * 1000));
 
-    HeadParams p;
-    heater.get_head_params(p);
+    HeadParams p = HeadParams_init_zero;
+    if (!heater.get_head_params(p)) {
+        APP_LOGE("Step response: can't read head params, result not stored");
+        app.enqueue_message(AppCmd::Stop{});
+        converged_count = 0;
+        return;
+    }
 
-    p.adrc_response = τ;
-    p.adrc_b0 = b0;
+    p.adrc_response = r.tau;
+    p.adrc_b0 = r.b0;
 
     heater.set_head_params(p);
     app.enqueue_message(AppCmd::Stop{true});
-}
-
-size_t StepResponse_State::find_t_idx_of(float ratio) {
-    if (!log_entries_) { return 0; }
-    auto& log = *log_entries_;
-
-    int16_t t_initial_x10 = log.front().temperature_x10;
-
-    // Find maximum temperature in log
-    int16_t t_max_x10 = log[0].temperature_x10;
-    size_t max_idx = 0;
-    for (size_t i = 1; i < log.size(); ++i) {
-        if (log[i].temperature_x10 > t_max_x10) {
-            t_max_x10 = log[i].temperature_x10;
-            max_idx = i;
-        }
-    }
-
-    // For ratio >= 1.0, return index of maximum temperature
-    if (ratio >= 1.0f) {
-        return max_idx;
-    }
-
-    // For ratio 0...1, find where temperature reaches ratio of (t_max - t_initial)
-    int16_t target_temp_x10 = t_initial_x10 + static_cast<int16_t>((t_max_x10 - t_initial_x10) * ratio);
-
-    // Find first point >= target
-    size_t idx = log.size() - 1;
-    for (size_t i = 0; i < log.size(); ++i) {
-        if (log[i].temperature_x10 >= target_temp_x10) {
-            idx = i;
-            break;
-        }
-    }
-
-    // Check if previous point is closer
-    if (idx > 0) {
-        int16_t diff_curr = std::abs(log[idx].temperature_x10 - target_temp_x10);
-        int16_t diff_prev = std::abs(log[idx - 1].temperature_x10 - target_temp_x10);
-
-        if (diff_prev < diff_curr) {
-            idx = idx - 1;
-        }
-    }
-
-    return idx;
+    converged_count = 0;
 }
@@ -1,24 +1,14 @@
 #pragma once
 
-#include <etl/memory.h>
-#include <etl/vector.h>
-
 #include "app.hpp"
+#include "lib/fopdt_fit.hpp"
 #include "proto/generated/types.pb.h"
 
 class StepResponse_State : public etl::fsm_state<App, StepResponse_State, DeviceActivityStatus_STEP_RESPONSE,
     AppCmd::Stop, AppCmd::Button> {
 public:
-    struct LogEntry {
-        int16_t temperature_x10;  // Temperature * 10
-        uint16_t power_x10;       // Power in watts * 10
-        uint16_t time_x50;        // Time in seconds * 50 (resolution 0.02s)
-    };
-
-    static constexpr int32_t LOG_INTERVAL_MS = 500;
-    static constexpr int32_t MAX_LOG_DURATION_MS = 1'000'000;  // 1000 seconds max
-    static constexpr int32_t MAX_LOG_SIZE = MAX_LOG_DURATION_MS / LOG_INTERVAL_MS;  // 2000 entries
-    using LOG_STORE = etl::vector<LogEntry, MAX_LOG_SIZE>;
+    static constexpr int32_t SAMPLE_INTERVAL_MS = 500;
+    static constexpr int32_t MAX_DURATION_MS = 1'000'000;  // 1000 seconds max
 
     auto on_enter_state() -> etl::fsm_state_id_t override;
 
@@ -28,9 +18,14 @@ public:
 
     void on_exit_state() override;
 
+    struct Scratch {
+        FopdtFit fit{};
+    };
+
 private:
-    etl::unique_ptr<LOG_STORE> log_entries_{};
+    Scratch* scratch{nullptr};
+    int32_t last_sample_ms{0};
+    uint32_t converged_count{0};
 
     void task_iterator(int32_t time_ms);
-    size_t find_t_idx_of(float ratio);
 };
@@ -0,0 +1,124 @@
+#include "tcr_calibration.hpp"
+#include <etl/limits.h>
+
+#include "components/time.hpp"
+#include "heater/heater.hpp"
+#include "logger.hpp"
+
+auto TcrCalibration_State::on_enter_state() -> etl::fsm_state_id_t {
+    auto& app = get_fsm_context();
+    APP_LOGI("State => TcrCalibration");
+
+    // Heater task only records history, sweep runs on timer ticks in app
+    // context, to process client references without extra locking.
+    if (!heater.task_start(HISTORY_ID_TCR_CALIBRATION)) {
+        app.tcr_calibration.finish();
+        app.beepTaskTerminated();
+        return DeviceActivityStatus_IDLE;
+    }
+
+    xTickTimer = xTimerCreate("TcrTick", pdMS_TO_TICKS(TICK_PERIOD_MS), pdTRUE, (void *)0,
+        [](TimerHandle_t){
+            application.enqueue_message(AppCmd::TcrTick{});
+        });
+
+    if (!xTickTimer || xTimerStart(xTickTimer, 0) != pdPASS) {
+        app.tcr_calibration.finish();
+        app.beepTaskTerminated();
+        return DeviceActivityStatus_IDLE;
+    }
+
+    step_started_ms = Time::now();
+    heater.set_power(app.tcr_calibration.get_power());
+    app.beepTaskStarted();
+    return No_State_Change;
+}
+
+auto TcrCalibration_State::on_event(const AppCmd::TcrTick&) -> etl::fsm_state_id_t {
+    auto& app = get_fsm_context();
+    auto& cal = app.tcr_calibration;
+
+    const auto now = Time::now();
+    if (cal.get_phase() == TcrCalibration::Phase::Settling && now - step_started_ms >= MAX_STEP_DURATION_MS) {
+        APP_LOGE("TCR calibration: no equilibrium at step {}", cal.get_step() + 1);
+        cal.finish();
+        app.beepTaskTerminated();
+        return DeviceActivityStatus_IDLE;
+    }
+
+    const float ohms = heater.get_resistance();
+    if (ohms == etl::numeric_limits<float>::max()) { return No_State_Change; }
+
+    const float mohms = ohms * 1000.0f;
+    const auto temperature_x10 = static_cast<int32_t>(heater.get_temperature() * 10);
+
+    if (cal.update(now, temperature_x10, mohms)) {
+        APP_LOGI("TCR calibration: step {}/{} stable, waiting for reference",
+            cal.get_step() + 1, cal.get_steps());
+        app.beepButtonPress();
+    }
+    return No_State_Change;
+}
+
+auto TcrCalibration_State::on_event(const AppCmd::TcrReference& event) -> etl::fsm_state_id_t {
+    auto& app = get_fsm_context();
+    auto& cal = app.tcr_calibration;
+
+    if (!cal.add_reference(event.temperature)) {
+        APP_LOGI("TCR calibration: reference ignored, plateau not reached");
+        return No_State_Change;
+    }
+
+    const auto& p = cal.get_points().back();
+    APP_LOGI("TCR calibration: point {} - {} mOhm at {}°C",
+        cal.get_step(), static_cast<int>(p.value), static_cast<int>(p.at));
+
+    if (cal.get_phase() != TcrCalibration::Phase::Done) {
+        step_started_ms = Time::now();
+        heater.set_power(cal.get_power());
+        return No_State_Change;
+    }
+
+    heater.set_power(0);
+    if (!heater.set_tcr_calibration(cal.get_points())) {
+        APP_LOGE("TCR calibration: failed to store head params");
+        app.beepTaskTerminated();
+        return DeviceActivityStatus_IDLE;
+    }
+
+    app.beepTaskSucceeded();
+    return DeviceActivityStatus_IDLE;
+}
+
+auto TcrCalibration_State::on_event(const AppCmd::Stop&) -> etl::fsm_state_id_t {
+    auto& app = get_fsm_context();
+
+    app.tcr_calibration.finish();
+    app.beepTaskTerminated();
+    return DeviceActivityStatus_IDLE;
+}
+
+auto TcrCalibration_State::on_event(const AppCmd::Button& event) -> etl::fsm_state_id_t {
+    auto& app = get_fsm_context();
+
+    if (event.type == ButtonEventId::BUTTON_PRESSED_1X) {
+        app.tcr_calibration.finish();
+        app.beepTaskTerminated();
+        return DeviceActivityStatus_IDLE;
+    }
+    return No_State_Change;
+}
+
+auto TcrCalibration_State::on_event_unknown(const etl::imessage& event) -> etl::fsm_state_id_t {
+    get_fsm_context().LogUnknownEvent(event);
+    return No_State_Change;
+}
+
+void TcrCalibration_State::on_exit_state() {
+    if (xTickTimer) {
+        xTimerStop(xTickTimer, 0);
+        xTimerDelete(xTickTimer, 0);
+        xTickTimer = nullptr;
+    }
+    heater.task_stop();
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "app.hpp"
+#include "proto/generated/types.pb.h"
+
+// Multi-point TCR calibration: step through power levels, wait for
+// equilibrium at each, record resistance against reference temperature
+// from client.
+class TcrCalibration_State : public etl::fsm_state<App, TcrCalibration_State, DeviceActivityStatus_TCR_CALIBRATION,
+    AppCmd::TcrTick, AppCmd::TcrReference, AppCmd::Stop, AppCmd::Button> {
+public:
+    static constexpr int32_t TICK_PERIOD_MS = 1000;
+    static constexpr uint32_t MAX_STEP_DURATION_MS = 30 * 60 * 1000;  // 30 minutes per plateau
+
+    auto on_enter_state() -> etl::fsm_state_id_t override;
+
+    auto on_event(const AppCmd::TcrTick& event) -> etl::fsm_state_id_t;
+    auto on_event(const AppCmd::TcrReference& event) -> etl::fsm_state_id_t;
+    auto on_event(const AppCmd::Stop& event) -> etl::fsm_state_id_t;
+    auto on_event(const AppCmd::Button& event) -> etl::fsm_state_id_t;
+    auto on_event_unknown(const etl::imessage& event) -> etl::fsm_state_id_t;
+
+    void on_exit_state() override;
+
+private:
+    TimerHandle_t xTickTimer{nullptr};
+    uint32_t step_started_ms{0};
+};
@@ -0,0 +1,16 @@
+#include "sample_recorder.hpp"
+
+#include "heater/drain_tracker.hpp"
+#include "heater/head.hpp"
+
+SampleRecorder sample_recorder;
+
+void SampleRecorder::start() {
+    SampleTraceWriter::start(static_cast<uint8_t>(drain_tracker.get_chip()));
+    adc_lut(head.get_adc_interpolator().points);
+    // Record live state as is. Reconfiguring would reset filters, and the
+    // trace would not match a session in progress.
+    head.record_sensor_config();
+    drain_tracker.record_info();
+    head.request_trace_state();
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+
+#include "components/time.hpp"
+#include "lib/sample_trace.hpp"
+
+// Records raw measurement inputs for host replay. Disabled by default,
+// recording calls are cheap no-ops until started via RPC.
+class SampleRecorder : public SampleTraceWriter<8 * 1024> {
+public:
+    void lock() override { portENTER_CRITICAL_SAFE(&spinlock); }
+    void unlock() override { portEXIT_CRITICAL_SAFE(&spinlock); }
+    auto now_ms() -> uint32_t override { return Time::now(); }
+
+    // Reset buffer and write initial state (ADC LUT, sensor config, drain
+    // info). ADC and TCR filter states follow from their tasks.
+    void start();
+
+private:
+    portMUX_TYPE spinlock = portMUX_INITIALIZER_UNLOCKED;
+};
+
+extern SampleRecorder sample_recorder;
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include "proto/generated/shared_constants.hpp"
 #include "proto/generated/types.pb.h"
 #include "lib/pt100.hpp"
 
@@ -11,6 +13,13 @@ public:
     static constexpr uint32_t TCR_R_DEFAULT = 3000; // in mohms
     static constexpr int32_t TCR_T_REF_DEFAULT_X10 = 25 * 10; // in Celsius * 10
     static constexpr float TCR_COEFF_DEFAULT = 0.00393f / 10.0f; // Copper TCR, scaled for 0.1°C units (original: 0.00393 [1/°C])
+    static constexpr size_t MAX_TCR_POINTS = SharedConstants::MAX_TCR_CAL_POINTS;
+
+    // Temperature with capture time of the sensor value it was derived from
+    struct Measurement {
+        int32_t temperature_x10;
+        uint32_t timestamp_ms;
+    };
 
     TemperatureProcessor() {
         rebuild();
@@ -25,12 +34,30 @@ public:
         p1_at = at_1; p1_value = value_1;
         rebuild();
     }
+    // Multi-point TCR calibration, overrides 2-point data when 2+ valid
+    // pairs given. Order does not matter, pairs are sorted by resistance.
+    void set_tcr_points(const float* at, const float* value, size_t count) {
+        tcr_points_count = 0;
+        for (size_t i = 0; i < count && tcr_points_count < MAX_TCR_POINTS; i++) {
+            if (at[i] <= 0 || value[i] <= 0) { continue; }
+
+            // Insertion sort by resistance
+            size_t j = tcr_points_count++;
+            for (; j > 0 && tcr_points[j - 1].value > value[i]; j--) { tcr_points[j] = tcr_points[j - 1]; }
+            tcr_points[j] = { at[i], value[i] };
+        }
+        rebuild();
+    }
 
     int32_t get_temperature_x10(uint32_t sensor_value) {
         if (sensor_type == SensorType_RTD) { return get_rtd_temperature_x10(sensor_value); }
         else { return get_tcr_temperature_x10(sensor_value); }
     }
 
+    auto get_measurement(uint32_t sensor_value, uint32_t timestamp_ms) -> Measurement {
+        return { get_temperature_x10(sensor_value), timestamp_ms };
+    }
+
 private:
     SensorType sensor_type{SensorType_RTD};
     // Calibration points
@@ -39,15 +66,25 @@ private:
     float p1_at{0.0f};
     float p1_value{0.0f};
 
+    struct TcrPoint { float at; float value; };
+    TcrPoint tcr_points[MAX_TCR_POINTS]{};
+    size_t tcr_points_count{0};
+
     // Coefficients for temperature calculation
     // RTD calibration: R_corrected = rtd_gain * R_raw + rtd_offset
     int32_t rtd_gain_q16{};   // Q16 fixed-point: gain = (R_expected1 - R_expected0) / (R_raw1 - R_raw0)
     int32_t rtd_offset{};     // in milliohms
 
-    // TCR calibration: T_x10 = tcr_t_ref_x10 + (R - tcr_r_base) * inv_gain
-    uint32_t tcr_r_base{};       // in milliohms
-    int32_t tcr_t_ref_x10{};     // temperature x10
-    int32_t tcr_inv_gain_q16{};  // Q16 fixed-point: inv_gain = dT_x10/dR
+    // TCR calibration: T_x10 = t_ref_x10 + (R - r_base) * inv_gain, for
+    // segment with largest r_base <= R (first/last segments extrapolate).
+    // Single segment for 0..2 calibration points.
+    struct TcrSegment {
+        uint32_t r_base;       // in milliohms
+        int32_t t_ref_x10;     // temperature x10
+        int32_t inv_gain_q16;  // Q16 fixed-point: inv_gain = dT_x10/dR
+    };
+    TcrSegment tcr_segments[MAX_TCR_POINTS - 1]{};
+    size_t tcr_segments_count{1};
 
 
     uint8_t cal_points_count() const {
@@ -116,43 +153,71 @@ private:
         return T_x10;
     }
 
+    static auto make_tcr_segment(float at, float value, float gain) -> TcrSegment {
+        return {
+            .r_base = static_cast<uint32_t>(value),
+            .t_ref_x10 = static_cast<int32_t>(at * 10),
+            .inv_gain_q16 = static_cast<int32_t>((1.0f / gain) * 65536.0f)
+        };
+    }
+
+    // Piecewise model needs both temperature and resistance strictly growing
+    bool prepare_tcr_multipoint() {
+        if (tcr_points_count < 2) { return false; }
+
+        for (size_t i = 1; i < tcr_points_count; i++) {
+            if (tcr_points[i].value <= tcr_points[i - 1].value ||
+                tcr_points[i].at <= tcr_points[i - 1].at) { return false; }
+        }
+
+        for (size_t i = 0; i + 1 < tcr_points_count; i++) {
+            const auto& p0 = tcr_points[i];
+            const auto& p1 = tcr_points[i + 1];
+            tcr_segments[i] = make_tcr_segment(p0.at, p0.value,
+                (p1.value - p0.value) / ((p1.at - p0.at) * 10.0f));
+        }
+        tcr_segments_count = tcr_points_count - 1;
+        return true;
+    }
+
     void prepare_tcr_coeffs() {
-        float gain;
+        if (prepare_tcr_multipoint()) { return; }
+
+        tcr_segments_count = 1;
         switch(cal_points_count()) {
             case 0: // No calibration points
-                tcr_r_base = TCR_R_DEFAULT;
-                tcr_t_ref_x10 = TCR_T_REF_DEFAULT_X10;
                 // gain = dR/dT_x10 = R_base * TCR_coeff
-                gain = TCR_R_DEFAULT * TCR_COEFF_DEFAULT;
-                tcr_inv_gain_q16 = static_cast<int32_t>((1.0f / gain) * 65536.0f);
+                tcr_segments[0] = make_tcr_segment(TCR_T_REF_DEFAULT_X10 / 10.0f, TCR_R_DEFAULT,
+                    TCR_R_DEFAULT * TCR_COEFF_DEFAULT);
                 break;
 
             case 1: // One calibration point
-                tcr_r_base = static_cast<uint32_t>(p0_value);
-                tcr_t_ref_x10 = static_cast<int32_t>(p0_at * 10);
                 // gain = dR/dT_x10 = R_base * TCR_coeff
-                gain = p0_value * TCR_COEFF_DEFAULT;
-                tcr_inv_gain_q16 = static_cast<int32_t>((1.0f / gain) * 65536.0f);
+                tcr_segments[0] = make_tcr_segment(p0_at, p0_value, p0_value * TCR_COEFF_DEFAULT);
                 break;
 
             case 2: // Two calibration points
-                tcr_r_base = static_cast<uint32_t>(p0_value);
-                tcr_t_ref_x10 = static_cast<int32_t>(p0_at * 10);
                 // gain = dR/dT_x10 = (R1 - R0) / (T1_x10 - T0_x10)
                 // Division by zero is protected by cal_points_count()
-                gain = (p1_value - p0_value) / ((p1_at - p0_at) * 10.0f);
-                tcr_inv_gain_q16 = static_cast<int32_t>((1.0f / gain) * 65536.0f);
+                tcr_segments[0] = make_tcr_segment(p0_at, p0_value,
+                    (p1_value - p0_value) / ((p1_at - p0_at) * 10.0f));
                 break;
         }
     }
 
+    // Constant time: at most MAX_TCR_POINTS - 2 integer compares to pick
+    // segment, then the same fixed-point math as for 2-point calibration.
     int32_t get_tcr_temperature_x10(uint32_t mohms) const {
+        size_t i = 0;
+        while (i + 1 < tcr_segments_count && mohms >= tcr_segments[i + 1].r_base) { i++; }
+        const auto& seg = tcr_segments[i];
+
         // T_x10 = T_ref_x10 + (R - R_base) * inv_gain
         // where inv_gain = dT_x10/dR
-        int32_t delta_R = static_cast<int32_t>(mohms - tcr_r_base);
-        int64_t delta_T_x10 = (static_cast<int64_t>(delta_R) * static_cast<int64_t>(tcr_inv_gain_q16)) >> 16;
+        int32_t delta_R = static_cast<int32_t>(mohms - seg.r_base);
+        int64_t delta_T_x10 = (static_cast<int64_t>(delta_R) * static_cast<int64_t>(seg.inv_gain_q16)) >> 16;
 
-        int32_t T_x10 = tcr_t_ref_x10 + static_cast<int32_t>(delta_T_x10);
+        int32_t T_x10 = seg.t_ref_x10 + static_cast<int32_t>(delta_T_x10);
         return T_x10;
     }
 
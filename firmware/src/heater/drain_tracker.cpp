@@ -1,6 +1,8 @@
 #include "drain_tracker.hpp"
 
 #include "components/i2c_io.hpp"
+#include "components/sample_recorder.hpp"
+#include "components/time.hpp"
 #include "logger.hpp"
 
 DrainTracker drain_tracker;
@@ -31,75 +33,39 @@ void DrainTracker::collect_data(uint32_t ctx_idx) {
     if (!adc_ina_read_reg16(vbus_reg, adc_v_raw)) { return; }
     if (!adc_ina_read_reg16(current_reg, adc_i_raw)) { return; }
 
-    adc_buffer[adc_count % ADC_FILTER_SIZE] = {
+    adc_filter.push({
         .v_raw = adc_v_raw,
         .i_raw = static_cast<int16_t>(adc_i_raw),
         .ctx_idx = ctx_idx
-    };
-    adc_count++;
+    });
+    sample_recorder.ina_sample(adc_v_raw, adc_i_raw, ctx_idx);
 }
 
 void DrainTracker::process_collected_data() {
-    if (adc_count == 0) {
-        return;
-    }
-    if (adc_ina_chip == ADC_INA_CHIP::Unknown) {
-        adc_count = 0;
-        return;
-    }
-
-    uint32_t count = adc_count < ADC_FILTER_SIZE ? adc_count : ADC_FILTER_SIZE;
-
-    // Check that all samples have a consistent profile index.
-    // If the index changed mid-collection, drop this batch; the next PWM cycle
-    // will retry.
-    uint32_t first_idx = adc_buffer[0].ctx_idx;
-    for (uint32_t i = 1; i < count; i++) {
-        if (adc_buffer[i].ctx_idx != first_idx) {
-            adc_count = 0;
-            return;
-        }
-    }
-
-    uint32_t v_sum{0};
-    int32_t i_sum{0};
-
-    for (uint32_t i = 0; i < count; i++) {
-        v_sum += adc_buffer[i].v_raw;
-        i_sum += adc_buffer[i].i_raw;
-    }
-
-    if (i_sum < 0) { i_sum = 0; }
-    uint32_t v_avg = v_sum / count;
-    uint32_t peak_mv = 0;
-    if (adc_ina_chip == ADC_INA_CHIP::INA238) {
-        // INA238 VBUS LSB = 3.125 mV
-        peak_mv = (v_avg * 3125 + 500) / 1000;
-    } else {
-        // INA226 VBUS LSB = 1.25 mV
-        peak_mv = (v_avg * 5 + 2) / 4;
-    }
-    // Shunt current already in mA
-    uint32_t peak_ma = static_cast<uint32_t>(i_sum / static_cast<int32_t>(count));
-    // Thresholds for real measurements, not PD limits.
-    bool load_valid = (peak_ma >= 300 && peak_mv >= 4000);
+    DRAIN_INFO result{};
+    if (!adc_filter.process(adc_ina_chip, result, Time::now())) { return; }
 
     xSemaphoreTake(info_lock, portMAX_DELAY);
-    info.peak_mv = peak_mv;
-    info.peak_ma = peak_ma;
-    info.load_valid = load_valid;
-    info.ctx_idx = first_idx;
+    info = result;
+    // Pulse started before trace recording, replay can't rebuild result
+    if (!sample_recorder.is_pulse_recorded()) { sample_recorder.drain_info(result); }
     xSemaphoreGive(info_lock);
+}
 
-    adc_count = 0;
+void DrainTracker::record_info() {
+    // Under lock, to keep order with updates
+    xSemaphoreTake(info_lock, portMAX_DELAY);
+    sample_recorder.drain_info(info);
+    xSemaphoreGive(info_lock);
 }
 
 void DrainTracker::clear_collected_data() {
-    adc_count = 0;
+    adc_filter.clear();
 }
 
 void DrainTracker::reset() {
     clear_collected_data();
+    sample_recorder.drain_reset();
 
     xSemaphoreTake(info_lock, portMAX_DELAY);
     info = DRAIN_INFO{};
@@ -5,37 +5,25 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 
+#include "lib/ina_filter.hpp"
+
 class DrainTracker {
 public:
-    enum class ADC_INA_CHIP {
-        Unknown,
-        INA226,
-        INA238
-    };
-
-    struct DRAIN_INFO {
-        uint32_t peak_mv = 0;
-        uint32_t peak_ma = 0;
-        bool load_valid = false;
-        uint32_t ctx_idx = 0;  // Profile index at which measurements were taken
-    };
+    using ADC_INA_CHIP = InaFilter::Chip;
+    using DRAIN_INFO = InaFilter::Result;
 
     void setup();
     void collect_data(uint32_t ctx_idx);
     void process_collected_data();
     void clear_collected_data();
     void reset();
+    // Write current info to sample trace
+    void record_info();
 
     DRAIN_INFO get_info() const;
+    ADC_INA_CHIP get_chip() const { return adc_ina_chip; }
 
 private:
-    static constexpr uint32_t ADC_FILTER_SIZE = 8;
-    struct ADC_ITEM {
-        uint16_t v_raw;
-        int16_t i_raw;
-        uint32_t ctx_idx;  // Profile index at sample time
-    };
-
     static constexpr uint8_t ADC_INA_ADDR = 0x40;
 
     bool adc_ina_detect();
@@ -43,8 +31,7 @@ private:
     bool adc_ina_read_reg16(uint8_t reg, uint16_t &data);
     bool adc_ina_write_reg16(uint8_t reg, uint16_t data);
 
-    ADC_ITEM adc_buffer[ADC_FILTER_SIZE]{};
-    uint32_t adc_count{0};
+    InaFilter adc_filter{};
     ADC_INA_CHIP adc_ina_chip{ADC_INA_CHIP::Unknown};
 
     mutable SemaphoreHandle_t info_lock{xSemaphoreCreateMutex()};
@@ -1,11 +1,19 @@
+#include <string.h>
 #include <esp_check.h>
+#include <esp_efuse_rtc_calib.h>
+#include <esp_timer.h>
 #include <esp_adc/adc_cali_scheme.h>
 #include <soc/soc_caps.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <etl/algorithm.h>
 
 #include "components/i2c_io.hpp"
 #include "components/pb2struct.hpp"
+#include "components/prefs.hpp"
+#include "components/sample_recorder.hpp"
+#include "components/time.hpp"
+#include "drain_tracker.hpp"
 #include "head.hpp"
 #include "logger.hpp"
 #include "lib/pt100.hpp"
@@ -17,6 +25,31 @@ Head head;
 static constexpr uint32_t TASK_TICK_MS = 200;
 static constexpr uint8_t DETACH_PROBE_FAIL_THRESHOLD = 3;
 
+// Cached ADC LUT. Valid only for the same eFuse calibration version, and if
+// current calibration gives the same values at probe points (catches
+// ESP-IDF curve fitting changes after firmware update).
+namespace {
+
+constexpr const char* ADC_LUT_KEY = "adc_lut";
+constexpr uint8_t ADC_LUT_FORMAT = 1;
+constexpr uint16_t ADC_LUT_PROBES_RAW[] = { 0, 1024, 2048, 3072, 4095 };
+constexpr size_t ADC_LUT_PROBES = sizeof(ADC_LUT_PROBES_RAW) / sizeof(ADC_LUT_PROBES_RAW[0]);
+
+using AdcLutPoint = GridAdcInterpolator<Head::ADC_INTERPOLATOR_LUT_SIZE_MAX>::CalibPoint;
+
+struct AdcLutCache {
+    uint8_t format;
+    uint8_t efuse_version;
+    uint16_t count;
+    uint16_t probes_mv[ADC_LUT_PROBES];
+    AdcLutPoint points[Head::ADC_INTERPOLATOR_LUT_SIZE_MAX];
+};
+
+// Used once at boot, keep off the stack
+AdcLutCache adc_lut_cache;
+
+} // namespace
+
 using afsm::state_id_t;
 
 namespace HeadState {
@@ -124,6 +157,14 @@ Head::Head() {
 
 void Head::setup() {
     i2c_init();
+    // ADC task must exist before conversion starts, ISR notifies it.
+    // Stack fits trace record of filter state (~0.8K).
+    xTaskCreate(
+        [](void* params) {
+            auto* self = static_cast<Head*>(params);
+            while (true) { self->adc_task_loop(); }
+        }, "HeadAdc", 1024*4, this, 5, &adc_task_handle
+    );
     // Configure ADC on IO4 (ADC1_CH4)
     adc_init();
     // Now we can start the FSM.
@@ -147,17 +188,16 @@ void Head::task_loop() {
         }
     }
 
-    update_sensor_uv();
-
     // Run state machine
     run();
 }
 
 void Head::adc_init() {
     // Calculate derived parameters
-    constexpr uint32_t adc_sample_freq_hz = TEMPERATURE_SAMPLE_FREQ_HZ * ADC_OVERSAMPLING_COUNT;
-    constexpr uint32_t conv_frame_size = ADC_OVERSAMPLING_COUNT * SOC_ADC_DIGI_RESULT_BYTES;
-    constexpr uint32_t dma_buffer_size = conv_frame_size * 2;
+    constexpr uint32_t adc_sample_freq_hz = ADC_SAMPLE_FREQ_HZ;
+    constexpr uint32_t conv_frame_size = ADC_FRAME_SAMPLES * SOC_ADC_DIGI_RESULT_BYTES;
+    // Slack for task latency, frames are drained in task context
+    constexpr uint32_t dma_buffer_size = conv_frame_size * 4;
 
     // Compile-time checks for hardware limits
     static_assert(adc_sample_freq_hz <= SOC_ADC_SAMPLE_FREQ_THRES_HIGH,
@@ -166,8 +206,6 @@ void Head::adc_init() {
                   "ADC sample frequency below hardware limit");
     static_assert(conv_frame_size % SOC_ADC_DIGI_RESULT_BYTES == 0,
                   "Frame size must be multiple of SOC_ADC_DIGI_RESULT_BYTES");
-    static_assert(ADC_OVERSAMPLING_COUNT >= 10,
-                  "Too few samples for meaningful averaging");
 
     // Create ADC handle
     adc_continuous_handle_cfg_t adc_config{};
@@ -199,8 +237,16 @@ void Head::adc_init() {
     cf.bitwidth = ADC_BITWIDTH_12;
     ESP_ERROR_CHECK(adc_cali_create_scheme_curve_fitting(&cf, &adc_cali_handle));
 
-    // Build ADC calibration lookup table with sub-mV interpolation
-    build_adc_lut();
+    // ADC calibration lookup table with sub-mV interpolation. Building it is
+    // slow, so it's cached.
+    const int64_t lut_start_us = esp_timer_get_time();
+    const bool lut_loaded = load_adc_lut();
+    if (!lut_loaded) {
+        build_adc_lut();
+        save_adc_lut();
+    }
+    APP_LOGI("Head: ADC LUT {} in {} us", lut_loaded ? "loaded" : "built",
+        static_cast<int32_t>(esp_timer_get_time() - lut_start_us));
 
     // Register callback
     adc_continuous_evt_cbs_t cbs{};
@@ -238,57 +284,117 @@ void Head::build_adc_lut() {
             grid_point++;
         }
     }
-}
 
-bool IRAM_ATTR Head::adc_conv_done_callback(adc_continuous_handle_t handle,
-                                           const adc_continuous_evt_data_t *edata,
-                                           void *user_data) {
-    Head* self = static_cast<Head*>(user_data);
+    adc_interpolator.rebuild();
+}
 
-    uint32_t sum = 0;
-    uint32_t count = 0;
+void Head::adc_lut_fingerprint(uint16_t* probes_mv) {
+    for (size_t i = 0; i < ADC_LUT_PROBES; i++) {
+        int mV = 0;
+        adc_cali_raw_to_voltage(adc_cali_handle, ADC_LUT_PROBES_RAW[i], &mV);
+        probes_mv[i] = static_cast<uint16_t>(mV);
+    }
+}
 
-    // Average all samples in this frame
-    for (uint32_t i = 0; i < edata->size; i += SOC_ADC_DIGI_RESULT_BYTES) {
-        adc_digi_output_data_t *p = (adc_digi_output_data_t*)&edata->conv_frame_buffer[i];
+bool Head::load_adc_lut() {
+    auto& kv = AsyncPreferenceKV::getInstance();
+    if (kv.length(PREFS_NAMESPACE, ADC_LUT_KEY) != sizeof(AdcLutCache)) { return false; }
 
-        if (p->type2.channel == ADC_CHANNEL_4) {
-            sum += p->type2.data;
-            count++;
-        }
+    auto& cache = adc_lut_cache;
+    if (!kv.read(PREFS_NAMESPACE, ADC_LUT_KEY, reinterpret_cast<uint8_t*>(&cache), sizeof(cache))) {
+        return false;
     }
 
-    if (count > 0) {
-        // Store avg_x100 to preserve fractional precision
-        uint32_t avg_x100 = (sum * 100) / count;
+    uint16_t probes_mv[ADC_LUT_PROBES];
+    adc_lut_fingerprint(probes_mv);
 
-        self->temp_ring_buffer[self->ring_buffer_idx] = avg_x100;
-        self->ring_buffer_idx = (self->ring_buffer_idx + 1) % TEMPERATURE_RING_BUFFER_SIZE;
-        auto prev_count = self->ring_buffer_count.load();
-        if (prev_count < TEMPERATURE_RING_BUFFER_SIZE) {
-            self->ring_buffer_count.store(static_cast<uint8_t>(prev_count + 1));
-        }
+    if (cache.format != ADC_LUT_FORMAT ||
+        cache.efuse_version != static_cast<uint8_t>(esp_efuse_rtc_calib_get_ver()) ||
+        cache.count < 2 || cache.count > ADC_INTERPOLATOR_LUT_SIZE_MAX ||
+        memcmp(cache.probes_mv, probes_mv, sizeof(probes_mv)) != 0)
+    {
+        APP_LOGI("Head: ADC LUT cache mismatch, rebuilding");
+        return false;
     }
 
-    return false; // Don't yield from ISR
+    adc_interpolator.points.assign(cache.points, cache.points + cache.count);
+    adc_interpolator.rebuild();
+    return true;
 }
 
-void Head::update_sensor_uv() {
-    uint32_t valid_count = ring_buffer_count.load();
-    if (valid_count == 0) {
-        return;
+void Head::save_adc_lut() {
+    auto& cache = adc_lut_cache;
+    memset(&cache, 0, sizeof(cache));
+
+    cache.format = ADC_LUT_FORMAT;
+    cache.efuse_version = static_cast<uint8_t>(esp_efuse_rtc_calib_get_ver());
+    cache.count = static_cast<uint16_t>(adc_interpolator.points.size());
+    adc_lut_fingerprint(cache.probes_mv);
+    etl::copy(adc_interpolator.points.begin(), adc_interpolator.points.end(), cache.points);
+
+    if (!AsyncPreferenceKV::getInstance().write(PREFS_NAMESPACE, ADC_LUT_KEY,
+            reinterpret_cast<uint8_t*>(&cache), sizeof(cache)))
+    {
+        APP_LOGE("Head: Failed to save ADC LUT cache");
     }
+}
+
+bool IRAM_ATTR Head::adc_conv_done_callback(adc_continuous_handle_t handle,
+                                           const adc_continuous_evt_data_t *edata,
+                                           void *user_data) {
+    Head* self = static_cast<Head*>(user_data);
+
+    BaseType_t must_yield = pdFALSE;
+    vTaskNotifyGiveFromISR(self->adc_task_handle, &must_yield);
+    return must_yield == pdTRUE;
+}
+
+void Head::adc_task_loop() {
+    static uint8_t frame[ADC_FRAME_SAMPLES * SOC_ADC_DIGI_RESULT_BYTES];
 
-    // Sum all avg_x100 values from ring buffer
-    uint32_t total_sum = 0;
-    for (uint32_t i = 0; i < valid_count; i++) {
-        total_sum += temp_ring_buffer[i];
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    if (adc_trace_state_pending.exchange(false)) {
+        sample_recorder.adc_state(adc_filter, adc_filter_has_output);
     }
 
-    // Convert to microvolts using interpolator (scale = valid_count * 100)
-    uint32_t uV = adc_interpolator.to_uv(total_sum, valid_count * 100);
+    // CIC stage outputs for trace, raw samples are too many. Flushed before
+    // each filter output, to keep order with sensor updates.
+    int32_t cic[SampleTrace::MAX_CIC_BATCH];
+    size_t cic_count = 0;
+
+    // Drain all frames available, notifications may be merged
+    uint32_t size = 0;
+    while (adc_continuous_read(adc_handle, frame, sizeof(frame), &size, 0) == ESP_OK) {
+        for (uint32_t i = 0; i < size; i += SOC_ADC_DIGI_RESULT_BYTES) {
+            const auto* p = reinterpret_cast<const adc_digi_output_data_t*>(&frame[i]);
+
+            if (p->type2.channel != ADC_CHANNEL_4) { continue; }
+            if (!adc_filter.push_cic(static_cast<uint16_t>(p->type2.data))) { continue; }
+
+            cic[cic_count++] = adc_filter.get_cic_output();
+            const bool ready = adc_filter.push_fir(adc_filter.get_cic_output());
+            if (ready || cic_count == SampleTrace::MAX_CIC_BATCH) {
+                sample_recorder.adc_cic(cic, cic_count);
+                cic_count = 0;
+            }
+            if (!ready) { continue; }
+
+            // New filter output (raw x OUTPUT_SCALE)
+            const uint32_t value = adc_filter.get_output();
+            adc_filter_has_output = true;
+
+            sensor_uv.push(adc_interpolator.to_uv(value, AdcFilter::OUTPUT_SCALE), Time::now());
+            sample_recorder.sensor_update();
 
-    last_sensor_value_uv.store(uV);
+            if (!first_sensor_value_logged) {
+                first_sensor_value_logged = true;
+                APP_LOGI("Head: First sensor value at {} ms since boot",
+                    static_cast<int32_t>(esp_timer_get_time() / 1000));
+            }
+        }
+    }
+    if (cic_count) { sample_recorder.adc_cic(cic, cic_count); }
 }
 
 bool Head::get_head_params_pb(etl::ivector<uint8_t>& pb_data) {
@@ -325,23 +431,60 @@ bool Head::set_head_params(const HeadParams& params) {
 bool Head::is_tcr_sensor() const {
     // New boards have no RTD support at all.
     return true;
-    //return last_sensor_value_uv.load() <= SENSOR_SHORTED_LEVEL_MV * 1000;
+    //return get_sensor_uv() <= SENSOR_SHORTED_LEVEL_MV * 1000;
 }
 
-int32_t Head::get_temperature_x10() {
+auto Head::get_temperature_measurement() -> TemperatureProcessor::Measurement {
     // Safety check, should never happen due to state machine
-    if (!is_attached()) { return UNKNOWN_TEMPERATURE_X10; }
+    if (!is_attached()) { return { UNKNOWN_TEMPERATURE_X10, Time::now() }; }
 
     if (!is_tcr_sensor()) {
-        auto uV = last_sensor_value_uv.load();
-        return temperature_processor_rtd.get_temperature_x10(uV);
+        const auto s = get_sensor_uv_snapshot();
+        return temperature_processor_rtd.get_measurement(s.last, s.timestamp_ms - TEMPERATURE_GROUP_DELAY_US / 1000);
     }
 
-    auto mohms = power.get_load_mohm();
-    if (mohms == Power::UNKNOWN_RESISTANCE) {
-        return UNKNOWN_TEMPERATURE_X10;
+    return { tcr_temperature_x10.load(), tcr_timestamp_ms.load() };
+}
+
+void Head::update_temperature_estimate(uint32_t now_ms) {
+    if (tcr_kalman_reload.exchange(false)) {
+        HeadParams params = HeadParams_init_zero;
+        get_head_params(params, true);
+        tcr_kalman.set_params(params.adrc_b0, params.adrc_response);
+        tcr_kalman.reset();
     }
-    return temperature_processor_tcr.get_temperature_x10(mohms);
+
+    if (tcr_trace_state_pending.exchange(false)) {
+        const auto s = tcr_kalman.get_state();
+        sample_recorder.tcr_state({ .valid = s.valid, .x_q = s.x_q, .p_q = s.p_q, .seq = tcr_kalman_seq });
+    }
+
+    const uint32_t dt_ms = now_ms - tcr_kalman_ts_ms;
+    tcr_kalman_ts_ms = now_ms;
+
+    const auto info = drain_tracker.get_info();
+    const uint32_t power_mw = power.get_average_power_mw(info);
+    sample_recorder.thermal_tick({ .dt_ms = dt_ms, .power_mw = power_mw });
+
+    if (!info.load_valid) {
+        tcr_kalman.reset();
+        tcr_temperature_x10.store(UNKNOWN_TEMPERATURE_X10);
+        tcr_timestamp_ms.store(now_ms);
+        tcr_variance_x100.store(0);
+        return;
+    }
+
+    tcr_kalman.predict(dt_ms, power_mw);
+    if (info.seq != tcr_kalman_seq || !tcr_kalman.is_valid()) {
+        tcr_kalman_seq = info.seq;
+        tcr_kalman.update(temperature_processor_tcr.get_temperature_x10(info.peak_mv * 1000 / info.peak_ma),
+                          info.samples);
+    }
+
+    tcr_temperature_x10.store(tcr_kalman.get_temperature_x10());
+    // Model advances estimate to now, otherwise it's as old as measurement
+    tcr_timestamp_ms.store(tcr_kalman.has_model() ? now_ms : info.timestamp_ms);
+    tcr_variance_x100.store(tcr_kalman.get_variance_x100());
 }
 
 void Head::configure_temperature_processor() {
@@ -363,5 +506,37 @@ void Head::configure_temperature_processor() {
             params.sensor_p1_at,
             params.sensor_p1_value
         );
+        temperature_processor_tcr.set_tcr_points(
+            params.sensor_tcr_at,
+            params.sensor_tcr_value,
+            etl::min(params.sensor_tcr_at_count, params.sensor_tcr_value_count)
+        );
     }
+    record_sensor_config();
+
+    // Model params are picked up by the control loop task
+    tcr_kalman_reload.store(true);
+}
+
+void Head::record_sensor_config() {
+    HeadParams params = HeadParams_init_zero;
+    if (!get_head_params(params, true)) { return; }
+
+    SampleTrace::SensorConfig cfg{
+        .is_tcr = is_tcr_sensor(),
+        .p0_at = params.sensor_p0_at,
+        .p0_value = params.sensor_p0_value,
+        .p1_at = params.sensor_p1_at,
+        .p1_value = params.sensor_p1_value,
+        .adrc_response = params.adrc_response,
+        .adrc_b0 = params.adrc_b0,
+        .adrc_n_coeff = params.adrc_n_coeff,
+        .adrc_m_coeff = params.adrc_m_coeff,
+        .tcr_count = static_cast<uint8_t>(etl::min(params.sensor_tcr_at_count, params.sensor_tcr_value_count)),
+        .tcr_at = {},
+        .tcr_value = {}
+    };
+    etl::copy_n(params.sensor_tcr_at, cfg.tcr_count, cfg.tcr_at);
+    etl::copy_n(params.sensor_tcr_value, cfg.tcr_count, cfg.tcr_value);
+    sample_recorder.sensor_config(cfg);
 }
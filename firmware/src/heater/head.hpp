@@ -2,6 +2,8 @@
 
 #include <esp_adc/adc_continuous.h>
 #include <esp_adc/adc_cali.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include <etl/limits.h>
 #include <etl/atomic.h>
 #include <etl/vector.h>
@@ -11,6 +13,9 @@
 #include "components/temperature_processor.hpp"
 #include "lib/data_guard.hpp"
 #include "lib/adc_interpolator.hpp"
+#include "lib/decimation_filter.hpp"
+#include "lib/spsc_accumulator.hpp"
+#include "lib/tcr_kalman.hpp"
 #include "proto/generated/types.pb.h"
 
 class Head : public afsm::fsm<Head> {
@@ -27,12 +32,22 @@ public:
 
     // User-configurable ADC parameters
 
-    // Temperature update frequency
-    static constexpr uint32_t TEMPERATURE_SAMPLE_FREQ_HZ = 100;
-    // Samples to average (improves accuracy ~32x)
-    static constexpr uint32_t ADC_OVERSAMPLING_COUNT = 200;
-    // Ring buffer size for additional smoothing
-    static constexpr uint32_t TEMPERATURE_RING_BUFFER_SIZE = 10;
+    static constexpr uint32_t ADC_SAMPLE_FREQ_HZ = 20'000;
+    // Samples per DMA frame (frame rate = 100 Hz)
+    static constexpr uint32_t ADC_FRAME_SAMPLES = 200;
+    // CIC stage output is 1 kHz
+    static constexpr uint32_t ADC_CIC_DECIMATION = 20;
+    // Temperature update frequency, 20..50 Hz. Must divide CIC output rate.
+    static constexpr uint32_t TEMPERATURE_SAMPLE_FREQ_HZ = 25;
+
+    static constexpr uint32_t ADC_FIR_DECIMATION = ADC_SAMPLE_FREQ_HZ / ADC_CIC_DECIMATION / TEMPERATURE_SAMPLE_FREQ_HZ;
+    static_assert(ADC_FIR_DECIMATION * ADC_CIC_DECIMATION * TEMPERATURE_SAMPLE_FREQ_HZ == ADC_SAMPLE_FREQ_HZ,
+                  "Output rate must divide CIC output rate");
+    // FIR spans 4 output periods
+    using AdcFilter = DecimationFilter<ADC_CIC_DECIMATION, ADC_FIR_DECIMATION, ADC_FIR_DECIMATION * 4 + 1>;
+    // Sensor value delay (linear phase filter). ~81 ms at 25 Hz, ~41 ms at 50 Hz.
+    static constexpr uint32_t TEMPERATURE_GROUP_DELAY_US =
+        static_cast<uint32_t>(uint64_t{AdcFilter::GROUP_DELAY_X2} * 500'000 / ADC_SAMPLE_FREQ_HZ);
 
     static constexpr size_t ADC_INTERPOLATOR_LUT_SIZE_MAX = 100;
 
@@ -49,14 +64,40 @@ public:
     bool set_head_params(const HeadParams& params);
 
     auto get_head_status() const -> HeadStatus { return head_status.load(); }
-    int32_t get_temperature_x10();
+    int32_t get_temperature_x10() { return get_temperature_measurement().temperature_x10; }
+    // Temperature with the time it corresponds to. For RTD that's ADC capture
+    // time minus filter delay, for TCR - time of the Kalman filter estimate.
+    auto get_temperature_measurement() -> TemperatureProcessor::Measurement;
     bool is_tcr_sensor() const;
 
-    void update_sensor_uv();
     void configure_temperature_processor();
+    // Trace recording start: write current config without applying it, and
+    // ask tasks to record their filter states.
+    void record_sensor_config();
+    void request_trace_state() {
+        adc_trace_state_pending.store(true);
+        tcr_trace_state_pending.store(true);
+    }
+
+    // TCR temperature filter step. Should be called periodically from the
+    // control loop, before temperature is read.
+    void update_temperature_estimate(uint32_t now_ms);
+    // TCR estimate variance, °C² x100. 0 if unknown.
+    auto get_temperature_variance_x100() const -> uint32_t { return tcr_variance_x100.load(); }
+
+    auto get_sensor_uv() const -> uint32_t { return sensor_uv.get_last(); }
+    // Consistent sensor state: latest value, running sum and count, timestamp
+    // Producer (HeadAdc task) has higher priority than readers, sleep a tick
+    // to let it finish an update if it was preempted.
+    auto get_sensor_uv_snapshot() const -> SpscAccumulator::Snapshot {
+        return sensor_uv.snapshot([] { vTaskDelay(1); });
+    }
+
+    auto get_adc_interpolator() const -> const GridAdcInterpolator<ADC_INTERPOLATOR_LUT_SIZE_MAX>& {
+        return adc_interpolator;
+    }
 
     etl::atomic<HeadStatus> head_status{HeadStatus_HEAD_DISCONNECTED};
-    etl::atomic<uint32_t> last_sensor_value_uv{SENSOR_FLOATING_LEVEL_MV * 1000};
 
     EepromStore eeprom_store{};
     DataGuard<EEBuffer> head_params{};
@@ -72,19 +113,39 @@ private:
     };
 
     void adc_init();
+    void adc_task_loop();
     void build_adc_lut();
+    // LUT cache in NVS, building it takes 4K calibration calls
+    bool load_adc_lut();
+    void save_adc_lut();
+    void adc_lut_fingerprint(uint16_t* probes_mv);
     static bool IRAM_ATTR adc_conv_done_callback(adc_continuous_handle_t handle,
                                                 const adc_continuous_evt_data_t *edata,
                                                 void *user_data);
 
     adc_continuous_handle_t adc_handle{nullptr};
     adc_cali_handle_t adc_cali_handle{nullptr};
-    AdcInterpolator<ADC_INTERPOLATOR_LUT_SIZE_MAX> adc_interpolator;
-
-    // Temperature ring buffer for final smoothing (stores avg_x100)
-    etl::array<uint32_t, TEMPERATURE_RING_BUFFER_SIZE> temp_ring_buffer{};
-    uint8_t ring_buffer_idx{0};
-    etl::atomic<uint8_t> ring_buffer_count{0};
+    GridAdcInterpolator<ADC_INTERPOLATOR_LUT_SIZE_MAX> adc_interpolator;
+
+    // DMA frames are filtered in a separate task, ISR only wakes it up
+    TaskHandle_t adc_task_handle{nullptr};
+    AdcFilter adc_filter{};
+    // Written by ADC task only, read from anywhere without locks
+    SpscAccumulator sensor_uv{SENSOR_FLOATING_LEVEL_MV * 1000};
+    bool first_sensor_value_logged{false};
+    bool adc_filter_has_output{false};
+    etl::atomic<bool> adc_trace_state_pending{false};
+
+    // Owned by control loop task, results are published via atomics
+    TcrKalman tcr_kalman{};
+    uint32_t tcr_kalman_seq{0};
+    uint32_t tcr_kalman_ts_ms{0};
+    etl::atomic<bool> tcr_kalman_reload{true};
+    etl::atomic<bool> tcr_trace_state_pending{false};
+    // Written together, torn read can only skew age by one tick
+    etl::atomic<int32_t> tcr_temperature_x10{UNKNOWN_TEMPERATURE_X10};
+    etl::atomic<uint32_t> tcr_timestamp_ms{0};
+    etl::atomic<uint32_t> tcr_variance_x100{0};
 };
 
 extern Head head;
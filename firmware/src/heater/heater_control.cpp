@@ -2,8 +2,11 @@
 #include "components/fan.hpp"
 #include "components/led_colors.hpp"
 #include "components/pb2struct.hpp"
+#include "components/sample_recorder.hpp"
+#include "drain_tracker.hpp"
 #include "head.hpp"
 #include "heater_control.hpp"
+#include "logger.hpp"
 #include "power.hpp"
 
 void HeaterControl::setup() {
@@ -24,7 +27,11 @@ void HeaterControl::setup() {
 }
 
 void HeaterControl::tick() {
-    power.receive(MsgToPower_SysTick{});
+    power.sys_tick();
+    const uint32_t now = Time::now();
+    head.update_temperature_estimate(now);
+    update_temperature_rate();
+    update_supervisor(now);
     update_fan_speed();
     update_temperature_indicator();
 
@@ -45,6 +52,12 @@ auto HeaterControl::task_start(int32_t task_id, HeaterTaskIteratorFn task_iterat
     if (get_health_status() != DeviceHealthStatus_DEV_OK) { return false; }
     if (!HeaterControlBase::task_start(task_id, task_iterator)) { return false; }
     power.minimize_idle_heating(false);
+    fault.store(HeaterFault_FAULT_NONE);
+    supervisor_model_checks.store(task_id != HISTORY_ID_STEP_RESPONSE &&
+                                  task_id != HISTORY_ID_RELAY_TUNE &&
+                                  task_id != HISTORY_ID_SENSOR_BAKE_MODE &&
+                                  task_id != HISTORY_ID_TCR_CALIBRATION);
+    supervisor_restart.store(true);
     return true;
 }
 
@@ -53,6 +66,24 @@ void HeaterControl::task_stop() {
     power.minimize_idle_heating(true);
 }
 
+void HeaterControl::on_control_tick(uint32_t dt_ms, float temperature, uint32_t temperature_age_ms,
+                                    float setpoint, float setpoint_rate, float max_power, float power)
+{
+    sample_recorder.control_tick({
+        .dt_ms = dt_ms,
+        .temperature_x10 = static_cast<int32_t>(lroundf(temperature * 10.0f)),
+        .setpoint = setpoint,
+        .setpoint_rate = setpoint_rate,
+        .power_max = max_power,
+        .power_out = power,
+        .temperature_age_ms = temperature_age_ms
+    });
+}
+
+void HeaterControl::on_control_reset() {
+    sample_recorder.control_reset();
+}
+
 bool HeaterControl::get_head_params_pb(etl::ivector<uint8_t>& pb_data) {
     return head.get_head_params_pb(pb_data);
 }
@@ -81,13 +112,16 @@ bool HeaterControl::set_calibration_point_0(float temperature) {
 
     if (!head.is_tcr_sensor()) {
         // RTD mode: use ADC voltage
-        params.sensor_p0_value = head.last_sensor_value_uv.load();
+        params.sensor_p0_value = head.get_sensor_uv();
     } else {
         // PCB mode: use heater resistance
         params.sensor_p0_value = power.get_load_mohm();
     }
 
     params.sensor_p0_at = temperature;
+    // Multi-point TCR table overrides p0/p1, manual point replaces it
+    params.sensor_tcr_at_count = 0;
+    params.sensor_tcr_value_count = 0;
     return set_head_params(params);
 }
 
@@ -97,13 +131,38 @@ bool HeaterControl::set_calibration_point_1(float temperature) {
 
     if (!head.is_tcr_sensor()) {
         // RTD mode: use ADC voltage
-        params.sensor_p1_value = head.last_sensor_value_uv.load();
+        params.sensor_p1_value = head.get_sensor_uv();
     } else {
         // PCB mode: use heater resistance
         params.sensor_p1_value = power.get_load_mohm();
     }
 
     params.sensor_p1_at = temperature;
+    // Same as point 0
+    params.sensor_tcr_at_count = 0;
+    params.sensor_tcr_value_count = 0;
+    return set_head_params(params);
+}
+
+// Stores multi-point TCR model. Edge points also go to p0/p1, as fallback
+// for 2-point consumers.
+bool HeaterControl::set_tcr_calibration(const etl::ivector<TcrCalibration::Point>& points) {
+    if (points.size() < 2 || points.size() > TcrCalibration::MAX_POINTS) { return false; }
+
+    HeadParams params = HeadParams_init_zero;
+    if (!get_head_params(params)) { return false; }
+
+    params.sensor_tcr_at_count = 0;
+    params.sensor_tcr_value_count = 0;
+    for (const auto& p : points) {
+        params.sensor_tcr_at[params.sensor_tcr_at_count++] = p.at;
+        params.sensor_tcr_value[params.sensor_tcr_value_count++] = p.value;
+    }
+
+    params.sensor_p0_at = points.front().at;
+    params.sensor_p0_value = points.front().value;
+    params.sensor_p1_at = points.back().at;
+    params.sensor_p1_value = points.back().value;
     return set_head_params(params);
 }
 
@@ -139,6 +198,86 @@ auto HeaterControl::get_temperature() -> float {
     return head.get_temperature_x10() * 0.1f;
 }
 
+auto HeaterControl::get_temperature_variance() -> float {
+    return head.get_temperature_variance_x100() * 0.01f;
+}
+
+auto HeaterControl::get_temperature_age_ms() -> uint32_t {
+    const auto age = static_cast<int32_t>(Time::now() - head.get_temperature_measurement().timestamp_ms);
+    return age > 0 ? static_cast<uint32_t>(age) : 0;
+}
+
+auto HeaterControl::get_temperature_rate() -> float {
+    return temperature_rate_x100.load() * 0.01f;
+}
+
+auto HeaterControl::get_temperature_residual() -> float {
+    return temperature_residual_x10.load() * 0.1f;
+}
+
+void HeaterControl::update_temperature_rate() {
+    // Fit by measurement time, not by tick time. RTD values come at own rate,
+    // and repeated reads of the same value are skipped by estimator.
+    const auto m = head.get_temperature_measurement();
+    if (m.temperature_x10 == head.UNKNOWN_TEMPERATURE_X10) {
+        rate_estimator.reset();
+    } else {
+        rate_estimator.push(m.timestamp_ms, m.temperature_x10);
+    }
+    temperature_rate_x100.store(rate_estimator.get_rate_x100());
+    temperature_residual_x10.store(rate_estimator.get_residual_x10());
+}
+
+// Library enum mirrors protocol one
+static_assert(static_cast<int>(ThermalSupervisor::Fault::OpenHeater) == HeaterFault_FAULT_OPEN_HEATER &&
+              static_cast<int>(ThermalSupervisor::Fault::ResistanceJump) == HeaterFault_FAULT_RESISTANCE_JUMP &&
+              static_cast<int>(ThermalSupervisor::Fault::StuckReading) == HeaterFault_FAULT_STUCK_READING &&
+              static_cast<int>(ThermalSupervisor::Fault::NoHeating) == HeaterFault_FAULT_NO_HEATING &&
+              static_cast<int>(ThermalSupervisor::Fault::HeatingWithoutPower) == HeaterFault_FAULT_HEATING_WITHOUT_POWER,
+              "ThermalSupervisor::Fault doesn't match HeaterFault");
+
+void HeaterControl::update_supervisor(uint32_t now_ms) {
+    const uint32_t dt_ms = now_ms - supervisor_ts_ms;
+    supervisor_ts_ms = now_ms;
+
+    if (supervisor_restart.exchange(false)) {
+        HeadParams p = HeadParams_init_zero;
+        // Identification tasks drive the heater outside of the model, it may
+        // be not known yet. Keep sensor checks only.
+        if (supervisor_model_checks.load() && get_head_params(p)) {
+            supervisor.set_params(p.adrc_b0, p.adrc_response);
+        } else {
+            supervisor.set_params(0, 0);
+        }
+        supervisor.reset();
+    }
+
+    // Check only while a task drives the heater. Fault is latched, report once.
+    // Head/power failures are handled by health status.
+    if (!is_task_active.load() || supervisor.get_fault() != ThermalSupervisor::Fault::None) { return; }
+    if (get_health_status() != DeviceHealthStatus_DEV_OK) { return; }
+
+    const auto info = drain_tracker.get_info();
+    const auto m = head.get_temperature_measurement();
+
+    const auto f = supervisor.update({
+        .now_ms = now_ms,
+        .dt_ms = dt_ms,
+        .temperature_x10 = m.temperature_x10,
+        .temperature_ts_ms = m.timestamp_ms,
+        // Same as TCR filter input
+        .power_mw = power.get_average_power_mw(info),
+        .resistance_mohm = info.load_valid ? info.peak_mv * 1000 / info.peak_ma : 0
+    });
+    if (f == ThermalSupervisor::Fault::None) { return; }
+
+    APP_LOGE("Heater fault: {}, stopping task", ThermalSupervisor::get_fault_name(f));
+    fault.store(static_cast<uint8_t>(f));
+    // Don't wait for the app to process stop, ADRC would drive power again
+    temperature_control_off();
+    application.enqueue_message(AppCmd::Stop{});
+}
+
 auto HeaterControl::get_volts() -> float {
     return power.get_peak_mv() * 0.001f;
 }
@@ -171,56 +310,25 @@ auto HeaterControl::get_max_power() -> float {
 }
 
 void HeaterControl::update_fan_speed() {
-    constexpr int32_t C_DIFF_ON_X10 = 4 * 10;
-    constexpr int32_t C_DIFF_OFF_X10 = 3 * 10;
-    constexpr int32_t C_EDGE_ON_X10 = 40 * 10;
-
-    int32_t temperature_x10 = head.get_temperature_x10();
-    int32_t setpoint_x10 = lround(temperature_setpoint.load() * 10.0f);
-    bool working = is_task_active.load();
+    const int32_t temperature_x10 = head.get_temperature_x10();
 
-    if (working) {
+    const auto action = FanPolicy::decide({
+        .task_active = is_task_active.load(),
         // The setpoint is valid only when a task is active and temperature
         // control is enabled.
-        if (temperature_control_enabled.load()) {
-            //
-            // We need to solve two problems:
-            // - Cool down reasonably fast
-            // - Avoid interference with ADRC control.
-            //
-            // Use simple logic with a safe threshold and small hysteresis:
-            // - If temperature > 4C above desired => full speed
-            // - If temperature < 3C above desired => off
-            //
-            // This is simple and should be okay. If needed, it can be improved later.
-            //
-            if (temperature_x10 > setpoint_x10 + C_DIFF_ON_X10) {
-                // Enable fan ONLY when ADRC output is about zero,
-                // to avoid interference.
-                if (power.get_target_power_mw() < 1*1000) {
-                    fan.max();
-                }
-            }
-            if (temperature_x10 < setpoint_x10 + C_DIFF_OFF_X10) { fan.off(); }
-        } else {
-            // If a task is running but temperature control is disabled, turn
-            // the fan off. This is a valid scenario for calibration-related tasks.
-            fan.off();
-        }
-    } else {
-        // No task: always cool down to a low temperature if the head is attached.
-        if (head.get_head_status() == HeadStatus_HEAD_CONNECTED &&
-            temperature_x10 != head.UNKNOWN_TEMPERATURE_X10)
-        {
-            if (temperature_x10 > C_EDGE_ON_X10) { fan.max(); }
-            else { fan.off(); }
-        }
-        else {
-            // Turn the fan off when no head is attached, or in TCR mode without power
-            // (with "unknown" temperature, powered via debug connector)
-            fan.off();
-        }
-    }
+        .temperature_control = temperature_control_enabled.load(),
+        .forced_cooling = forced_cooling.load(),
+        .head_connected = head.get_head_status() == HeadStatus_HEAD_CONNECTED,
+        // "Unknown" in TCR mode without power (powered via debug connector)
+        .temperature_known = temperature_x10 != head.UNKNOWN_TEMPERATURE_X10,
+        .temperature_x10 = temperature_x10,
+        .setpoint_x10 = static_cast<int32_t>(lroundf(temperature_setpoint.load() * 10.0f)),
+        .rate_x100 = temperature_rate_x100.load(),
+        .target_power_mw = power.get_target_power_mw()
+    });
+
+    if (action == FanPolicy::Action::On) { fan.max(); }
+    else if (action == FanPolicy::Action::Off) { fan.off(); }
 }
 
 void HeaterControl::update_temperature_indicator() {
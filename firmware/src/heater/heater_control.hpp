@@ -5,6 +5,10 @@
 #include "app.hpp"
 #include "components/time.hpp"
 #include "heater_control_base.hpp"
+#include "lib/fan_policy.hpp"
+#include "lib/rate_estimator.hpp"
+#include "lib/tcr_calibration.hpp"
+#include "lib/thermal_supervisor.hpp"
 #include "power.hpp"
 
 class HeaterControl: public HeaterControlBase {
@@ -14,7 +18,7 @@ public:
     uint32_t get_time_ms() const override { return Time::now(); }
 
     void set_power(float power_w) override;
-    auto task_start(int32_t task_id, HeaterTaskIteratorFn task_iterator = nullptr) -> bool;
+    auto task_start(int32_t task_id, HeaterTaskIteratorFn task_iterator = HeaterTaskIteratorFn{}) -> bool;
     void task_stop();
 
     bool get_head_params_pb(etl::ivector<uint8_t>& pb_data) override;
@@ -23,6 +27,7 @@ public:
     bool set_head_params(const HeadParams& params) override;
     bool set_calibration_point_0(float temperature) override;
     bool set_calibration_point_1(float temperature) override;
+    bool set_tcr_calibration(const etl::ivector<TcrCalibration::Point>& points);
 
     auto get_health_status() -> DeviceHealthStatus override;
     auto get_activity_status() -> DeviceActivityStatus override;
@@ -30,6 +35,16 @@ public:
     auto get_head_status() -> HeadStatus override;
 
     auto get_temperature() -> float override;
+    auto get_temperature_variance() -> float override;
+    auto get_temperature_age_ms() -> uint32_t override;
+    auto get_temperature_rate() -> float override;
+    auto get_temperature_residual() -> float override;
+    auto get_temperature_rate_x100() const -> int32_t { return temperature_rate_x100.load(); }
+    // Fault, that stopped the last task. Cleared on task start.
+    auto get_fault() const -> HeaterFault { return static_cast<HeaterFault>(fault.load()); }
+    // Keep fan at max while no task runs, whatever the temperature. Owner
+    // must release it.
+    void set_forced_cooling(bool on) { forced_cooling.store(on); }
     auto get_resistance() -> float override;
     auto get_max_power() -> float override;
     auto get_power() -> float override;
@@ -37,7 +52,31 @@ public:
     auto get_amperes() -> float override;
     auto get_duty_cycle() -> float override;
 
+protected:
+    void on_control_tick(uint32_t dt_ms, float temperature, uint32_t temperature_age_ms, float setpoint,
+                         float setpoint_rate, float max_power, float power) override;
+    void on_control_reset() override;
+
 private:
+    // ~1.6 s at control loop rate, ~0.2 °C/s noise with TCR sensor
+    static constexpr size_t RATE_WINDOW = 32;
+
+    RateEstimator<RATE_WINDOW> rate_estimator{};
+    etl::atomic<int32_t> temperature_rate_x100{0};
+    etl::atomic<int32_t> temperature_residual_x10{0};
+
+    // Runs in heater task. Restart (with params reload) is requested from
+    // task_start() via flag.
+    ThermalSupervisor supervisor{};
+    uint32_t supervisor_ts_ms{0};
+    etl::atomic<bool> supervisor_restart{false};
+    etl::atomic<bool> supervisor_model_checks{true};
+    etl::atomic<uint8_t> fault{HeaterFault_FAULT_NONE};
+
+    etl::atomic<bool> forced_cooling{false};
+
+    void update_temperature_rate();
+    void update_supervisor(uint32_t now_ms);
     void update_fan_speed();
     void update_temperature_indicator();
 };
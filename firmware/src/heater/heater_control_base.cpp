@@ -47,7 +47,9 @@ void HeaterControlBase::get_history(int32_t client_history_version, float from,
     for (size_t i = 0; i < chunk_length; ++i) {
         history_chunk.data[i].x = static_cast<float>(data[from_idx + i].x);
         history_chunk.data[i].y = static_cast<float>(data[from_idx + i].y) * history_y_multiplier_inv;
+        history_chunk.rate_x100[i] = history.get_rate(from_idx + i);
     }
+    history_chunk.rate_x100_count = chunk_length;
 
     struct2pb(history_chunk, pb_data, HistoryChunk_fields);
     history.unlock();
@@ -65,6 +67,7 @@ void HeaterControlBase::temperature_control_on() {
     load_all_params();
 
     adrc.reset_to(get_temperature());
+    on_control_reset();
     temperature_control_enabled = true;
 }
 
@@ -77,20 +80,29 @@ void HeaterControlBase::tick() {
     uint32_t now = get_time_ms();
     uint32_t dt_ms = now - prev_tick_ms;
 
+    xSemaphoreTakeRecursive(task_mutex, portMAX_DELAY);
+
     // If the temperature controller is active, use it to update power.
     if (is_task_active.load()) {
         if (temperature_control_enabled) {
             static constexpr float dt_inv_multiplier = 1.0F / 1000;
             const float dt = static_cast<float>(dt_ms) * dt_inv_multiplier;
 
-            const float power = adrc.iterate(
-                get_temperature(),
-                temperature_setpoint,
-                get_max_power(),
-                dt,
-                temperature_setpoint_rate
-            );
+            const float temperature = get_temperature();
+            const uint32_t age_ms = etl::min(get_temperature_age_ms(), MAX_COMPENSATED_AGE_MS);
+            const float age = static_cast<float>(age_ms) * dt_inv_multiplier;
+            const float setpoint = temperature_setpoint;
+            const float setpoint_rate = temperature_setpoint_rate;
+            const float max_power = get_max_power();
+
+            const float power = adrc.iterate(temperature, setpoint, max_power, dt, setpoint_rate, age);
             set_power(power);
+            control_input_age_ms.store(age_ms);
+            on_control_tick(dt_ms, temperature, age_ms, setpoint, setpoint_rate, max_power, power);
+
+            xSemaphoreTake(reflow_metrics_mutex, portMAX_DELAY);
+            if (reflow_metrics_active) { reflow_metrics.push(dt_ms, temperature, setpoint); }
+            xSemaphoreGive(reflow_metrics_mutex);
         }
 
         // Write history every second
@@ -98,16 +110,18 @@ void HeaterControlBase::tick() {
 
         const uint32_t seconds = task_time_ms / 1000;
         if (seconds > history_last_recorded_ts) {
-            if (!history.add(seconds, lround(get_temperature() * history_y_multiplier))) {
+            if (!history.add(seconds, lround(get_temperature() * history_y_multiplier),
+                             lround(get_temperature_rate() * history_rate_multiplier))) {
                 APP_LOGE("History overflow: max {} points", History::MAX_POINTS);
             }
             history_last_recorded_ts = seconds;
         }
 
         // A task can have a custom iterator; execute it if needed.
-        if (task_iterator) task_iterator(task_time_ms);
+        if (task_iterator.is_valid()) task_iterator(static_cast<int32_t>(task_time_ms));
     }
 
+    xSemaphoreGiveRecursive(task_mutex);
     prev_tick_ms = now;
 }
 
@@ -116,6 +130,8 @@ auto HeaterControlBase::task_start(int32_t task_id, HeaterTaskIteratorFn ticker)
     if (get_head_status() != HeadStatus_HEAD_CONNECTED) { return false; }
     if (!load_all_params()) { return false; }
 
+    xSemaphoreTakeRecursive(task_mutex, portMAX_DELAY);
+
     history.data.clear();
     history.set_params(2, history_y_multiplier * 1, 400);
     task_start_ts = get_time_ms();
@@ -128,12 +144,46 @@ auto HeaterControlBase::task_start(int32_t task_id, HeaterTaskIteratorFn ticker)
 
     task_iterator = ticker;
     is_task_active.store(true);
+
+    xSemaphoreGiveRecursive(task_mutex);
     return true;
 }
 
 void HeaterControlBase::task_stop() {
+    xSemaphoreTakeRecursive(task_mutex, portMAX_DELAY);
     is_task_active.store(false);
-    task_iterator = nullptr;
+    task_iterator = HeaterTaskIteratorFn{};
+    xSemaphoreGiveRecursive(task_mutex);
+
     temperature_control_off();
     set_power(0);
 };
+
+void HeaterControlBase::reflow_metrics_start(const ReflowMetrics::Config& cfg) {
+    xSemaphoreTake(reflow_metrics_mutex, portMAX_DELAY);
+    reflow_metrics.start(cfg);
+    reflow_metrics_active = true;
+    reflow_metrics_completed = false;
+    reflow_metrics_valid = true;
+    xSemaphoreGive(reflow_metrics_mutex);
+}
+
+auto HeaterControlBase::reflow_metrics_stop(bool completed) -> ReflowMetrics::Result {
+    xSemaphoreTake(reflow_metrics_mutex, portMAX_DELAY);
+    if (reflow_metrics_active) {
+        reflow_metrics_active = false;
+        reflow_metrics_completed = completed;
+    }
+    auto result = reflow_metrics.get_result(reflow_metrics_completed);
+    xSemaphoreGive(reflow_metrics_mutex);
+    return result;
+}
+
+auto HeaterControlBase::get_reflow_metrics(ReflowMetrics::Result& result) -> bool {
+    xSemaphoreTake(reflow_metrics_mutex, portMAX_DELAY);
+    // While running, verdict is preliminary
+    result = reflow_metrics.get_result(reflow_metrics_completed);
+    const bool valid = reflow_metrics_valid;
+    xSemaphoreGive(reflow_metrics_mutex);
+    return valid;
+}
@@ -2,14 +2,17 @@
 
 #include <etl/vector.h>
 #include <etl/atomic.h>
-#include <functional>
+#include <etl/delegate.h>
 #include "components/prefs.hpp"
 #include "components/history.hpp"
 #include "lib/adrc.hpp"
+#include "lib/reflow_metrics.hpp"
 #include "proto/generated/types.pb.h"
 #include "proto/generated/shared_constants.hpp"
 
-using HeaterTaskIteratorFn = std::function<void(uint32_t)>;
+// Bind to state's member function, `create<T, &T::method>(obj)`. Holds just
+// object pointer + stub, no heap allocations.
+using HeaterTaskIteratorFn = etl::delegate<void(int32_t)>;
 
 class HeaterControlBase {
 public:
@@ -31,6 +34,17 @@ public:
     virtual auto get_head_status() -> HeadStatus = 0;
 
     virtual auto get_temperature() -> float = 0;
+    // Temperature estimate variance, °C² (0 if not available)
+    virtual auto get_temperature_variance() -> float = 0;
+    // How old value returned by get_temperature() is
+    virtual auto get_temperature_age_ms() -> uint32_t = 0;
+    // Temperature rate of change, °C/s (0 until enough samples)
+    virtual auto get_temperature_rate() -> float = 0;
+    // Deviation of the last temperature sample from the recent trend, °C.
+    // Big values mean sensor glitch, real temperature can't jump.
+    virtual auto get_temperature_residual() -> float = 0;
+    // Residual limit, for glitch checks in tasks
+    static constexpr float MAX_TEMPERATURE_RESIDUAL = 5.0f;
     virtual auto get_resistance() -> float = 0;
     virtual auto get_max_power() -> float = 0;
     virtual auto get_power() -> float = 0;
@@ -51,25 +65,57 @@ public:
 
     // "task" machinery, by default record history.
 
-    auto task_start(int32_t task_id, HeaterTaskIteratorFn task_iterator = nullptr) -> bool;
+    auto task_start(int32_t task_id, HeaterTaskIteratorFn task_iterator = HeaterTaskIteratorFn{}) -> bool;
     void task_stop();
 
+    // Reflow quality metrics, accumulated from control loop between start
+    // and stop. Stop is no-op if not started.
+    void reflow_metrics_start(const ReflowMetrics::Config& cfg);
+    auto reflow_metrics_stop(bool completed) -> ReflowMetrics::Result;
+    // Current (or last) run metrics. False if nothing measured yet.
+    auto get_reflow_metrics(ReflowMetrics::Result& result) -> bool;
+
+    // Temperature age at the last controller iteration (compensated by ADRC)
+    auto get_control_input_age_ms() const -> uint32_t { return control_input_age_ms.load(); }
+
 protected:
+    // Hooks to observe controller inputs/outputs (for trace recording).
+    virtual void on_control_tick(uint32_t /*dt_ms*/, float /*temperature*/, uint32_t /*temperature_age_ms*/,
+                                 float /*setpoint*/, float /*setpoint_rate*/, float /*max_power*/,
+                                 float /*power*/) {}
+    virtual void on_control_reset() {}
+
     ADRC adrc{};
     etl::atomic<bool> temperature_control_enabled{false};
     etl::atomic<float> temperature_setpoint{0};
     etl::atomic<float> temperature_setpoint_rate{0};
     etl::atomic<bool> is_task_active{false};
     int32_t prev_tick_ms{0};
+    etl::atomic<uint32_t> control_input_age_ms{0};
 
 private:
-    HeaterTaskIteratorFn task_iterator{nullptr};
+    // Older values are not extrapolated further (stale sensor, not latency)
+    static constexpr uint32_t MAX_COMPENSATED_AGE_MS = 500;
+
+    HeaterTaskIteratorFn task_iterator{};
     int32_t task_start_ts{0};
+    // Held by tick() over the task part. task_stop() returns only when the
+    // iterator is not running, so states can free its data right after.
+    // Recursive, iterator may stop the task itself.
+    SemaphoreHandle_t task_mutex{xSemaphoreCreateRecursiveMutex()};
     History history{};
     HistoryChunk history_chunk{};
     int32_t history_version{0};
     int32_t history_task_id{0};
     int32_t history_last_recorded_ts{0}; // in seconds
+    ReflowMetrics reflow_metrics{};
+    bool reflow_metrics_active{false};
+    bool reflow_metrics_completed{false};
+    bool reflow_metrics_valid{false};
+    SemaphoreHandle_t reflow_metrics_mutex{xSemaphoreCreateMutex()};
+
     static constexpr int32_t history_y_multiplier = 100;
     static constexpr float history_y_multiplier_inv = 1.0F / history_y_multiplier;
+    // Same as HistoryChunk.rate_x100
+    static constexpr int32_t history_rate_multiplier = 100;
 };
@@ -1,19 +1,17 @@
 #pragma once
 
 #include <etl/atomic.h>
-#include <etl/fsm.h>
 #include <etl/limits.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 #include <pd/pd.h>
 
+#include "drain_tracker.hpp"
+#include "lib/power_fsm.hpp"
 #include "profile_selector.hpp"
 #include "proto/generated/types.pb.h"
 #include "pwm.hpp"
 
-// Extra custom events
-DEFINE_SIMPLE_MSG(MsgToPower_SysTick, 200);
-
 using DPM_EventListener_Base = etl::message_router<class DPM_EventListener,
     pd::MsgToDpm_Startup,
     pd::MsgToDpm_TransitToDefault,
@@ -47,57 +45,53 @@ private:
     Power& power;
 };
 
-class Power: public etl::fsm {
+class Power: public PowerFsm::Io {
 public:
     static constexpr uint32_t UNKNOWN_RESISTANCE = etl::numeric_limits<uint32_t>::max();
 
     Power();
     void setup();
-    void log_state();
-    void log_unknown_event(const etl::imessage& msg);
     void log_pdos();
 
-    void receive(const etl::imessage& message) {
+    // Heater control tick
+    void sys_tick() {
         lock();
-        etl::fsm::receive(message);
-        unlock();
-    }
-    void transition_to(etl::fsm_state_id_t state) {
-        lock();
-        etl::fsm::transition_to(state);
+        fsm.on_sys_tick();
         unlock();
     }
 
-    void set_power_mw(uint32_t mw) { target_power_mw = mw; }
-    uint32_t get_target_power_mw() const { return target_power_mw; }
+    void set_power_mw(uint32_t mw) { fsm.target_power_mw = mw; }
+    uint32_t get_target_power_mw() const { return fsm.target_power_mw; }
     void minimize_idle_heating(bool enable);
 
     uint32_t get_peak_mv();
     uint32_t get_peak_ma();
     uint32_t get_duty_x1000();
     uint32_t get_load_mohm();
+    // Average over PWM period, for a drain info snapshot the caller holds
+    uint32_t get_average_power_mw(const DrainTracker::DRAIN_INFO& info);
     uint32_t get_max_power_mw();
     PowerStatus get_power_status() { return power_status; }
     void set_power_status(PowerStatus status) { power_status = status; }
 
     DPM_EventListener dpm_event_listener{*this};
-    pd::PDO_LIST source_caps{};
-    bool is_apdo_updating{false};
-    bool is_from_caps_update{false};
-    uint32_t prev_apdo_mv{0};
-    uint32_t next_apdo_mv{0};
-
-    // Power management state
-    etl::atomic<uint32_t> target_power_mw{0};
-    ProfileSelector::POWER_PLAN current_plan{};
-    ProfileSelector::POWER_PLAN next_plan{};
-    ProfileSelector::FEEDBACK_PARAMS last_feedback{};
+    PowerFsm fsm{profile_selector, *this};
 
     Pwm pwm{};
 
     void lock() { xSemaphoreTake(_lock, portMAX_DELAY); }
     void unlock() { xSemaphoreGive(_lock); }
 
+    // PowerFsm::Io
+    void trigger_by_position(uint32_t position, uint32_t mv) override;
+    void clear_trigger_to(uint32_t position, uint32_t mv) override;
+    auto is_handshake_reported() -> bool override;
+    auto get_drain_info() -> PowerFsm::DrainInfo override;
+    void drain_reset() override;
+    void pwm_enable(bool enable) override;
+    void pwm_set(PwmScheduler::Modulation modulation, uint32_t duty_x1000) override;
+    void on_state(PowerFsm::State state) override;
+
 private:
     etl::atomic<PowerStatus> power_status{PowerStatus_PWR_OFF};
     SemaphoreHandle_t _lock{xSemaphoreCreateMutex()};
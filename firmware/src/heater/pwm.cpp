@@ -1,127 +1,12 @@
 #include <etl/algorithm.h>
 
+#include "components/sample_recorder.hpp"
 #include "drain_tracker.hpp"
 #include "profile_selector.hpp"
 #include "pwm.hpp"
 
 extern ProfileSelector profile_selector;
 
-namespace PwmState {
-    enum {
-        Disabled,
-        Pulse,
-        Gap
-    };
-}
-
-class PwmDisabled_state : public afsm::state<Pwm, PwmDisabled_state, PwmState::Disabled> {
-public:
-    static auto on_enter_state(Pwm& pwm) -> afsm::state_id_t {
-        pwm.load_on(false);
-        pwm.duty_error = 0;
-
-        pwm._enabled.store(false);
-        return No_State_Change;
-    }
-
-    static auto on_run_state(Pwm& pwm) -> afsm::state_id_t {
-        if (pwm._enabled.load()) { return PwmState::Pulse; }
-        return No_State_Change;
-    }
-    static void on_exit_state(Pwm&) {}
-};
-
-class PwmPulse_state : public afsm::state<Pwm, PwmPulse_state, PwmState::Pulse> {
-public:
-    static auto on_enter_state(Pwm& pwm) -> afsm::state_id_t {
-        auto duty_x1000 = pwm.get_duty_x1000();
-
-        if (duty_x1000 == 0 && pwm._reduce_idle_rate.load()) {
-            pwm.pulse_ticks = Pwm::PWM_MIN_PULSE_TICKS;
-            pwm.gap_ticks = Pwm::PWM_IDLE_PERIOD_TICKS;
-            pwm.duty_error = 0; // reset carry when idle pulsing
-        } else {
-            const uint32_t desired = duty_x1000 * Pwm::PWM_PERIOD_TICKS;
-            // Round-to-nearest with error feedback (signed error in 1/1000-tick)
-            int32_t tmp = static_cast<int32_t>(desired) + pwm.duty_error + 500;
-            uint32_t pulse_ticks = static_cast<uint32_t>(tmp / 1000);
-
-            // Clamp pulse to valid range (min pulse .. full period)
-            pwm.pulse_ticks = etl::clamp(pulse_ticks, Pwm::PWM_MIN_PULSE_TICKS, Pwm::PWM_PERIOD_TICKS);
-            pwm.gap_ticks = Pwm::PWM_PERIOD_TICKS - pwm.pulse_ticks;
-
-            // Update signed error (deviation) after clamping to reflect actual pulse length
-            // Restrict error range to avoid overflow due to pulse clamping
-            pwm.duty_error = etl::clamp(
-                static_cast<int32_t>(desired) + pwm.duty_error - static_cast<int32_t>(pwm.pulse_ticks) * 1000,
-                static_cast<int32_t>(-500),
-                static_cast<int32_t>(499)
-            );
-        }
-
-        pwm.tick_count = 0;
-        drain_tracker.clear_collected_data();
-        pwm.load_on(true);
-        return No_State_Change;
-    }
-
-    static auto on_run_state(Pwm& pwm) -> afsm::state_id_t {
-        pwm.tick_count++;
-
-        if (pwm.tick_count >= Pwm::POWER_STABILIZATION_TICKS) {
-            // DrainTracker polls INAxxx current monitor once per tick after stabilization.
-            // Capture profile index at measurement time for eventual consistency.
-            drain_tracker.collect_data(profile_selector.current_index);
-        }
-
-        if (pwm.tick_count >= pwm.pulse_ticks) { return PwmState::Gap; }
-        return No_State_Change;
-    }
-
-    static void on_exit_state(Pwm& pwm) {
-        if (pwm.tick_count >= pwm.pulse_ticks) {
-            // The end was reached naturally, so process ADC data averaged over
-            // the pulse tail. Otherwise, we are being disabled, so skip this step.
-            drain_tracker.process_collected_data();
-        }
-    }
-};
-
-class PwmGap_state : public afsm::state<Pwm, PwmGap_state, PwmState::Gap> {
-public:
-    static auto on_enter_state(Pwm& pwm) -> afsm::state_id_t {
-        // If no gap, go back to pulse immediately
-        if (pwm.gap_ticks == 0) { return PwmState::Pulse; }
-
-        pwm.tick_count = 0;
-        pwm.load_on(false);
-        return No_State_Change;
-    }
-
-    static auto on_run_state(Pwm& pwm) -> afsm::state_id_t {
-        if (++pwm.tick_count >= pwm.gap_ticks) { return PwmState::Pulse; }
-        return No_State_Change;
-    }
-
-    static void on_exit_state(Pwm&) {}
-};
-
-using PWM_STATES = afsm::state_pack<
-    PwmDisabled_state,
-    PwmPulse_state,
-    PwmGap_state
->;
-
-// (no static state – all timing stored in Pwm instance)
-
-Pwm::Pwm() {
-    set_states<PWM_STATES>(afsm::Uninitialized);
-}
-
-void Pwm::task_loop() {
-    run();
-}
-
 void Pwm::setup() {
     // Configure switch pin.
     gpio_config_t io_conf = {
@@ -133,21 +18,32 @@ void Pwm::setup() {
         .intr_type = GPIO_INTR_DISABLE
     };
     gpio_config(&io_conf);
+    load_on(false);
 
     drain_tracker.setup();
-    change_state(PwmState::Disabled);
+    sample_recorder.pwm_edge(SampleTrace::PwmEvent::Off);
 
     xTaskCreate(
-        // Set high priority
-        // TODO: Ensure it's okay with the NimBLE stack.
+        // Set high priority, INA reads must finish before the pulse ends.
+        // Still below NimBLE host (21) and BT controller (23) tasks, so radio
+        // timing is not affected. If BLE delays wakeup past the pulse end,
+        // the sample is skipped (see task_loop).
         [](void* params) {
             auto* self = static_cast<Pwm*>(params);
-            while (true) {
-                self->task_loop();
-                vTaskDelay(1);
-            }
-        }, "Pwm", 1024*4, this, 15, nullptr
+            while (true) { self->task_loop(); }
+        }, "Pwm", 1024*4, this, 15, &task_handle
     );
+
+    gptimer_config_t timer_config{};
+    timer_config.clk_src = GPTIMER_CLK_SRC_DEFAULT;
+    timer_config.direction = GPTIMER_COUNT_UP;
+    timer_config.resolution_hz = TIMER_RESOLUTION_HZ;
+    ESP_ERROR_CHECK(gptimer_new_timer(&timer_config, &timer));
+
+    gptimer_event_callbacks_t cbs{};
+    cbs.on_alarm = timer_alarm_callback;
+    ESP_ERROR_CHECK(gptimer_register_event_callbacks(timer, &cbs, this));
+    ESP_ERROR_CHECK(gptimer_enable(timer));
 }
 
 void Pwm::set_duty_x1000(uint32_t duty_0_1000) {
@@ -159,19 +55,115 @@ uint32_t Pwm::get_duty_x1000() const {
 }
 
 void Pwm::enable(bool enable) {
-    if (enable) {
-        // Only set flag, to work in sync with ticks
+    xSemaphoreTake(lock, portMAX_DELAY);
+
+    if (enable && !_enabled.load()) {
         _enabled.store(true);
-    } else {
+
+        // First period starts right now, then timer takes over
+        scheduler.reset();
+        pending = { PwmScheduler::Event::PeriodStart, 0, false };
+        alarm_at = 0;
+        gptimer_set_raw_count(timer, 0);
+        const uint32_t events = advance();
+        gptimer_start(timer);
+        xTaskNotify(task_handle, events, eSetBits);
+    } else if (!enable && _enabled.load()) {
         // Disable immediately
-        change_state(PwmState::Disabled);
+        gptimer_stop(timer);
+        load_on(false);
+        _enabled.store(false);
+
+        // Drop events not processed yet
+        xTaskNotifyStateClear(task_handle);
+        ulTaskNotifyValueClear(task_handle, UINT32_MAX);
+        sample_recorder.pwm_edge(SampleTrace::PwmEvent::Off);
     }
+
+    xSemaphoreGive(lock);
 }
 
 void Pwm::reduce_idle_rate(bool reduce) {
     _reduce_idle_rate.store(reduce);
 }
 
-void Pwm::load_on(bool on) {
+void Pwm::set_modulation(PwmScheduler::Modulation modulation) {
+    _modulation.store(modulation);
+}
+
+void IRAM_ATTR Pwm::load_on(bool on) {
     gpio_set_level(load_switch_pin, on ? 1 : 0);
 }
+
+// Applies steps due now and arms the alarm for the next one. Runs in timer
+// ISR, or with timer stopped. Returns events for the task.
+//
+// ISR stays active during flash writes, so everything here is in IRAM:
+// scheduler methods, and GPIO/GPTimer control via sdkconfig. No switch, its
+// lookup table would go to flash.
+uint32_t IRAM_ATTR Pwm::advance() {
+    using Event = PwmScheduler::Event;
+    static_assert(static_cast<uint32_t>(Event::PeriodStart) == 0);
+    static_assert((1u << static_cast<uint32_t>(Event::PulseStart)) >> 1 == NOTIFY_PULSE_START);
+    static_assert((1u << static_cast<uint32_t>(Event::Sample)) >> 1 == NOTIFY_SAMPLE);
+    static_assert((1u << static_cast<uint32_t>(Event::PulseEnd)) >> 1 == NOTIFY_PULSE_END);
+
+    scheduler.set_duty_x1000(_duty_x1000.load());
+    scheduler.reduce_idle_rate(_reduce_idle_rate.load());
+    scheduler.set_modulation(_modulation.load());
+
+    // Steps without delay are merged, only the final switch state is set.
+    // That keeps load on between back-to-back pulses at full duty.
+    uint32_t events = 0;
+    bool on = false;
+    do {
+        on = pending.load_on;
+        events |= (1u << static_cast<uint32_t>(pending.event)) >> 1;
+        pending = scheduler.next();
+    } while (pending.delay_us == 0);
+    load_on(on);
+
+    // Alarms are absolute, ISR latency doesn't accumulate
+    alarm_at += pending.delay_us;
+    gptimer_alarm_config_t alarm_config{};
+    alarm_config.alarm_count = alarm_at;
+    gptimer_set_alarm_action(timer, &alarm_config);
+    return events;
+}
+
+bool IRAM_ATTR Pwm::timer_alarm_callback(gptimer_handle_t,
+                                         const gptimer_alarm_event_data_t *,
+                                         void *user_data) {
+    Pwm* self = static_cast<Pwm*>(user_data);
+
+    BaseType_t must_yield = pdFALSE;
+    xTaskNotifyFromISR(self->task_handle, self->advance(), eSetBits, &must_yield);
+    return must_yield == pdTRUE;
+}
+
+void Pwm::task_loop() {
+    uint32_t events = 0;
+    xTaskNotifyWait(0, UINT32_MAX, &events, portMAX_DELAY);
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+
+    if (_enabled.load()) {
+        // Merged events are handled in the order they happen. Pulse end
+        // comes before start of the next one.
+        if (events & NOTIFY_PULSE_END) {
+            sample_recorder.pwm_edge(SampleTrace::PwmEvent::PulseEnd);
+            drain_tracker.process_collected_data();
+        }
+        if (events & NOTIFY_PULSE_START) {
+            drain_tracker.clear_collected_data();
+            sample_recorder.pwm_edge(SampleTrace::PwmEvent::PulseStart);
+        }
+        // Late wakeup, load can be already off
+        if ((events & NOTIFY_SAMPLE) && !(events & NOTIFY_PULSE_END)) {
+            // Capture profile index at measurement time for eventual consistency.
+            drain_tracker.collect_data(profile_selector.current_index);
+        }
+    }
+
+    xSemaphoreGive(lock);
+}
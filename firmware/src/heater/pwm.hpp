@@ -1,22 +1,20 @@
 #pragma once
 
 #include <driver/gpio.h>
+#include <driver/gptimer.h>
+#include <esp_attr.h>
+#include <etl/atomic.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
-#include <pd/utils/afsm.h>
+#include <freertos/task.h>
 
-class Pwm : public afsm::fsm<Pwm>{
-public:
-    static_assert(configTICK_RATE_HZ == 1000, "PWM timings assume 1 ms FreeRTOS tick");
-
-    static constexpr uint32_t PWM_PERIOD_TICKS = 100;
-    static constexpr uint32_t PWM_IDLE_PERIOD_TICKS = 500;
-    static constexpr uint32_t PWM_MIN_PULSE_TICKS = 6;
-    static constexpr uint32_t POWER_STABILIZATION_TICKS = 4;
-    static_assert(PWM_MIN_PULSE_TICKS >= POWER_STABILIZATION_TICKS,
-        "PWM_MIN_PULSE_TICKS must be >= POWER_STABILIZATION_TICKS for ADC readings");
+#include "lib/pwm_scheduler.hpp"
 
-    Pwm();
+// Heater switch. Edges are set from the hardware timer ISR with 1 µs
+// resolution, INA reads are done by a task, woken by timer events. Both
+// timer and task sleep while disabled.
+class Pwm {
+public:
     void setup();
     // Duty is 0..1000
     void set_duty_x1000(uint32_t duty_0_1000);
@@ -24,36 +22,38 @@ public:
 
     void enable(bool enable);
     void reduce_idle_rate(bool reduce);
-    void load_on(bool on);
-
-    // PWM cycle bookkeeping
-    // (ticks counted in units of PWM_TICK_MS)
-    uint32_t pulse_ticks{0};
-    uint32_t gap_ticks{0};
-    uint32_t tick_count{0};
-    // Signed error for dithering (-500..+499), 1/1000-tick units
-    int32_t duty_error{0};
-
-    void run() {
-        xSemaphoreTake(fsm_lock, portMAX_DELAY);
-        Base::run();
-        xSemaphoreGive(fsm_lock);
-    }
-    void change_state(afsm::state_id_t new_state_id) {
-        xSemaphoreTake(fsm_lock, portMAX_DELAY);
-        Base::change_state(new_state_id);
-        xSemaphoreGive(fsm_lock);
-    }
-
-    etl::atomic<bool> _enabled{false};
-    etl::atomic<bool> _reduce_idle_rate{true};
+    void set_modulation(PwmScheduler::Modulation modulation);
 
 private:
-    using Base = afsm::fsm<Pwm>;
+    static constexpr gpio_num_t load_switch_pin{GPIO_NUM_3};
+    static constexpr uint32_t TIMER_RESOLUTION_HZ = 1'000'000;
+
+    // Task notification bits, set by timer ISR. Bit is (1 << event) >> 1,
+    // PeriodStart has none.
+    static constexpr uint32_t NOTIFY_PULSE_START = 1 << 0;
+    static constexpr uint32_t NOTIFY_SAMPLE = 1 << 1;
+    static constexpr uint32_t NOTIFY_PULSE_END = 1 << 2;
+
     void task_loop();
+    // Called from timer ISR
+    void IRAM_ATTR load_on(bool on);
+    uint32_t IRAM_ATTR advance();
 
-    static constexpr gpio_num_t load_switch_pin{GPIO_NUM_3};
+    static bool IRAM_ATTR timer_alarm_callback(gptimer_handle_t timer,
+                                               const gptimer_alarm_event_data_t *edata,
+                                               void *user_data);
+
+    gptimer_handle_t timer{nullptr};
+    TaskHandle_t task_handle{nullptr};
+    SemaphoreHandle_t lock{xSemaphoreCreateMutex()};
 
-    SemaphoreHandle_t fsm_lock{xSemaphoreCreateMutex()};
+    // Owned by timer ISR while enabled
+    PwmScheduler scheduler{};
+    PwmScheduler::Step pending{};
+    uint64_t alarm_at{0};
+
+    etl::atomic<bool> _enabled{false};
+    etl::atomic<bool> _reduce_idle_rate{true};
     etl::atomic<uint32_t> _duty_x1000{0};
+    etl::atomic<PwmScheduler::Modulation> _modulation{PwmScheduler::Modulation::Pwm};
 };
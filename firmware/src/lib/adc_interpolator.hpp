@@ -67,3 +67,102 @@ public:
         return uV_interp;
     }
 };
+
+// Same table and results as AdcInterpolator (within 1 uV), but O(1):
+//
+// - Segment is picked via index over uniform raw grid (table is built on
+//   ~uniform grid too, so a bin holds 1-2 points at most), instead of linear
+//   search.
+// - Per-segment slopes are precomputed in Q16, so conversion is one 32x32
+//   multiply and one 32-bit divide (by scale), instead of 64-bit divide.
+//
+// Call `rebuild()` after `points` change.
+template<size_t MAX_POINTS = 100>
+class GridAdcInterpolator {
+public:
+    using CalibPoint = typename AdcInterpolator<MAX_POINTS>::CalibPoint;
+
+    static constexpr uint32_t RAW_BITS = 12;
+    static constexpr uint32_t GRID_SHIFT = 5;
+    static constexpr size_t GRID_SIZE = (1u << RAW_BITS) >> GRID_SHIFT;
+    // Marks segment with slope too steep for Q16 (or falling), converted
+    // with exact math
+    static constexpr uint32_t SLOPE_EXACT = UINT32_MAX;
+
+    static_assert(MAX_POINTS <= 256, "Segment index must fit uint8_t");
+
+    etl::vector<CalibPoint, MAX_POINTS> points;
+
+    void rebuild() {
+        slopes_q16.clear();
+        if (points.size() < 2) { return; }
+
+        for (size_t i = 0; i + 1 < points.size(); i++) {
+            if (points[i + 1].mV < points[i].mV) {
+                slopes_q16.push_back(SLOPE_EXACT);
+                continue;
+            }
+            const uint32_t dr = points[i + 1].raw - points[i].raw;
+            const uint64_t delta_uv = (uint64_t)(points[i + 1].mV - points[i].mV) * 1000;
+            // Rounded to nearest, Q16
+            const uint64_t slope = dr ? ((delta_uv << 16) + dr / 2) / dr : 0;
+            slopes_q16.push_back(slope < SLOPE_EXACT ? (uint32_t)slope : SLOPE_EXACT);
+        }
+
+        // Last segment with left raw <= bin start, the same choice as linear
+        // search does.
+        size_t seg = 0;
+        for (size_t bin = 0; bin < GRID_SIZE; bin++) {
+            const uint32_t raw = bin << GRID_SHIFT;
+            while (seg + 1 < slopes_q16.size() && points[seg + 1].raw <= raw) { seg++; }
+            grid[bin] = (uint8_t)seg;
+        }
+    }
+
+    uint32_t to_uv(uint32_t adc_raw_scaled, uint32_t scale) const {
+        if (points.empty() || scale == 0) {
+            return 0;
+        }
+
+        uint64_t first_scaled = (uint64_t)points.front().raw * scale;
+        uint64_t last_scaled = (uint64_t)points.back().raw * scale;
+
+        if (adc_raw_scaled <= first_scaled) {
+            return (uint32_t)points.front().mV * 1000;
+        }
+        if (adc_raw_scaled >= last_scaled || slopes_q16.empty()) {
+            return (uint32_t)points.back().mV * 1000;
+        }
+
+        uint32_t avg_raw = adc_raw_scaled / scale;
+
+        // Bin gives a segment at the left of avg_raw, step forward over
+        // points inside the bin.
+        size_t left = grid[(avg_raw >> GRID_SHIFT) & (GRID_SIZE - 1)];
+        while (left + 1 < slopes_q16.size() && points[left + 1].raw <= avg_raw) { left++; }
+
+        const auto& p = points[left];
+        uint32_t numerator = adc_raw_scaled - (uint32_t)p.raw * scale;
+        uint32_t slope = slopes_q16[left];
+
+        if (slope == SLOPE_EXACT) {
+            // Same math as AdcInterpolator
+            int64_t denominator = (int64_t)(points[left + 1].raw - p.raw) * scale;
+            int32_t mV_delta = (int32_t)points[left + 1].mV - (int32_t)p.mV;
+            int64_t uV_interp_scaled = (int64_t)p.mV * 1000 * denominator + (int64_t)mV_delta * 1000 * numerator;
+            return (uint32_t)(uV_interp_scaled / denominator);
+        }
+
+        // Product >> 16 is about segment's uV delta * scale, and fits 32 bits
+        // for real tables. 64-bit divide is left as fallback only.
+        uint64_t delta_scaled = ((uint64_t)numerator * slope) >> 16;
+        if (delta_scaled <= UINT32_MAX) {
+            return (uint32_t)p.mV * 1000 + (uint32_t)delta_scaled / scale;
+        }
+        return (uint32_t)p.mV * 1000 + (uint32_t)(delta_scaled / scale);
+    }
+
+private:
+    etl::vector<uint32_t, MAX_POINTS - 1> slopes_q16;
+    uint8_t grid[GRID_SIZE]{};
+};
@@ -10,6 +10,7 @@ private:
     float kp{0.0F};
     float z1{0.0F};
     float z2{0.0F};
+    float u_last{0.0F};
 
 public:
     void set_params(float b0, float tau, float N, float M) {
@@ -22,11 +23,14 @@ public:
     void set_params_raw(float b0, float omega_o, float kp) {
         this->b0 = b0;
         this->beta1 = 2 * omega_o;
-        this->beta2 = powf(omega_o, 2);
+        this->beta2 = omega_o * omega_o;
         this->kp = kp;
     }
 
-    auto iterate(float y, float y_ref, float u_max, float dt, float y_ref_rate = 0) -> float {
+    // `y_age` is how old measurement is (filter delay, sampling), in the same
+    // units as `dt`. Measurement is extrapolated to "now" with observer's
+    // rate estimate, before it's fed to ESO.
+    auto iterate(float y, float y_ref, float u_max, float dt, float y_ref_rate = 0, float y_age = 0) -> float {
         const float e = y_ref - z1;
         const float u = (kp * e + y_ref_rate - z2) / b0;
 
@@ -34,15 +38,18 @@ public:
         const float u_output = etl::max(0.0f, etl::min(u, u_max));
 
         // ESO update, with respect to real output
-        const float e_obs = y - z1;
+        const float y_now = y_age > 0 ? y + y_age * (b0 * u_last + z2) : y;
+        const float e_obs = y_now - z1;
         z1 += dt * (b0 * u_output + z2 + beta1 * e_obs);
         z2 += dt * (beta2 * e_obs);
 
+        u_last = u_output;
         return u_output;
     }
 
     void reset_to(float y) {
         z1 = y;
         z2 = 0.0F;
+        u_last = 0.0F;
     }
 };
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <etl/algorithm.h>
+#include <etl/vector.h>
+
+#include "lib/reflow_metrics.hpp"
+#include "proto/generated/shared_constants.hpp"
+
+// Batch production bookkeeping: runs counter, readiness detection between
+// runs, cycle time statistics and reflow quality of every run.
+//
+// Cycle of every run is: heat (reflow) -> cool (forced, until ready) ->
+// idle (ready, waiting for start). Last run has no cool/idle phases.
+//
+// Platform-agnostic, time is passed in explicitly.
+class BatchCycle {
+public:
+    // Per-run records kept. Totals continue to accumulate above this limit.
+    static constexpr size_t MAX_RUNS = 32;
+
+    // Ready, when plate is below start temperature and not cooling fast.
+    // Sensor lags the plate surface, fast cooling means a gradient still exists.
+    static constexpr int32_t READY_TEMPERATURE_X10 = SharedConstants::START_TEMPERATURE * 10;
+    static constexpr int32_t READY_RATE_X100 = 20;  // 0.2 °C/s
+    // Hot room fallback: plate can't go below START_TEMPERATURE, accept when
+    // temperature stalled not far above it.
+    static constexpr int32_t STALL_TEMPERATURE_X10 = READY_TEMPERATURE_X10 + 10 * 10;
+    static constexpr int32_t STALL_RATE_X100 = 2;   // 0.02 °C/s
+    // Rate is measured over this window, to suppress sensor noise
+    static constexpr uint32_t RATE_WINDOW_MS = 10 * 1000;
+
+    enum class Phase : uint8_t { Inactive, Heat, Cool, Idle };
+
+    // Reflow quality comes from ReflowMetrics summary, the run's history
+    // itself is not kept (next run restarts it). Narrow types fit ±3276 °C
+    // and ±327 °C/s, to keep MAX_RUNS records small.
+    struct Run {
+        uint32_t heat_ms;
+        uint32_t cool_ms;
+        uint32_t idle_ms;
+        bool succeeded;
+        uint8_t failures;           // ReflowMetrics::Failure bits
+        int16_t peak_x10;
+        int16_t max_overshoot_x10;
+        int16_t ramp_up_max_x100;
+        int16_t ramp_down_max_x100;
+        uint32_t tal_ms;
+    };
+
+    struct Stats {
+        uint32_t total{0};      // Requested runs
+        uint32_t completed{0};  // Finished runs, including failed
+        uint32_t succeeded{0};
+        uint32_t heat_ms{0};    // Totals over all completed runs
+        uint32_t cool_ms{0};
+        uint32_t idle_ms{0};
+        etl::vector<Run, MAX_RUNS> runs{};
+    };
+
+    auto start(uint32_t count, bool auto_start) -> bool {
+        if (count == 0) { return false; }
+
+        stats = Stats{};
+        stats.total = count;
+        autostart = auto_start;
+        phase = Phase::Idle;
+        return true;
+    }
+
+    // Drops batch, keeping stats for later reading
+    void finish() { phase = Phase::Inactive; }
+
+    auto is_active() const -> bool { return phase != Phase::Inactive; }
+    auto is_auto_start() const -> bool { return autostart; }
+    auto get_phase() const -> Phase { return phase; }
+    auto get_stats() const -> const Stats& { return stats; }
+
+    void on_heat_start(uint32_t now_ms) {
+        // Idle time belongs to the previous run
+        if (phase == Phase::Idle && stats.completed > 0) {
+            add_time(stats.completed - 1, now_ms - phase_start_ms, &Run::idle_ms, stats.idle_ms);
+        }
+        phase = Phase::Heat;
+        phase_start_ms = now_ms;
+    }
+
+    // Returns true if more runs are pending. Failed run (metrics not
+    // passed) stops the batch.
+    auto on_heat_end(uint32_t now_ms, const ReflowMetrics::Result& metrics) -> bool {
+        const uint32_t heat_ms = now_ms - phase_start_ms;
+        const bool succeeded = metrics.passed;
+
+        if (!stats.runs.full()) {
+            stats.runs.push_back({
+                .heat_ms = heat_ms,
+                .cool_ms = 0,
+                .idle_ms = 0,
+                .succeeded = succeeded,
+                .failures = static_cast<uint8_t>(metrics.failures),
+                .peak_x10 = static_cast<int16_t>(metrics.peak_x10),
+                .max_overshoot_x10 = static_cast<int16_t>(metrics.max_overshoot_x10),
+                .ramp_up_max_x100 = static_cast<int16_t>(metrics.ramp_up_max_x100),
+                .ramp_down_max_x100 = static_cast<int16_t>(metrics.ramp_down_max_x100),
+                .tal_ms = metrics.tal_ms
+            });
+        }
+        stats.completed++;
+        stats.heat_ms += heat_ms;
+        if (succeeded) { stats.succeeded++; }
+
+        if (!succeeded || stats.completed >= stats.total) {
+            phase = Phase::Inactive;
+            return false;
+        }
+
+        phase = Phase::Cool;
+        phase_start_ms = now_ms;
+        rate_x100 = INT32_MIN;
+        rate_ref_ms = now_ms;
+        rate_ref_x10 = INT32_MIN;
+        return true;
+    }
+
+    // Feed temperature while cooling. Returns true when plate becomes ready
+    // (once, then phase switches to Idle).
+    auto update_cooling(uint32_t now_ms, int32_t temperature_x10) -> bool {
+        if (phase != Phase::Cool) { return false; }
+
+        if (rate_ref_x10 == INT32_MIN) {
+            rate_ref_x10 = temperature_x10;
+            rate_ref_ms = now_ms;
+        } else if (now_ms - rate_ref_ms >= RATE_WINDOW_MS) {
+            // x10 °C per ms -> x100 °C per s
+            rate_x100 = static_cast<int32_t>(
+                static_cast<int64_t>(temperature_x10 - rate_ref_x10) * 10'000 / static_cast<int32_t>(now_ms - rate_ref_ms));
+            rate_ref_x10 = temperature_x10;
+            rate_ref_ms = now_ms;
+        }
+
+        if (!is_ready(temperature_x10)) { return false; }
+
+        add_time(stats.completed - 1, now_ms - phase_start_ms, &Run::cool_ms, stats.cool_ms);
+        phase = Phase::Idle;
+        phase_start_ms = now_ms;
+        return true;
+    }
+
+    // Last measured cooling rate, x100 °C/s. INT32_MIN if not known yet.
+    auto get_rate_x100() const -> int32_t { return rate_x100; }
+
+private:
+    Stats stats{};
+    Phase phase{Phase::Inactive};
+    bool autostart{false};
+    uint32_t phase_start_ms{0};
+
+    int32_t rate_x100{INT32_MIN};
+    uint32_t rate_ref_ms{0};
+    int32_t rate_ref_x10{INT32_MIN};
+
+    auto is_ready(int32_t temperature_x10) const -> bool {
+        if (rate_x100 == INT32_MIN) { return false; }
+
+        const int32_t rate_abs = rate_x100 < 0 ? -rate_x100 : rate_x100;
+        if (temperature_x10 <= READY_TEMPERATURE_X10 && rate_abs <= READY_RATE_X100) { return true; }
+        return temperature_x10 <= STALL_TEMPERATURE_X10 && rate_abs <= STALL_RATE_X100;
+    }
+
+    void add_time(size_t idx, uint32_t ms, uint32_t Run::* field, uint32_t& total) {
+        if (idx < stats.runs.size()) { stats.runs[idx].*field = ms; }
+        total += ms;
+    }
+};
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Two-stage decimator for oversampled ADC stream (12-bit samples):
+//
+// 1. CIC, order 3, decimates by CIC_DECIMATION. Integer adds only, cheap
+//    enough to run for every ADC sample.
+// 2. Low-pass FIR (Hann windowed sinc, cut at 0.4 of output Nyquist)
+//    decimates by FIR_DECIMATION. It is also convolved with a 3-tap CIC droop
+//    compensator. FIR is evaluated only when output is due.
+//
+// Hann window and low cutoff are chosen for white noise. Sharper filters
+// (Blackman, cut at Nyquist) have ~40% more noise at the same delay.
+//
+// Output is raw ADC value x OUTPUT_SCALE. Both stages are linear phase, so
+// total group delay is fixed: GROUP_DELAY_X2 / 2 input samples.
+//
+// Stages can be fed separately. Trace recording stores CIC outputs (raw
+// samples are too many), and replay runs FIR stage only.
+//
+// Platform-agnostic, FIR coefficients are designed in constructor.
+template <uint32_t CIC_DECIMATION, uint32_t FIR_DECIMATION, uint32_t FIR_TAPS>
+class DecimationFilter {
+public:
+    static constexpr uint32_t CIC_ORDER = 3;
+    static constexpr uint32_t OUTPUT_SCALE = 100;
+    static constexpr uint32_t DECIMATION = CIC_DECIMATION * FIR_DECIMATION;
+    static constexpr uint32_t TAPS = FIR_TAPS;
+    // Input samples x2, to stay integer
+    static constexpr uint32_t GROUP_DELAY_X2 = CIC_ORDER * (CIC_DECIMATION - 1) + (FIR_TAPS - 1) * CIC_DECIMATION;
+
+    static_assert(CIC_DECIMATION >= 2 && FIR_DECIMATION >= 1, "Bad decimation");
+    static_assert(FIR_TAPS % 2 == 1 && FIR_TAPS >= 5, "FIR must have odd taps count");
+    // CIC gain R^3 on 12-bit input must fit int32
+    static_assert(static_cast<uint64_t>(CIC_DECIMATION) * CIC_DECIMATION * CIC_DECIMATION * 4096 < (1ull << 31),
+                  "CIC decimation too big");
+
+    DecimationFilter() {
+        design();
+        reset();
+    }
+
+    void reset() {
+        for (auto& v : integrators) { v = 0; }
+        for (auto& v : combs) { v = 0; }
+        for (auto& v : fir_line) { v = 0; }
+        cic_phase = 0;
+        fir_phase = 0;
+        fir_pos = 0;
+        warmup = WARMUP_SAMPLES;
+    }
+
+    // Feed one ADC sample. Returns true when new output is available.
+    auto push(uint16_t sample) -> bool {
+        if (!push_cic(sample)) { return false; }
+        return push_fir(cic_output);
+    }
+
+    // CIC stage only. Returns true when its output is available.
+    auto push_cic(uint16_t sample) -> bool {
+        // Integrators wrap, that's fine - combs cancel it (modular math)
+        integrators[0] += sample;
+        integrators[1] += integrators[0];
+        integrators[2] += integrators[1];
+
+        if (++cic_phase < CIC_DECIMATION) { return false; }
+        cic_phase = 0;
+
+        uint32_t v = integrators[2];
+        for (auto& c : combs) {
+            const uint32_t prev = c;
+            c = v;
+            v -= prev;
+        }
+        cic_output = static_cast<int32_t>(v);
+        return true;
+    }
+
+    // Last CIC stage output, raw ADC x CIC gain
+    auto get_cic_output() const -> int32_t { return cic_output; }
+
+    // FIR stage, fed with CIC outputs. Returns true when new output is
+    // available.
+    auto push_fir(int32_t v) -> bool {
+        fir_line[fir_pos] = v;
+        if (++fir_pos == FIR_TAPS) { fir_pos = 0; }
+        if (warmup) { warmup--; }
+
+        if (++fir_phase < FIR_DECIMATION) { return false; }
+        fir_phase = 0;
+        if (warmup) { return false; }
+
+        // Coefficients are symmetric, so direction doesn't matter
+        int64_t acc = 0;
+        size_t idx = fir_pos;
+        for (size_t k = 0; k < FIR_TAPS; k++) {
+            acc += static_cast<int64_t>(coeffs[k]) * fir_line[idx];
+            if (++idx == FIR_TAPS) { idx = 0; }
+        }
+
+        // Remove CIC and coefficients gain, round to nearest
+        constexpr int64_t divisor = static_cast<int64_t>(CIC_GAIN) << COEFF_BITS;
+        acc *= OUTPUT_SCALE;
+        output = acc <= 0 ? 0 : static_cast<uint32_t>((acc + divisor / 2) / divisor);
+        return true;
+    }
+
+    // Last output, raw ADC x OUTPUT_SCALE
+    auto get_output() const -> uint32_t { return output; }
+
+    // FIR stage state, to continue elsewhere bit-exact (trace replay). Line
+    // has TAPS values, `pos` is the oldest one.
+    struct FirState {
+        uint32_t phase;
+        uint32_t pos;
+        uint32_t warmup;
+        uint32_t output;
+    };
+
+    auto get_fir_state() const -> FirState {
+        return { fir_phase, static_cast<uint32_t>(fir_pos), warmup, output };
+    }
+    auto get_fir_line() const -> const int32_t* { return fir_line; }
+
+    void set_fir_state(const FirState& state, const int32_t* line) {
+        for (size_t i = 0; i < FIR_TAPS; i++) { fir_line[i] = line[i]; }
+        fir_phase = state.phase % FIR_DECIMATION;
+        fir_pos = state.pos % FIR_TAPS;
+        warmup = state.warmup;
+        output = state.output;
+    }
+
+private:
+    static constexpr uint32_t CIC_GAIN = CIC_DECIMATION * CIC_DECIMATION * CIC_DECIMATION;
+    static constexpr uint32_t COEFF_BITS = 20;
+    // CIC combs fill, then FIR line
+    static constexpr uint32_t WARMUP_SAMPLES = CIC_ORDER + FIR_TAPS;
+
+    uint32_t integrators[CIC_ORDER]{};
+    uint32_t combs[CIC_ORDER]{};
+    int32_t fir_line[FIR_TAPS]{};
+    int32_t coeffs[FIR_TAPS]{};
+    uint32_t cic_phase{0};
+    uint32_t fir_phase{0};
+    size_t fir_pos{0};
+    uint32_t warmup{WARMUP_SAMPLES};
+    uint32_t output{0};
+    int32_t cic_output{0};
+
+    void design() {
+        constexpr size_t BASE_TAPS = FIR_TAPS - 2;
+        constexpr double PI = 3.14159265358979323846;
+        // Cycles per CIC output sample
+        constexpr double fc = 0.2 / FIR_DECIMATION;
+
+        double base[BASE_TAPS];
+        double sum = 0;
+        for (size_t k = 0; k < BASE_TAPS; k++) {
+            const double m = static_cast<double>(k) - (BASE_TAPS - 1) / 2.0;
+            const double sinc = m == 0 ? 2 * fc : sin(2 * PI * fc * m) / (PI * m);
+            const double w = 2 * PI * static_cast<double>(k) / (BASE_TAPS - 1);
+            base[k] = sinc * (0.5 - 0.5 * cos(w));
+            sum += base[k];
+        }
+
+        // CIC droop is ~ 1 - N·ω²·(1 - 1/R²)/24 at CIC output rate. Filter
+        // [-a, 1+2a, -a] has response 1 + 2a·(1 - cos ω) ~ 1 + a·ω².
+        constexpr double R2 = static_cast<double>(CIC_DECIMATION) * CIC_DECIMATION;
+        constexpr double a = CIC_ORDER * (1.0 - 1.0 / R2) / 24;
+        const double comp[3] = { -a, 1 + 2 * a, -a };
+
+        int64_t total = 0;
+        for (size_t k = 0; k < FIR_TAPS; k++) {
+            double h = 0;
+            for (size_t j = 0; j < 3; j++) {
+                if (k >= j && k - j < BASE_TAPS) { h += comp[j] * base[k - j] / sum; }
+            }
+            coeffs[k] = static_cast<int32_t>(lround(h * (1 << COEFF_BITS)));
+            total += coeffs[k];
+        }
+        // Exact unity DC gain
+        coeffs[FIR_TAPS / 2] += static_cast<int32_t>((1 << COEFF_BITS) - total);
+    }
+};
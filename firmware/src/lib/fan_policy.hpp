@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+
+// Fan on/off decision, evaluated every heater tick. Platform-agnostic part
+// of HeaterControl::update_fan_speed().
+//
+// - Task with temperature control: cool only the overshoot, with small
+//   hysteresis, checked against temperature projected by current rate. Fan
+//   starts only when controller output is about zero, to avoid fighting it.
+// - Task without temperature control (calibrations): off.
+// - No task: cool down to touch-safe edge. Forced cooling (batch cooldown)
+//   keeps fan on regardless of the edge, until the owner releases it.
+// - Head missing or temperature unknown: off.
+class FanPolicy {
+public:
+    enum class Action : uint8_t {
+        Keep,
+        On,
+        Off
+    };
+
+    struct Input {
+        bool task_active;
+        bool temperature_control;
+        bool forced_cooling;
+        bool head_connected;
+        bool temperature_known;
+        int32_t temperature_x10;
+        int32_t setpoint_x10;
+        int32_t rate_x100;        // °C/s x100
+        uint32_t target_power_mw;
+    };
+
+    static constexpr int32_t DIFF_ON_X10 = 4 * 10;
+    static constexpr int32_t DIFF_OFF_X10 = 3 * 10;
+    static constexpr int32_t EDGE_ON_X10 = 40 * 10;
+    // Compare thresholds with temperature projected this far ahead
+    static constexpr int32_t LOOKAHEAD_MS = 2000;
+    static constexpr uint32_t IDLE_POWER_MW = 1 * 1000;
+
+    static auto decide(const Input& in) -> Action {
+        if (in.task_active) {
+            if (!in.temperature_control) { return Action::Off; }
+
+            // Rising temperature never delays stop
+            const int32_t projected_x10 = in.temperature_x10 + in.rate_x100 * LOOKAHEAD_MS / 10'000;
+            const int32_t low_x10 = projected_x10 < in.temperature_x10 ? projected_x10 : in.temperature_x10;
+
+            if (low_x10 < in.setpoint_x10 + DIFF_OFF_X10) { return Action::Off; }
+            if (projected_x10 > in.setpoint_x10 + DIFF_ON_X10 && in.target_power_mw < IDLE_POWER_MW) {
+                return Action::On;
+            }
+            return Action::Keep;
+        }
+
+        if (!in.head_connected || !in.temperature_known) { return Action::Off; }
+        if (in.forced_cooling) { return Action::On; }
+        return in.temperature_x10 > EDGE_ON_X10 ? Action::On : Action::Off;
+    }
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <math.h>
+
+#include "lib/least_squares.hpp"
+
+// Streaming FOPDT (first order plus dead time) fit of a step response:
+//
+//   τ·dy/dt = -(y - y0) + K·u(t - L),   b0 = K/τ
+//
+// Integrating both sides from 0 to t (for t > L, u = const after step) gives
+// a model, linear in parameters, without noisy derivatives:
+//
+//   y - y0 = -1/τ · ∫(y - y0)dt + b0 · ∫u dt - b0·L·u
+//
+// Regressors are [-∫(y - y0), ∫u, u], so only normal equations are stored
+// (constant memory), and every sample of the response contributes, instead of
+// two interpolated points.
+//
+// The model does not hold in dead time (y stays at y0, model goes negative),
+// so samples enter the fit only after response onset. Integrals still run
+// from the step, L is estimated from the fit.
+class FopdtFit {
+public:
+    // Response onset, |y - y0|. Above sensor noise, and small enough to
+    // lose only a few samples after L.
+    static constexpr float ONSET_THRESHOLD = 1.0f;  // °C
+
+    struct Result {
+        float tau;       // Response time, s
+        float b0;        // K/τ, °C/s per W
+        float delay;     // Dead time, s
+        float tau_rel_sd;  // Relative standard deviations of τ and b0
+        float b0_rel_sd;
+    };
+
+    void reset(float initial_temperature) {
+        ls.reset();
+        y0 = initial_temperature;
+        y_integral = 0;
+        u_integral = 0;
+        prev_dy = 0;
+        prev_u = 0;
+        elapsed = 0;
+        onset = -1;
+    }
+
+    // Feed next sample. `dt` - time since previous sample, s. `power` - W,
+    // applied during this interval.
+    void add(float dt, float temperature, float power) {
+        const double dy = static_cast<double>(temperature - y0);
+        const double u = power;
+        const double h = dt;
+
+        // Trapezoidal integration
+        y_integral += (dy + prev_dy) * 0.5 * h;
+        u_integral += (u + (elapsed > 0 ? prev_u : u)) * 0.5 * h;
+        prev_dy = dy;
+        prev_u = u;
+        elapsed += h;
+
+        if (onset < 0) {
+            if (fabs(dy) < ONSET_THRESHOLD) { return; }
+            onset = elapsed;
+        }
+
+        const double x[3] = { -y_integral, u_integral, u };
+        ls.add(x, dy);
+    }
+
+    auto get_elapsed() const -> float { return static_cast<float>(elapsed); }
+    // Time of response onset, s. Negative if not detected yet.
+    auto get_onset() const -> float { return static_cast<float>(onset); }
+
+    // Returns false if there is not enough data yet, or fit is not physical.
+    auto solve(Result& r) const -> bool {
+        double theta[3];
+        if (!ls.solve(theta)) { return false; }
+
+        const double inv_tau = theta[0];
+        const double b0 = theta[1];
+        if (inv_tau <= 0 || b0 <= 0) { return false; }
+
+        double var[3];
+        if (!ls.variance(theta, var)) { return false; }
+
+        r.tau = static_cast<float>(1.0 / inv_tau);
+        r.b0 = static_cast<float>(b0);
+        r.delay = static_cast<float>(-theta[2] / b0);
+        // σ(1/τ)/(1/τ) == σ(τ)/τ, to first order
+        r.tau_rel_sd = static_cast<float>(sqrt(var[0]) / inv_tau);
+        r.b0_rel_sd = static_cast<float>(sqrt(var[1]) / b0);
+        return true;
+    }
+
+private:
+    LeastSquares<3> ls{};
+    float y0{0};
+    double y_integral{0};
+    double u_integral{0};
+    double prev_dy{0};
+    double prev_u{0};
+    double elapsed{0};
+    double onset{-1};
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stdint.h>
+
+// Averaging of raw INAxxx samples, collected over the PWM pulse tail.
+// Platform-agnostic part of DrainTracker, shared with host-side trace replay.
+class InaFilter {
+public:
+    enum class Chip : uint8_t {
+        Unknown,
+        INA226,
+        INA238
+    };
+
+    struct Sample {
+        uint16_t v_raw;
+        int16_t i_raw;
+        uint32_t ctx_idx;  // Profile index at sample time
+    };
+
+    struct Result {
+        uint32_t peak_mv = 0;
+        uint32_t peak_ma = 0;
+        bool load_valid = false;
+        uint32_t ctx_idx = 0;  // Profile index at which measurements were taken
+        uint32_t samples = 0;  // Number of samples averaged
+        uint32_t seq = 0;      // Incremented on each update, to detect new data
+        uint32_t timestamp_ms = 0;  // Capture time (end of sampled pulse)
+    };
+
+    static constexpr uint32_t FILTER_SIZE = 8;
+
+    void push(const Sample& sample) {
+        buffer[count % FILTER_SIZE] = sample;
+        count++;
+    }
+
+    void clear() { count = 0; }
+
+    // Continue result numbering from a known one (trace replay)
+    void set_seq(uint32_t seq) { updates = seq; }
+
+    auto size() const -> uint32_t { return count; }
+
+    // Returns true if result was updated. Collected samples are always
+    // consumed.
+    auto process(Chip chip, Result& result, uint32_t timestamp_ms) -> bool {
+        if (count == 0) { return false; }
+        if (chip == Chip::Unknown) {
+            count = 0;
+            return false;
+        }
+
+        const uint32_t n = count < FILTER_SIZE ? count : FILTER_SIZE;
+
+        // Check that all samples have a consistent profile index.
+        // If the index changed mid-collection, drop this batch; the next PWM cycle
+        // will retry.
+        const uint32_t first_idx = buffer[0].ctx_idx;
+        for (uint32_t i = 1; i < n; i++) {
+            if (buffer[i].ctx_idx != first_idx) {
+                count = 0;
+                return false;
+            }
+        }
+
+        uint32_t v_sum{0};
+        int32_t i_sum{0};
+
+        for (uint32_t i = 0; i < n; i++) {
+            v_sum += buffer[i].v_raw;
+            i_sum += buffer[i].i_raw;
+        }
+
+        if (i_sum < 0) { i_sum = 0; }
+        const uint32_t v_avg = v_sum / n;
+        uint32_t peak_mv = 0;
+        if (chip == Chip::INA238) {
+            // INA238 VBUS LSB = 3.125 mV
+            peak_mv = (v_avg * 3125 + 500) / 1000;
+        } else {
+            // INA226 VBUS LSB = 1.25 mV
+            peak_mv = (v_avg * 5 + 2) / 4;
+        }
+        // Shunt current already in mA
+        const uint32_t peak_ma = static_cast<uint32_t>(i_sum / static_cast<int32_t>(n));
+
+        result.peak_mv = peak_mv;
+        result.peak_ma = peak_ma;
+        // Thresholds for real measurements, not PD limits.
+        result.load_valid = (peak_ma >= 300 && peak_mv >= 4000);
+        result.ctx_idx = first_idx;
+        result.samples = n;
+        result.seq = ++updates;
+        result.timestamp_ms = timestamp_ms;
+
+        count = 0;
+        return true;
+    }
+
+private:
+    Sample buffer[FILTER_SIZE]{};
+    uint32_t count{0};
+    uint32_t updates{0};
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+
+// Streaming linear least squares, via normal equations.
+//
+// Keeps only AᵀA, Aᵀy and yᵀy, so memory does not depend on samples count.
+// Accumulated in double - enough for millions of samples of typical thermal
+// data. Solved with Gaussian elimination (partial pivoting).
+template <size_t N>
+class LeastSquares {
+public:
+    void add(const double (&x)[N], double y) {
+        for (size_t i = 0; i < N; i++) {
+            for (size_t j = i; j < N; j++) { ata[i][j] += x[i] * x[j]; }
+            aty[i] += x[i] * y;
+        }
+        yty += y * y;
+        count++;
+    }
+
+    void reset() { *this = LeastSquares{}; }
+
+    // Returns false if system is degenerate (not enough excitation).
+    auto solve(double (&theta)[N]) const -> bool { return solve_for(aty, theta); }
+
+    // Sum of squared residuals for given solution: yᵀy - 2θᵀAᵀy + θᵀAᵀAθ
+    auto sse(const double (&theta)[N]) const -> double {
+        double r = yty;
+        for (size_t i = 0; i < N; i++) {
+            r -= 2 * theta[i] * aty[i];
+            for (size_t j = 0; j < N; j++) {
+                r += theta[i] * theta[j] * (i <= j ? ata[i][j] : ata[j][i]);
+            }
+        }
+        return r > 0 ? r : 0;
+    }
+
+    // Parameter variances, σ²·diag((AᵀA)⁻¹), with σ² estimated from
+    // residuals. Assumes white noise, so is optimistic for real sensors -
+    // use as convergence indicator, not as strict bound.
+    auto variance(const double (&theta)[N], double (&var)[N]) const -> bool {
+        if (count <= N) { return false; }
+        const double sigma2 = sse(theta) / static_cast<double>(count - N);
+
+        for (size_t i = 0; i < N; i++) {
+            double e[N]{};
+            double col[N];
+            e[i] = 1;
+            if (!solve_for(e, col)) { return false; }
+            var[i] = sigma2 * col[i];
+        }
+        return true;
+    }
+
+    auto size() const -> size_t { return count; }
+
+private:
+    double ata[N][N]{};  // Upper triangle only
+    double aty[N]{};
+    double yty{0};
+    size_t count{0};
+
+    auto solve_for(const double (&b)[N], double (&x)[N]) const -> bool {
+        double m[N][N + 1];
+        for (size_t i = 0; i < N; i++) {
+            for (size_t j = 0; j < N; j++) { m[i][j] = i <= j ? ata[i][j] : ata[j][i]; }
+            m[i][N] = b[i];
+        }
+
+        for (size_t col = 0; col < N; col++) {
+            size_t pivot = col;
+            for (size_t r = col + 1; r < N; r++) {
+                if (fabs(m[r][col]) > fabs(m[pivot][col])) { pivot = r; }
+            }
+            if (fabs(m[pivot][col]) < 1e-12 * (fabs(ata[col][col]) + 1e-300)) { return false; }
+
+            if (pivot != col) {
+                for (size_t j = 0; j <= N; j++) {
+                    const double tmp = m[col][j];
+                    m[col][j] = m[pivot][j];
+                    m[pivot][j] = tmp;
+                }
+            }
+
+            for (size_t r = col + 1; r < N; r++) {
+                const double f = m[r][col] / m[col][col];
+                for (size_t j = col; j <= N; j++) { m[r][j] -= f * m[col][j]; }
+            }
+        }
+
+        for (size_t i = N; i-- > 0;) {
+            double s = m[i][N];
+            for (size_t j = i + 1; j < N; j++) { s -= m[i][j] * x[j]; }
+            x[i] = s / m[i][i];
+        }
+        return true;
+    }
+};
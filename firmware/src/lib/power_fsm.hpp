@@ -0,0 +1,296 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "heater/profile_selector.hpp"
+#include "lib/ina_filter.hpp"
+#include "lib/pwm_scheduler.hpp"
+
+// Power states: PD contract negotiation and load control on top of
+// ProfileSelector. Platform-agnostic part of Power, also driven by the
+// simulated USB-PD source in tools/pd_sim.
+//
+// DPM events come in as method calls, actions go out via `Io`. Not thread
+// safe, the owner serializes all calls (Power wraps them with its lock).
+class PowerFsm {
+public:
+    enum class State : uint8_t {
+        Off,
+        Initializing,
+        Calibrate,
+        Ready,
+        WaitContractChange,
+        Fault
+    };
+
+    using DrainInfo = InaFilter::Result;
+
+    class Io {
+    public:
+        virtual ~Io() = default;
+
+        // DPM triggers. NOTE: trigger MUST be async, to avoid deadlock
+        // when called from DPM event handler.
+        virtual void trigger_by_position(uint32_t position, uint32_t mv) = 0;
+        // Update trigger without new power level request
+        virtual void clear_trigger_to(uint32_t position, uint32_t mv) = 0;
+        virtual auto is_handshake_reported() -> bool = 0;
+
+        virtual auto get_drain_info() -> DrainInfo = 0;
+        virtual void drain_reset() = 0;
+
+        virtual void pwm_enable(bool enable) = 0;
+        virtual void pwm_set(PwmScheduler::Modulation modulation, uint32_t duty_x1000) = 0;
+
+        // Called on each state enter, before state actions
+        virtual void on_state(State /*state*/) {}
+        // APDO voltage adjust requested, contract stays on the same profile
+        virtual void on_apdo_update(uint32_t /*profile_idx*/, uint32_t /*mv*/) {}
+    };
+
+    PowerFsm(ProfileSelector& ps, Io& io) : ps(ps), io(io) {}
+
+    ProfileSelector& ps;
+    pd::PDO_LIST source_caps{};
+    // Written by heater control without lock
+    std::atomic<uint32_t> target_power_mw{0};
+
+    auto get_state() const -> State { return state; }
+
+    // Enter initial state
+    void start() { enter(State::Off); }
+
+    //
+    // DPM events
+    //
+
+    // Startup and TransitToDefault
+    void on_startup() { transition_to(State::Initializing); }
+    void on_cable_detached() { transition_to(State::Off); }
+    void on_src_disabled() { transition_to(State::Fault); }
+
+    // SRC Caps can come in 3 cases:
+    //
+    // 1. On startup, when PD stack is initialized.
+    // 2. After soft reset from SRC.
+    // 3. If been forced by SRC.
+    //
+    // The last ones requires restore of previous state.
+    void on_src_caps_received(const pd::PDO_LIST& caps) {
+        source_caps = caps;
+        ps.load_pdos(source_caps);
+        io.clear_trigger_to(ps.default_position, ps.default_mv);
+
+        if (state == State::Ready) {
+            is_from_caps_update = true;
+            transition_to(State::WaitContractChange);
+        } else if (state == State::WaitContractChange) {
+            is_from_caps_update = true;
+            enter(State::WaitContractChange);
+        }
+    }
+
+    void on_select_cap_done(uint32_t position) { ps.set_pdo_index(static_cast<int32_t>(position) - 1); }
+
+    void on_handshake_done() {
+        if (state == State::Initializing) { transition_to(State::Calibrate); }
+    }
+
+    void on_snk_ready() {
+        switch (state) {
+            case State::Initializing:
+                if (io.is_handshake_reported()) { transition_to(State::Calibrate); }
+                break;
+            case State::Ready:
+                // Local APDO update complete, and SRC is ready.
+                // PWM stays intact, because been updated prior to APDO adjusting.
+                prev_apdo_mv = next_apdo_mv;
+                current_plan = next_plan;
+                is_apdo_updating = false;
+                break;
+            case State::WaitContractChange:
+                current_plan = next_plan;
+                transition_to(State::Ready);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void on_new_power_level_rejected() {
+        if (state != State::Ready && state != State::WaitContractChange) { return; }
+
+        // Force re-init on failure
+        is_apdo_updating = false;
+        io.trigger_by_position(ps.default_position, ps.default_mv);
+        transition_to(State::Initializing);
+    }
+
+    void on_sys_tick() {
+        if (state == State::Calibrate) {
+            if (io.get_drain_info().load_valid) { transition_to(State::Ready); }
+            return;
+        }
+        if (state != State::Ready) { return; }
+
+        const auto drain_info = io.get_drain_info();
+
+        if (drain_info.load_valid) {
+            // Update feedback with current measurements.
+            // Context from current_plan — that's what was active during measurement.
+            last_feedback = {
+                .peak_mv = drain_info.peak_mv,
+                .peak_ma = drain_info.peak_ma,
+                .req_mv = current_plan.mv,
+                .req_idx = current_plan.profile_idx
+            };
+        }
+
+        // Wait until APDO update is finished
+        if (is_apdo_updating) { return; }
+
+        if (!drain_info.load_valid) {
+            // If head connection lost for some reasons (ejected)
+            io.pwm_enable(false);
+            io.trigger_by_position(ps.default_position, ps.default_mv);
+            transition_to(State::Initializing);
+            return;
+        }
+
+        auto plan = ps.plan_power(target_power_mw, last_feedback);
+
+        // If completely new PDO required - go to switching state.
+        if (plan.profile_idx != ps.current_index) {
+            is_from_caps_update = false;
+            transition_to(State::WaitContractChange);
+            return;
+        }
+
+        const auto idx = ps.current_index;
+        const auto& desc = ps.descriptors[idx];
+
+        if (desc.mv_min == desc.mv_max) {
+            // Fixed PDO. Voltage is the same, only adjust duty cycle.
+            // Duty goes down to zero here, so use sigma-delta to get below
+            // min pulse.
+            io.pwm_set(PwmScheduler::Modulation::SigmaDelta, plan.duty_x1000);
+            io.pwm_enable(true);
+            current_plan = plan;
+            return;
+        }
+
+        // APDO. Power is set by voltage, duty is mostly 100%. Keep plain
+        // PWM, voltage planning needs fresh feedback every period.
+        io.pwm_set(PwmScheduler::Modulation::Pwm, plan.duty_x1000);
+        io.pwm_enable(true);
+
+        // Avoid unnecessary APDO updates if voltage didn't change much
+        auto mv = (plan.mv + 50) / 100 * 100; // Round to 0.1V precision
+        if (mv != prev_apdo_mv) {
+            // Update APDO contract without state change. Lock next ticks
+            // until update finishes. State can be terminated from outside
+            // to init/off only, then no pending PS_RDY will be left.
+            next_apdo_mv = mv;
+            next_plan = plan;
+            is_apdo_updating = true;
+            io.on_apdo_update(idx, plan.mv);
+            io.trigger_by_position(idx + 1, plan.mv);
+        } else {
+            // Voltage same, duty updated immediately
+            current_plan = plan;
+        }
+    }
+
+    auto get_max_power_mw() -> uint32_t {
+        const auto info = io.get_drain_info();
+
+        if (!info.load_valid || ps.descriptors.empty() || info.peak_ma == 0) { return 0; }
+        return ps.mw_max(ps.current_index, info.peak_mv * 1000 / info.peak_ma);
+    }
+
+private:
+    Io& io;
+
+    State state{State::Off};
+    bool is_apdo_updating{false};
+    bool is_from_caps_update{false};
+    uint32_t prev_apdo_mv{0};
+    uint32_t next_apdo_mv{0};
+    ProfileSelector::POWER_PLAN current_plan{};
+    ProfileSelector::POWER_PLAN next_plan{};
+    ProfileSelector::FEEDBACK_PARAMS last_feedback{};
+
+    void transition_to(State next) {
+        if (next == state) { return; }
+        enter(next);
+    }
+
+    void enter(State next) {
+        state = next;
+        io.on_state(state);
+
+        switch (state) {
+            case State::Off:
+                source_caps.clear();
+                ps.descriptors.clear();
+                ps.set_pdo_index(0);
+                io.pwm_enable(false);
+                io.drain_reset();
+                target_power_mw = 0;
+                break;
+
+            case State::Initializing:
+                io.clear_trigger_to(ps.default_position, ps.default_mv);
+                io.pwm_enable(false);
+                io.drain_reset();
+                target_power_mw = 0;
+                break;
+
+            case State::Calibrate:
+                if (io.get_drain_info().load_valid) {
+                    transition_to(State::Ready);
+                    return;
+                }
+                // Measure every period, to get load info ASAP
+                io.pwm_set(PwmScheduler::Modulation::Pwm, 0);
+                io.pwm_enable(true);
+                break;
+
+            case State::Ready:
+                // Reset lock for sure. Don't start PWM/Profile here, wait
+                // for SysTick to kick in. This will cause small delay on
+                // first entry, but that's acceptable.
+                is_apdo_updating = false;
+                prev_apdo_mv = 0;
+                break;
+
+            case State::WaitContractChange: {
+                // Turn load off
+                io.pwm_enable(false);
+
+                // Always re-evaluate best profile, because we can come here
+                // from different states (including unexpected src caps event).
+                auto plan = ps.plan_power(target_power_mw, last_feedback);
+                next_plan = plan;
+                if (!is_from_caps_update) {
+                    io.trigger_by_position(plan.profile_idx + 1, plan.mv);
+                } else {
+                    // If we react to capabilities update, set defaults without
+                    // triggering DPM flag. Because PE will ask selection itself.
+                    io.clear_trigger_to(plan.profile_idx + 1, plan.mv);
+                }
+                is_from_caps_update = false;
+                break;
+            }
+
+            case State::Fault:
+                source_caps.clear();
+                ps.descriptors.clear();
+                ps.set_pdo_index(0);
+                io.pwm_enable(false);
+                break;
+        }
+    }
+};
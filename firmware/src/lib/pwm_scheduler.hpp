@@ -0,0 +1,176 @@
+#pragma once
+
+#include <stdint.h>
+
+// Steps are generated in the timer ISR, which runs during flash writes on
+// target. Keep the ISR path in IRAM there.
+#if __has_include(<esp_attr.h>)
+#include <esp_attr.h>
+#define PWM_SCHEDULER_ISR IRAM_ATTR
+#else
+#define PWM_SCHEDULER_ISR
+#endif
+
+// Heater PWM timing, as a sequence of steps for a hardware timer alarm.
+//
+// Every period may start with a pulse. INA samples are taken over the pulse
+// tail: after the power stage settles, and early enough before the falling
+// edge to finish the I2C read with load still on. Duty is latched at period
+// start, so updates never cut or stretch a pulse in progress.
+//
+// Pulse can't be shorter than MIN_PULSE_US, so plain PWM delivers more than
+// requested at low duty. Sigma-delta mode carries the error across periods
+// and skips whole periods instead (1st order, error feedback). A pulse is
+// still forced every MAX_SKIP_PERIODS + 1 periods, to keep INA measurements
+// going.
+//
+// Time is in µs, platform-agnostic. Methods used by the ISR are marked
+// PWM_SCHEDULER_ISR, avoid code that may go to flash there (jump tables,
+// lookup tables).
+class PwmScheduler {
+public:
+    enum class Event : uint8_t {
+        PeriodStart,  // Load stays off, nothing to do
+        PulseStart,
+        Sample,
+        PulseEnd
+    };
+
+    enum class Modulation : uint8_t {
+        Pwm,
+        SigmaDelta
+    };
+
+    struct Step {
+        Event event;
+        uint32_t delay_us;  // Since the previous step
+        bool load_on;       // Switch state after this step
+    };
+
+    static constexpr uint32_t PERIOD_US = 100'000;
+    static constexpr uint32_t IDLE_GAP_US = 500'000;
+    static constexpr uint32_t MIN_PULSE_US = 6'000;
+    static constexpr uint32_t POWER_STABILIZATION_US = 4'000;
+    // INA full conversion cycle is ~0.7 ms, faster reads would repeat data
+    static constexpr uint32_t SAMPLE_INTERVAL_US = 1'000;
+    // Task wakeup + I2C transfer must fit before the falling edge
+    static constexpr uint32_t SAMPLE_GUARD_US = 1'000;
+    // Sigma-delta: max gap between pulses is the same as idle one
+    static constexpr uint32_t MAX_SKIP_PERIODS = 4;
+
+    static_assert(PERIOD_US % 1000 == 0, "Duty step must be a whole number of µs");
+    static_assert(MIN_PULSE_US >= POWER_STABILIZATION_US + SAMPLE_GUARD_US,
+        "MIN_PULSE_US must leave room for at least one INA sample");
+
+    // Duty is 0..1000
+    PWM_SCHEDULER_ISR void set_duty_x1000(uint32_t duty) { duty_x1000 = duty > 1000 ? 1000 : duty; }
+    PWM_SCHEDULER_ISR void reduce_idle_rate(bool reduce) { reduce_idle = reduce; }
+
+    PWM_SCHEDULER_ISR void set_modulation(Modulation m) {
+        if (m == modulation) { return; }
+        modulation = m;
+        error_us = 0;
+        skipped = 0;
+    }
+
+    // Next step starts a period without delay
+    void reset() {
+        phase = Phase::Boundary;
+        error_us = 0;
+        skipped = 0;
+    }
+
+    PWM_SCHEDULER_ISR auto next() -> Step {
+        switch (phase) {
+            case Phase::Boundary:
+                // Called at period start, latch duty now
+                plan_period();
+                if (!pulse_us) { return { Event::PeriodStart, gap_us, false }; }
+                phase = Phase::Pulse;
+                return { Event::PulseStart, 0, true };
+
+            case Phase::Gap:
+                phase = Phase::Boundary;
+                // Zero gap is full duty, next pulse follows without an edge
+                return { Event::PeriodStart, gap_us, false };
+
+            case Phase::Pulse:
+                break;
+        }
+
+        if (next_sample_us + SAMPLE_GUARD_US <= pulse_us) {
+            const uint32_t delay = next_sample_us - elapsed_us;
+            elapsed_us = next_sample_us;
+            next_sample_us += SAMPLE_INTERVAL_US;
+            return { Event::Sample, delay, true };
+        }
+
+        const uint32_t delay = pulse_us - elapsed_us;
+        phase = Phase::Gap;
+        return { Event::PulseEnd, delay, false };
+    }
+
+    // Current period plan, pulse is 0 for skipped period
+    auto get_pulse_us() const -> uint32_t { return pulse_us; }
+    auto get_gap_us() const -> uint32_t { return gap_us; }
+
+private:
+    enum class Phase : uint8_t {
+        Boundary,  // Next call is at period start
+        Pulse,
+        Gap
+    };
+
+    Phase phase{Phase::Boundary};
+    Modulation modulation{Modulation::Pwm};
+    uint32_t duty_x1000{0};
+    bool reduce_idle{true};
+
+    uint32_t pulse_us{0};
+    uint32_t gap_us{0};
+    uint32_t elapsed_us{0};      // Since pulse start
+    uint32_t next_sample_us{0};  // Since pulse start
+
+    // Sigma-delta state. Error is kept within ±MIN_PULSE_US / 2, forced
+    // pulses below that are not paid back.
+    int32_t error_us{0};
+    uint32_t skipped{0};
+
+    PWM_SCHEDULER_ISR void plan_period() {
+        elapsed_us = 0;
+        next_sample_us = POWER_STABILIZATION_US;
+
+        if (duty_x1000 == 0 && reduce_idle) {
+            pulse_us = MIN_PULSE_US;
+            gap_us = IDLE_GAP_US;
+            error_us = 0;
+            skipped = 0;
+            return;
+        }
+
+        const int32_t desired = static_cast<int32_t>(duty_x1000 * (PERIOD_US / 1000));
+
+        if (modulation == Modulation::Pwm) {
+            pulse_us = clamp_pulse(desired);
+        } else {
+            const int32_t target = desired + error_us;
+            if (target >= static_cast<int32_t>(MIN_PULSE_US / 2) || skipped >= MAX_SKIP_PERIODS) {
+                pulse_us = clamp_pulse(target);
+                skipped = 0;
+            } else {
+                pulse_us = 0;
+                skipped++;
+            }
+            constexpr int32_t max_error = MIN_PULSE_US / 2;
+            const int32_t error = target - static_cast<int32_t>(pulse_us);
+            error_us = error > max_error ? max_error : (error < -max_error ? -max_error : error);
+        }
+        gap_us = PERIOD_US - pulse_us;
+    }
+
+    PWM_SCHEDULER_ISR static auto clamp_pulse(int32_t us) -> uint32_t {
+        if (us < static_cast<int32_t>(MIN_PULSE_US)) { return MIN_PULSE_US; }
+        if (us > static_cast<int32_t>(PERIOD_US)) { return PERIOD_US; }
+        return static_cast<uint32_t>(us);
+    }
+};
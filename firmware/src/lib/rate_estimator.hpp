@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Temperature rate of change, least squares line over the last WINDOW
+// samples (1st order Savitzky–Golay, but with real timestamps, so tick jitter
+// and skipped samples don't bias the slope).
+//
+// Besides the slope, reports residual of the newest sample vs the fitted
+// line. Real temperature can't jump, so a big residual means sensor glitch.
+//
+// Fixed point: input is °C x10 with ms timestamps, rate is °C/s x100. Input
+// range and gaps between samples are limited, so sums always fit int64.
+// Platform-agnostic.
+template <size_t WINDOW>
+class RateEstimator {
+public:
+    static_assert(WINDOW >= 3, "Window too small");
+    // Fit is meaningless with too few points
+    static constexpr size_t MIN_SAMPLES = WINDOW / 2 > 3 ? WINDOW / 2 : 3;
+    // Longer gap means stale sensor, old samples are dropped
+    static constexpr uint32_t MAX_GAP_MS = 1000;
+    static constexpr int32_t MAX_VALUE_X10 = 1000 * 10;
+
+    void reset() {
+        count = 0;
+        pos = 0;
+        rate_x100 = 0;
+        residual_x10 = 0;
+    }
+
+    void push(uint32_t timestamp_ms, int32_t value_x10) {
+        // Same measurement, re-read by a faster consumer
+        if (count && timestamp_ms == timestamps[last_idx()]) { return; }
+        if (count && timestamp_ms - timestamps[last_idx()] > MAX_GAP_MS) { reset(); }
+
+        if (value_x10 > MAX_VALUE_X10) { value_x10 = MAX_VALUE_X10; }
+        if (value_x10 < -MAX_VALUE_X10) { value_x10 = -MAX_VALUE_X10; }
+
+        timestamps[pos] = timestamp_ms;
+        values[pos] = value_x10;
+        pos = (pos + 1) % WINDOW;
+        if (count < WINDOW) { count++; }
+
+        fit(timestamp_ms, value_x10);
+    }
+
+    auto is_valid() const -> bool { return count >= MIN_SAMPLES; }
+    // °C/s x100, 0 until enough samples
+    auto get_rate_x100() const -> int32_t { return rate_x100; }
+    // Newest sample minus fitted line at its time, °C x10
+    auto get_residual_x10() const -> int32_t { return residual_x10; }
+
+private:
+    uint32_t timestamps[WINDOW]{};
+    int32_t values[WINDOW]{};
+    size_t pos{0};
+    size_t count{0};
+    int32_t rate_x100{0};
+    int32_t residual_x10{0};
+
+    auto last_idx() const -> size_t { return (pos + WINDOW - 1) % WINDOW; }
+
+    void fit(uint32_t now_ms, int32_t now_x10) {
+        if (!is_valid()) {
+            rate_x100 = 0;
+            residual_x10 = 0;
+            return;
+        }
+
+        // Time is relative to the newest sample (t <= 0), values relative to
+        // it too. Keeps sums small, fitted line value at t = 0 is intercept.
+        int64_t st = 0, sy = 0, stt = 0, sty = 0;
+        for (size_t i = 0; i < count; i++) {
+            const int64_t t = -static_cast<int64_t>(now_ms - timestamps[i]);
+            const int64_t y = values[i] - now_x10;
+            st += t;
+            sy += y;
+            stt += t * t;
+            sty += t * y;
+        }
+
+        const int64_t n = static_cast<int64_t>(count);
+        const int64_t num = n * sty - st * sy;
+        const int64_t den = n * stt - st * st;
+        if (den <= 0) { return; }
+
+        // x10 °C per ms -> x100 °C per s
+        rate_x100 = static_cast<int32_t>(div_round(num * 10'000, den));
+        // Intercept is (sy - slope·st) / n, residual is 0 - intercept
+        residual_x10 = static_cast<int32_t>(-div_round(sy * den - num * st, n * den));
+    }
+
+    static auto div_round(int64_t a, int64_t b) -> int64_t {
+        return (a >= 0 ? a + b / 2 : a - b / 2) / b;
+    }
+};
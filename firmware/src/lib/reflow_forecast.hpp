@@ -0,0 +1,180 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <etl/algorithm.h>
+#include <etl/vector.h>
+
+#include "lib/adrc.hpp"
+#include "lib/timeline.hpp"
+#include "proto/generated/shared_constants.hpp"
+#include "proto/generated/types.pb.h"
+
+// Forward simulation of reflow profile, to check feasibility before start.
+//
+// Runs the same Timeline and ADRC as firmware against first order head model,
+// derived from ADRC params (b0 = K/τ, τ = response):
+//
+//   dT/dt = b0 * P - (T - T_ambient) / τ
+//
+// Power is limited by PD envelope at the load resistance, which follows
+// temperature via heater TCR. Envelope comes from overridable hook, to keep
+// this class platform-agnostic.
+class ReflowForecast {
+public:
+    // Keep in sync with HeaterControl tick
+    static constexpr int32_t TICK_MS = 50;
+    // Steps budget, to keep run time bounded on long profiles: tick is
+    // increased if needed, but not above observer stability margin.
+    static constexpr int32_t MAX_STEPS = 10'000;
+    static constexpr int32_t MAX_TICK_MS = 250;
+    // Envelope changes slowly, no need to update it every tick
+    static constexpr int32_t ENVELOPE_UPDATE_MS = 1000;
+
+    // Tolerance for "feasible" verdict
+    static constexpr int32_t MAX_LAG_X10 = 5 * 10;
+    static constexpr int32_t MAX_PEAK_DEVIATION_X10 = 5 * 10;
+
+    struct Config {
+        float adrc_b0;
+        float adrc_response;
+        float adrc_n_coeff;
+        float adrc_m_coeff;
+        float start_temperature;
+        float ambient_temperature;
+        // Measured load and temperature it was measured at
+        uint32_t load_mohms;
+        float load_temperature;
+        // Relative resistance change per °C (copper ~0.00393)
+        float tcr;
+        float liquidus;
+        int32_t accel_max_x100;  // Trajectory shaping, see Timeline::load()
+    };
+
+    struct SegmentRate {
+        int32_t requested_x100;  // °C/s * 100
+        int32_t achieved_x100;
+    };
+
+    struct Result {
+        bool feasible{false};
+        uint32_t eta_s{0};             // Profile duration, reflow stops at the end
+        uint32_t energy_j{0};
+        int32_t peak_x10{0};           // Predicted peak temperature
+        int32_t peak_deviation_x10{0}; // Predicted - profile peak
+        uint32_t tal_s{0};             // Predicted time above liquidus
+        int32_t tal_deviation_s{0};    // Predicted - profile TAL
+        int32_t max_lag_x10{0};        // Worst (setpoint - temperature)
+        etl::vector<SegmentRate, SharedConstants::MAX_REFLOW_SEGMENTS> segments{};
+    };
+
+    virtual ~ReflowForecast() = default;
+
+    // Max available power at given load, in mW.
+    virtual auto get_max_power_mw(uint32_t load_mohms) -> uint32_t = 0;
+
+    auto run(const Profile& profile, const Config& cfg) -> Result {
+        Result result{};
+
+        Timeline timeline{};
+        timeline.load(profile, cfg.accel_max_x100);
+        const int32_t max_time_ms = timeline.get_max_time_x1000();
+        result.eta_s = static_cast<uint32_t>(max_time_ms / 1000);
+        if (max_time_ms <= 0 || cfg.adrc_response <= 0 || cfg.adrc_b0 <= 0) { return result; }
+
+        const int32_t tick_ms = etl::clamp(max_time_ms / MAX_STEPS + 1, TICK_MS, MAX_TICK_MS);
+        const float dt = static_cast<float>(tick_ms) * 0.001f;
+        const float tau_inv = 1.0f / cfg.adrc_response;
+
+        ADRC adrc{};
+        adrc.set_params(cfg.adrc_b0, cfg.adrc_response, cfg.adrc_n_coeff, cfg.adrc_m_coeff);
+        adrc.reset_to(cfg.start_temperature);
+
+        float temperature = cfg.start_temperature;
+        float energy = 0;
+        float max_power = 0;
+        float peak = temperature;
+        int32_t profile_peak_x100 = 0;
+        int32_t tal_ms = 0;
+        int32_t profile_tal_ms = 0;
+        int32_t next_envelope_ms = 0;
+        const auto liquidus_x100 = static_cast<int32_t>(cfg.liquidus * 100);
+
+        // Segment ends, to measure achieved rates
+        etl::vector<int32_t, SharedConstants::MAX_REFLOW_SEGMENTS> segment_ends{};
+        for (size_t i = 0, end = 0; i < profile.segments_count && !segment_ends.full(); i++) {
+            end += static_cast<size_t>(etl::max(profile.segments[i].duration, int32_t{0})) * 1000;
+            segment_ends.push_back(static_cast<int32_t>(end));
+        }
+        size_t segment_idx = 0;
+        float segment_start_temperature = temperature;
+
+        for (int32_t t = 0; t <= max_time_ms; t += tick_ms) {
+            while (segment_idx < segment_ends.size() && t >= segment_ends[segment_idx]) {
+                close_segment(result, profile, segment_idx, segment_start_temperature, temperature);
+                segment_start_temperature = temperature;
+                segment_idx++;
+            }
+
+            const int32_t target_x100 = timeline.get_target_x100(t);
+            const int32_t rate_x100 = timeline.get_rate_x100(t);
+
+            if (t >= next_envelope_ms) {
+                max_power = static_cast<float>(get_max_power_mw(load_at(cfg, temperature))) * 0.001f;
+                next_envelope_ms = t + ENVELOPE_UPDATE_MS;
+            }
+
+            const float power = adrc.iterate(temperature, static_cast<float>(target_x100) * 0.01f,
+                max_power, dt, static_cast<float>(rate_x100) * 0.01f);
+
+            temperature += dt * (cfg.adrc_b0 * power - (temperature - cfg.ambient_temperature) * tau_inv);
+            energy += power * dt;
+
+            // Stats
+            peak = etl::max(peak, temperature);
+            profile_peak_x100 = etl::max(profile_peak_x100, target_x100);
+            if (temperature > cfg.liquidus) { tal_ms += tick_ms; }
+            if (target_x100 > liquidus_x100) { profile_tal_ms += tick_ms; }
+
+            const auto lag_x10 = static_cast<int32_t>((static_cast<float>(target_x100) * 0.01f - temperature) * 10);
+            result.max_lag_x10 = etl::max(result.max_lag_x10, lag_x10);
+        }
+
+        for (; segment_idx < segment_ends.size(); segment_idx++) {
+            close_segment(result, profile, segment_idx, segment_start_temperature, temperature);
+            segment_start_temperature = temperature;
+        }
+
+        result.energy_j = static_cast<uint32_t>(energy);
+        result.peak_x10 = static_cast<int32_t>(peak * 10);
+        result.peak_deviation_x10 = result.peak_x10 - profile_peak_x100 / 10;
+        result.tal_s = static_cast<uint32_t>(tal_ms / 1000);
+        result.tal_deviation_s = (tal_ms - profile_tal_ms) / 1000;
+
+        result.feasible = result.max_lag_x10 <= MAX_LAG_X10 &&
+            result.peak_deviation_x10 <= MAX_PEAK_DEVIATION_X10 &&
+            result.peak_deviation_x10 >= -MAX_PEAK_DEVIATION_X10;
+
+        return result;
+    }
+
+private:
+    static auto load_at(const Config& cfg, float temperature) -> uint32_t {
+        const float k = 1.0f + cfg.tcr * (temperature - cfg.load_temperature);
+        return static_cast<uint32_t>(static_cast<float>(cfg.load_mohms) * etl::max(k, 0.1f));
+    }
+
+    static void close_segment(Result& result, const Profile& profile, size_t idx, float t_start, float t_end) {
+        const auto& s = profile.segments[idx];
+        const int32_t prev_target_x100 = idx == 0
+            ? SharedConstants::START_TEMPERATURE * 100
+            : profile.segments[idx - 1].target * 100;
+
+        SegmentRate rate{0, 0};
+        if (s.duration > 0) {
+            rate.requested_x100 = (s.target * 100 - prev_target_x100) / s.duration;
+            rate.achieved_x100 = static_cast<int32_t>((t_end - t_start) * 100 / static_cast<float>(s.duration));
+        }
+        result.segments.push_back(rate);
+    }
+};
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+#include <etl/algorithm.h>
+
+// Streaming reflow quality metrics (peak, time above liquidus, soak, ramp
+// rates), for both actual temperature and setpoint. Fed from control loop,
+// O(1) memory and work per tick.
+//
+// Setpoint stats give "what profile expected", to check actual values against
+// without parsing the profile itself.
+class ReflowMetrics {
+public:
+    // Ramp rate is measured as temperature difference over this window,
+    // sampled once per second. Short enough to catch local spikes, long
+    // enough to suppress sensor noise.
+    static constexpr uint32_t RAMP_WINDOW_S = 4;
+    static constexpr uint32_t RAMP_SAMPLE_MS = 1000;
+
+    static constexpr int32_t LIQUIDUS_DEFAULT_X10 = 217 * 10;  // SAC305
+
+    struct Config {
+        int32_t liquidus_x10;
+        // Soak (preheat plateau) band
+        int32_t soak_from_x10;
+        int32_t soak_to_x10;
+        // Tolerances
+        int32_t peak_tolerance_x10;   // |peak - profile peak|
+        int32_t tal_tolerance_s;      // |TAL - profile TAL|
+        int32_t ramp_up_max_x100;     // °C/s * 100
+        int32_t ramp_down_max_x100;   // Cooling, positive value
+    };
+
+    // J-STD-020 like limits
+    static auto default_config(int32_t liquidus_x10 = LIQUIDUS_DEFAULT_X10) -> Config {
+        return {
+            .liquidus_x10 = liquidus_x10,
+            .soak_from_x10 = 150 * 10,
+            .soak_to_x10 = 200 * 10,
+            .peak_tolerance_x10 = 5 * 10,
+            .tal_tolerance_s = 15,
+            .ramp_up_max_x100 = 3 * 100,
+            .ramp_down_max_x100 = 6 * 100
+        };
+    }
+
+    enum Failure : uint32_t {
+        FAIL_NONE = 0,
+        FAIL_NOT_COMPLETED = 1 << 0,
+        FAIL_PEAK = 1 << 1,
+        FAIL_TAL = 1 << 2,
+        FAIL_RAMP_UP = 1 << 3,
+        FAIL_RAMP_DOWN = 1 << 4
+    };
+
+    struct Result {
+        bool passed{false};
+        uint32_t failures{FAIL_NONE};
+        uint32_t duration_ms{0};
+        int32_t liquidus_x10{0};
+        int32_t peak_x10{0};
+        int32_t profile_peak_x10{0};
+        uint32_t tal_ms{0};           // Time above liquidus
+        uint32_t profile_tal_ms{0};
+        uint32_t soak_ms{0};          // Time in soak band, before first liquidus crossing
+        uint32_t profile_soak_ms{0};
+        int32_t ramp_up_max_x100{0};
+        int32_t ramp_down_max_x100{0};  // Positive value
+        int32_t max_lag_x10{0};         // Worst (setpoint - temperature)
+        int32_t max_overshoot_x10{0};   // Worst (temperature - setpoint)
+    };
+
+    void start(const Config& config) {
+        cfg = config;
+        acc = Result{};
+        acc.liquidus_x10 = cfg.liquidus_x10;
+        acc.peak_x10 = INT32_MIN;
+        acc.profile_peak_x10 = INT32_MIN;
+        reflowed = false;
+        profile_reflowed = false;
+        ramp_count = 0;
+        ramp_head = 0;
+        sample_elapsed_ms = RAMP_SAMPLE_MS;  // Take first sample immediately
+    }
+
+    void push(uint32_t dt_ms, float temperature, float setpoint) {
+        const auto t_x10 = static_cast<int32_t>(lroundf(temperature * 10));
+        const auto sp_x10 = static_cast<int32_t>(lroundf(setpoint * 10));
+
+        acc.duration_ms += dt_ms;
+
+        acc.peak_x10 = etl::max(acc.peak_x10, t_x10);
+        acc.profile_peak_x10 = etl::max(acc.profile_peak_x10, sp_x10);
+
+        if (t_x10 > cfg.liquidus_x10) { acc.tal_ms += dt_ms; reflowed = true; }
+        if (sp_x10 > cfg.liquidus_x10) { acc.profile_tal_ms += dt_ms; profile_reflowed = true; }
+
+        if (!reflowed && in_soak(t_x10)) { acc.soak_ms += dt_ms; }
+        if (!profile_reflowed && in_soak(sp_x10)) { acc.profile_soak_ms += dt_ms; }
+
+        acc.max_lag_x10 = etl::max(acc.max_lag_x10, sp_x10 - t_x10);
+        acc.max_overshoot_x10 = etl::max(acc.max_overshoot_x10, t_x10 - sp_x10);
+
+        sample_elapsed_ms += dt_ms;
+        if (sample_elapsed_ms >= RAMP_SAMPLE_MS) {
+            sample_elapsed_ms -= RAMP_SAMPLE_MS;
+            push_ramp_sample(t_x10);
+        }
+    }
+
+    // Metrics with verdict. `completed` - profile was executed to the end.
+    auto get_result(bool completed) const -> Result {
+        Result r = acc;
+        if (r.peak_x10 == INT32_MIN) { r.peak_x10 = 0; }
+        if (r.profile_peak_x10 == INT32_MIN) { r.profile_peak_x10 = 0; }
+
+        uint32_t f = FAIL_NONE;
+        if (!completed) { f |= FAIL_NOT_COMPLETED; }
+        if (iabs(r.peak_x10 - r.profile_peak_x10) > cfg.peak_tolerance_x10) { f |= FAIL_PEAK; }
+        // TAL is checked only if profile reaches liquidus at all
+        if (r.profile_tal_ms > 0) {
+            const int32_t tal_diff_s = (static_cast<int32_t>(r.tal_ms) - static_cast<int32_t>(r.profile_tal_ms)) / 1000;
+            if (iabs(tal_diff_s) > cfg.tal_tolerance_s) { f |= FAIL_TAL; }
+        }
+        if (r.ramp_up_max_x100 > cfg.ramp_up_max_x100) { f |= FAIL_RAMP_UP; }
+        if (r.ramp_down_max_x100 > cfg.ramp_down_max_x100) { f |= FAIL_RAMP_DOWN; }
+
+        r.failures = f;
+        r.passed = f == FAIL_NONE;
+        return r;
+    }
+
+private:
+    Config cfg{default_config()};
+    Result acc{};
+    bool reflowed{false};
+    bool profile_reflowed{false};
+
+    // Ramp window ring, RAMP_WINDOW_S + 1 samples
+    int32_t ramp_samples[RAMP_WINDOW_S + 1]{};
+    uint32_t ramp_count{0};
+    uint32_t ramp_head{0};
+    uint32_t sample_elapsed_ms{0};
+
+    static auto iabs(int32_t v) -> int32_t { return v < 0 ? -v : v; }
+
+    auto in_soak(int32_t t_x10) const -> bool {
+        return t_x10 >= cfg.soak_from_x10 && t_x10 <= cfg.soak_to_x10;
+    }
+
+    void push_ramp_sample(int32_t t_x10) {
+        static constexpr uint32_t SIZE = RAMP_WINDOW_S + 1;
+
+        ramp_samples[ramp_head] = t_x10;
+        ramp_head = (ramp_head + 1) % SIZE;
+        if (ramp_count < SIZE) { ramp_count++; }
+        if (ramp_count < SIZE) { return; }
+
+        // Oldest sample is at head now
+        const int32_t diff_x10 = t_x10 - ramp_samples[ramp_head];
+        const int32_t rate_x100 = diff_x10 * 10 / static_cast<int32_t>(RAMP_WINDOW_S);
+
+        acc.ramp_up_max_x100 = etl::max(acc.ramp_up_max_x100, rate_x100);
+        acc.ramp_down_max_x100 = etl::max(acc.ramp_down_max_x100, -rate_x100);
+    }
+};
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <etl/algorithm.h>
+
+// Relay feedback identification (Åström–Hägglund experiment).
+//
+// Power is switched between two levels with hysteresis around setpoint, so
+// the head settles into a limit cycle a few degrees wide. Classic describing
+// function analysis underestimates τ by ~20% for slow heads (square wave
+// harmonics), so params are taken from cycle shape instead:
+//
+// - Near setpoint, heat loss is almost constant, so rise and fall rates differ
+//   only by b0·(u_high - u_low):  b0 = (s_up - s_down) / (u_high - u_low)
+// - Static gain from cycle averages: K = (mean T - ambient) / mean u
+// - τ = K / b0
+// - Peak overshoots switching point by s_up·L, that gives dead time L.
+//
+// Platform-agnostic, caller supplies time step and temperature.
+class RelayTune {
+public:
+    // First cycles are skipped (heat-up transient), next ones are averaged.
+    static constexpr uint32_t WARMUP_CYCLES = 1;
+    static constexpr uint32_t MEASURE_CYCLES = 3;
+
+    struct Config {
+        float setpoint;
+        float hysteresis;   // ε, °C
+        float power_high;   // W
+        float power_low;    // W
+        float ambient;      // °C, for static gain
+    };
+
+    struct Result {
+        float period;       // Tu, s
+        float amplitude;    // a, °C (half of peak-to-peak)
+        float gain;         // K, °C/W
+        float tau;          // s
+        float delay;        // L, s
+        float b0;           // K/τ
+    };
+
+    enum class Status : uint8_t { Running, Done, Failed };
+
+    void start(const Config& config) {
+        cfg = config;
+        status = Status::Running;
+        relay_high = true;
+        cycles = 0;
+        measured = 0;
+        cycle = Accumulator{};
+        total = Accumulator{};
+        amplitude_sum = 0;
+        rate_up_sum = 0;
+        rate_down_sum = 0;
+        overshoot_sum = 0;
+        result = Result{};
+    }
+
+    // `dt` - time since previous call, s. Returns power to apply.
+    auto update(float dt, float temperature) -> float {
+        if (status != Status::Running) { return cfg.power_low; }
+
+        const float power = relay_high ? cfg.power_high : cfg.power_low;
+        cycle.add(dt, temperature, power);
+
+        if (relay_high && temperature > cfg.setpoint + cfg.hysteresis) {
+            relay_high = false;
+        } else if (!relay_high && temperature < cfg.setpoint - cfg.hysteresis) {
+            // Cycle boundary is low -> high switch
+            relay_high = true;
+            complete_cycle();
+        }
+
+        return relay_high ? cfg.power_high : cfg.power_low;
+    }
+
+    auto get_status() const -> Status { return status; }
+    auto get_result() const -> const Result& { return result; }
+    auto get_cycles() const -> uint32_t { return cycles; }
+
+private:
+    struct Accumulator {
+        float time{0};
+        float t_integral{0};
+        float u_integral{0};
+        float t_min{1e6f};
+        float t_max{-1e6f};
+        float t_min_at{0};
+        float t_max_at{0};
+
+        void add(float dt, float temperature, float power) {
+            time += dt;
+            t_integral += temperature * dt;
+            u_integral += power * dt;
+            if (temperature < t_min) { t_min = temperature; t_min_at = time; }
+            if (temperature > t_max) { t_max = temperature; t_max_at = time; }
+        }
+    };
+
+    Config cfg{};
+    Status status{Status::Failed};
+    Result result{};
+    bool relay_high{true};
+    uint32_t cycles{0};
+    uint32_t measured{0};
+    Accumulator cycle{};
+    Accumulator total{};
+    float amplitude_sum{0};
+    float rate_up_sum{0};
+    float rate_down_sum{0};
+    float overshoot_sum{0};
+
+    void complete_cycle() {
+        // The first boundary closes heat-up, not a full cycle
+        if (cycles++ > WARMUP_CYCLES) {
+            total.time += cycle.time;
+            total.t_integral += cycle.t_integral;
+            total.u_integral += cycle.u_integral;
+            // Cycle starts at low -> high switch, so temperature still falls
+            // for L, then rises to max, then falls till cycle end.
+            const float swing = cycle.t_max - cycle.t_min;
+            const float rise_time = cycle.t_max_at - cycle.t_min_at;
+            const float fall_time = cycle.time - rise_time;
+            if (rise_time <= 0 || fall_time <= 0) {
+                status = Status::Failed;
+                return;
+            }
+            amplitude_sum += swing * 0.5f;
+            rate_up_sum += swing / rise_time;
+            rate_down_sum += swing / fall_time;
+            overshoot_sum += cycle.t_max - (cfg.setpoint + cfg.hysteresis);
+            measured++;
+        }
+        cycle = Accumulator{};
+
+        if (measured >= MEASURE_CYCLES) { status = calculate() ? Status::Done : Status::Failed; }
+    }
+
+    auto calculate() -> bool {
+        const auto n = static_cast<float>(measured);
+        const float du = cfg.power_high - cfg.power_low;
+
+        if (total.time <= 0 || du <= 0 || total.u_integral <= 0) { return false; }
+
+        const float mean_t = total.t_integral / total.time;
+        const float mean_u = total.u_integral / total.time;
+        const float K = (mean_t - cfg.ambient) / mean_u;
+
+        const float rate_up = rate_up_sum / n;
+        const float rate_down = rate_down_sum / n;
+        const float b0 = (rate_up + rate_down) / du;
+        if (K <= 0 || b0 <= 0) { return false; }
+
+        result = {
+            .period = total.time / n,
+            .amplitude = amplitude_sum / n,
+            .gain = K,
+            .tau = K / b0,
+            .delay = etl::max(overshoot_sum / n / rate_up, 0.0f),
+            .b0 = b0
+        };
+        return true;
+    }
+};
@@ -0,0 +1,684 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <etl/atomic.h>
+
+#include "lib/ina_filter.hpp"
+#include "proto/generated/shared_constants.hpp"
+
+// Compact binary trace of raw measurement inputs, for deterministic replay of
+// the signal processing chain on host.
+//
+// Stream is a sequence of records:
+//
+//   [type: u8] [dt_ms: varint] [payload]
+//
+// - dt_ms is the delta from the previous record timestamp. The Start record
+//   carries an absolute u32 timestamp and resets the base.
+// - Multibyte fixed fields are little-endian, floats are IEEE754 bit patterns.
+// - If the buffer overflows, records are dropped, and a Gap record with the
+//   dropped count is emitted before the next stored one.
+// - State that can't be rebuilt from the stream (filters running before
+//   recording started) is written by its owners after Start. Record is
+//   applied as is, replay continues from it.
+class SampleTrace {
+public:
+    static constexpr uint8_t VERSION = 1;
+
+    enum class RecordType : uint8_t {
+        Start = 1,      // u8 version, u8 INA chip, u32 absolute ts
+        Gap,            // varint dropped records count
+        AdcLut,         // u8 count, count x (u16 raw, u16 mV)
+        SensorConfig,   // u8 is_tcr, 8 x f32, u8 tcr_count, tcr_count x (f32 at, f32 value)
+        AdcCic,         // u8 count, count x zigzag varint delta from previous (first from 0),
+                        // ADC decimation filter CIC stage outputs
+        SensorUpdate,   // - (Head converts last ADC value to sensor uV)
+        InaSample,      // u16 v_raw, u16 i_raw, varint ctx_idx
+        PwmEdge,        // u8 PwmEvent
+        DrainReset,     // - (DrainTracker measurements dropped)
+        ControlReset,   // - (ADRC reset to current temperature)
+        ControlTick,    // varint dt_ms, zigzag temperature_x10, 4 x f32, varint temperature_age_ms
+        ThermalTick,    // varint dt_ms, varint power_mw (TCR estimator prediction step)
+        DrainInfo,      // varint peak_mv, varint peak_ma, u8 load_valid, varint ctx_idx,
+                        // varint samples, varint seq, u32 timestamp_ms
+        AdcState,       // u8 valid, varint output_x100, varint phase, varint pos, varint warmup,
+                        // u8 taps, taps x zigzag varint delta (ADC decimation filter FIR stage)
+        TcrState        // u8 valid, u32 x_q, u32 p_q, varint seq (TCR estimator)
+    };
+
+    enum class PwmEvent : uint8_t {
+        PulseStart,     // Load on, INA samples cleared
+        PulseEnd,       // Pulse finished naturally, INA samples processed
+        Off             // PWM disabled, samples dropped
+    };
+
+    struct SensorConfig {
+        bool is_tcr;
+        float p0_at;
+        float p0_value;
+        float p1_at;
+        float p1_value;
+        float adrc_response;
+        float adrc_b0;
+        float adrc_n_coeff;
+        float adrc_m_coeff;
+        // Multi-point TCR calibration, overrides p0/p1 when 2+ points
+        uint8_t tcr_count;
+        float tcr_at[SharedConstants::MAX_TCR_CAL_POINTS];
+        float tcr_value[SharedConstants::MAX_TCR_CAL_POINTS];
+    };
+
+    struct ControlTick {
+        uint32_t dt_ms;
+        int32_t temperature_x10;  // Value seen by the controller
+        float setpoint;
+        float setpoint_rate;
+        float power_max;
+        float power_out;          // Controller output, for verification
+        uint32_t temperature_age_ms;  // Compensated by controller
+    };
+
+    struct ThermalTick {
+        uint32_t dt_ms;
+        uint32_t power_mw;        // Power delivered to heater (V·I·duty)
+    };
+
+    // DecimationFilter FIR stage, line values come separately
+    struct AdcState {
+        bool valid;               // Filter produced output
+        uint32_t output_x100;
+        uint32_t phase;
+        uint32_t pos;
+        uint32_t warmup;
+    };
+
+    struct TcrState {
+        bool valid;
+        int32_t x_q;              // TcrKalman state, as is
+        uint32_t p_q;
+        uint32_t seq;             // Last fused DrainInfo seq
+    };
+
+    static constexpr size_t MAX_HEAD_SIZE = 1 + 5;
+    static constexpr size_t MAX_LUT_POINTS = 255;
+    static constexpr size_t MAX_ADC_VALUES = 255;
+    // CIC outputs per record, caller should flush batches not bigger
+    static constexpr size_t MAX_CIC_BATCH = 16;
+
+    // Encoding helpers
+
+    static auto put_u8(uint8_t* p, uint8_t v) -> size_t { p[0] = v; return 1; }
+
+    static auto put_u16(uint8_t* p, uint16_t v) -> size_t {
+        p[0] = static_cast<uint8_t>(v & 0xFF);
+        p[1] = static_cast<uint8_t>(v >> 8);
+        return 2;
+    }
+
+    static auto put_u32(uint8_t* p, uint32_t v) -> size_t {
+        for (size_t i = 0; i < 4; i++) { p[i] = static_cast<uint8_t>(v >> (i * 8)); }
+        return 4;
+    }
+
+    static auto put_f32(uint8_t* p, float v) -> size_t {
+        uint32_t bits;
+        memcpy(&bits, &v, sizeof(bits));
+        return put_u32(p, bits);
+    }
+
+    static auto put_varint(uint8_t* p, uint32_t v) -> size_t {
+        size_t n = 0;
+        while (v >= 0x80) {
+            p[n++] = static_cast<uint8_t>(v | 0x80);
+            v >>= 7;
+        }
+        p[n++] = static_cast<uint8_t>(v);
+        return n;
+    }
+
+    static auto zigzag(int32_t v) -> uint32_t {
+        return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+    }
+
+    static auto unzigzag(uint32_t v) -> int32_t {
+        return static_cast<int32_t>(v >> 1) ^ -static_cast<int32_t>(v & 1);
+    }
+
+    // Neighbour ADC values are close. Modular math, any int32 sequence is
+    // restored exactly.
+    static auto put_deltas(uint8_t* p, const int32_t* values, size_t count) -> size_t {
+        size_t n = 0;
+        uint32_t prev = 0;
+        for (size_t i = 0; i < count; i++) {
+            const auto v = static_cast<uint32_t>(values[i]);
+            n += put_varint(p + n, zigzag(static_cast<int32_t>(v - prev)));
+            prev = v;
+        }
+        return n;
+    }
+};
+
+
+// Fixed-size ring of encoded records. Writers can be called from ISR, so
+// platform-specific code must provide a lock suitable for that context.
+template <size_t BufferSize>
+class SampleTraceWriter : public SampleTrace {
+public:
+    static_assert(BufferSize > 512, "Buffer must fit at least the ADC LUT record");
+
+    virtual ~SampleTraceWriter() = default;
+
+    virtual void lock() {}
+    virtual void unlock() {}
+    virtual auto now_ms() -> uint32_t = 0;
+
+    auto is_enabled() const -> bool { return enabled.load(); }
+
+    void start(uint8_t ina_chip) {
+        lock();
+        epoch++;
+        head = 0;
+        tail = 0;
+        used = 0;
+        dropped = 0;
+        last_ts = now_ms();
+
+        uint8_t payload[6];
+        size_t n = 0;
+        n += put_u8(payload + n, VERSION);
+        n += put_u8(payload + n, ina_chip);
+        n += put_u32(payload + n, last_ts);
+        write_unlocked(RecordType::Start, payload, n);
+        pulse_recorded.store(false);
+        unlock();
+
+        enabled.store(true);
+    }
+
+    void stop() { enabled.store(false); }
+
+    // False until a pulse start is recorded. INA samples of a pulse started
+    // before are incomplete, the owner should record the result instead.
+    auto is_pulse_recorded() const -> bool { return pulse_recorded.load(); }
+
+    template <typename Points>
+    void adc_lut(const Points& points) {
+        if (!is_enabled()) { return; }
+
+        uint8_t payload[1 + MAX_LUT_POINTS * 4];
+        const size_t count = points.size() < MAX_LUT_POINTS ? points.size() : MAX_LUT_POINTS;
+        size_t n = put_u8(payload, static_cast<uint8_t>(count));
+        for (size_t i = 0; i < count; i++) {
+            n += put_u16(payload + n, points[i].raw);
+            n += put_u16(payload + n, points[i].mV);
+        }
+        write(RecordType::AdcLut, payload, n);
+    }
+
+    void sensor_config(const SensorConfig& cfg) {
+        if (!is_enabled()) { return; }
+
+        uint8_t payload[1 + 8 * 4 + 1 + SharedConstants::MAX_TCR_CAL_POINTS * 8];
+        size_t n = put_u8(payload, cfg.is_tcr ? 1 : 0);
+        n += put_f32(payload + n, cfg.p0_at);
+        n += put_f32(payload + n, cfg.p0_value);
+        n += put_f32(payload + n, cfg.p1_at);
+        n += put_f32(payload + n, cfg.p1_value);
+        n += put_f32(payload + n, cfg.adrc_response);
+        n += put_f32(payload + n, cfg.adrc_b0);
+        n += put_f32(payload + n, cfg.adrc_n_coeff);
+        n += put_f32(payload + n, cfg.adrc_m_coeff);
+
+        const uint8_t tcr_count = cfg.tcr_count < SharedConstants::MAX_TCR_CAL_POINTS
+            ? cfg.tcr_count : SharedConstants::MAX_TCR_CAL_POINTS;
+        n += put_u8(payload + n, tcr_count);
+        for (size_t i = 0; i < tcr_count; i++) {
+            n += put_f32(payload + n, cfg.tcr_at[i]);
+            n += put_f32(payload + n, cfg.tcr_value[i]);
+        }
+        write(RecordType::SensorConfig, payload, n);
+    }
+
+    void adc_cic(const int32_t* values, size_t count) {
+        if (!is_enabled()) { return; }
+
+        uint8_t payload[1 + MAX_CIC_BATCH * 5];
+        if (count > MAX_CIC_BATCH) { count = MAX_CIC_BATCH; }
+        size_t n = put_u8(payload, static_cast<uint8_t>(count));
+        n += put_deltas(payload + n, values, count);
+        write(RecordType::AdcCic, payload, n);
+    }
+
+    void sensor_update() {
+        if (!is_enabled()) { return; }
+        write(RecordType::SensorUpdate, nullptr, 0);
+    }
+
+    void ina_sample(uint16_t v_raw, uint16_t i_raw, uint32_t ctx_idx) {
+        if (!is_enabled()) { return; }
+
+        uint8_t payload[2 + 2 + 5];
+        size_t n = put_u16(payload, v_raw);
+        n += put_u16(payload + n, i_raw);
+        n += put_varint(payload + n, ctx_idx);
+        write(RecordType::InaSample, payload, n);
+    }
+
+    void pwm_edge(PwmEvent event) {
+        if (!is_enabled()) { return; }
+
+        uint8_t payload[1];
+        put_u8(payload, static_cast<uint8_t>(event));
+        // Flag must not leak into the next session, update under lock
+        lock();
+        if (is_enabled()) {
+            write_unlocked(RecordType::PwmEdge, payload, 1);
+            if (event == PwmEvent::PulseStart) { pulse_recorded.store(true); }
+        }
+        unlock();
+    }
+
+    void drain_reset() {
+        if (!is_enabled()) { return; }
+        write(RecordType::DrainReset, nullptr, 0);
+    }
+
+    void control_reset() {
+        if (!is_enabled()) { return; }
+        write(RecordType::ControlReset, nullptr, 0);
+    }
+
+    void control_tick(const ControlTick& tick) {
+        if (!is_enabled()) { return; }
+
+        uint8_t payload[5 + 5 + 4 * 4 + 5];
+        size_t n = put_varint(payload, tick.dt_ms);
+        n += put_varint(payload + n, zigzag(tick.temperature_x10));
+        n += put_f32(payload + n, tick.setpoint);
+        n += put_f32(payload + n, tick.setpoint_rate);
+        n += put_f32(payload + n, tick.power_max);
+        n += put_f32(payload + n, tick.power_out);
+        n += put_varint(payload + n, tick.temperature_age_ms);
+        write(RecordType::ControlTick, payload, n);
+    }
+
+    void thermal_tick(const ThermalTick& tick) {
+        if (!is_enabled()) { return; }
+
+        uint8_t payload[5 + 5];
+        size_t n = put_varint(payload, tick.dt_ms);
+        n += put_varint(payload + n, tick.power_mw);
+        write(RecordType::ThermalTick, payload, n);
+    }
+
+    void drain_info(const InaFilter::Result& info) {
+        if (!is_enabled()) { return; }
+
+        uint8_t payload[5 + 5 + 1 + 5 + 5 + 5 + 4];
+        size_t n = put_varint(payload, info.peak_mv);
+        n += put_varint(payload + n, info.peak_ma);
+        n += put_u8(payload + n, info.load_valid ? 1 : 0);
+        n += put_varint(payload + n, info.ctx_idx);
+        n += put_varint(payload + n, info.samples);
+        n += put_varint(payload + n, info.seq);
+        n += put_u32(payload + n, info.timestamp_ms);
+        write(RecordType::DrainInfo, payload, n);
+    }
+
+    // FIR stage of DecimationFilter. CIC stage is not needed, its outputs
+    // are recorded.
+    template <typename Filter>
+    void adc_state(const Filter& filter, bool valid) {
+        static_assert(Filter::TAPS <= MAX_ADC_VALUES, "FIR line doesn't fit record");
+        if (!is_enabled()) { return; }
+
+        const auto s = filter.get_fir_state();
+        uint8_t payload[1 + 4 * 5 + 1 + Filter::TAPS * 5];
+        size_t n = put_u8(payload, valid ? 1 : 0);
+        n += put_varint(payload + n, s.output);
+        n += put_varint(payload + n, s.phase);
+        n += put_varint(payload + n, s.pos);
+        n += put_varint(payload + n, s.warmup);
+        n += put_u8(payload + n, static_cast<uint8_t>(Filter::TAPS));
+        n += put_deltas(payload + n, filter.get_fir_line(), Filter::TAPS);
+        write(RecordType::AdcState, payload, n);
+    }
+
+    void tcr_state(const TcrState& state) {
+        if (!is_enabled()) { return; }
+
+        uint8_t payload[1 + 4 + 4 + 5];
+        size_t n = put_u8(payload, state.valid ? 1 : 0);
+        n += put_u32(payload + n, static_cast<uint32_t>(state.x_q));
+        n += put_u32(payload + n, state.p_q);
+        n += put_varint(payload + n, state.seq);
+        write(RecordType::TcrState, payload, n);
+    }
+
+    // Drain encoded bytes. Records can be split between reads, the client
+    // is expected to concatenate the stream. Single reader.
+    //
+    // Lock is held only to take and commit indices, not for the copy (up to
+    // the whole buffer), so ISR writers are not delayed. Writers never touch
+    // the used region, only restart does, detected by epoch.
+    auto read(uint8_t* out, size_t max_size) -> size_t {
+        size_t n = 0;
+        while (n < max_size) {
+            lock();
+            const uint32_t read_epoch = epoch;
+            const size_t from = tail;
+            const size_t available = used;
+            unlock();
+
+            // Contiguous part, up to the buffer end
+            size_t chunk = max_size - n;
+            if (chunk > available) { chunk = available; }
+            if (chunk > BufferSize - from) { chunk = BufferSize - from; }
+            if (chunk == 0) { break; }
+
+            memcpy(out + n, buffer + from, chunk);
+
+            lock();
+            // Restarted meanwhile, copied bytes are stale
+            const bool valid = epoch == read_epoch;
+            if (valid) {
+                tail = (from + chunk) % BufferSize;
+                used -= chunk;
+            }
+            unlock();
+
+            if (!valid) { break; }
+            n += chunk;
+        }
+        return n;
+    }
+
+    auto get_dropped() const -> uint32_t { return dropped; }
+
+private:
+    uint8_t buffer[BufferSize]{};
+    size_t head{0};
+    size_t tail{0};
+    size_t used{0};
+    uint32_t epoch{0};
+    uint32_t last_ts{0};
+    uint32_t dropped{0};
+    uint32_t pending_gap{0};
+    etl::atomic<bool> enabled{false};
+    etl::atomic<bool> pulse_recorded{false};
+
+    void write(RecordType type, const uint8_t* payload, size_t size) {
+        lock();
+        if (is_enabled()) { write_unlocked(type, payload, size); }
+        unlock();
+    }
+
+    void write_unlocked(RecordType type, const uint8_t* payload, size_t size) {
+        // Take timestamp under lock, to keep stream monotonic.
+        const uint32_t ts = now_ms();
+        const uint32_t dt = ts - last_ts;
+
+        uint8_t gap[MAX_HEAD_SIZE + 5];
+        size_t gap_size = 0;
+        if (pending_gap > 0) {
+            gap_size += put_u8(gap, static_cast<uint8_t>(RecordType::Gap));
+            gap_size += put_varint(gap + gap_size, 0);
+            gap_size += put_varint(gap + gap_size, pending_gap);
+        }
+
+        uint8_t record_head[MAX_HEAD_SIZE];
+        size_t head_size = put_u8(record_head, static_cast<uint8_t>(type));
+        head_size += put_varint(record_head + head_size, dt);
+
+        if (gap_size + head_size + size > BufferSize - used) {
+            dropped++;
+            pending_gap++;
+            return;
+        }
+
+        push(gap, gap_size);
+        push(record_head, head_size);
+        push(payload, size);
+        pending_gap = 0;
+        last_ts = ts;
+    }
+
+    void push(const uint8_t* data, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            buffer[head] = data[i];
+            head = (head + 1) % BufferSize;
+        }
+        used += size;
+    }
+};
+
+
+// Sequential decoder of a trace byte stream.
+class SampleTraceReader : public SampleTrace {
+public:
+    struct Record {
+        RecordType type;
+        uint32_t ts_ms;
+
+        // Payload, valid fields depend on type
+        uint8_t version;
+        uint8_t ina_chip;
+        uint32_t value;             // Gap count
+        uint16_t v_raw;
+        uint16_t i_raw;
+        uint32_t ctx_idx;
+        PwmEvent pwm_event;
+        SensorConfig sensor_config;
+        ControlTick control;
+        ThermalTick thermal;
+        InaFilter::Result drain;
+        AdcState adc;
+        TcrState tcr;
+        const uint8_t* lut_data;    // count x (u16 raw, u16 mV)
+        size_t lut_count;
+        int32_t adc_values[MAX_ADC_VALUES];  // AdcCic outputs, AdcState FIR line
+        size_t adc_count;
+    };
+
+    SampleTraceReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    // Returns false at the end of stream, or on a truncated/broken record.
+    auto next(Record& r) -> bool {
+        const size_t start = pos;
+        if (!parse(r)) {
+            pos = start;
+            return false;
+        }
+        return true;
+    }
+
+    // Bytes consumed by successfully parsed records
+    auto offset() const -> size_t { return pos; }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t pos{0};
+    uint32_t last_ts{0};
+
+    auto get_u8(uint8_t& v) -> bool {
+        if (pos + 1 > size) { return false; }
+        v = data[pos++];
+        return true;
+    }
+
+    auto get_u16(uint16_t& v) -> bool {
+        if (pos + 2 > size) { return false; }
+        v = static_cast<uint16_t>(data[pos] | (data[pos + 1] << 8));
+        pos += 2;
+        return true;
+    }
+
+    auto get_u32(uint32_t& v) -> bool {
+        if (pos + 4 > size) { return false; }
+        v = 0;
+        for (size_t i = 0; i < 4; i++) { v |= static_cast<uint32_t>(data[pos + i]) << (i * 8); }
+        pos += 4;
+        return true;
+    }
+
+    auto get_f32(float& v) -> bool {
+        uint32_t bits;
+        if (!get_u32(bits)) { return false; }
+        memcpy(&v, &bits, sizeof(v));
+        return true;
+    }
+
+    auto get_varint(uint32_t& v) -> bool {
+        v = 0;
+        for (uint32_t shift = 0; shift < 35; shift += 7) {
+            uint8_t b;
+            if (!get_u8(b)) { return false; }
+            v |= static_cast<uint32_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) { return true; }
+        }
+        return false;
+    }
+
+    auto get_deltas(int32_t* values, size_t count) -> bool {
+        uint32_t prev = 0;
+        for (size_t i = 0; i < count; i++) {
+            uint32_t d;
+            if (!get_varint(d)) { return false; }
+            prev += static_cast<uint32_t>(unzigzag(d));
+            values[i] = static_cast<int32_t>(prev);
+        }
+        return true;
+    }
+
+    auto parse(Record& r) -> bool {
+        uint8_t type;
+        uint32_t dt;
+        if (!get_u8(type) || !get_varint(dt)) { return false; }
+
+        r.type = static_cast<RecordType>(type);
+
+        switch (r.type) {
+            case RecordType::Start: {
+                uint32_t ts;
+                if (!get_u8(r.version) || !get_u8(r.ina_chip) || !get_u32(ts)) { return false; }
+                if (r.version != VERSION) { return false; }
+                last_ts = ts;
+                break;
+            }
+            case RecordType::Gap:
+                if (!get_varint(r.value)) { return false; }
+                break;
+
+            case RecordType::AdcLut: {
+                uint8_t count;
+                if (!get_u8(count)) { return false; }
+                if (pos + count * 4u > size) { return false; }
+                r.lut_data = data + pos;
+                r.lut_count = count;
+                pos += count * 4u;
+                break;
+            }
+            case RecordType::SensorConfig: {
+                uint8_t is_tcr;
+                auto& c = r.sensor_config;
+                if (!get_u8(is_tcr) ||
+                    !get_f32(c.p0_at) || !get_f32(c.p0_value) ||
+                    !get_f32(c.p1_at) || !get_f32(c.p1_value) ||
+                    !get_f32(c.adrc_response) || !get_f32(c.adrc_b0) ||
+                    !get_f32(c.adrc_n_coeff) || !get_f32(c.adrc_m_coeff) ||
+                    !get_u8(c.tcr_count) || c.tcr_count > SharedConstants::MAX_TCR_CAL_POINTS)
+                {
+                    return false;
+                }
+                for (size_t i = 0; i < c.tcr_count; i++) {
+                    if (!get_f32(c.tcr_at[i]) || !get_f32(c.tcr_value[i])) { return false; }
+                }
+                c.is_tcr = is_tcr != 0;
+                break;
+            }
+            case RecordType::AdcCic: {
+                uint8_t count;
+                if (!get_u8(count) || !get_deltas(r.adc_values, count)) { return false; }
+                r.adc_count = count;
+                break;
+            }
+
+            case RecordType::InaSample:
+                if (!get_u16(r.v_raw) || !get_u16(r.i_raw) || !get_varint(r.ctx_idx)) { return false; }
+                break;
+
+            case RecordType::PwmEdge: {
+                uint8_t event;
+                if (!get_u8(event)) { return false; }
+                r.pwm_event = static_cast<PwmEvent>(event);
+                break;
+            }
+            case RecordType::ControlTick: {
+                uint32_t t;
+                auto& c = r.control;
+                if (!get_varint(c.dt_ms) || !get_varint(t) ||
+                    !get_f32(c.setpoint) || !get_f32(c.setpoint_rate) ||
+                    !get_f32(c.power_max) || !get_f32(c.power_out) ||
+                    !get_varint(c.temperature_age_ms))
+                {
+                    return false;
+                }
+                c.temperature_x10 = unzigzag(t);
+                break;
+            }
+            case RecordType::ThermalTick:
+                if (!get_varint(r.thermal.dt_ms) || !get_varint(r.thermal.power_mw)) { return false; }
+                break;
+
+            case RecordType::DrainInfo: {
+                uint8_t load_valid;
+                auto& d = r.drain;
+                if (!get_varint(d.peak_mv) || !get_varint(d.peak_ma) || !get_u8(load_valid) ||
+                    !get_varint(d.ctx_idx) || !get_varint(d.samples) || !get_varint(d.seq) ||
+                    !get_u32(d.timestamp_ms))
+                {
+                    return false;
+                }
+                d.load_valid = load_valid != 0;
+                break;
+            }
+            case RecordType::AdcState: {
+                uint8_t valid;
+                uint8_t taps;
+                auto& a = r.adc;
+                if (!get_u8(valid) || !get_varint(a.output_x100) || !get_varint(a.phase) ||
+                    !get_varint(a.pos) || !get_varint(a.warmup) ||
+                    !get_u8(taps) || !get_deltas(r.adc_values, taps))
+                {
+                    return false;
+                }
+                a.valid = valid != 0;
+                r.adc_count = taps;
+                break;
+            }
+            case RecordType::TcrState: {
+                uint8_t valid;
+                uint32_t x;
+                if (!get_u8(valid) || !get_u32(x) || !get_u32(r.tcr.p_q) || !get_varint(r.tcr.seq)) { return false; }
+                r.tcr.valid = valid != 0;
+                r.tcr.x_q = static_cast<int32_t>(x);
+                break;
+            }
+            case RecordType::SensorUpdate:
+            case RecordType::DrainReset:
+            case RecordType::ControlReset:
+                break;
+
+            default:
+                return false;
+        }
+
+        if (r.type != RecordType::Start) { last_ts += dt; }
+        r.ts_ms = last_ts;
+        return true;
+    }
+};
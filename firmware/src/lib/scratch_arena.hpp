@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Single-tenant static memory for objects which never live at the same time
+// (working data of FSM states, for example). Size and alignment are the max
+// of registered types, so RAM budget is known at compile time and there is no
+// heap churn on state change.
+//
+// Not thread-safe, owner must serialize acquire/release.
+template <typename... Ts>
+class ScratchArena {
+public:
+    static constexpr size_t SIZE = [] {
+        size_t r = 0;
+        ((r = sizeof(Ts) > r ? sizeof(Ts) : r), ...);
+        return r;
+    }();
+
+    ScratchArena() = default;
+    ScratchArena(const ScratchArena&) = delete;
+    auto operator=(const ScratchArena&) -> ScratchArena& = delete;
+    ~ScratchArena() { release(); }
+
+    // Constructs T in arena. Previous tenant (if left) is destroyed first.
+    template <typename T, typename... Args>
+    auto acquire(Args&&... args) -> T& {
+        static_assert((std::is_same_v<T, Ts> || ...), "Type is not registered in arena");
+
+        release();
+        T* obj = ::new (static_cast<void*>(storage)) T(std::forward<Args>(args)...);
+        destroy = [](void* p) { static_cast<T*>(p)->~T(); };
+        return *obj;
+    }
+
+    void release() {
+        if (!destroy) { return; }
+        destroy(storage);
+        destroy = nullptr;
+    }
+
+    auto in_use() const -> bool { return destroy != nullptr; }
+
+private:
+    alignas(Ts...) uint8_t storage[SIZE];
+    void (*destroy)(void*){nullptr};
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <etl/vector.h>
@@ -13,6 +14,11 @@ public:
 
     etl::vector<Point, MAX_POINTS> data{};
 
+    // Rate x100 for each point in `data`. Not packed, taken from the point
+    // that landed. Kept apart, so Point layout stays [x, y] for wasm, and
+    // int16 (±327 °C/s) to halve RAM cost.
+    auto get_rate(size_t idx) const -> int32_t { return rates[idx]; }
+
     void set_params(int32_t _x_threshold, int32_t _y_threshold, int32_t _x_scale_after) {
         x_threshold = _x_threshold;
         y_threshold = _y_threshold;
@@ -21,7 +27,7 @@ public:
 
     void reset() { lock(); data.clear(); unlock();}
 
-    auto add(int32_t x, int32_t y) -> bool {
+    auto add(int32_t x, int32_t y, int32_t rate = 0) -> bool {
         lock();
 
         if (!data.empty() && data.back().x == x && data.back().y == y) {
@@ -40,6 +46,7 @@ public:
         } else {
             data.back() = point;
         }
+        rates[data.size() - 1] = static_cast<int16_t>(std::clamp(rate, INT16_MIN + 1, INT16_MAX));
 
         unlock();
         return true;
@@ -63,6 +70,8 @@ private:
         return false;
     }
 
+    int16_t rates[MAX_POINTS]{};
+
     // Thresholds for delta encoding
     int32_t x_threshold{10};
     int32_t y_threshold{1};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+// Lock-free accumulator between a single producer task and consumers
+// (seqlock). Readers don't modify state, so more of them are fine. Not for
+// ISR producers: a reader can't wait for an interrupted ISR to finish.
+//
+// Producer keeps a running sum and a sample counter, so readers get O(1)
+// consistent snapshots, and can average everything produced between two
+// snapshots without missing or double-counting samples. Producer never
+// waits, readers retry if they raced with an update.
+//
+// While an update is in progress readers call `relax`, it must let the
+// producer run. On a single core a busy loop in a reader with priority not
+// lower than the producer would never see the update finish.
+class SpscAccumulator {
+public:
+    struct Snapshot {
+        uint32_t last{0};          // Latest value
+        uint64_t sum{0};           // Sum of all values pushed
+        uint32_t count{0};         // Number of values pushed
+        uint32_t timestamp_ms{0};  // Time of latest value
+    };
+
+    explicit SpscAccumulator(uint32_t initial = 0) { last.store(initial, std::memory_order_relaxed); }
+
+    // Producer only
+    void push(uint32_t value, uint32_t timestamp_ms) {
+        const uint32_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        // Producer is the only writer, no RMW needed
+        const uint64_t new_sum = (static_cast<uint64_t>(sum_hi.load(std::memory_order_relaxed)) << 32 |
+                                  sum_lo.load(std::memory_order_relaxed)) + value;
+        last.store(value, std::memory_order_relaxed);
+        sum_lo.store(static_cast<uint32_t>(new_sum), std::memory_order_relaxed);
+        sum_hi.store(static_cast<uint32_t>(new_sum >> 32), std::memory_order_relaxed);
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        timestamp.store(timestamp_ms, std::memory_order_relaxed);
+
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    template <typename Relax>
+    auto snapshot(Relax relax) const -> Snapshot {
+        Snapshot r{};
+        while (true) {
+            const uint32_t s1 = seq.load(std::memory_order_acquire);
+            if (s1 & 1) {
+                relax();
+                continue;
+            }
+
+            r.last = last.load(std::memory_order_relaxed);
+            r.sum = static_cast<uint64_t>(sum_hi.load(std::memory_order_relaxed)) << 32 |
+                    sum_lo.load(std::memory_order_relaxed);
+            r.count = count.load(std::memory_order_relaxed);
+            r.timestamp_ms = timestamp.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) == s1) { return r; }
+        }
+    }
+
+    // Latest value only, single load, no retry needed
+    auto get_last() const -> uint32_t { return last.load(std::memory_order_relaxed); }
+
+    // Mean of values pushed after `from` up to `to`. Returns false if nothing
+    // new was pushed.
+    static auto mean(const Snapshot& from, const Snapshot& to, uint32_t& out) -> bool {
+        const uint32_t n = to.count - from.count;
+        if (n == 0) { return false; }
+        out = static_cast<uint32_t>((to.sum - from.sum) / n);
+        return true;
+    }
+
+private:
+    std::atomic<uint32_t> seq{0};
+    std::atomic<uint32_t> last{0};
+    std::atomic<uint32_t> sum_lo{0};
+    std::atomic<uint32_t> sum_hi{0};
+    std::atomic<uint32_t> count{0};
+    std::atomic<uint32_t> timestamp{0};
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <etl/vector.h>
+
+#include "proto/generated/shared_constants.hpp"
+
+// Automated multi-point TCR calibration sweep.
+//
+// Heater is driven with fixed power levels (like sensor bake), one by one.
+// At each level we wait for thermal equilibrium, then client supplies
+// reference temperature (external thermometer) and the plateau resistance
+// is recorded. Collected pairs make piecewise linear R -> T model.
+//
+// Platform-agnostic, time is passed in explicitly.
+class TcrCalibration {
+public:
+    static constexpr size_t MAX_POINTS = SharedConstants::MAX_TCR_CAL_POINTS;
+
+    // Plateau is reached, when temperature changes slower than this, for a
+    // few rate windows in a row. Reading is not calibrated yet, but is still
+    // monotonic, that's enough.
+    static constexpr int32_t STABLE_RATE_X100 = 1;  // 0.01 °C/s, 0.6 °C/min
+    static constexpr uint32_t STABLE_WINDOWS = 3;
+    static constexpr uint32_t RATE_WINDOW_MS = 20 * 1000;
+
+    enum class Phase : uint8_t { Inactive, Settling, Ready, Done };
+
+    struct Point {
+        float at;     // Reference temperature, °C
+        float value;  // Heater resistance, mOhm
+    };
+
+    // Power levels are max_watts * i / steps, i = 1..steps
+    auto start(float max_watts, uint32_t steps) -> bool {
+        if (max_watts <= 0 || steps < 2 || steps > MAX_POINTS) { return false; }
+
+        max_power = max_watts;
+        steps_total = steps;
+        points.clear();
+        phase = Phase::Settling;
+        reset_plateau();
+        return true;
+    }
+
+    void finish() { phase = Phase::Inactive; }
+
+    // Feed new sample, returns true when plateau is reached.
+    auto update(uint32_t now_ms, int32_t temperature_x10, float mohms) -> bool {
+        if (phase != Phase::Settling && phase != Phase::Ready) { return false; }
+
+        // Average resistance over the last window (noise suppression)
+        window_r_sum += mohms;
+        window_r_count++;
+
+        if (rate_ref_x10 == INT32_MIN) {
+            rate_ref_x10 = temperature_x10;
+            rate_ref_ms = now_ms;
+            return false;
+        }
+        if (now_ms - rate_ref_ms < RATE_WINDOW_MS) { return false; }
+
+        rate_x100 = static_cast<int32_t>(
+            static_cast<int64_t>(temperature_x10 - rate_ref_x10) * 10'000 / static_cast<int32_t>(now_ms - rate_ref_ms));
+        rate_ref_x10 = temperature_x10;
+        rate_ref_ms = now_ms;
+
+        plateau_r = window_r_sum / static_cast<float>(window_r_count);
+        window_r_sum = 0;
+        window_r_count = 0;
+
+        if (phase == Phase::Ready) { return false; }
+
+        const int32_t rate_abs = rate_x100 < 0 ? -rate_x100 : rate_x100;
+        stable_windows = rate_abs <= STABLE_RATE_X100 ? stable_windows + 1 : 0;
+        if (stable_windows < STABLE_WINDOWS) { return false; }
+
+        phase = Phase::Ready;
+        return true;
+    }
+
+    // Record reference for current plateau and move to next power level.
+    // Returns false if plateau is not reached yet.
+    auto add_reference(float temperature) -> bool {
+        if (phase != Phase::Ready) { return false; }
+
+        points.push_back({ temperature, plateau_r });
+        if (points.size() >= steps_total) {
+            phase = Phase::Done;
+        } else {
+            phase = Phase::Settling;
+            reset_plateau();
+        }
+        return true;
+    }
+
+    auto get_phase() const -> Phase { return phase; }
+    auto get_power() const -> float {
+        return max_power * static_cast<float>(points.size() + 1) / static_cast<float>(steps_total);
+    }
+    auto get_step() const -> uint32_t { return static_cast<uint32_t>(points.size()); }
+    auto get_steps() const -> uint32_t { return steps_total; }
+    auto get_points() const -> const etl::vector<Point, MAX_POINTS>& { return points; }
+    // Last measured rate, x100 °C/s. INT32_MIN if not known yet.
+    auto get_rate_x100() const -> int32_t { return rate_x100; }
+    // Resistance, averaged over the last rate window
+    auto get_plateau_resistance() const -> float { return plateau_r; }
+
+private:
+    Phase phase{Phase::Inactive};
+    float max_power{0};
+    uint32_t steps_total{0};
+    etl::vector<Point, MAX_POINTS> points{};
+
+    int32_t rate_x100{INT32_MIN};
+    uint32_t rate_ref_ms{0};
+    int32_t rate_ref_x10{INT32_MIN};
+    uint32_t stable_windows{0};
+    float window_r_sum{0};
+    uint32_t window_r_count{0};
+    float plateau_r{0};
+
+    void reset_plateau() {
+        rate_x100 = INT32_MIN;
+        rate_ref_x10 = INT32_MIN;
+        stable_windows = 0;
+        window_r_sum = 0;
+        window_r_count = 0;
+        plateau_r = 0;
+    }
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <stdint.h>
+
+// One-state Kalman filter for heater temperature in TCR mode.
+//
+// Resistance-derived temperature comes once per PWM pulse, and is noisy when
+// pulses are short (few INA samples averaged). Between measurements the state
+// is predicted with the same first-order model, as used for ADRC tuning:
+//
+//   dT/dt = b0·P - (T - T_ambient) / τ
+//
+// Fixed point: temperature is Q16 °C, variance is Q16 °C². Platform-agnostic,
+// float is used only to load model params.
+class TcrKalman {
+public:
+    static constexpr uint32_t FRAC_BITS = 16;
+    static constexpr int32_t AMBIENT_X10 = 25 * 10;
+    // Measurement noise SD at full INA filter (8 samples) is ~0.7 °C. Fewer
+    // samples scale variance up.
+    static constexpr uint32_t MEASUREMENT_VARIANCE_X100 = 50;
+    static constexpr uint32_t MEASUREMENT_FULL_SAMPLES = 8;
+    // Model error growth, °C² per second (b0/τ are rough, ambient is a guess)
+    static constexpr uint32_t PROCESS_VARIANCE_X100_PER_S = 400;
+    // Measurements outside of this many SD mean the model is off (head
+    // swapped, params changed), restart from the measurement.
+    static constexpr uint32_t GATE_SD = 6;
+    // Variance cap, prediction without measurements is useless beyond it
+    static constexpr uint32_t MAX_VARIANCE_X100 = 100 * 100;
+    // Keeps (1 - 2·dt/τ) positive, for any reasonable τ
+    static constexpr uint32_t MAX_DT_MS = 1000;
+
+    // b0 in °C/s per W, τ in seconds. Zero/negative values disable the model,
+    // then prediction only grows variance.
+    void set_params(float b0, float tau_s) {
+        if (b0 <= 0 || tau_s < 2.0f * MAX_DT_MS / 1000) {
+            b0_q24 = 0;
+            tau_ms = 0;
+            return;
+        }
+        b0_q24 = static_cast<int32_t>(b0 * (1 << 24) + 0.5f);
+        tau_ms = static_cast<uint32_t>(tau_s * 1000 + 0.5f);
+    }
+
+    void reset() { valid = false; }
+
+    auto is_valid() const -> bool { return valid; }
+    // Without model, estimate is not advanced between measurements
+    auto has_model() const -> bool { return tau_ms != 0; }
+
+    // Advance model by dt with power delivered to heater
+    void predict(uint32_t dt_ms, uint32_t power_mw) {
+        if (!valid) { return; }
+        if (dt_ms > MAX_DT_MS) { dt_ms = MAX_DT_MS; }
+
+        int64_t p = p_q;
+        if (tau_ms) {
+            // b0·P·dt, with P in mW and dt in ms
+            const int64_t heat = static_cast<int64_t>(b0_q24) * power_mw * dt_ms / (int64_t{1'000'000} << 8);
+            const int64_t loss = static_cast<int64_t>(x_q - to_q(AMBIENT_X10)) * dt_ms / tau_ms;
+            x_q += static_cast<int32_t>(heat - loss);
+
+            // Decay factor (1 - dt/τ)², linearized
+            p -= 2 * p * dt_ms / tau_ms;
+        }
+        p += static_cast<int64_t>(variance_q(PROCESS_VARIANCE_X100_PER_S)) * dt_ms / 1000;
+        p_q = clamp_variance(p);
+    }
+
+    // Fuse resistance-derived temperature, averaged over `samples` INA reads
+    void update(int32_t temperature_x10, uint32_t samples) {
+        const int32_t z = to_q(temperature_x10);
+        if (samples == 0) { samples = 1; }
+        const int64_t r = static_cast<int64_t>(variance_q(MEASUREMENT_VARIANCE_X100)) *
+                          MEASUREMENT_FULL_SAMPLES / samples;
+
+        const int64_t e = static_cast<int64_t>(z) - x_q;
+        const int64_t s = p_q + r;
+
+        // e² vs GATE²·S, both in Q32
+        if (!valid || e * e > (s << FRAC_BITS) * (GATE_SD * GATE_SD)) {
+            x_q = z;
+            p_q = clamp_variance(r);
+            valid = true;
+            return;
+        }
+
+        // Gain is Q16, in [0..1)
+        const int64_t k = (static_cast<int64_t>(p_q) << FRAC_BITS) / s;
+        x_q += static_cast<int32_t>((k * e) >> FRAC_BITS);
+        p_q = clamp_variance((p_q * ((int64_t{1} << FRAC_BITS) - k)) >> FRAC_BITS);
+    }
+
+    auto get_temperature_x10() const -> int32_t {
+        return static_cast<int32_t>((static_cast<int64_t>(x_q) * 10 + (1 << (FRAC_BITS - 1))) >> FRAC_BITS);
+    }
+
+    // Estimate variance, °C² x100
+    auto get_variance_x100() const -> uint32_t {
+        return static_cast<uint32_t>((static_cast<uint64_t>(p_q) * 100 + (1 << (FRAC_BITS - 1))) >> FRAC_BITS);
+    }
+
+    // Raw state, to continue elsewhere bit-exact (trace replay)
+    struct State {
+        bool valid;
+        int32_t x_q;
+        uint32_t p_q;
+    };
+
+    auto get_state() const -> State { return { valid, x_q, p_q }; }
+    void set_state(const State& s) {
+        valid = s.valid;
+        x_q = s.x_q;
+        p_q = s.p_q;
+    }
+
+private:
+    int32_t x_q{0};
+    uint32_t p_q{0};
+    bool valid{false};
+
+    int32_t b0_q24{0};
+    uint32_t tau_ms{0};
+
+    static constexpr auto to_q(int32_t value_x10) -> int32_t {
+        return static_cast<int32_t>((static_cast<int64_t>(value_x10) << FRAC_BITS) / 10);
+    }
+
+    static constexpr auto variance_q(uint32_t value_x100) -> uint32_t {
+        return static_cast<uint32_t>((static_cast<uint64_t>(value_x100) << FRAC_BITS) / 100);
+    }
+
+    static auto clamp_variance(int64_t p) -> uint32_t {
+        constexpr int64_t max = variance_q(MAX_VARIANCE_X100);
+        if (p < 1) { return 1; }
+        return static_cast<uint32_t>(p > max ? max : p);
+    }
+};
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <stdint.h>
+
+// Heater fault detector, runs every control tick in constant time.
+//
+// Measured temperature is checked against heat actually delivered, using the
+// same first-order model as for ADRC tuning:
+//
+//   dT/dt = b0·P - (T - T_ambient) / τ
+//
+// Two leaky sums over the last few seconds are compared:
+//
+// - expected heating, b0·P·dt. Power is lagged first, the sensor sees heat
+//   with some delay.
+// - observed heating, ΔT + loss·dt. That's how much heat the sensor shows,
+//   if losses were known.
+//
+// Observed much less than expected means heat goes nowhere (sensor detached,
+// heater is not in contact). Observed much more than expected means heating
+// without power (sensor fault, stuck power stage). Mismatch with a frozen
+// reading is classified as stuck sensor.
+//
+// Fan cooling is not modelled. It's used only without power, so lack of
+// heating is judged only after power was on for a while.
+//
+// Electrical checks don't need model: no valid load while task is running
+// (open heater), and resistance jump, faster than temperature can explain.
+//
+// Fixed point: temperature sums are Q16 °C. Platform-agnostic, float is used
+// only to load model params.
+class ThermalSupervisor {
+public:
+    enum class Fault : uint8_t {
+        None,
+        OpenHeater,
+        ResistanceJump,
+        StuckReading,
+        NoHeating,
+        HeatingWithoutPower
+    };
+
+    struct Input {
+        uint32_t now_ms;
+        uint32_t dt_ms;
+        int32_t temperature_x10;
+        uint32_t temperature_ts_ms;  // Time the temperature corresponds to
+        uint32_t power_mw;           // Delivered, average over PWM period
+        uint32_t resistance_mohm;    // 0 if load is not measured
+    };
+
+    static constexpr uint32_t FRAC_BITS = 16;
+    static constexpr int32_t AMBIENT_X10 = 25 * 10;
+    static constexpr uint32_t MAX_DT_MS = 1000;
+
+    // No valid load measurement for this long
+    static constexpr uint32_t OPEN_TRIP_MS = 500;
+    // Resistance away from the recent reference. Real heating changes it by a
+    // few % per second at most, reference follows it with REF_TAU_MS lag.
+    static constexpr uint32_t JUMP_PERMILLE = 150;
+    static constexpr uint32_t JUMP_TRIP_MS = 300;
+    static constexpr uint32_t REF_TAU_MS = 1000;
+    // Temperature measurement not updated
+    static constexpr uint32_t STALE_TRIP_MS = 1000;
+    // Reading is "frozen" when it has not changed even by 0.1 °C this long
+    static constexpr uint32_t FROZEN_MS = 2000;
+    static constexpr int32_t STUCK_GAP_X10 = 5 * 10;
+
+    // Model checks. Thresholds cover ~20% error of b0/τ and ambient guess.
+    static constexpr uint32_t MODEL_LAG_MS = 2000;
+    static constexpr uint32_t WINDOW_MS = 5000;
+    // Lack of heating: observed below half of expected, after power was on
+    // for two windows (fan cooling is forgotten).
+    static constexpr uint32_t NO_HEAT_MIN_MW = 5 * 1000;
+    static constexpr uint32_t NO_HEAT_POWERED_MS = 2 * WINDOW_MS;
+    static constexpr int32_t NO_HEAT_MIN_X10 = 3 * 10;
+    static constexpr uint32_t NO_HEAT_RATIO_PERCENT = 50;
+    // Excess heating: observed above expected by 6 °C + 50%
+    static constexpr int32_t EXCESS_HEAT_X10 = 6 * 10;
+    static constexpr uint32_t EXCESS_HEAT_RATIO_PERCENT = 50;
+
+    // b0 in °C/s per W, τ in seconds. Zero/negative values disable model
+    // checks, electrical and stale checks still work.
+    void set_params(float b0, float tau_s) {
+        if (b0 <= 0 || tau_s < 2.0f * MAX_DT_MS / 1000) {
+            b0_q24 = 0;
+            tau_ms = 0;
+            return;
+        }
+        b0_q24 = static_cast<int32_t>(b0 * (1 << 24) + 0.5f);
+        tau_ms = static_cast<uint32_t>(tau_s * 1000 + 0.5f);
+    }
+
+    void reset() {
+        fault = Fault::None;
+        started = false;
+        open_ms = 0;
+        jump_ms = 0;
+        r_ref_q8 = 0;
+        frozen_ms = 0;
+        powered_ms = 0;
+        power_lag_q8 = 0;
+        expected_q = 0;
+        observed_q = 0;
+    }
+
+    auto has_model() const -> bool { return tau_ms != 0; }
+    auto get_fault() const -> Fault { return fault; }
+
+    // Feed one control tick. Fault is latched until reset.
+    auto update(const Input& in) -> Fault {
+        if (fault != Fault::None) { return fault; }
+
+        const uint32_t dt_ms = in.dt_ms > MAX_DT_MS ? MAX_DT_MS : in.dt_ms;
+        const int32_t t_q = to_q(in.temperature_x10);
+
+        if (!started) {
+            started = true;
+            prev_t_q = t_q;
+            prev_x10 = in.temperature_x10;
+            if (in.resistance_mohm) { r_ref_q8 = static_cast<int64_t>(in.resistance_mohm) << 8; }
+            return fault;
+        }
+
+        // Open heater
+        open_ms = in.resistance_mohm ? 0 : open_ms + dt_ms;
+        if (open_ms >= OPEN_TRIP_MS) { return trip(Fault::OpenHeater); }
+
+        // Resistance jump. Reference is frozen while resistance is off.
+        if (in.resistance_mohm) {
+            const int64_t r_q8 = static_cast<int64_t>(in.resistance_mohm) << 8;
+            if (r_ref_q8 == 0) { r_ref_q8 = r_q8; }
+
+            const int64_t diff = r_q8 - r_ref_q8;
+            if ((diff < 0 ? -diff : diff) * 1000 > r_ref_q8 * JUMP_PERMILLE) {
+                jump_ms += dt_ms;
+                if (jump_ms >= JUMP_TRIP_MS) { return trip(Fault::ResistanceJump); }
+            } else {
+                jump_ms = 0;
+                r_ref_q8 += diff * dt_ms / REF_TAU_MS;
+            }
+        }
+
+        // Stale measurement. TCR estimate can be slightly ahead of "now".
+        if (static_cast<int32_t>(in.now_ms - in.temperature_ts_ms) > static_cast<int32_t>(STALE_TRIP_MS)) {
+            return trip(Fault::StuckReading);
+        }
+
+        if (in.temperature_x10 == prev_x10) {
+            frozen_ms += dt_ms;
+        } else {
+            frozen_ms = 0;
+            prev_x10 = in.temperature_x10;
+        }
+
+        if (!tau_ms) {
+            prev_t_q = t_q;
+            return fault;
+        }
+
+        // Model sums
+        power_lag_q8 += ((static_cast<int64_t>(in.power_mw) << 8) - power_lag_q8) * dt_ms / MODEL_LAG_MS;
+        const int64_t heat = static_cast<int64_t>(b0_q24) * power_lag_q8 * dt_ms / (int64_t{1'000'000} << 16);
+        const int64_t loss = static_cast<int64_t>(prev_t_q - to_q(AMBIENT_X10)) * dt_ms / tau_ms;
+
+        expected_q += heat - expected_q * dt_ms / WINDOW_MS;
+        observed_q += (t_q - prev_t_q) + loss - observed_q * dt_ms / WINDOW_MS;
+        prev_t_q = t_q;
+
+        powered_ms = in.power_mw >= NO_HEAT_MIN_MW ? powered_ms + dt_ms : 0;
+
+        // Don't blame heat balance for resistance glitch, it's being checked
+        if (jump_ms) { return fault; }
+
+        const int64_t gap = expected_q - observed_q;
+        if (frozen_ms >= FROZEN_MS && (gap < 0 ? -gap : gap) > to_q(STUCK_GAP_X10)) {
+            return trip(Fault::StuckReading);
+        }
+        if (powered_ms >= NO_HEAT_POWERED_MS && expected_q > to_q(NO_HEAT_MIN_X10) &&
+            observed_q * 100 < expected_q * NO_HEAT_RATIO_PERCENT)
+        {
+            return trip(Fault::NoHeating);
+        }
+        if (-gap > to_q(EXCESS_HEAT_X10) + expected_q * EXCESS_HEAT_RATIO_PERCENT / 100) {
+            return trip(Fault::HeatingWithoutPower);
+        }
+        return fault;
+    }
+
+    // Expected and observed heating over the window, °C x10 (for debug)
+    auto get_expected_x10() const -> int32_t { return from_q(expected_q); }
+    auto get_observed_x10() const -> int32_t { return from_q(observed_q); }
+
+    static auto get_fault_name(Fault f) -> const char* {
+        switch (f) {
+            case Fault::None: return "none";
+            case Fault::OpenHeater: return "open heater";
+            case Fault::ResistanceJump: return "resistance jump";
+            case Fault::StuckReading: return "stuck temperature reading";
+            case Fault::NoHeating: return "power without heating";
+            case Fault::HeatingWithoutPower: return "heating without power";
+        }
+        return "unknown";
+    }
+
+private:
+    Fault fault{Fault::None};
+    bool started{false};
+
+    int32_t b0_q24{0};
+    uint32_t tau_ms{0};
+
+    uint32_t open_ms{0};
+    uint32_t jump_ms{0};
+    int64_t r_ref_q8{0};
+    uint32_t frozen_ms{0};
+    uint32_t powered_ms{0};
+    int32_t prev_x10{0};
+    int32_t prev_t_q{0};
+
+    int64_t power_lag_q8{0};
+    int64_t expected_q{0};
+    int64_t observed_q{0};
+
+    auto trip(Fault f) -> Fault {
+        fault = f;
+        return fault;
+    }
+
+    static constexpr auto to_q(int32_t value_x10) -> int32_t {
+        return static_cast<int32_t>((static_cast<int64_t>(value_x10) << FRAC_BITS) / 10);
+    }
+
+    static constexpr auto from_q(int64_t value_q) -> int32_t {
+        return static_cast<int32_t>(value_q * 10 >> FRAC_BITS);
+    }
+};
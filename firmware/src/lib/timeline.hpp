@@ -0,0 +1,270 @@
+#pragma once
+
+#include <math.h>
+
+#include <etl/algorithm.h>
+#include <etl/vector.h>
+
+#include "proto/generated/shared_constants.hpp"
+#include "proto/generated/types.pb.h"
+
+// Reflow profile as piecewise-linear temperature function of time.
+//
+// Profile is precompiled to segment table with integer slopes, and evaluated
+// via monotonic cursor. Reflow asks for increasing time, so every tick costs
+// O(1) without float math (soft-float core). Going back in time rewinds the
+// cursor (O(n), rare).
+class Timeline {
+public:
+    // Use integer math for speed
+    // Time is in milliseconds, temperature is in 1/100 degrees,
+    // rate is in 1/100 degrees per second.
+    static constexpr int32_t x_axis_multiplier = 1000;
+    static constexpr int32_t y_axis_multiplier = 100;
+    static constexpr int32_t RATE_MAX_X100 = 100 * y_axis_multiplier;
+
+    enum class SegmentKind : uint8_t {
+        Linear,    // Ramp from previous target
+        Step,      // Zero duration, instant jump
+        Parabolic  // Constant acceleration (shaped corner)
+    };
+
+    // Highest shaping acceleration, 1/100 degrees per s². Keeps Q40 in int32.
+    static constexpr int32_t ACCEL_MAX_X100 = 1'500;
+
+    struct Segment {
+        SegmentKind kind;
+        int32_t t0_x1000;
+        int32_t t1_x1000;
+        int32_t v0_x100;
+        int32_t v1_x100;
+        int32_t slope_q24;   // (1/100 degrees per ms) << 24, at t0
+        int32_t rate_x100;   // Clamped to ±RATE_MAX_X100
+        int32_t accel_q40;   // (1/100 degrees per ms²) << 40, Parabolic only
+    };
+
+    // `accel_max_x100` - corner rounding acceleration, 1/100 degrees per s².
+    // 0 disables shaping. Float math is used here, but only once per run.
+    void load(const Profile& profile, int32_t accel_max_x100 = 0) {
+        segments.clear();
+        cursor = 0;
+
+        struct Point { int32_t t; int32_t v; };
+        etl::vector<Point, SharedConstants::MAX_REFLOW_SEGMENTS + 1> points{};
+
+        points.push_back({0, SharedConstants::START_TEMPERATURE * y_axis_multiplier});
+        for (size_t i = 0; i < profile.segments_count && !points.full(); ++i) {
+            const auto& s = profile.segments[i];
+            points.push_back({
+                points.back().t + etl::max(s.duration, int32_t{0}) * x_axis_multiplier,
+                s.target * y_axis_multiplier
+            });
+        }
+
+        const auto rate_of = [&](size_t i) -> float {
+            const int32_t dt = points[i].t - points[i - 1].t;
+            if (dt <= 0) { return 0; }
+            return static_cast<float>(points[i].v - points[i - 1].v) / static_cast<float>(dt);
+        };
+
+        for (size_t i = 1; i < points.size(); ++i) {
+            const auto& p0 = points[i - 1];
+            const auto& p1 = points[i];
+
+            if (accel_max_x100 <= 0 || p1.t <= p0.t) {
+                segments.push_back(compile_segment(p0.t, p1.t, p0.v, p1.v));
+                continue;
+            }
+
+            // Velocities at ends, in 1/100 degrees per ms. Profile starts
+            // from rest, last point has no corner.
+            const float v0 = i == 1 ? 0 : corner_velocity(rate_of(i - 1), rate_of(i), points[i - 2].t == p0.t);
+            const float v1 = i + 1 == points.size() ? rate_of(i)
+                : corner_velocity(rate_of(i), rate_of(i + 1), points[i + 1].t == p1.t);
+
+            shape_segment(p0.t, p1.t, p0.v, p1.v, v0, v1,
+                static_cast<float>(etl::min(accel_max_x100, ACCEL_MAX_X100)) * 1e-6f);
+        }
+    }
+
+    auto get_max_time_x1000() const -> int32_t {
+        if (segments.empty()) { return 0; }
+        return segments.back().t1_x1000;
+    }
+
+    // Temperature at given time, x100. 0 when out of profile.
+    auto get_target_x100(int32_t offset_x1000) -> int32_t {
+        const auto* s = seek(offset_x1000);
+        if (!s) { return 0; }
+
+        switch (s->kind) {
+            case SegmentKind::Step:
+                return s->v1_x100;
+
+            case SegmentKind::Parabolic: {
+                const int64_t dt = offset_x1000 - s->t0_x1000;
+                // Mean slope over [t0, t] = slope(t0) + accel * dt / 2
+                const int64_t mean_slope_q24 = s->slope_q24 + ((s->accel_q40 * dt) >> 17);
+                return s->v0_x100 + static_cast<int32_t>((mean_slope_q24 * dt + (1 << 23)) >> 24);
+            }
+
+            case SegmentKind::Linear:
+            default:
+                return s->v0_x100 + static_cast<int32_t>(
+                    (static_cast<int64_t>(s->slope_q24) * (offset_x1000 - s->t0_x1000) + (1 << 23)) >> 24);
+        }
+    }
+
+    // Desired temperature change rate, x100 (degrees per second). 0 when out
+    // of profile.
+    auto get_rate_x100(int32_t offset_x1000) -> int32_t {
+        const auto* s = seek(offset_x1000);
+        if (!s) { return 0; }
+
+        if (s->kind == SegmentKind::Parabolic) {
+            const int64_t dt = offset_x1000 - s->t0_x1000;
+            const int64_t slope_q24 = s->slope_q24 + ((s->accel_q40 * dt) >> 16);
+            const int64_t rate = (slope_q24 * x_axis_multiplier + (1 << 23)) >> 24;
+            return static_cast<int32_t>(etl::clamp(rate, int64_t{-RATE_MAX_X100}, int64_t{RATE_MAX_X100}));
+        }
+        return s->rate_x100;
+    }
+
+    auto get_segments() const -> const etl::ivector<Segment>& { return segments; }
+
+private:
+    // Shaping splits every segment into up to 3 pieces
+    etl::vector<Segment, SharedConstants::MAX_REFLOW_SEGMENTS * 3> segments{};
+    size_t cursor{0};
+
+    // Velocity at corner between rates r0 and r1 (min-mod). Zero at extremums,
+    // to not overshoot peaks. Steps are not shaped, so corners next to them are
+    // kept as is.
+    static auto corner_velocity(float r0, float r1, bool step_before) -> float {
+        if (step_before) { return r1; }
+        if (r0 > 0 && r1 > 0) { return etl::min(r0, r1); }
+        if (r0 < 0 && r1 < 0) { return etl::max(r0, r1); }
+        return 0;
+    }
+
+    // Trapezoidal velocity profile v0 -> vc -> v1 within [t0, t1], covering
+    // v1 - v0 exactly. Units are ms and 1/100 degrees. If acceleration is not
+    // enough to fit, it's increased up to ACCEL_MAX_X100, then falls back to
+    // plain linear segment.
+    void shape_segment(int32_t t0, int32_t t1, int32_t y0, int32_t y1, float v0, float v1, float accel) {
+        const float T = static_cast<float>(t1 - t0);
+        const float D = static_cast<float>(y1 - y0);
+        const float accel_limit = static_cast<float>(ACCEL_MAX_X100) * 1e-6f;
+
+        // Distance, covered with cruise velocity vc
+        const auto area = [&](float vc, float a) {
+            return vc * T - (vc - v0) * fabsf(vc - v0) / (2 * a) - (vc - v1) * fabsf(vc - v1) / (2 * a);
+        };
+
+        for (float a = accel; a <= accel_limit * 1.001f; a *= 2) {
+            // Reachable cruise velocities: |vc - v0| + |vc - v1| <= a·T
+            const float half_span = (a * T - fabsf(v1 - v0)) / 2;
+            if (half_span < 0) { continue; }
+
+            float lo = etl::min(v0, v1) - half_span;
+            float hi = etl::max(v0, v1) + half_span;
+            if (area(lo, a) > D || area(hi, a) < D) { continue; }
+
+            // area() is monotonic in the valid range
+            for (int i = 0; i < 40; i++) {
+                const float mid = (lo + hi) / 2;
+                (area(mid, a) < D ? lo : hi) = mid;
+            }
+            const float vc = (lo + hi) / 2;
+
+            const auto ta = static_cast<int32_t>(fabsf(vc - v0) / a + 0.5f);
+            const auto td = static_cast<int32_t>(fabsf(vc - v1) / a + 0.5f);
+            const int32_t tc = etl::max(static_cast<int32_t>(T) - ta - td, int32_t{0});
+
+            // Pieces: accelerate, cruise, decelerate. Rounding error is
+            // absorbed by the cruise piece (or the last one, if no cruise),
+            // to end exactly at profile point.
+            struct Piece { int32_t duration; float slope; float accel; int32_t dy; };
+            Piece pieces[3] = {
+                { ta, v0, vc >= v0 ? a : -a, 0 },
+                { tc, vc, 0, 0 },
+                { static_cast<int32_t>(T) - ta - tc, vc, v1 >= vc ? a : -a, 0 }
+            };
+
+            size_t adjust = 2;
+            if (tc > 0) { adjust = 1; }
+            else { while (adjust > 0 && pieces[adjust].duration <= 0) { adjust--; } }
+
+            int32_t dy_rest = y1 - y0;
+            for (size_t i = 0; i < 3; i++) {
+                auto& p = pieces[i];
+                if (i == adjust || p.duration <= 0) { continue; }
+                const auto d = static_cast<float>(p.duration);
+                p.dy = static_cast<int32_t>(lroundf(p.slope * d + p.accel * d * d / 2));
+                dy_rest -= p.dy;
+            }
+
+            auto& adj = pieces[adjust];
+            const auto d_adj = static_cast<float>(adj.duration);
+            const float error = static_cast<float>(dy_rest) - (adj.slope * d_adj + adj.accel * d_adj * d_adj / 2);
+            if (adj.accel != 0) { adj.accel += 2 * error / (d_adj * d_adj); }
+            else { adj.slope += error / d_adj; }
+            adj.dy = dy_rest;
+
+            int32_t t = t0;
+            int32_t y = y0;
+            for (const auto& p : pieces) {
+                if (p.duration <= 0) { continue; }
+                segments.push_back(parabolic_segment(t, t + p.duration, y, y + p.dy, p.slope, p.accel));
+                t += p.duration;
+                y += p.dy;
+            }
+            return;
+        }
+
+        segments.push_back(compile_segment(t0, t1, y0, y1));
+    }
+
+    static auto parabolic_segment(int32_t t0, int32_t t1, int32_t v0, int32_t v1, float slope, float accel) -> Segment {
+        Segment s{SegmentKind::Parabolic, t0, t1, v0, v1, 0, 0, 0};
+        s.slope_q24 = static_cast<int32_t>(lroundf(slope * static_cast<float>(1 << 24)));
+        s.accel_q40 = static_cast<int32_t>(lroundf(accel * 1099511627776.0f));  // 2^40
+        return s;
+    }
+
+    static auto compile_segment(int32_t t0, int32_t t1, int32_t v0, int32_t v1) -> Segment {
+        Segment s{SegmentKind::Linear, t0, t1, v0, v1, 0, 0, 0};
+        const int32_t dt = t1 - t0;
+        const int32_t dv = v1 - v0;
+
+        if (dt <= 0) {
+            s.kind = SegmentKind::Step;
+            s.rate_x100 = dv > 0 ? RATE_MAX_X100 : (dv < 0 ? -RATE_MAX_X100 : 0);
+            return s;
+        }
+
+        // Round to nearest
+        const int64_t slope_num = static_cast<int64_t>(dv) << 24;
+        s.slope_q24 = static_cast<int32_t>((slope_num + (slope_num >= 0 ? dt / 2 : -dt / 2)) / dt);
+
+        const int64_t rate_num = static_cast<int64_t>(dv) * x_axis_multiplier;
+        const int64_t rate = (rate_num + (rate_num >= 0 ? dt / 2 : -dt / 2)) / dt;
+        s.rate_x100 = static_cast<int32_t>(etl::clamp(rate, int64_t{-RATE_MAX_X100}, int64_t{RATE_MAX_X100}));
+        return s;
+    }
+
+    // Segment, active at given time: the first one, ending at or after it
+    // (at boundaries previous segment wins).
+    auto seek(int32_t offset_x1000) -> const Segment* {
+        if (offset_x1000 < 0 || segments.empty()) { return nullptr; }
+        if (offset_x1000 > segments.back().t1_x1000) { return nullptr; }
+
+        // Rewind if time went back
+        if (cursor >= segments.size() || (cursor > 0 && segments[cursor - 1].t1_x1000 >= offset_x1000)) {
+            cursor = 0;
+        }
+        while (segments[cursor].t1_x1000 < offset_x1000) { cursor++; }
+
+        return &segments[cursor];
+    }
+};
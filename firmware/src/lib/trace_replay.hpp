@@ -0,0 +1,262 @@
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+#include "components/temperature_processor.hpp"
+#include "lib/adc_interpolator.hpp"
+#include "lib/adrc.hpp"
+#include "lib/decimation_filter.hpp"
+#include "lib/ina_filter.hpp"
+#include "lib/sample_trace.hpp"
+#include "lib/tcr_kalman.hpp"
+
+// Pushes a recorded trace through the same processing chain as firmware
+// (ADC decimation FIR stage and interpolator, INA filter, temperature
+// processors, TCR Kalman filter, ADRC). Raw ADC samples are too many for the
+// trace, recording starts from CIC stage outputs. CIC is exact integer math,
+// so nothing is lost for FIR experiments.
+//
+// Controller ticks are verified against recorded values. Any mismatch means
+// the replayed chain differs from the one that produced the trace. That's
+// expected when experimenting with filter/controller changes, and the
+// override hook can be used to dump both variants for comparison.
+class TraceReplay {
+public:
+    // Keep in sync with Head
+    static constexpr uint32_t ADC_CIC_DECIMATION = 20;
+    static constexpr uint32_t ADC_FIR_DECIMATION = 40;
+    using AdcFilter = DecimationFilter<ADC_CIC_DECIMATION, ADC_FIR_DECIMATION, ADC_FIR_DECIMATION * 4 + 1>;
+    static constexpr uint32_t ADC_VALUE_SCALE = AdcFilter::OUTPUT_SCALE;
+    static constexpr size_t LUT_SIZE_MAX = 100;
+    static constexpr uint32_t INITIAL_SENSOR_UV = 800 * 1000;
+    static constexpr int32_t UNKNOWN_TEMPERATURE_X10 = 10'000 * 10;
+    static constexpr uint32_t UNKNOWN_RESISTANCE = 0xFFFFFFFF;
+
+    struct Stats {
+        uint32_t records = 0;
+        uint32_t gaps = 0;            // Gap records
+        uint32_t dropped = 0;         // Records lost in gaps
+        uint32_t control_ticks = 0;
+        uint32_t temperature_mismatches = 0;
+        uint32_t power_mismatches = 0;
+    };
+
+    TraceReplay() {
+        temperature_processor_rtd.set_sensor_type(SensorType_RTD);
+        temperature_processor_tcr.set_sensor_type(SensorType_TCR);
+    }
+
+    virtual ~TraceReplay() = default;
+
+    // Called for each replayed controller iteration.
+    virtual void on_control_tick(uint32_t /*ts_ms*/, const SampleTrace::ControlTick& /*recorded*/,
+                                 int32_t /*temperature_x10*/, float /*power*/) {}
+
+    // Returns false if stream is broken/truncated before the end.
+    auto run(const uint8_t* data, size_t size) -> bool {
+        SampleTraceReader reader(data, size);
+        SampleTraceReader::Record r{};
+
+        while (reader.next(r)) { process(r); }
+        return reader.offset() == size;
+    }
+
+    void process(const SampleTraceReader::Record& r) {
+        stats.records++;
+
+        switch (r.type) {
+            case SampleTrace::RecordType::Start:
+                ina_chip = static_cast<InaFilter::Chip>(r.ina_chip);
+                pulse_recorded = false;
+                adc_state_known = false;
+                break;
+
+            case SampleTrace::RecordType::Gap:
+                stats.gaps++;
+                stats.dropped += r.value;
+                break;
+
+            case SampleTrace::RecordType::AdcLut:
+                adc_interpolator.points.clear();
+                for (size_t i = 0; i < r.lut_count && i < LUT_SIZE_MAX; i++) {
+                    const uint8_t* p = r.lut_data + i * 4;
+                    adc_interpolator.points.push_back({
+                        .raw = static_cast<uint16_t>(p[0] | (p[1] << 8)),
+                        .mV = static_cast<uint16_t>(p[2] | (p[3] << 8))
+                    });
+                }
+                adc_interpolator.rebuild();
+                break;
+
+            case SampleTrace::RecordType::SensorConfig: {
+                const auto& c = r.sensor_config;
+                is_tcr = c.is_tcr;
+                temperature_processor_rtd.set_cal_points(c.p0_at, c.p0_value, c.p1_at, c.p1_value);
+                temperature_processor_tcr.set_cal_points(c.p0_at, c.p0_value, c.p1_at, c.p1_value);
+                temperature_processor_tcr.set_tcr_points(c.tcr_at, c.tcr_value, c.tcr_count);
+                adrc.set_params(c.adrc_b0, c.adrc_response, c.adrc_n_coeff, c.adrc_m_coeff);
+                tcr_kalman.set_params(c.adrc_b0, c.adrc_response);
+                tcr_kalman.reset();
+                break;
+            }
+            case SampleTrace::RecordType::AdcCic:
+                // Filter state is unknown until recorded
+                if (!adc_state_known) { break; }
+                for (size_t i = 0; i < r.adc_count; i++) {
+                    if (adc_filter.push_fir(r.adc_values[i])) {
+                        adc_value = adc_filter.get_output();
+                        adc_value_valid = true;
+                    }
+                }
+                break;
+
+            case SampleTrace::RecordType::SensorUpdate:
+                if (adc_state_known) { update_sensor_uv(); }
+                break;
+
+            case SampleTrace::RecordType::InaSample:
+                ina_filter.push({
+                    .v_raw = r.v_raw,
+                    .i_raw = static_cast<int16_t>(r.i_raw),
+                    .ctx_idx = r.ctx_idx
+                });
+                break;
+
+            case SampleTrace::RecordType::PwmEdge:
+                if (r.pwm_event == SampleTrace::PwmEvent::PulseStart) {
+                    ina_filter.clear();
+                    pulse_recorded = true;
+                }
+                if (r.pwm_event == SampleTrace::PwmEvent::PulseEnd) {
+                    // Samples of a pulse started before recording are
+                    // incomplete, result comes in DrainInfo.
+                    if (pulse_recorded) { ina_filter.process(ina_chip, drain_info, r.ts_ms); }
+                    else { ina_filter.clear(); }
+                }
+                break;
+
+            case SampleTrace::RecordType::DrainReset:
+                ina_filter.clear();
+                drain_info = InaFilter::Result{};
+                break;
+
+            case SampleTrace::RecordType::ControlReset:
+                adrc.reset_to(static_cast<float>(get_temperature_x10()) * 0.1f);
+                break;
+
+            case SampleTrace::RecordType::ControlTick:
+                control_tick(r.ts_ms, r.control);
+                break;
+
+            case SampleTrace::RecordType::ThermalTick:
+                thermal_tick(r.thermal);
+                break;
+
+            case SampleTrace::RecordType::DrainInfo:
+                drain_info = r.drain;
+                ina_filter.set_seq(r.drain.seq);
+                break;
+
+            case SampleTrace::RecordType::AdcState:
+                // Filter differs from the recorded one, can't continue
+                if (r.adc_count != AdcFilter::TAPS) { break; }
+                adc_filter.set_fir_state({ r.adc.phase, r.adc.pos, r.adc.warmup, r.adc.output_x100 }, r.adc_values);
+                adc_state_known = true;
+                adc_value = r.adc.output_x100;
+                adc_value_valid = r.adc.valid;
+                update_sensor_uv();
+                break;
+
+            case SampleTrace::RecordType::TcrState:
+                tcr_kalman.set_state({ r.tcr.valid, r.tcr.x_q, r.tcr.p_q });
+                tcr_kalman_seq = r.tcr.seq;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    auto get_load_mohm() const -> uint32_t {
+        if (!drain_info.load_valid) { return UNKNOWN_RESISTANCE; }
+        return drain_info.peak_mv * 1000 / drain_info.peak_ma;
+    }
+
+    auto get_temperature_x10() -> int32_t {
+        if (!is_tcr) { return temperature_processor_rtd.get_temperature_x10(sensor_uv); }
+
+        if (!tcr_kalman.is_valid()) { return UNKNOWN_TEMPERATURE_X10; }
+        return tcr_kalman.get_temperature_x10();
+    }
+
+    // Last resistance-derived temperature, without filtering. For comparison.
+    auto get_raw_temperature_x10() -> int32_t {
+        const auto mohms = get_load_mohm();
+        if (mohms == UNKNOWN_RESISTANCE) { return UNKNOWN_TEMPERATURE_X10; }
+        return temperature_processor_tcr.get_temperature_x10(mohms);
+    }
+
+    auto get_temperature_variance_x100() const -> uint32_t { return tcr_kalman.get_variance_x100(); }
+
+    auto get_sensor_uv() const -> uint32_t { return sensor_uv; }
+    auto get_drain_info() const -> const InaFilter::Result& { return drain_info; }
+
+    Stats stats{};
+
+private:
+    GridAdcInterpolator<LUT_SIZE_MAX> adc_interpolator{};
+    InaFilter ina_filter{};
+    InaFilter::Chip ina_chip{InaFilter::Chip::Unknown};
+    InaFilter::Result drain_info{};
+    TemperatureProcessor temperature_processor_rtd{};
+    TemperatureProcessor temperature_processor_tcr{};
+    ADRC adrc{};
+    TcrKalman tcr_kalman{};
+    uint32_t tcr_kalman_seq{0};
+    bool is_tcr{true};
+    bool pulse_recorded{false};
+
+    AdcFilter adc_filter{};
+    bool adc_state_known{false};
+    uint32_t adc_value{0};
+    bool adc_value_valid{false};
+    uint32_t sensor_uv{INITIAL_SENSOR_UV};
+
+    void update_sensor_uv() {
+        if (!adc_value_valid) { return; }
+        sensor_uv = adc_interpolator.to_uv(adc_value, ADC_VALUE_SCALE);
+    }
+
+    // Same as Head::update_temperature_estimate()
+    void thermal_tick(const SampleTrace::ThermalTick& tick) {
+        if (!drain_info.load_valid) {
+            tcr_kalman.reset();
+            return;
+        }
+
+        tcr_kalman.predict(tick.dt_ms, tick.power_mw);
+        if (drain_info.seq != tcr_kalman_seq || !tcr_kalman.is_valid()) {
+            tcr_kalman_seq = drain_info.seq;
+            tcr_kalman.update(get_raw_temperature_x10(), drain_info.samples);
+        }
+    }
+
+    void control_tick(uint32_t ts_ms, const SampleTrace::ControlTick& recorded) {
+        static constexpr float dt_inv_multiplier = 1.0F / 1000;
+
+        const int32_t temperature_x10 = get_temperature_x10();
+        const float temperature = static_cast<float>(temperature_x10) * 0.1f;
+        const float dt = static_cast<float>(recorded.dt_ms) * dt_inv_multiplier;
+        const float age = static_cast<float>(recorded.temperature_age_ms) * dt_inv_multiplier;
+
+        const float power = adrc.iterate(temperature, recorded.setpoint, recorded.power_max,
+                                         dt, recorded.setpoint_rate, age);
+
+        stats.control_ticks++;
+        if (temperature_x10 != recorded.temperature_x10) { stats.temperature_mismatches++; }
+        if (power != recorded.power_out) { stats.power_mismatches++; }
+
+        on_control_tick(ts_ms, recorded, temperature_x10, power);
+    }
+};
@@ -9,10 +9,13 @@ namespace SharedConstants {
   inline constexpr int HISTORY_ID_SENSOR_BAKE_MODE = 4000;
   inline constexpr int HISTORY_ID_ADRC_TEST_MODE = 4001;
   inline constexpr int HISTORY_ID_STEP_RESPONSE = 4002;
+  inline constexpr int HISTORY_ID_RELAY_TUNE = 4003;
+  inline constexpr int HISTORY_ID_TCR_CALIBRATION = 4004;
   inline constexpr int MAX_RPC_MESSAGE_SIZE = 4096;
   inline constexpr int MAX_AUTH_RPC_MESSAGE_SIZE = 1024;
   inline constexpr int MAX_PROFILE_NAME_LENGTH = 50;
   inline constexpr int MAX_REFLOW_SEGMENTS = 10;
   inline constexpr int MAX_REFLOW_PROFILES = 10;
   inline constexpr int MAX_HISTORY_CHUNK = 100;
+  inline constexpr int MAX_TCR_CAL_POINTS = 8;
 } // namespace SharedConstants
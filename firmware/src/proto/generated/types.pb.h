@@ -22,7 +22,9 @@ typedef enum _ConstantsBase {
     /* History IDs for tasks (selected to not conflict with profile IDs) */
     HISTORY_ID_SENSOR_BAKE_MODE = 4000,
     HISTORY_ID_ADRC_TEST_MODE = 4001,
-    HISTORY_ID_STEP_RESPONSE = 4002
+    HISTORY_ID_STEP_RESPONSE = 4002,
+    HISTORY_ID_RELAY_TUNE = 4003,
+    HISTORY_ID_TCR_CALIBRATION = 4004
 } ConstantsBase;
 
 typedef enum _SensorType {
@@ -57,9 +59,22 @@ typedef enum _DeviceActivityStatus {
     DeviceActivityStatus_SENSOR_BAKE = 2,
     DeviceActivityStatus_ADRC_TEST = 3,
     DeviceActivityStatus_STEP_RESPONSE = 4,
-    DeviceActivityStatus_BONDING = 5
+    DeviceActivityStatus_BONDING = 5,
+    DeviceActivityStatus_BATCH_COOLDOWN = 6,
+    DeviceActivityStatus_RELAY_TUNE = 7,
+    DeviceActivityStatus_TCR_CALIBRATION = 8
 } DeviceActivityStatus;
 
+/* Reason of the last task stop by heater fault supervisor */
+typedef enum _HeaterFault {
+    HeaterFault_FAULT_NONE = 0,
+    HeaterFault_FAULT_OPEN_HEATER = 1,
+    HeaterFault_FAULT_RESISTANCE_JUMP = 2,
+    HeaterFault_FAULT_STUCK_READING = 3,
+    HeaterFault_FAULT_NO_HEATING = 4, /* Power delivered, but temperature does not follow */
+    HeaterFault_FAULT_HEATING_WITHOUT_POWER = 5
+} HeaterFault;
+
 /* Struct definitions */
 typedef struct _Segment {
     /* Target temperature in Celsius */
@@ -76,6 +91,9 @@ typedef struct _Profile {
     /* Temperature segments sequence */
     pb_size_t segments_count;
     Segment segments[10];
+    /* Solder liquidus, Celsius. Used for quality metrics, SAC305 if not set */
+    bool has_liquidus;
+    float liquidus;
 } Profile;
 
 typedef struct _ProfilesData {
@@ -96,6 +114,10 @@ typedef struct _HistoryChunk {
     int32_t version;
     pb_size_t data_count;
     Point data[100];
+    /* Temperature rate of change at each point, °C/s x100. Same length as
+ `data`, or empty if not supported. */
+    pb_size_t rate_x100_count;
+    int32_t rate_x100[100];
 } HistoryChunk;
 
 typedef struct _HeadParams {
@@ -114,6 +136,12 @@ typedef struct _HeadParams {
     /* ω_controller = ω_observer / M. Usually 2..5
  3 is a good starting point. Changes are probably not required. */
     float adrc_m_coeff;
+    /* Multi-point TCR calibration (temperature / heater resistance pairs),
+ piecewise linear. Overrides p0/p1 points, when 2+ pairs set. */
+    pb_size_t sensor_tcr_at_count;
+    float sensor_tcr_at[8];
+    pb_size_t sensor_tcr_value_count;
+    float sensor_tcr_value[8];
 } HeadParams;
 
 typedef struct _DeviceInfo {
@@ -131,6 +159,12 @@ typedef struct _DeviceInfo {
     /* Max possible power in mW, for current heater resistance
  at current PD profile */
     uint32_t max_mw;
+    /* Temperature estimate variance, °C² x100 (TCR Kalman filter) */
+    uint32_t temperature_variance_x100;
+    /* Temperature rate of change, °C/s x100 */
+    int32_t rate_x100;
+    /* Cleared on next task start */
+    HeaterFault fault;
 } DeviceInfo;
 
 
@@ -143,8 +177,8 @@ extern "C" {
 
 /* Helper constants for enums */
 #define _ConstantsBase_MIN CONSTANT_UNSPECIFIED
-#define _ConstantsBase_MAX HISTORY_ID_STEP_RESPONSE
-#define _ConstantsBase_ARRAYSIZE ((ConstantsBase)(HISTORY_ID_STEP_RESPONSE+1))
+#define _ConstantsBase_MAX HISTORY_ID_TCR_CALIBRATION
+#define _ConstantsBase_ARRAYSIZE ((ConstantsBase)(HISTORY_ID_TCR_CALIBRATION+1))
 #define ConstantsBase_CONSTANT_UNSPECIFIED CONSTANT_UNSPECIFIED
 #define ConstantsBase_MAX_BLE_NAME_LENGTH MAX_BLE_NAME_LENGTH
 #define ConstantsBase_MAX_TOUCH_SAFE_TEMPERATURE MAX_TOUCH_SAFE_TEMPERATURE
@@ -152,6 +186,8 @@ extern "C" {
 #define ConstantsBase_HISTORY_ID_SENSOR_BAKE_MODE HISTORY_ID_SENSOR_BAKE_MODE
 #define ConstantsBase_HISTORY_ID_ADRC_TEST_MODE HISTORY_ID_ADRC_TEST_MODE
 #define ConstantsBase_HISTORY_ID_STEP_RESPONSE HISTORY_ID_STEP_RESPONSE
+#define ConstantsBase_HISTORY_ID_RELAY_TUNE HISTORY_ID_RELAY_TUNE
+#define ConstantsBase_HISTORY_ID_TCR_CALIBRATION HISTORY_ID_TCR_CALIBRATION
 
 #define _SensorType_MIN SensorType_RTD
 #define _SensorType_MAX SensorType_TCR
@@ -170,8 +206,12 @@ extern "C" {
 #define _DeviceHealthStatus_ARRAYSIZE ((DeviceHealthStatus)(DeviceHealthStatus_DEV_FAILURE+1))
 
 #define _DeviceActivityStatus_MIN DeviceActivityStatus_IDLE
-#define _DeviceActivityStatus_MAX DeviceActivityStatus_BONDING
-#define _DeviceActivityStatus_ARRAYSIZE ((DeviceActivityStatus)(DeviceActivityStatus_BONDING+1))
+#define _DeviceActivityStatus_MAX DeviceActivityStatus_TCR_CALIBRATION
+#define _DeviceActivityStatus_ARRAYSIZE ((DeviceActivityStatus)(DeviceActivityStatus_TCR_CALIBRATION+1))
+
+#define _HeaterFault_MIN HeaterFault_FAULT_NONE
+#define _HeaterFault_MAX HeaterFault_FAULT_HEATING_WITHOUT_POWER
+#define _HeaterFault_ARRAYSIZE ((HeaterFault)(HeaterFault_FAULT_HEATING_WITHOUT_POWER+1))
 
 
 
@@ -183,23 +223,24 @@ extern "C" {
 #define DeviceInfo_activity_ENUMTYPE DeviceActivityStatus
 #define DeviceInfo_power_ENUMTYPE PowerStatus
 #define DeviceInfo_head_ENUMTYPE HeadStatus
+#define DeviceInfo_fault_ENUMTYPE HeaterFault
 
 
 /* Initializer values for message structs */
 #define Segment_init_default                     {0, 0}
-#define Profile_init_default                     {0, "", 0, {Segment_init_default, Segment_init_default, Segment_init_default, Segment_init_default, Segment_init_default, Segment_init_default, Segment_init_default, Segment_init_default, Segment_init_default, Segment_init_default}}
+#define Profile_init_default                     {0, "", 0, {Segment_init_default, Segment_init_default, Segment_init_default, Segment_init_default, Segment_init_default, Segment_init_default, Segment_init_default, Segment_init_default, Segment_init_default, Segment_init_default}, false, 0}
 #define ProfilesData_init_default                {0, {Profile_init_default, Profile_init_default, Profile_init_default, Profile_init_default, Profile_init_default, Profile_init_default, Profile_init_default, Profile_init_default, Profile_init_default, Profile_init_default}, 0}
 #define Point_init_default                       {0, 0}
-#define HistoryChunk_init_default                {0, 0, 0, {Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default}}
-#define HeadParams_init_default                  {0, 0, 0, 0, 0, 0, 0, 0}
-#define DeviceInfo_init_default                  {_DeviceHealthStatus_MIN, _DeviceActivityStatus_MIN, _PowerStatus_MIN, _HeadStatus_MIN, 0, 0, 0, 0, 0, 0}
+#define HistoryChunk_init_default                {0, 0, 0, {Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default, Point_init_default}, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}}
+#define HeadParams_init_default                  {0, 0, 0, 0, 0, 0, 0, 0, 0, {0, 0, 0, 0, 0, 0, 0, 0}, 0, {0, 0, 0, 0, 0, 0, 0, 0}}
+#define DeviceInfo_init_default                  {_DeviceHealthStatus_MIN, _DeviceActivityStatus_MIN, _PowerStatus_MIN, _HeadStatus_MIN, 0, 0, 0, 0, 0, 0, 0, 0, _HeaterFault_MIN}
 #define Segment_init_zero                        {0, 0}
-#define Profile_init_zero                        {0, "", 0, {Segment_init_zero, Segment_init_zero, Segment_init_zero, Segment_init_zero, Segment_init_zero, Segment_init_zero, Segment_init_zero, Segment_init_zero, Segment_init_zero, Segment_init_zero}}
+#define Profile_init_zero                        {0, "", 0, {Segment_init_zero, Segment_init_zero, Segment_init_zero, Segment_init_zero, Segment_init_zero, Segment_init_zero, Segment_init_zero, Segment_init_zero, Segment_init_zero, Segment_init_zero}, false, 0}
 #define ProfilesData_init_zero                   {0, {Profile_init_zero, Profile_init_zero, Profile_init_zero, Profile_init_zero, Profile_init_zero, Profile_init_zero, Profile_init_zero, Profile_init_zero, Profile_init_zero, Profile_init_zero}, 0}
 #define Point_init_zero                          {0, 0}
-#define HistoryChunk_init_zero                   {0, 0, 0, {Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero}}
-#define HeadParams_init_zero                     {0, 0, 0, 0, 0, 0, 0, 0}
-#define DeviceInfo_init_zero                     {_DeviceHealthStatus_MIN, _DeviceActivityStatus_MIN, _PowerStatus_MIN, _HeadStatus_MIN, 0, 0, 0, 0, 0, 0}
+#define HistoryChunk_init_zero                   {0, 0, 0, {Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero, Point_init_zero}, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}}
+#define HeadParams_init_zero                     {0, 0, 0, 0, 0, 0, 0, 0, 0, {0, 0, 0, 0, 0, 0, 0, 0}, 0, {0, 0, 0, 0, 0, 0, 0, 0}}
+#define DeviceInfo_init_zero                     {_DeviceHealthStatus_MIN, _DeviceActivityStatus_MIN, _PowerStatus_MIN, _HeadStatus_MIN, 0, 0, 0, 0, 0, 0, 0, 0, _HeaterFault_MIN}
 
 /* Field tags (for use in manual encoding/decoding) */
 #define Segment_target_tag                       1
@@ -207,6 +248,7 @@ extern "C" {
 #define Profile_id_tag                           1
 #define Profile_name_tag                         2
 #define Profile_segments_tag                     3
+#define Profile_liquidus_tag                     4
 #define ProfilesData_items_tag                   1
 #define ProfilesData_selected_id_tag             2
 #define Point_x_tag                              1
@@ -214,6 +256,7 @@ extern "C" {
 #define HistoryChunk_type_tag                    1
 #define HistoryChunk_version_tag                 2
 #define HistoryChunk_data_tag                    3
+#define HistoryChunk_rate_x100_tag               4
 #define HeadParams_sensor_p0_at_tag              1
 #define HeadParams_sensor_p0_value_tag           2
 #define HeadParams_sensor_p1_at_tag              3
@@ -222,6 +265,8 @@ extern "C" {
 #define HeadParams_adrc_b0_tag                   6
 #define HeadParams_adrc_n_coeff_tag              7
 #define HeadParams_adrc_m_coeff_tag              8
+#define HeadParams_sensor_tcr_at_tag             9
+#define HeadParams_sensor_tcr_value_tag          10
 #define DeviceInfo_health_tag                    1
 #define DeviceInfo_activity_tag                  2
 #define DeviceInfo_power_tag                     3
@@ -232,6 +277,9 @@ extern "C" {
 #define DeviceInfo_duty_x1000_tag                8
 #define DeviceInfo_resistance_mohms_tag          9
 #define DeviceInfo_max_mw_tag                    10
+#define DeviceInfo_temperature_variance_x100_tag 11
+#define DeviceInfo_rate_x100_tag                 12
+#define DeviceInfo_fault_tag                     13
 #define reflow_export_name_tag                   50003
 
 /* Struct field encoding specification for nanopb */
@@ -244,7 +292,8 @@ X(a, STATIC,   SINGULAR, INT32,    duration,          2)
 #define Profile_FIELDLIST(X, a) \
 X(a, STATIC,   SINGULAR, INT32,    id,                1) \
 X(a, STATIC,   SINGULAR, STRING,   name,              2) \
-X(a, STATIC,   REPEATED, MESSAGE,  segments,          3)
+X(a, STATIC,   REPEATED, MESSAGE,  segments,          3) \
+X(a, STATIC,   OPTIONAL, FLOAT,    liquidus,          4)
 #define Profile_CALLBACK NULL
 #define Profile_DEFAULT NULL
 #define Profile_segments_MSGTYPE Segment
@@ -265,7 +314,8 @@ X(a, STATIC,   SINGULAR, FLOAT,    y,                 2)
 #define HistoryChunk_FIELDLIST(X, a) \
 X(a, STATIC,   SINGULAR, INT32,    type,              1) \
 X(a, STATIC,   SINGULAR, INT32,    version,           2) \
-X(a, STATIC,   REPEATED, MESSAGE,  data,              3)
+X(a, STATIC,   REPEATED, MESSAGE,  data,              3) \
+X(a, STATIC,   REPEATED, SINT32,   rate_x100,         4)
 #define HistoryChunk_CALLBACK NULL
 #define HistoryChunk_DEFAULT NULL
 #define HistoryChunk_data_MSGTYPE Point
@@ -278,7 +328,9 @@ X(a, STATIC,   SINGULAR, FLOAT,    sensor_p1_value,   4) \
 X(a, STATIC,   SINGULAR, FLOAT,    adrc_response,     5) \
 X(a, STATIC,   SINGULAR, FLOAT,    adrc_b0,           6) \
 X(a, STATIC,   SINGULAR, FLOAT,    adrc_n_coeff,      7) \
-X(a, STATIC,   SINGULAR, FLOAT,    adrc_m_coeff,      8)
+X(a, STATIC,   SINGULAR, FLOAT,    adrc_m_coeff,      8) \
+X(a, STATIC,   REPEATED, FLOAT,    sensor_tcr_at,     9) \
+X(a, STATIC,   REPEATED, FLOAT,    sensor_tcr_value,  10)
 #define HeadParams_CALLBACK NULL
 #define HeadParams_DEFAULT NULL
 
@@ -292,7 +344,10 @@ X(a, STATIC,   SINGULAR, UINT32,   peak_mv,           6) \
 X(a, STATIC,   SINGULAR, UINT32,   peak_ma,           7) \
 X(a, STATIC,   SINGULAR, UINT32,   duty_x1000,        8) \
 X(a, STATIC,   SINGULAR, UINT32,   resistance_mohms,   9) \
-X(a, STATIC,   SINGULAR, UINT32,   max_mw,           10)
+X(a, STATIC,   SINGULAR, UINT32,   max_mw,           10) \
+X(a, STATIC,   SINGULAR, UINT32,   temperature_variance_x100,  11) \
+X(a, STATIC,   SINGULAR, SINT32,   rate_x100,        12) \
+X(a, STATIC,   SINGULAR, UENUM,    fault,            13)
 #define DeviceInfo_CALLBACK NULL
 #define DeviceInfo_DEFAULT NULL
 
@@ -314,12 +369,12 @@ extern const pb_msgdesc_t DeviceInfo_msg;
 #define DeviceInfo_fields &DeviceInfo_msg
 
 /* Maximum encoded size of messages (where known) */
-#define DeviceInfo_size                          49
-#define HeadParams_size                          40
-#define HistoryChunk_size                        1222
+#define DeviceInfo_size                          63
+#define HeadParams_size                          108
+#define HistoryChunk_size                        1725
 #define Point_size                               10
-#define Profile_size                             303
-#define ProfilesData_size                        3071
+#define Profile_size                             308
+#define ProfilesData_size                        3121
 #define Segment_size                             22
 #define TYPES_PB_H_MAX_SIZE                      ProfilesData_size
 
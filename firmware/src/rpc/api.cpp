@@ -7,12 +7,20 @@
 
 #include "api.hpp"
 #include "app.hpp"
+#include "app_states/reflow.hpp"
 #include "auth_utils.hpp"
 #include "ble_auth_store.hpp"
 #include "components/pb2struct.hpp"
 #include "components/prefs.hpp"
 #include "components/profiles_config.hpp"
+#include "components/sample_recorder.hpp"
+#include "components/temperature_processor.hpp"
+#include "components/time.hpp"
+#include "heater/drain_tracker.hpp"
+#include "heater/head.hpp"
 #include "heater/heater.hpp"
+#include "heater/power.hpp"
+#include "lib/reflow_forecast.hpp"
 #include "rpc.hpp"
 #include "session.hpp"
 #include "proto/generated/shared_constants.hpp"
@@ -172,7 +180,10 @@ void get_status(const RpcParams& params, RpcResponse& response, Session&) {
         .peak_ma = static_cast<uint32_t>(heater.get_amperes() * 1000),
         .duty_x1000 = static_cast<uint32_t>(heater.get_duty_cycle() * 1000),
         .resistance_mohms = static_cast<uint32_t>(heater.get_resistance() * 1000),
-        .max_mw = static_cast<uint32_t>(heater.get_max_power() * 1000)
+        .max_mw = static_cast<uint32_t>(heater.get_max_power() * 1000),
+        .temperature_variance_x100 = static_cast<uint32_t>(heater.get_temperature_variance() * 100),
+        .rate_x100 = heater.get_temperature_rate_x100(),
+        .fault = heater.get_fault()
     };
 
     etl::vector<uint8_t, DeviceInfo_size> buffer{};
@@ -256,6 +267,19 @@ void run_reflow(const RpcParams& params, RpcResponse& response, Session&) {
     response.write_bool(application.get_state_id() == DeviceActivityStatus_REFLOW);
 }
 
+// Params: runs count, auto start (false = wait for button press between runs).
+void run_batch(const RpcParams& params, RpcResponse& response, Session&) {
+    uint32_t count = 0;
+    bool auto_start = false;
+    if (!params.has_count(2) || !params.get_uint32(0, count) || !params.get_bool(1, auto_start) || count == 0) {
+        response.write_error("Invalid params");
+        return;
+    }
+
+    application.receive(AppCmd::Batch{count, auto_start});
+    response.write_bool(application.get_state_id() == DeviceActivityStatus_REFLOW);
+}
+
 void run_sensor_bake(const RpcParams& params, RpcResponse& response, Session&) {
     float watts = 0;
     if (!params.has_count(1) || !params.get_float(0, watts)) {
@@ -289,6 +313,47 @@ void run_step_response(const RpcParams& params, RpcResponse& response, Session&)
     response.write_bool(application.get_state_id() == DeviceActivityStatus_STEP_RESPONSE);
 }
 
+// Params: setpoint temperature, relay power (W). Power toggles between
+// given value and zero around setpoint.
+void run_relay_tune(const RpcParams& params, RpcResponse& response, Session&) {
+    float temperature = 0;
+    float watts = 0;
+    if (!params.has_count(2) || !params.get_float(0, temperature) || !params.get_float(1, watts) || watts <= 0) {
+        response.write_error("Invalid params");
+        return;
+    }
+
+    application.receive(AppCmd::RelayTune{temperature, watts});
+    response.write_bool(application.get_state_id() == DeviceActivityStatus_RELAY_TUNE);
+}
+
+// Params: max power (W), steps count. Power levels are max * i / steps.
+void run_tcr_calibration(const RpcParams& params, RpcResponse& response, Session&) {
+    float watts = 0;
+    uint32_t steps = 0;
+    if (!params.has_count(2) || !params.get_float(0, watts) || !params.get_uint32(1, steps)) {
+        response.write_error("Invalid params");
+        return;
+    }
+
+    application.receive(AppCmd::TcrCalibrate{watts, steps});
+    response.write_bool(application.get_state_id() == DeviceActivityStatus_TCR_CALIBRATION);
+}
+
+// Params: reference temperature at current plateau. Returns false if plateau
+// is not reached yet.
+void tcr_calibration_reference(const RpcParams& params, RpcResponse& response, Session&) {
+    float temperature = 0;
+    if (!params.has_count(1) || !params.get_float(0, temperature)) {
+        response.write_error("Invalid params");
+        return;
+    }
+
+    const auto step = application.get_tcr_calibration_snapshot().get_step();
+    application.receive(AppCmd::TcrReference{temperature});
+    response.write_bool(application.get_tcr_calibration_snapshot().get_step() != step);
+}
+
 void get_head_params(const RpcParams& params, RpcResponse& response, Session&) {
     if (!params.has_count(0)) {
         response.write_error("Invalid params");
@@ -364,9 +429,9 @@ void get_pd_profiles(const RpcParams& params, RpcResponse& response, Session&) {
     }
 
     etl::vector<uint8_t, pd::MaxPdoObjects * sizeof(uint32_t)> raw_pdos{};
-    raw_pdos.reserve(power.source_caps.size() * sizeof(uint32_t));
+    raw_pdos.reserve(power.fsm.source_caps.size() * sizeof(uint32_t));
 
-    for (auto pdo : power.source_caps) {
+    for (auto pdo : power.fsm.source_caps) {
         raw_pdos.push_back(static_cast<uint8_t>(pdo & 0xFF));
         raw_pdos.push_back(static_cast<uint8_t>((pdo >> 8) & 0xFF));
         raw_pdos.push_back(static_cast<uint8_t>((pdo >> 16) & 0xFF));
@@ -402,6 +467,442 @@ void set_ble_name(const RpcParams& params, RpcResponse& response, Session&) {
     response.write_bool(true);
 }
 
+void trace_start(const RpcParams& params, RpcResponse& response, Session&) {
+    if (!params.has_count(0)) {
+        response.write_error("Invalid params");
+        return;
+    }
+
+    sample_recorder.start();
+    response.write_bool(true);
+}
+
+void trace_stop(const RpcParams& params, RpcResponse& response, Session&) {
+    if (!params.has_count(0)) {
+        response.write_error("Invalid params");
+        return;
+    }
+
+    sample_recorder.stop();
+    response.write_bool(true);
+}
+
+// Returns next chunk of recorded trace. Empty chunk means no new data yet.
+void trace_read(const RpcParams& params, RpcResponse& response, Session&) {
+    if (!params.has_count(0)) {
+        response.write_error("Invalid params");
+        return;
+    }
+
+    etl::vector<uint8_t, SharedConstants::MAX_RPC_MESSAGE_SIZE - RPC_ENVELOPE_SLACK> buffer{};
+    buffer.resize(buffer.max_size());
+    buffer.resize(sample_recorder.read(buffer.data(), buffer.size()));
+    response.write_binary(buffer);
+}
+
+using LatencyBuffer = etl::vector<uint8_t, 128>;
+
+auto latency_data(LatencyBuffer& output) -> bool {
+    const uint32_t now = Time::now();
+    auto age = [now](uint32_t ts) -> uint32_t {
+        const auto d = static_cast<int32_t>(now - ts);
+        return d > 0 ? static_cast<uint32_t>(d) : 0;
+    };
+
+    const auto sensor = head.get_sensor_uv_snapshot();
+    const auto drain = drain_tracker.get_info();
+
+    output.clear();
+    output.resize(output.max_size());
+
+    CborEncoder encoder;
+    CborEncoder map;
+    cbor_encoder_init(&encoder, output.data(), output.size(), 0);
+
+    CborError error = cbor_encoder_create_map(&encoder, &map, 5);
+    // Time since last ADC filter output, and filter group delay on top of it
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "adc_age_ms");
+    if (error == CborNoError) error = cbor_encode_uint(&map, age(sensor.timestamp_ms));
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "adc_delay_ms");
+    if (error == CborNoError) error = cbor_encode_uint(&map, Head::TEMPERATURE_GROUP_DELAY_US / 1000);
+    // Time since last heater V/I measurement (end of PWM pulse)
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "ina_age_ms");
+    if (error == CborNoError) {
+        error = drain.load_valid ? cbor_encode_uint(&map, age(drain.timestamp_ms)) : cbor_encode_null(&map);
+    }
+    // Age of temperature now, and of one used by the last controller tick
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "temperature_age_ms");
+    if (error == CborNoError) error = cbor_encode_uint(&map, heater.get_temperature_age_ms());
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "control_age_ms");
+    if (error == CborNoError) error = cbor_encode_uint(&map, heater.get_control_input_age_ms());
+    if (error == CborNoError) error = cbor_encoder_close_container_checked(&encoder, &map);
+
+    if (error != CborNoError) {
+        output.clear();
+        return false;
+    }
+
+    output.resize(cbor_encoder_get_buffer_size(&encoder, output.data()));
+    return true;
+}
+
+// Measurement ages per pipeline stage, for latency diagnostics.
+void get_latency(const RpcParams& params, RpcResponse& response, Session&) {
+    if (!params.has_count(0)) {
+        response.write_error("Invalid params");
+        return;
+    }
+
+    LatencyBuffer output{};
+    if (!latency_data(output)) {
+        response.write_error("Internal error");
+        return;
+    }
+
+    response.write_binary(output);
+}
+
+// Power envelope from current source capabilities. Power FSM picks the best
+// PDO on the fly, so take max over all of them.
+class PdEnvelopeForecast : public ReflowForecast {
+public:
+    explicit PdEnvelopeForecast(const ProfileSelector& selector) : selector{selector} {}
+
+    auto get_max_power_mw(uint32_t load_mohms) -> uint32_t override {
+        uint32_t max_mw = 0;
+        for (uint32_t i = 0; i < selector.descriptors.size(); i++) {
+            max_mw = etl::max(max_mw, selector.mw_max(i, load_mohms));
+        }
+        return max_mw;
+    }
+
+private:
+    const ProfileSelector& selector;
+};
+
+using ForecastBuffer = etl::vector<uint8_t, 256>;
+
+auto reflow_forecast_data(ForecastBuffer& output, const ReflowForecast::Result& r) -> bool {
+    output.clear();
+    output.resize(output.max_size());
+
+    CborEncoder encoder;
+    CborEncoder map;
+    CborEncoder segments;
+    cbor_encoder_init(&encoder, output.data(), output.size(), 0);
+
+    CborError error = cbor_encoder_create_map(&encoder, &map, 9);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "feasible");
+    if (error == CborNoError) error = cbor_encode_boolean(&map, r.feasible);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "eta_s");
+    if (error == CborNoError) error = cbor_encode_uint(&map, r.eta_s);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "energy_j");
+    if (error == CborNoError) error = cbor_encode_uint(&map, r.energy_j);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "peak_x10");
+    if (error == CborNoError) error = cbor_encode_int(&map, r.peak_x10);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "peak_deviation_x10");
+    if (error == CborNoError) error = cbor_encode_int(&map, r.peak_deviation_x10);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "tal_s");
+    if (error == CborNoError) error = cbor_encode_uint(&map, r.tal_s);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "tal_deviation_s");
+    if (error == CborNoError) error = cbor_encode_int(&map, r.tal_deviation_s);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "max_lag_x10");
+    if (error == CborNoError) error = cbor_encode_int(&map, r.max_lag_x10);
+
+    // [[requested_x100, achieved_x100], ...]
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "rates_x100");
+    if (error == CborNoError) error = cbor_encoder_create_array(&map, &segments, r.segments.size());
+    for (const auto& seg : r.segments) {
+        CborEncoder pair;
+        if (error == CborNoError) error = cbor_encoder_create_array(&segments, &pair, 2);
+        if (error == CborNoError) error = cbor_encode_int(&pair, seg.requested_x100);
+        if (error == CborNoError) error = cbor_encode_int(&pair, seg.achieved_x100);
+        if (error == CborNoError) error = cbor_encoder_close_container_checked(&segments, &pair);
+    }
+    if (error == CborNoError) error = cbor_encoder_close_container_checked(&map, &segments);
+    if (error == CborNoError) error = cbor_encoder_close_container_checked(&encoder, &map);
+
+    if (error != CborNoError) {
+        output.clear();
+        return false;
+    }
+
+    output.resize(cbor_encoder_get_buffer_size(&encoder, output.data()));
+    return true;
+}
+
+// Simulates selected profile against current PD envelope, before run.
+// Param: liquidus temperature, °C.
+void get_reflow_forecast(const RpcParams& params, RpcResponse& response, Session&) {
+    float liquidus = 0;
+    if (!params.has_count(1) || !params.get_float(0, liquidus)) {
+        response.write_error("Invalid params");
+        return;
+    }
+
+    HeadParams head_params = HeadParams_init_zero;
+    if (heater.get_head_status() != HeadStatus_HEAD_CONNECTED || !heater.get_head_params(head_params)) {
+        response.write_error("Hotplate is not connected");
+        return;
+    }
+
+    Profile profile{};
+    if (!profiles_config.get_selected_profile(profile)) {
+        response.write_error("Failed to load profile");
+        return;
+    }
+
+    const auto load_mohms = power.get_load_mohm();
+    if (load_mohms == Power::UNKNOWN_RESISTANCE) {
+        response.write_error("Load is not measured yet");
+        return;
+    }
+
+    const float temperature = heater.get_temperature();
+    const ReflowForecast::Config cfg{
+        .adrc_b0 = head_params.adrc_b0,
+        .adrc_response = head_params.adrc_response,
+        .adrc_n_coeff = head_params.adrc_n_coeff,
+        .adrc_m_coeff = head_params.adrc_m_coeff,
+        .start_temperature = temperature,
+        .ambient_temperature = etl::min(temperature, 25.0f),
+        .load_mohms = load_mohms,
+        .load_temperature = temperature,
+        .tcr = TemperatureProcessor::TCR_COEFF_DEFAULT * 10,
+        .liquidus = liquidus,
+        .accel_max_x100 = Reflow_State::get_trajectory_accel_x100()
+    };
+
+    // Snapshot, Power task can update capabilities any time
+    const ProfileSelector selector = profile_selector;
+    PdEnvelopeForecast forecast{selector};
+    const auto result = forecast.run(profile, cfg);
+
+    ForecastBuffer output{};
+    if (!reflow_forecast_data(output, result)) {
+        response.write_error("Internal error");
+        return;
+    }
+
+    response.write_binary(output);
+}
+
+using MetricsBuffer = etl::vector<uint8_t, 384>;
+
+auto reflow_metrics_data(MetricsBuffer& output, const ReflowMetrics::Result& r) -> bool {
+    output.clear();
+    output.resize(output.max_size());
+
+    CborEncoder encoder;
+    CborEncoder map;
+    cbor_encoder_init(&encoder, output.data(), output.size(), 0);
+
+    CborError error = cbor_encoder_create_map(&encoder, &map, 15);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "passed");
+    if (error == CborNoError) error = cbor_encode_boolean(&map, r.passed);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "failures");
+    if (error == CborNoError) error = cbor_encode_uint(&map, r.failures);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "duration_ms");
+    if (error == CborNoError) error = cbor_encode_uint(&map, r.duration_ms);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "liquidus_x10");
+    if (error == CborNoError) error = cbor_encode_int(&map, r.liquidus_x10);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "peak_x10");
+    if (error == CborNoError) error = cbor_encode_int(&map, r.peak_x10);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "profile_peak_x10");
+    if (error == CborNoError) error = cbor_encode_int(&map, r.profile_peak_x10);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "tal_ms");
+    if (error == CborNoError) error = cbor_encode_uint(&map, r.tal_ms);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "profile_tal_ms");
+    if (error == CborNoError) error = cbor_encode_uint(&map, r.profile_tal_ms);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "soak_ms");
+    if (error == CborNoError) error = cbor_encode_uint(&map, r.soak_ms);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "profile_soak_ms");
+    if (error == CborNoError) error = cbor_encode_uint(&map, r.profile_soak_ms);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "ramp_up_max_x100");
+    if (error == CborNoError) error = cbor_encode_int(&map, r.ramp_up_max_x100);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "ramp_down_max_x100");
+    if (error == CborNoError) error = cbor_encode_int(&map, r.ramp_down_max_x100);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "max_lag_x10");
+    if (error == CborNoError) error = cbor_encode_int(&map, r.max_lag_x10);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "max_overshoot_x10");
+    if (error == CborNoError) error = cbor_encode_int(&map, r.max_overshoot_x10);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "running");
+    if (error == CborNoError) error = cbor_encode_boolean(&map,
+        application.get_state_id() == DeviceActivityStatus_REFLOW);
+    if (error == CborNoError) error = cbor_encoder_close_container_checked(&encoder, &map);
+
+    if (error != CborNoError) {
+        output.clear();
+        return false;
+    }
+
+    output.resize(cbor_encoder_get_buffer_size(&encoder, output.data()));
+    return true;
+}
+
+// Quality metrics of current (preliminary) or last reflow run.
+void get_reflow_metrics(const RpcParams& params, RpcResponse& response, Session&) {
+    if (!params.has_count(0)) {
+        response.write_error("Invalid params");
+        return;
+    }
+
+    ReflowMetrics::Result result{};
+    if (!heater.get_reflow_metrics(result)) {
+        response.write_error("No reflow data");
+        return;
+    }
+
+    MetricsBuffer output{};
+    if (!reflow_metrics_data(output, result)) {
+        response.write_error("Internal error");
+        return;
+    }
+
+    response.write_binary(output);
+}
+
+using BatchStatsBuffer = etl::vector<uint8_t, 1280>;
+
+auto batch_stats_data(BatchStatsBuffer& output, const BatchCycle& batch) -> bool {
+    const auto& s = batch.get_stats();
+
+    output.clear();
+    output.resize(output.max_size());
+
+    CborEncoder encoder;
+    CborEncoder map;
+    CborEncoder runs;
+    cbor_encoder_init(&encoder, output.data(), output.size(), 0);
+
+    CborError error = cbor_encoder_create_map(&encoder, &map, 8);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "active");
+    if (error == CborNoError) error = cbor_encode_boolean(&map, batch.is_active());
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "total");
+    if (error == CborNoError) error = cbor_encode_uint(&map, s.total);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "completed");
+    if (error == CborNoError) error = cbor_encode_uint(&map, s.completed);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "succeeded");
+    if (error == CborNoError) error = cbor_encode_uint(&map, s.succeeded);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "heat_ms");
+    if (error == CborNoError) error = cbor_encode_uint(&map, s.heat_ms);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "cool_ms");
+    if (error == CborNoError) error = cbor_encode_uint(&map, s.cool_ms);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "idle_ms");
+    if (error == CborNoError) error = cbor_encode_uint(&map, s.idle_ms);
+
+    // [[heat_ms, cool_ms, idle_ms, succeeded, peak_x10, tal_ms,
+    //   max_overshoot_x10, ramp_up_max_x100, ramp_down_max_x100, failures], ...],
+    // first MAX_RUNS runs
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "runs");
+    if (error == CborNoError) error = cbor_encoder_create_array(&map, &runs, s.runs.size());
+    for (const auto& run : s.runs) {
+        CborEncoder item;
+        if (error == CborNoError) error = cbor_encoder_create_array(&runs, &item, 10);
+        if (error == CborNoError) error = cbor_encode_uint(&item, run.heat_ms);
+        if (error == CborNoError) error = cbor_encode_uint(&item, run.cool_ms);
+        if (error == CborNoError) error = cbor_encode_uint(&item, run.idle_ms);
+        if (error == CborNoError) error = cbor_encode_boolean(&item, run.succeeded);
+        if (error == CborNoError) error = cbor_encode_int(&item, run.peak_x10);
+        if (error == CborNoError) error = cbor_encode_uint(&item, run.tal_ms);
+        if (error == CborNoError) error = cbor_encode_int(&item, run.max_overshoot_x10);
+        if (error == CborNoError) error = cbor_encode_int(&item, run.ramp_up_max_x100);
+        if (error == CborNoError) error = cbor_encode_int(&item, run.ramp_down_max_x100);
+        if (error == CborNoError) error = cbor_encode_uint(&item, run.failures);
+        if (error == CborNoError) error = cbor_encoder_close_container_checked(&runs, &item);
+    }
+    if (error == CborNoError) error = cbor_encoder_close_container_checked(&map, &runs);
+    if (error == CborNoError) error = cbor_encoder_close_container_checked(&encoder, &map);
+
+    if (error != CborNoError) {
+        output.clear();
+        return false;
+    }
+
+    output.resize(cbor_encoder_get_buffer_size(&encoder, output.data()));
+    return true;
+}
+
+// Cycle times and per-run reflow metrics of current (or last finished) batch.
+void get_batch_stats(const RpcParams& params, RpcResponse& response, Session&) {
+    if (!params.has_count(0)) {
+        response.write_error("Invalid params");
+        return;
+    }
+
+    BatchStatsBuffer output{};
+    if (!batch_stats_data(output, application.get_batch_snapshot())) {
+        response.write_error("Internal error");
+        return;
+    }
+
+    response.write_binary(output);
+}
+
+using TcrCalibrationBuffer = etl::vector<uint8_t, 256>;
+
+auto tcr_calibration_data(TcrCalibrationBuffer& output, const TcrCalibration& cal) -> bool {
+    output.clear();
+    output.resize(output.max_size());
+
+    CborEncoder encoder;
+    CborEncoder map;
+    CborEncoder points;
+    cbor_encoder_init(&encoder, output.data(), output.size(), 0);
+
+    // Phase: 0 - inactive, 1 - settling, 2 - waiting for reference, 3 - done
+    CborError error = cbor_encoder_create_map(&encoder, &map, 7);
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "phase");
+    if (error == CborNoError) error = cbor_encode_uint(&map, static_cast<uint8_t>(cal.get_phase()));
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "step");
+    if (error == CborNoError) error = cbor_encode_uint(&map, cal.get_step());
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "steps");
+    if (error == CborNoError) error = cbor_encode_uint(&map, cal.get_steps());
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "power_x10");
+    if (error == CborNoError) error = cbor_encode_uint(&map, static_cast<uint32_t>(cal.get_power() * 10));
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "rate_x100");
+    if (error == CborNoError) error = cbor_encode_int(&map, cal.get_rate_x100());
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "mohms");
+    if (error == CborNoError) error = cbor_encode_uint(&map, static_cast<uint32_t>(cal.get_plateau_resistance()));
+
+    // [[at_x10, mohms], ...]
+    if (error == CborNoError) error = cbor_encode_text_stringz(&map, "points");
+    if (error == CborNoError) error = cbor_encoder_create_array(&map, &points, cal.get_points().size());
+    for (const auto& p : cal.get_points()) {
+        CborEncoder item;
+        if (error == CborNoError) error = cbor_encoder_create_array(&points, &item, 2);
+        if (error == CborNoError) error = cbor_encode_int(&item, static_cast<int32_t>(p.at * 10));
+        if (error == CborNoError) error = cbor_encode_uint(&item, static_cast<uint32_t>(p.value));
+        if (error == CborNoError) error = cbor_encoder_close_container_checked(&points, &item);
+    }
+    if (error == CborNoError) error = cbor_encoder_close_container_checked(&map, &points);
+    if (error == CborNoError) error = cbor_encoder_close_container_checked(&encoder, &map);
+
+    if (error != CborNoError) {
+        output.clear();
+        return false;
+    }
+
+    output.resize(cbor_encoder_get_buffer_size(&encoder, output.data()));
+    return true;
+}
+
+// Progress of current (or last) TCR calibration sweep.
+void get_tcr_calibration(const RpcParams& params, RpcResponse& response, Session&) {
+    if (!params.has_count(0)) {
+        response.write_error("Invalid params");
+        return;
+    }
+
+    TcrCalibrationBuffer output{};
+    if (!tcr_calibration_data(output, application.get_tcr_calibration_snapshot())) {
+        response.write_error("Internal error");
+        return;
+    }
+
+    response.write_binary(output);
+}
+
 } // namespace
 
 void api_methods_create(RpcDispatcher& rpc) {
@@ -414,9 +915,17 @@ void api_methods_create(RpcDispatcher& rpc) {
     rpc.addMethod("save_profiles_data", RpcDispatcher::MethodHandler::create<save_profiles_data>());
     rpc.addMethod("stop", RpcDispatcher::MethodHandler::create<stop>());
     rpc.addMethod("run_reflow", RpcDispatcher::MethodHandler::create<run_reflow>());
+    rpc.addMethod("get_reflow_forecast", RpcDispatcher::MethodHandler::create<get_reflow_forecast>());
+    rpc.addMethod("get_reflow_metrics", RpcDispatcher::MethodHandler::create<get_reflow_metrics>());
+    rpc.addMethod("run_batch", RpcDispatcher::MethodHandler::create<run_batch>());
+    rpc.addMethod("get_batch_stats", RpcDispatcher::MethodHandler::create<get_batch_stats>());
     rpc.addMethod("run_sensor_bake", RpcDispatcher::MethodHandler::create<run_sensor_bake>());
     rpc.addMethod("run_adrc_test", RpcDispatcher::MethodHandler::create<run_adrc_test>());
     rpc.addMethod("run_step_response", RpcDispatcher::MethodHandler::create<run_step_response>());
+    rpc.addMethod("run_relay_tune", RpcDispatcher::MethodHandler::create<run_relay_tune>());
+    rpc.addMethod("run_tcr_calibration", RpcDispatcher::MethodHandler::create<run_tcr_calibration>());
+    rpc.addMethod("tcr_calibration_reference", RpcDispatcher::MethodHandler::create<tcr_calibration_reference>());
+    rpc.addMethod("get_tcr_calibration", RpcDispatcher::MethodHandler::create<get_tcr_calibration>());
     rpc.addMethod("get_head_params", RpcDispatcher::MethodHandler::create<get_head_params>());
     rpc.addMethod("set_head_params", RpcDispatcher::MethodHandler::create<set_head_params>());
     rpc.addMethod("set_cpoint0", RpcDispatcher::MethodHandler::create<set_cpoint0>());
@@ -424,6 +933,10 @@ void api_methods_create(RpcDispatcher& rpc) {
     rpc.addMethod("get_pd_profiles", RpcDispatcher::MethodHandler::create<get_pd_profiles>());
     rpc.addMethod("get_ble_name", RpcDispatcher::MethodHandler::create<get_ble_name>());
     rpc.addMethod("set_ble_name", RpcDispatcher::MethodHandler::create<set_ble_name>());
+    rpc.addMethod("trace_start", RpcDispatcher::MethodHandler::create<trace_start>());
+    rpc.addMethod("trace_stop", RpcDispatcher::MethodHandler::create<trace_stop>());
+    rpc.addMethod("trace_read", RpcDispatcher::MethodHandler::create<trace_read>());
+    rpc.addMethod("get_latency", RpcDispatcher::MethodHandler::create<get_latency>());
 }
 
 void pairing_enable() { pairing_enabled_flag = true; }
@@ -7,7 +7,7 @@
 
 class Session;
 
-using RpcDispatcher = cbor_rpc_dispatcher::Dispatcher<24, SharedConstants::MAX_RPC_MESSAGE_SIZE, 48, Session>;
+using RpcDispatcher = cbor_rpc_dispatcher::Dispatcher<32, SharedConstants::MAX_RPC_MESSAGE_SIZE, 48, Session>;
 using BleName = etl::string<SharedConstants::MAX_BLE_NAME_LENGTH>;
 
 extern RpcDispatcher rpc;
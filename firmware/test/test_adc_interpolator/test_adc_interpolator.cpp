@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
 #include "lib/adc_interpolator.hpp"
 
 // ESP32 12-bit ADC (raw: 0-4095) with 0dB attenuation (ADC_ATTEN_DB_0)
@@ -82,6 +84,145 @@ TEST(AdcInterpolatorTest, ScaledInterpolation) {
     EXPECT_EQ(interp.to_uv(20133, 10), 466790u);
 }
 
+// Table the same way Head::build_adc_lut() makes it: ~uniform grid, point
+// is placed at the last mV transition, with a mildly non-linear curve.
+template <typename T>
+static void fill_realistic_lut(T& interp, size_t size) {
+    auto curve_mV = [](uint32_t raw) -> uint32_t {
+        const double x = raw / 4095.0;
+        return static_cast<uint32_t>(5 + 1040 * x + 40 * x * (1 - x));
+    };
+
+    uint32_t prev_mV = curve_mV(0);
+    uint32_t last_transition_idx = 0;
+    size_t grid_point = 0;
+
+    for (uint32_t raw = 1; raw <= 4095; raw++) {
+        const uint32_t mV = curve_mV(raw);
+        if (mV != prev_mV) {
+            last_transition_idx = raw;
+            prev_mV = mV;
+        }
+        const uint32_t next_grid_idx = static_cast<uint32_t>((grid_point * 4095) / (size - 1));
+        if (raw >= next_grid_idx && grid_point < size) {
+            interp.points.push_back({
+                static_cast<uint16_t>(last_transition_idx),
+                static_cast<uint16_t>(prev_mV)
+            });
+            grid_point++;
+        }
+    }
+}
+
+TEST(GridAdcInterpolatorTest, SameAsLinearOnSimpleTables) {
+    GridAdcInterpolator<10> interp;
+
+    interp.points.push_back({1000, 231});
+    interp.points.push_back({2000, 463});
+    interp.points.push_back({3000, 695});
+    interp.rebuild();
+
+    EXPECT_EQ(interp.to_uv(500, 1), 231000u);
+    EXPECT_EQ(interp.to_uv(3500, 1), 695000u);
+    EXPECT_EQ(interp.to_uv(1000, 1), 231000u);
+    EXPECT_EQ(interp.to_uv(2000, 1), 463000u);
+    EXPECT_EQ(interp.to_uv(3000, 1), 695000u);
+    EXPECT_EQ(interp.to_uv(1500, 1), 347000u);
+    EXPECT_EQ(interp.to_uv(2500, 1), 579000u);
+
+    interp.points.clear();
+    interp.points.push_back({2000, 463});
+    interp.points.push_back({2200, 520});
+    interp.points.push_back({2400, 558});
+    interp.rebuild();
+
+    EXPECT_EQ(interp.to_uv(21050, 10), 492925u);
+    EXPECT_EQ(interp.to_uv(23100, 10), 540900u);
+    EXPECT_EQ(interp.to_uv(21997, 10), 519914u);
+    EXPECT_EQ(interp.to_uv(20133, 10), 466790u);
+}
+
+TEST(GridAdcInterpolatorTest, MatchesLinearOnRealisticTable) {
+    AdcInterpolator<100> linear;
+    GridAdcInterpolator<100> grid;
+    fill_realistic_lut(linear, 100);
+    fill_realistic_lut(grid, 100);
+    grid.rebuild();
+
+    ASSERT_EQ(linear.points.size(), grid.points.size());
+
+    uint32_t max_diff = 0;
+    // Head converts sum of avg_x100 values, scale = count * 100
+    for (uint32_t scale : {1u, 100u, 800u, 1600u}) {
+        for (uint32_t raw_x100 = 0; raw_x100 <= 4095 * 100; raw_x100 += 7) {
+            const uint32_t sum = static_cast<uint32_t>(static_cast<uint64_t>(raw_x100) * scale / 100);
+            const uint32_t a = linear.to_uv(sum, scale);
+            const uint32_t b = grid.to_uv(sum, scale);
+            const uint32_t diff = a > b ? a - b : b - a;
+            if (diff > max_diff) { max_diff = diff; }
+        }
+    }
+    // Only Q16 slope rounding may differ, far below 1 LSB (~270 uV)
+    EXPECT_LE(max_diff, 1u);
+}
+
+TEST(GridAdcInterpolatorTest, SeveralPointsInOneBin) {
+    AdcInterpolator<10> linear;
+    GridAdcInterpolator<10> grid;
+
+    for (auto* pts : { &linear.points, &grid.points }) {
+        pts->push_back({100, 20});
+        pts->push_back({101, 90});   // Steep segment, exact fallback
+        pts->push_back({105, 91});
+        pts->push_back({110, 89});   // Falling segment, exact fallback
+        pts->push_back({4000, 1000});
+    }
+    grid.rebuild();
+
+    for (uint32_t sum = 0; sum <= 4100 * 16; sum++) {
+        const auto a = static_cast<int64_t>(linear.to_uv(sum, 16));
+        const auto b = static_cast<int64_t>(grid.to_uv(sum, 16));
+        // Exact fallback segments must match bit to bit
+        if (sum < 110 * 16) { ASSERT_EQ(a, b) << "sum=" << sum; }
+        else { ASSERT_LE(std::abs(a - b), 1) << "sum=" << sum; }
+    }
+}
+
+TEST(GridAdcInterpolatorTest, Benchmark) {
+    AdcInterpolator<100> linear;
+    GridAdcInterpolator<100> grid;
+    fill_realistic_lut(linear, 100);
+    fill_realistic_lut(grid, 100);
+    grid.rebuild();
+
+    constexpr uint32_t CALLS = 1'000'000;
+    constexpr uint32_t SCALE = 800;
+    volatile uint32_t sink = 0;
+
+    using clock = std::chrono::steady_clock;
+
+    uint32_t seed = 1;
+    auto start = clock::now();
+    for (uint32_t i = 0; i < CALLS; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        sink = linear.to_uv((seed >> 8) % (4095 * SCALE), SCALE);
+    }
+    const auto linear_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+
+    seed = 1;
+    start = clock::now();
+    for (uint32_t i = 0; i < CALLS; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        sink = grid.to_uv((seed >> 8) % (4095 * SCALE), SCALE);
+    }
+    const auto grid_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+
+    (void)sink;
+
+    printf("AdcInterpolator per call: linear %.1f ns, grid %.1f ns\n",
+        static_cast<double>(linear_ns) / CALLS, static_cast<double>(grid_ns) / CALLS);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
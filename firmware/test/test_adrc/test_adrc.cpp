@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <deque>
+#include "lib/adrc.hpp"
+
+TEST(AdrcTest, ZeroAgeIsUnchanged) {
+    ADRC a{};
+    ADRC b{};
+    a.set_params(0.5f, 30.0f, 5.0f, 3.0f);
+    b.set_params(0.5f, 30.0f, 5.0f, 3.0f);
+    a.reset_to(25.0f);
+    b.reset_to(25.0f);
+
+    for (int i = 0; i < 100; i++) {
+        const float y = 25.0f + static_cast<float>(i) * 0.1f;
+        EXPECT_EQ(a.iterate(y, 200.0f, 60.0f, 0.05f, 1.0f), b.iterate(y, 200.0f, 60.0f, 0.05f, 1.0f, 0.0f));
+    }
+}
+
+namespace {
+
+struct StepResult {
+    double overshoot;  // °C above setpoint
+    double iae;        // Integral of absolute error, °C·s
+};
+
+// First order plant, measurement is delayed by `delay_ms`. Controller is told
+// the age or not.
+auto step(uint32_t delay_ms, bool compensate) -> StepResult {
+    constexpr double B0 = 0.5;
+    constexpr double TAU = 30;
+    constexpr double SETPOINT = 200;
+    constexpr uint32_t TICK_MS = 50;
+
+    ADRC adrc{};
+    // Aggressive tuning, sensitive to delay
+    adrc.set_params(static_cast<float>(B0), static_cast<float>(TAU), 40.0f, 3.0f);
+    adrc.reset_to(25.0f);
+
+    double y = 25;
+    std::deque<double> line(delay_ms / TICK_MS + 1, y);
+    double power = 0;
+    StepResult r{0, 0};
+
+    for (uint32_t ms = 0; ms < 60'000; ms += TICK_MS) {
+        const double dt = TICK_MS / 1000.0;
+        y += dt * (B0 * power - (y - 25) / TAU);
+
+        line.push_back(y);
+        line.pop_front();
+        const double measured = line.front();
+
+        power = adrc.iterate(static_cast<float>(measured), static_cast<float>(SETPOINT), 100.0f,
+                             static_cast<float>(dt), 0.0f,
+                             compensate ? static_cast<float>(delay_ms) / 1000.0f : 0.0f);
+
+        r.overshoot = std::max(r.overshoot, y - SETPOINT);
+        r.iae += std::abs(SETPOINT - y) * dt;
+    }
+    return r;
+}
+
+} // namespace
+
+TEST(AdrcTest, AgeCompensationReducesOvershoot) {
+    const auto plain = step(400, false);
+    const auto comp = step(400, true);
+    const auto ideal = step(0, false);
+
+    printf("Overshoot: no delay %.2f, delayed %.2f, compensated %.2f °C\n",
+        ideal.overshoot, plain.overshoot, comp.overshoot);
+    printf("IAE:       no delay %.1f, delayed %.1f, compensated %.1f °C·s\n", ideal.iae, plain.iae, comp.iae);
+
+    EXPECT_LT(comp.overshoot, plain.overshoot * 0.2);
+    EXPECT_LT(comp.iae, plain.iae);
+    EXPECT_LT(comp.iae, ideal.iae * 1.05);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <math.h>
+#include "lib/batch_cycle.hpp"
+
+static auto metrics(bool passed, int32_t peak_x10 = 2450) -> ReflowMetrics::Result {
+    ReflowMetrics::Result r{};
+    r.passed = passed;
+    r.failures = passed ? ReflowMetrics::FAIL_NONE : ReflowMetrics::FAIL_NOT_COMPLETED;
+    r.peak_x10 = peak_x10;
+    r.tal_ms = 60000;
+    r.max_overshoot_x10 = 12;
+    r.ramp_up_max_x100 = 180;
+    r.ramp_down_max_x100 = 250;
+    return r;
+}
+
+// Feeds exponential cooling towards ambient, returns time when ready (or 0).
+static auto cool_down(BatchCycle& batch, uint32_t t0_ms, float from, float ambient, float tau_s) -> uint32_t {
+    for (uint32_t t = 0; t < 3600 * 1000; t += 500) {
+        const float temperature = ambient + (from - ambient) * expf(-static_cast<float>(t) * 0.001f / tau_s);
+        if (batch.update_cooling(t0_ms + t, static_cast<int32_t>(temperature * 10))) { return t0_ms + t; }
+    }
+    return 0;
+}
+
+TEST(BatchCycleTest, RejectsEmptyBatch) {
+    BatchCycle batch{};
+    EXPECT_FALSE(batch.start(0, true));
+    EXPECT_FALSE(batch.is_active());
+}
+
+TEST(BatchCycleTest, FullCycleStats) {
+    BatchCycle batch{};
+    ASSERT_TRUE(batch.start(2, false));
+    EXPECT_EQ(batch.get_phase(), BatchCycle::Phase::Idle);
+
+    batch.on_heat_start(1000);
+    EXPECT_TRUE(batch.on_heat_end(301000, metrics(true)));
+    EXPECT_EQ(batch.get_phase(), BatchCycle::Phase::Cool);
+
+    const uint32_t ready_ms = cool_down(batch, 301000, 250.0f, 22.0f, 60.0f);
+    ASSERT_GT(ready_ms, 301000u);
+    EXPECT_EQ(batch.get_phase(), BatchCycle::Phase::Idle);
+
+    batch.on_heat_start(ready_ms + 5000);
+    EXPECT_FALSE(batch.on_heat_end(ready_ms + 305000, metrics(true)));
+    EXPECT_FALSE(batch.is_active());
+
+    const auto& s = batch.get_stats();
+    EXPECT_EQ(s.total, 2u);
+    EXPECT_EQ(s.completed, 2u);
+    EXPECT_EQ(s.succeeded, 2u);
+    ASSERT_EQ(s.runs.size(), 2u);
+
+    EXPECT_EQ(s.runs[0].heat_ms, 300000u);
+    EXPECT_EQ(s.runs[0].cool_ms, ready_ms - 301000);
+    EXPECT_EQ(s.runs[0].idle_ms, 5000u);
+    EXPECT_EQ(s.runs[1].heat_ms, 300000u);
+    EXPECT_EQ(s.runs[1].cool_ms, 0u);
+    EXPECT_TRUE(s.runs[1].succeeded);
+    EXPECT_EQ(s.runs[1].peak_x10, 2450);
+    EXPECT_EQ(s.runs[1].tal_ms, 60000u);
+    EXPECT_EQ(s.runs[1].max_overshoot_x10, 12);
+    EXPECT_EQ(s.runs[1].ramp_up_max_x100, 180);
+    EXPECT_EQ(s.runs[1].ramp_down_max_x100, 250);
+    EXPECT_EQ(s.heat_ms, 600000u);
+    EXPECT_EQ(s.cool_ms, ready_ms - 301000);
+    EXPECT_EQ(s.idle_ms, 5000u);
+}
+
+TEST(BatchCycleTest, NotReadyWhileCoolingFast) {
+    BatchCycle batch{};
+    batch.start(2, true);
+    batch.on_heat_start(0);
+    batch.on_heat_end(0, metrics(true));
+
+    // Below start temperature, but still falling at 1 °C/s
+    uint32_t t = 0;
+    for (int32_t temp_x10 = 290; temp_x10 > 200; temp_x10 -= 5, t += 500) {
+        EXPECT_FALSE(batch.update_cooling(t, temp_x10));
+    }
+    EXPECT_LT(batch.get_rate_x100(), -BatchCycle::READY_RATE_X100);
+
+    // Settled
+    bool ready = false;
+    for (int i = 0; i < 100 && !ready; i++, t += 500) { ready = batch.update_cooling(t, 200); }
+    EXPECT_TRUE(ready);
+}
+
+TEST(BatchCycleTest, HotRoomFallback) {
+    BatchCycle batch{};
+    batch.start(2, true);
+    batch.on_heat_start(0);
+    batch.on_heat_end(0, metrics(true));
+
+    // Ambient above START_TEMPERATURE, plate settles at 35 °C
+    EXPECT_GT(cool_down(batch, 0, 200.0f, 35.0f, 60.0f), 0u);
+
+    // Too hot to accept
+    BatchCycle hot{};
+    hot.start(2, true);
+    hot.on_heat_start(0);
+    hot.on_heat_end(0, metrics(true));
+    EXPECT_EQ(cool_down(hot, 0, 200.0f, 50.0f, 60.0f), 0u);
+}
+
+TEST(BatchCycleTest, FailedRunStopsBatch) {
+    BatchCycle batch{};
+    batch.start(5, true);
+    batch.on_heat_start(0);
+    EXPECT_FALSE(batch.on_heat_end(1000, metrics(false)));
+    EXPECT_FALSE(batch.is_active());
+    EXPECT_EQ(batch.get_stats().completed, 1u);
+    EXPECT_EQ(batch.get_stats().succeeded, 0u);
+    ASSERT_EQ(batch.get_stats().runs.size(), 1u);
+    EXPECT_FALSE(batch.get_stats().runs[0].succeeded);
+    EXPECT_EQ(batch.get_stats().runs[0].failures, ReflowMetrics::FAIL_NOT_COMPLETED);
+}
+
+TEST(BatchCycleTest, RunsArrayIsBounded) {
+    BatchCycle batch{};
+    const uint32_t count = BatchCycle::MAX_RUNS + 3;
+    batch.start(count, true);
+
+    uint32_t t = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        batch.on_heat_start(t);
+        t += 100;
+        if (!batch.on_heat_end(t, metrics(true))) { break; }
+        // Already cold
+        for (int j = 0; j < 30 && !batch.update_cooling(t, 250); j++) { t += 500; }
+    }
+
+    const auto& s = batch.get_stats();
+    EXPECT_EQ(s.completed, count);
+    EXPECT_EQ(s.runs.size(), BatchCycle::MAX_RUNS);
+    EXPECT_EQ(s.heat_ms, count * 100);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
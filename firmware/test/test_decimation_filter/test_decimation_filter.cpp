@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <functional>
+#include <random>
+#include "lib/decimation_filter.hpp"
+
+// Same configuration as Head: 20 kHz ADC, 1 kHz after CIC, 25 Hz output
+static constexpr uint32_t ADC_FREQ_HZ = 20'000;
+using Filter = DecimationFilter<20, 40, 161>;
+
+// Former Head scheme: 200-sample frame averages (x100) in the ISR, ring of
+// 10 frames, summed by Head task every 200 ms.
+class LegacyPipeline {
+public:
+    static constexpr uint32_t FRAME = 200;
+    static constexpr uint32_t RING = 10;
+    static constexpr uint32_t TICK = ADC_FREQ_HZ / 5;
+
+    void push(uint16_t sample) {
+        frame_sum += sample;
+        if (++frame_count == FRAME) {
+            ring[ring_idx] = frame_sum * 100 / FRAME;
+            ring_idx = (ring_idx + 1) % RING;
+            if (ring_count < RING) { ring_count++; }
+            frame_sum = 0;
+            frame_count = 0;
+        }
+        if (++tick_count == TICK) {
+            tick_count = 0;
+            uint32_t total = 0;
+            for (uint32_t i = 0; i < ring_count; i++) { total += ring[i]; }
+            if (ring_count) { value = total / (ring_count * 100.0); }
+        }
+    }
+
+    double value{0};
+
+private:
+    uint32_t frame_sum{0};
+    uint32_t frame_count{0};
+    uint32_t ring[RING]{};
+    uint32_t ring_idx{0};
+    uint32_t ring_count{0};
+    uint32_t tick_count{0};
+};
+
+class NewPipeline {
+public:
+    void push(uint16_t sample) {
+        if (filter.push(sample)) { value = filter.get_output() / static_cast<double>(Filter::OUTPUT_SCALE); }
+    }
+
+    double value{0};
+
+private:
+    Filter filter{};
+};
+
+struct Metrics {
+    double lag_ms;   // Mean lag of value seen by a reader, vs true signal
+    double noise;    // SD of reader-visible error, raw LSB
+};
+
+// Simulates ADC sampling `signal` with gaussian noise. Value is "read" every
+// 1 ms, like an asynchronous consumer would do.
+template <typename Pipeline>
+static auto simulate(const std::function<double(double)>& signal, double slope, double noise_sd,
+                     double duration_s) -> Metrics {
+    Pipeline p{};
+    std::mt19937 rng(42);
+    std::normal_distribution<double> noise(0, noise_sd);
+
+    double err_sum = 0;
+    double err_sq_sum = 0;
+    uint32_t count = 0;
+
+    const auto total = static_cast<uint32_t>(duration_s * ADC_FREQ_HZ);
+    for (uint32_t n = 0; n < total; n++) {
+        const double t = static_cast<double>(n) / ADC_FREQ_HZ;
+        const double v = std::clamp(std::round(signal(t) + noise(rng)), 0.0, 4095.0);
+        p.push(static_cast<uint16_t>(v));
+
+        // Skip first second (startup)
+        if (n % (ADC_FREQ_HZ / 1000) || t < 1.0) { continue; }
+        const double err = signal(t) - p.value;
+        err_sum += err;
+        err_sq_sum += err * err;
+        count++;
+    }
+
+    const double mean = err_sum / count;
+    return {
+        .lag_ms = slope != 0 ? mean / slope * 1000 : 0,
+        .noise = std::sqrt(std::max(err_sq_sum / count - mean * mean, 0.0))
+    };
+}
+
+TEST(DecimationFilterTest, UnityDcGain) {
+    Filter f{};
+    uint32_t outputs = 0;
+    for (uint32_t i = 0; i < ADC_FREQ_HZ; i++) {
+        if (f.push(2345)) {
+            outputs++;
+            EXPECT_EQ(f.get_output(), 2345u * Filter::OUTPUT_SCALE);
+        }
+    }
+    // 25 Hz minus warmup
+    EXPECT_GE(outputs, 20u);
+    EXPECT_LE(outputs, 25u);
+}
+
+TEST(DecimationFilterTest, FullScaleNoOverflow) {
+    Filter f{};
+    for (uint32_t i = 0; i < ADC_FREQ_HZ; i++) {
+        if (f.push(4095)) { EXPECT_EQ(f.get_output(), 4095u * Filter::OUTPUT_SCALE); }
+    }
+}
+
+TEST(DecimationFilterTest, RampLagMatchesGroupDelay) {
+    // Measure lag at output instants only, without reader staleness
+    Filter f{};
+    constexpr double slope = 100;  // LSB/s
+    double max_diff = 0;
+    for (uint32_t n = 0; n < 4 * ADC_FREQ_HZ; n++) {
+        // ADC samples are integer, so ramp comes as a staircase
+        auto stair = [](double t) { return std::floor(1000 + slope * t); };
+        const double t = static_cast<double>(n) / ADC_FREQ_HZ;
+        if (!f.push(static_cast<uint16_t>(stair(t)))) { continue; }
+        if (t < 1.0) { continue; }
+
+        const double delay_s = Filter::GROUP_DELAY_X2 / 2.0 / ADC_FREQ_HZ;
+        // Staircase is the ramp shifted down by 0.5 LSB on average
+        const double expected = 1000 + slope * (t - delay_s) - 0.5;
+        max_diff = std::max(max_diff, std::abs(f.get_output() / 100.0 - expected));
+    }
+    EXPECT_LT(max_diff, 0.05);
+}
+
+TEST(DecimationFilterTest, FirStageContinuesFromState) {
+    // Like trace replay: second filter gets FIR state mid-stream, then only
+    // CIC outputs of the first one
+    Filter device{};
+    Filter replay{};
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> noise(-20, 20);
+
+    uint32_t outputs = 0;
+    for (uint32_t n = 0; n < 2 * ADC_FREQ_HZ; n++) {
+        if (n == ADC_FREQ_HZ / 2 + 7 * 20) { replay.set_fir_state(device.get_fir_state(), device.get_fir_line()); }
+
+        const auto sample = static_cast<uint16_t>(1500 + noise(rng));
+        if (!device.push_cic(sample)) { continue; }
+        const bool ready = device.push_fir(device.get_cic_output());
+        if (n < ADC_FREQ_HZ / 2 + 7 * 20) { continue; }
+
+        EXPECT_EQ(replay.push_fir(device.get_cic_output()), ready);
+        if (ready) {
+            outputs++;
+            EXPECT_EQ(replay.get_output(), device.get_output());
+        }
+    }
+    EXPECT_GT(outputs, 30u);
+}
+
+TEST(DecimationFilterTest, RejectsMains) {
+    // Slightly off nominal, so aliases don't hide at fixed phase
+    for (double hz : {49.7, 60.3}) {
+        Filter f{};
+        double max_err = 0;
+        for (uint32_t n = 0; n < 5 * ADC_FREQ_HZ; n++) {
+            const double t = static_cast<double>(n) / ADC_FREQ_HZ;
+            const double v = std::round(2000 + 20 * std::sin(2 * M_PI * hz * t));
+            if (!f.push(static_cast<uint16_t>(v)) || t < 1.0) { continue; }
+            max_err = std::max(max_err, std::abs(f.get_output() / 100.0 - 2000));
+        }
+        printf("Mains %.1f Hz, 20 LSB amplitude: output error %.3f LSB\n", hz, max_err);
+        EXPECT_LT(max_err, 0.1);
+    }
+}
+
+TEST(DecimationFilterTest, BenchVsLegacy) {
+    const double slope = 100;  // LSB/s, ~fast reflow heating
+    auto ramp = [&](double t) { return 500 + slope * t; };
+    auto dc = [](double) { return 2000.0; };
+
+    const auto legacy_lag = simulate<LegacyPipeline>(ramp, slope, 1.0, 10);
+    const auto new_lag = simulate<NewPipeline>(ramp, slope, 1.0, 10);
+    const auto legacy_noise = simulate<LegacyPipeline>(dc, 0, 8.0, 20);
+    const auto new_noise = simulate<NewPipeline>(dc, 0, 8.0, 20);
+
+    printf("Reader-visible lag:  legacy %.1f ms, decimator %.1f ms (group delay %.1f ms)\n",
+        legacy_lag.lag_ms, new_lag.lag_ms, Filter::GROUP_DELAY_X2 * 500.0 / ADC_FREQ_HZ);
+    printf("Noise (8 LSB input): legacy %.4f LSB, decimator %.4f LSB\n", legacy_noise.noise, new_noise.noise);
+
+    EXPECT_LT(new_lag.lag_ms, legacy_lag.lag_ms * 0.75);
+    EXPECT_LT(new_noise.noise, legacy_noise.noise * 1.15);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include "lib/fan_policy.hpp"
+
+using Action = FanPolicy::Action;
+
+namespace {
+
+auto idle(int32_t temperature_x10, bool forced = false) -> FanPolicy::Input {
+    return {
+        .task_active = false,
+        .temperature_control = false,
+        .forced_cooling = forced,
+        .head_connected = true,
+        .temperature_known = true,
+        .temperature_x10 = temperature_x10,
+        .setpoint_x10 = 0,
+        .rate_x100 = 0,
+        .target_power_mw = 0
+    };
+}
+
+auto working(int32_t temperature_x10, int32_t setpoint_x10, int32_t rate_x100, uint32_t power_mw) -> FanPolicy::Input {
+    return {
+        .task_active = true,
+        .temperature_control = true,
+        .forced_cooling = false,
+        .head_connected = true,
+        .temperature_known = true,
+        .temperature_x10 = temperature_x10,
+        .setpoint_x10 = setpoint_x10,
+        .rate_x100 = rate_x100,
+        .target_power_mw = power_mw
+    };
+}
+
+} // namespace
+
+TEST(FanPolicyTest, IdleCoolsToEdge) {
+    EXPECT_EQ(FanPolicy::decide(idle(FanPolicy::EDGE_ON_X10 + 1)), Action::On);
+    EXPECT_EQ(FanPolicy::decide(idle(FanPolicy::EDGE_ON_X10)), Action::Off);
+}
+
+TEST(FanPolicyTest, ForcedCoolingBelowEdge) {
+    // Batch cooldown waits for 30 °C, fan must not stop at 40 °C
+    EXPECT_EQ(FanPolicy::decide(idle(35 * 10, true)), Action::On);
+    EXPECT_EQ(FanPolicy::decide(idle(25 * 10, true)), Action::On);
+
+    // But not without head or temperature
+    auto in = idle(35 * 10, true);
+    in.head_connected = false;
+    EXPECT_EQ(FanPolicy::decide(in), Action::Off);
+    in = idle(35 * 10, true);
+    in.temperature_known = false;
+    EXPECT_EQ(FanPolicy::decide(in), Action::Off);
+}
+
+TEST(FanPolicyTest, TaskOvershootHysteresis) {
+    // Above on-threshold, only with controller output off
+    EXPECT_EQ(FanPolicy::decide(working(2050, 2000, 0, 0)), Action::On);
+    EXPECT_EQ(FanPolicy::decide(working(2050, 2000, 0, 5000)), Action::Keep);
+    // Between thresholds, keep state
+    EXPECT_EQ(FanPolicy::decide(working(2035, 2000, 0, 0)), Action::Keep);
+    EXPECT_EQ(FanPolicy::decide(working(2020, 2000, 0, 0)), Action::Off);
+}
+
+TEST(FanPolicyTest, TaskLookahead) {
+    // Fast rise starts fan before overshoot peaks
+    EXPECT_EQ(FanPolicy::decide(working(2035, 2000, 100, 0)), Action::On);
+    // Fast cooling stops it early
+    EXPECT_EQ(FanPolicy::decide(working(2045, 2000, -100, 0)), Action::Off);
+    // Calibrations without temperature control
+    auto in = working(2500, 2000, 0, 0);
+    in.temperature_control = false;
+    EXPECT_EQ(FanPolicy::decide(in), Action::Off);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <math.h>
+#include <random>
+#include "lib/fopdt_fit.hpp"
+
+// Simulated head: FOPDT plant, sensor with noise and 0.1°C quantization.
+struct Plant {
+    float tau;
+    float b0;
+    float delay;
+    float ambient;
+    float noise_sd;
+
+    std::mt19937 rng{42};
+
+    auto temperature_at(float t, float power) -> float {
+        const float K = b0 * tau;
+        const float rise = t > delay ? K * power * (1.0f - expf(-(t - delay) / tau)) : 0.0f;
+        std::normal_distribution<float> noise(0.0f, noise_sd);
+        const float measured = ambient + rise + (noise_sd > 0 ? noise(rng) : 0.0f);
+        return roundf(measured * 10.0f) / 10.0f;
+    }
+};
+
+static constexpr float DT = 0.5f;
+
+static auto run_fit(Plant& plant, float power, float duration) -> FopdtFit {
+    FopdtFit fit{};
+    fit.reset(plant.temperature_at(0, power));
+    fit.add(0, plant.temperature_at(0, power), power);
+    for (float t = DT; t <= duration; t += DT) {
+        fit.add(DT, plant.temperature_at(t, power), power);
+    }
+    return fit;
+}
+
+TEST(FopdtFitTest, NoData) {
+    FopdtFit fit{};
+    fit.reset(25.0f);
+    FopdtFit::Result r{};
+    EXPECT_FALSE(fit.solve(r));
+}
+
+TEST(FopdtFitTest, CleanResponse) {
+    Plant plant{113.0f, 0.0536f, 3.0f, 25.0f, 0.0f};
+    const auto fit = run_fit(plant, 20.0f, 400.0f);
+
+    FopdtFit::Result r{};
+    ASSERT_TRUE(fit.solve(r));
+    EXPECT_NEAR(r.tau, 113.0f, 113.0f * 0.02f);
+    EXPECT_NEAR(r.b0, 0.0536f, 0.0536f * 0.02f);
+    EXPECT_NEAR(r.delay, 3.0f, 1.0f);
+    EXPECT_LT(r.tau_rel_sd, 0.01f);
+}
+
+TEST(FopdtFitTest, NoisyResponseAtOneTau) {
+    // Only about 1.2τ of data, old method needed plateau (~5τ)
+    Plant plant{113.0f, 0.0536f, 3.0f, 25.0f, 0.3f};
+    const auto fit = run_fit(plant, 20.0f, 140.0f);
+
+    FopdtFit::Result r{};
+    ASSERT_TRUE(fit.solve(r));
+    EXPECT_NEAR(r.tau, 113.0f, 113.0f * 0.05f);
+    EXPECT_NEAR(r.b0, 0.0536f, 0.0536f * 0.05f);
+    EXPECT_LT(r.tau_rel_sd, 0.05f);
+    EXPECT_LT(r.b0_rel_sd, 0.05f);
+}
+
+TEST(FopdtFitTest, ConfidenceImprovesWithData) {
+    Plant plant{80.0f, 0.08f, 2.0f, 25.0f, 0.3f};
+
+    FopdtFit::Result early{};
+    FopdtFit::Result late{};
+    ASSERT_TRUE(run_fit(plant, 15.0f, 30.0f).solve(early));
+    ASSERT_TRUE(run_fit(plant, 15.0f, 160.0f).solve(late));
+
+    EXPECT_GT(early.tau_rel_sd, late.tau_rel_sd);
+    EXPECT_NEAR(late.tau, 80.0f, 80.0f * 0.05f);
+}
+
+TEST(FopdtFitTest, DeadTimeSamplesSkipped) {
+    // Long dead time relative to the fitted window. Flat samples before onset
+    // don't match the model and would bias τ and b0 if fed in.
+    Plant plant{80.0f, 0.08f, 15.0f, 25.0f, 0.3f};
+    const auto fit = run_fit(plant, 15.0f, 120.0f);
+
+    EXPECT_GT(fit.get_onset(), 15.0f);
+    EXPECT_LT(fit.get_onset(), 20.0f);
+
+    FopdtFit::Result r{};
+    ASSERT_TRUE(fit.solve(r));
+    EXPECT_NEAR(r.tau, 80.0f, 80.0f * 0.05f);
+    EXPECT_NEAR(r.b0, 0.08f, 0.08f * 0.05f);
+    EXPECT_NEAR(r.delay, 15.0f, 1.5f);
+}
+
+TEST(FopdtFitTest, NoOnsetNoFit) {
+    Plant plant{80.0f, 0.08f, 30.0f, 25.0f, 0.0f};
+    const auto fit = run_fit(plant, 15.0f, 25.0f);
+
+    EXPECT_LT(fit.get_onset(), 0.0f);
+    FopdtFit::Result r{};
+    EXPECT_FALSE(fit.solve(r));
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+#include "lib/power_fsm.hpp"
+
+#include <vector>
+
+using State = PowerFsm::State;
+
+namespace {
+
+// Raw PD encoding
+auto fixed_pdo(uint32_t mv, uint32_t ma) -> uint32_t { return ((mv / 50) << 10) | (ma / 10); }
+auto pps_pdo(uint32_t mv_min, uint32_t mv_max, uint32_t ma) -> uint32_t {
+    return (3u << 30) | ((mv_max / 100) << 17) | ((mv_min / 100) << 8) | (ma / 50);
+}
+
+struct Trigger { uint32_t position; uint32_t mv; bool request; };
+
+class FakeIo : public PowerFsm::Io {
+public:
+    void trigger_by_position(uint32_t position, uint32_t mv) override { triggers.push_back({ position, mv, true }); }
+    void clear_trigger_to(uint32_t position, uint32_t mv) override { triggers.push_back({ position, mv, false }); }
+    auto is_handshake_reported() -> bool override { return handshake_reported; }
+
+    auto get_drain_info() -> PowerFsm::DrainInfo override { return drain_info; }
+    void drain_reset() override { drain_info = {}; }
+
+    void pwm_enable(bool enable) override { pwm_enabled = enable; }
+    void pwm_set(PwmScheduler::Modulation m, uint32_t duty) override { modulation = m; duty_x1000 = duty; }
+
+    void on_state(State state) override { states.push_back(state); }
+
+    void set_load(uint32_t mv, uint32_t mohm) {
+        drain_info.peak_mv = mv;
+        drain_info.peak_ma = mv * 1000 / mohm;
+        drain_info.load_valid = true;
+    }
+
+    auto last_request() const -> const Trigger* {
+        for (auto it = triggers.rbegin(); it != triggers.rend(); ++it) {
+            if (it->request) { return &*it; }
+        }
+        return nullptr;
+    }
+
+    std::vector<Trigger> triggers{};
+    std::vector<State> states{};
+    PowerFsm::DrainInfo drain_info{};
+    bool handshake_reported{false};
+    bool pwm_enabled{false};
+    PwmScheduler::Modulation modulation{PwmScheduler::Modulation::Pwm};
+    uint32_t duty_x1000{0};
+};
+
+class PowerFsmTest : public ::testing::Test {
+protected:
+    ProfileSelector ps{};
+    FakeIo io{};
+    PowerFsm fsm{ps, io};
+
+    // Attach, caps, first contract on default position, load measured
+    void bring_up(const pd::PDO_LIST& caps, uint32_t load_mohm = 3000) {
+        fsm.start();
+        fsm.on_startup();
+        fsm.on_src_caps_received(caps);
+        fsm.on_select_cap_done(ps.default_position);
+        fsm.on_snk_ready();
+        io.handshake_reported = true;
+        fsm.on_handshake_done();
+        ASSERT_EQ(fsm.get_state(), State::Calibrate);
+        io.set_load(5000, load_mohm);
+        fsm.on_sys_tick();
+        ASSERT_EQ(fsm.get_state(), State::Ready);
+    }
+};
+
+} // namespace
+
+TEST_F(PowerFsmTest, StartupReachesReadyThroughCalibrate) {
+    pd::PDO_LIST caps{};
+    caps.push_back(fixed_pdo(5000, 3000));
+    caps.push_back(fixed_pdo(9000, 3000));
+    bring_up(caps);
+
+    const std::vector<State> expected{ State::Off, State::Initializing, State::Calibrate, State::Ready };
+    EXPECT_EQ(io.states, expected);
+    // Calibrate measures with plain PWM and zero duty
+    EXPECT_TRUE(io.pwm_enabled);
+    EXPECT_EQ(io.duty_x1000, 0u);
+}
+
+TEST_F(PowerFsmTest, SnkReadyWaitsForHandshake) {
+    pd::PDO_LIST caps{};
+    caps.push_back(fixed_pdo(5000, 3000));
+    fsm.start();
+    fsm.on_startup();
+    fsm.on_src_caps_received(caps);
+    fsm.on_snk_ready();
+    EXPECT_EQ(fsm.get_state(), State::Initializing);
+
+    io.handshake_reported = true;
+    fsm.on_snk_ready();
+    EXPECT_EQ(fsm.get_state(), State::Calibrate);
+}
+
+TEST_F(PowerFsmTest, FixedProfileUsesSigmaDelta) {
+    pd::PDO_LIST caps{};
+    caps.push_back(fixed_pdo(5000, 3000));
+    bring_up(caps);
+
+    fsm.target_power_mw = 4000;
+    fsm.on_sys_tick();
+    EXPECT_EQ(fsm.get_state(), State::Ready);
+    EXPECT_TRUE(io.pwm_enabled);
+    EXPECT_EQ(io.modulation, PwmScheduler::Modulation::SigmaDelta);
+    EXPECT_GT(io.duty_x1000, 0u);
+    EXPECT_LT(io.duty_x1000, 1000u);
+}
+
+TEST_F(PowerFsmTest, BetterProfileSwitchesContract) {
+    pd::PDO_LIST caps{};
+    caps.push_back(fixed_pdo(5000, 3000));
+    caps.push_back(fixed_pdo(15000, 3000));
+    bring_up(caps, 6000);
+
+    fsm.target_power_mw = 30000;
+    fsm.on_sys_tick();
+    ASSERT_EQ(fsm.get_state(), State::WaitContractChange);
+    EXPECT_FALSE(io.pwm_enabled);
+    ASSERT_NE(io.last_request(), nullptr);
+    EXPECT_EQ(io.last_request()->position, 2u);
+
+    fsm.on_select_cap_done(2);
+    fsm.on_snk_ready();
+    EXPECT_EQ(fsm.get_state(), State::Ready);
+}
+
+TEST_F(PowerFsmTest, ApdoAdjustLocksUntilSnkReady) {
+    pd::PDO_LIST caps{};
+    caps.push_back(fixed_pdo(5000, 3000));
+    caps.push_back(pps_pdo(3300, 21000, 3000));
+    bring_up(caps);
+    // PPS is the default position, when available
+    ASSERT_EQ(ps.current_index, 1);
+
+    fsm.target_power_mw = 30000;
+    fsm.on_sys_tick();
+    ASSERT_EQ(fsm.get_state(), State::Ready);
+    EXPECT_EQ(io.modulation, PwmScheduler::Modulation::Pwm);
+    const auto requests = io.triggers.size();
+    ASSERT_NE(io.last_request(), nullptr);
+    EXPECT_EQ(io.last_request()->position, 2u);
+
+    // No new requests until SRC confirms
+    fsm.on_sys_tick();
+    EXPECT_EQ(io.triggers.size(), requests);
+
+    fsm.on_snk_ready();
+    fsm.on_sys_tick();
+    EXPECT_EQ(fsm.get_state(), State::Ready);
+}
+
+TEST_F(PowerFsmTest, UnexpectedCapsRestoreWithoutRequest) {
+    pd::PDO_LIST caps{};
+    caps.push_back(fixed_pdo(5000, 3000));
+    bring_up(caps);
+
+    fsm.on_src_caps_received(caps);
+    EXPECT_EQ(fsm.get_state(), State::WaitContractChange);
+    // PE asks selection itself, trigger is only updated
+    EXPECT_FALSE(io.triggers.back().request);
+
+    // Repeated caps re-enter the state
+    io.states.clear();
+    fsm.on_src_caps_received(caps);
+    const std::vector<State> expected{ State::WaitContractChange };
+    EXPECT_EQ(io.states, expected);
+}
+
+TEST_F(PowerFsmTest, RejectAndLoadLossReinit) {
+    pd::PDO_LIST caps{};
+    caps.push_back(fixed_pdo(5000, 3000));
+    bring_up(caps);
+
+    fsm.on_new_power_level_rejected();
+    EXPECT_EQ(fsm.get_state(), State::Initializing);
+    EXPECT_FALSE(io.drain_info.load_valid);
+    EXPECT_EQ(fsm.target_power_mw.load(), 0u);
+
+    // Rejects outside of Ready / WaitContractChange are ignored
+    const auto requests = io.triggers.size();
+    fsm.on_new_power_level_rejected();
+    EXPECT_EQ(io.triggers.size(), requests);
+
+    io.handshake_reported = true;
+    fsm.on_snk_ready();
+    io.set_load(5000, 3000);
+    fsm.on_sys_tick();
+    ASSERT_EQ(fsm.get_state(), State::Ready);
+
+    io.drain_info.load_valid = false;
+    fsm.on_sys_tick();
+    EXPECT_EQ(fsm.get_state(), State::Initializing);
+    EXPECT_FALSE(io.pwm_enabled);
+}
+
+TEST_F(PowerFsmTest, DetachAndFaultDropProfiles) {
+    pd::PDO_LIST caps{};
+    caps.push_back(fixed_pdo(5000, 3000));
+    bring_up(caps);
+    EXPECT_GT(fsm.get_max_power_mw(), 0u);
+
+    fsm.on_src_disabled();
+    EXPECT_EQ(fsm.get_state(), State::Fault);
+    EXPECT_TRUE(fsm.source_caps.empty());
+    EXPECT_TRUE(ps.descriptors.empty());
+    EXPECT_EQ(fsm.get_max_power_mw(), 0u);
+
+    fsm.on_cable_detached();
+    EXPECT_EQ(fsm.get_state(), State::Off);
+    EXPECT_FALSE(io.pwm_enabled);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "lib/pwm_scheduler.hpp"
+
+using Event = PwmScheduler::Event;
+using Modulation = PwmScheduler::Modulation;
+
+namespace {
+
+struct Measured {
+    uint64_t total_us;
+    uint64_t on_us;
+    std::vector<uint32_t> period_on_us;  // On time per PERIOD_US slot
+};
+
+// Plays steps like the timer ISR does, for `periods` x PERIOD_US
+auto measure(uint32_t duty, Modulation modulation, bool reduce_idle, size_t periods) -> Measured {
+    PwmScheduler pwm{};
+    pwm.set_modulation(modulation);
+    pwm.reduce_idle_rate(reduce_idle);
+    pwm.reset();
+    pwm.set_duty_x1000(duty);
+
+    Measured m{};
+    m.period_on_us.resize(periods);
+    const uint64_t horizon = periods * PwmScheduler::PERIOD_US;
+    bool load = false;
+
+    while (true) {
+        const auto s = pwm.next();
+        if (m.total_us + s.delay_us > horizon) { break; }
+        if (load) {
+            m.on_us += s.delay_us;
+            // Pulses don't cross period boundaries, unless duty is 100%
+            m.period_on_us[m.total_us / PwmScheduler::PERIOD_US] += s.delay_us;
+        }
+        m.total_us += s.delay_us;
+        load = s.load_on;
+    }
+    return m;
+}
+
+auto duty_error_x1000(const Measured& m, uint32_t duty) -> double {
+    return static_cast<double>(m.on_us) * 1000 / static_cast<double>(m.total_us) - duty;
+}
+
+// Largest amplitude of delivered duty (x1000) harmonics up to `max_hz`, DC
+// excluded. Head is a thermal low-pass, slow harmonics are what shows up in
+// temperature.
+auto spectral_ripple_x1000(const Measured& m, double max_hz) -> double {
+    const size_t n = m.period_on_us.size();
+    const double period_s = PwmScheduler::PERIOD_US / 1e6;
+    const auto max_bin = static_cast<size_t>(max_hz * n * period_s);
+    double worst = 0;
+    for (size_t k = 1; k <= max_bin; k++) {
+        double re = 0, im = 0;
+        for (size_t i = 0; i < n; i++) {
+            const double x = m.period_on_us[i] * 1000.0 / PwmScheduler::PERIOD_US;
+            re += x * std::cos(2 * M_PI * k * i / n);
+            im -= x * std::sin(2 * M_PI * k * i / n);
+        }
+        worst = std::max(worst, 2 * std::hypot(re, im) / n);
+    }
+    return worst;
+}
+
+} // namespace
+
+TEST(PwmSchedulerTest, DutyIsExact) {
+    for (uint32_t duty = 0; duty <= 1000; duty++) {
+        const uint32_t expected = duty * PwmScheduler::PERIOD_US / 1000 < PwmScheduler::MIN_PULSE_US
+            ? PwmScheduler::MIN_PULSE_US * 1000 / PwmScheduler::PERIOD_US
+            : duty;
+        const auto m = measure(duty, Modulation::Pwm, false, 5);
+        EXPECT_EQ(m.total_us, 5 * PwmScheduler::PERIOD_US) << "duty " << duty;
+        EXPECT_EQ(m.on_us * 1000, expected * m.total_us) << "duty " << duty;
+    }
+}
+
+TEST(PwmSchedulerTest, IdlePulses) {
+    for (auto modulation : { Modulation::Pwm, Modulation::SigmaDelta }) {
+        PwmScheduler pwm{};
+        pwm.set_modulation(modulation);
+        pwm.reset();
+        pwm.set_duty_x1000(0);
+
+        EXPECT_EQ(pwm.next().event, Event::PulseStart);
+        uint32_t pulse_us = 0;
+        PwmScheduler::Step s{};
+        do {
+            s = pwm.next();
+            pulse_us += s.delay_us;
+        } while (s.event != Event::PulseEnd);
+        EXPECT_EQ(pulse_us, PwmScheduler::MIN_PULSE_US);
+        EXPECT_FALSE(s.load_on);
+
+        s = pwm.next();
+        EXPECT_EQ(s.event, Event::PeriodStart);
+        EXPECT_EQ(s.delay_us, PwmScheduler::IDLE_GAP_US);
+        s = pwm.next();
+        EXPECT_EQ(s.event, Event::PulseStart);
+        EXPECT_EQ(s.delay_us, 0u);
+    }
+}
+
+TEST(PwmSchedulerTest, SamplesOnlyOnStableLoad) {
+    for (auto modulation : { Modulation::Pwm, Modulation::SigmaDelta }) {
+        for (uint32_t duty : { 0u, 15u, 45u, 60u, 61u, 100u, 333u, 999u, 1000u }) {
+            PwmScheduler pwm{};
+            pwm.set_modulation(modulation);
+            pwm.reduce_idle_rate(false);
+            pwm.reset();
+            pwm.set_duty_x1000(duty);
+
+            uint64_t now_us = 0, pulse_start = 0, prev_sample = 0;
+            uint32_t samples = 0;
+            bool load = false;
+            for (size_t i = 0; i < 5000; i++) {
+                const auto s = pwm.next();
+                now_us += s.delay_us;
+                switch (s.event) {
+                    case Event::PeriodStart:
+                        EXPECT_FALSE(s.load_on);
+                        break;
+                    case Event::PulseStart:
+                        EXPECT_TRUE(s.load_on);
+                        EXPECT_EQ(s.delay_us, 0u);
+                        // Measurements keep going
+                        EXPECT_LE(now_us - pulse_start, (PwmScheduler::MAX_SKIP_PERIODS + 1) * PwmScheduler::PERIOD_US);
+                        pulse_start = now_us;
+                        samples = 0;
+                        break;
+                    case Event::Sample:
+                        EXPECT_TRUE(load);
+                        EXPECT_GE(now_us - pulse_start, PwmScheduler::POWER_STABILIZATION_US);
+                        if (samples) { EXPECT_GE(now_us - prev_sample, PwmScheduler::SAMPLE_INTERVAL_US); }
+                        prev_sample = now_us;
+                        samples++;
+                        break;
+                    case Event::PulseEnd:
+                        EXPECT_TRUE(load);
+                        EXPECT_FALSE(s.load_on);
+                        EXPECT_GE(now_us - pulse_start, PwmScheduler::MIN_PULSE_US) << "duty " << duty;
+                        EXPECT_GE(samples, 1u) << "duty " << duty;
+                        EXPECT_GE(now_us - prev_sample, PwmScheduler::SAMPLE_GUARD_US) << "duty " << duty;
+                        break;
+                }
+                load = s.load_on;
+            }
+        }
+    }
+}
+
+TEST(PwmSchedulerTest, DutyLatchedAtPeriodStart) {
+    PwmScheduler pwm{};
+    pwm.reset();
+    pwm.set_duty_x1000(500);
+
+    EXPECT_EQ(pwm.next().event, Event::PulseStart);
+    EXPECT_EQ(pwm.get_pulse_us(), 50'000u);
+
+    // Change mid-pulse doesn't cut it
+    pwm.set_duty_x1000(100);
+    uint32_t pulse_us = 0;
+    PwmScheduler::Step s{};
+    do {
+        s = pwm.next();
+        pulse_us += s.delay_us;
+    } while (s.event != Event::PulseEnd);
+    EXPECT_EQ(pulse_us, 50'000u);
+
+    s = pwm.next();
+    EXPECT_EQ(s.event, Event::PeriodStart);
+    EXPECT_EQ(s.delay_us, 50'000u);
+    EXPECT_EQ(pwm.get_pulse_us(), 50'000u);
+    EXPECT_EQ(pwm.next().event, Event::PulseStart);
+    EXPECT_EQ(pwm.get_pulse_us(), 10'000u);
+}
+
+TEST(PwmSchedulerTest, ResetStartsPeriodNow) {
+    PwmScheduler pwm{};
+    pwm.set_duty_x1000(300);
+    pwm.reset();
+    for (int i = 0; i < 10; i++) { pwm.next(); }
+
+    pwm.reset();
+    const auto s = pwm.next();
+    EXPECT_EQ(s.event, Event::PulseStart);
+    EXPECT_EQ(s.delay_us, 0u);
+}
+
+TEST(PwmSchedulerTest, SigmaDeltaSameAsPwmAboveMinPulse) {
+    for (uint32_t duty = PwmScheduler::MIN_PULSE_US * 1000 / PwmScheduler::PERIOD_US; duty <= 1000; duty++) {
+        const auto pwm = measure(duty, Modulation::Pwm, false, 20);
+        const auto sd = measure(duty, Modulation::SigmaDelta, false, 20);
+        EXPECT_EQ(pwm.period_on_us, sd.period_on_us) << "duty " << duty;
+    }
+}
+
+TEST(PwmSchedulerTest, SigmaDeltaLowDuty) {
+    constexpr size_t PERIODS = 1000;  // 100 s
+    constexpr double RIPPLE_MAX_HZ = 1.0;
+    constexpr double MIN_DUTY_X1000 = PwmScheduler::MIN_PULSE_US * 1000.0 / PwmScheduler::PERIOD_US;
+    // Lowest duty sigma-delta can do, min pulse every MAX_SKIP_PERIODS + 1
+    constexpr double FLOOR_X1000 = MIN_DUTY_X1000 / (PwmScheduler::MAX_SKIP_PERIODS + 1);
+
+    printf("duty   PWM error/ripple   SD error/ripple (x1000, ripple below %.0f Hz)\n", RIPPLE_MAX_HZ);
+    for (uint32_t duty : { 0u, 5u, 12u, 13u, 20u, 25u, 33u, 40u, 47u, 55u, 59u, 60u }) {
+        const auto pwm = measure(duty, Modulation::Pwm, false, PERIODS);
+        const auto sd = measure(duty, Modulation::SigmaDelta, false, PERIODS);
+
+        const double pwm_error = duty_error_x1000(pwm, duty);
+        const double sd_error = duty_error_x1000(sd, duty);
+        const double pwm_ripple = spectral_ripple_x1000(pwm, RIPPLE_MAX_HZ);
+        const double sd_ripple = spectral_ripple_x1000(sd, RIPPLE_MAX_HZ);
+        printf("%4u   %6.2f / %5.2f     %6.2f / %5.2f\n", duty, pwm_error, pwm_ripple, sd_error, sd_ripple);
+
+        // PWM can't go below min pulse
+        EXPECT_NEAR(pwm_error, MIN_DUTY_X1000 - duty, 0.01);
+        EXPECT_NEAR(pwm_ripple, 0, 0.01);
+
+        EXPECT_NEAR(sd_error, std::max(FLOOR_X1000 - duty, 0.0), 0.05) << "duty " << duty;
+        // Slow ripple is a fraction of min pulse duty
+        EXPECT_LT(sd_ripple, MIN_DUTY_X1000 / 5) << "duty " << duty;
+    }
+}
+
+TEST(PwmSchedulerTest, ModulationChangeDropsError) {
+    PwmScheduler pwm{};
+    pwm.set_modulation(Modulation::SigmaDelta);
+    pwm.reset();
+    pwm.set_duty_x1000(20);
+    // 2 ms wanted, skipped
+    EXPECT_EQ(pwm.next().event, Event::PeriodStart);
+    EXPECT_EQ(pwm.get_pulse_us(), 0u);
+
+    // Accumulated error doesn't leak through mode change
+    pwm.set_modulation(Modulation::Pwm);
+    pwm.set_modulation(Modulation::SigmaDelta);
+    EXPECT_EQ(pwm.next().event, Event::PeriodStart);
+    EXPECT_EQ(pwm.next().event, Event::PulseStart);
+    EXPECT_EQ(pwm.get_pulse_us(), PwmScheduler::MIN_PULSE_US);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
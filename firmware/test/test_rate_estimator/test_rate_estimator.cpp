@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include "lib/rate_estimator.hpp"
+
+using Estimator = RateEstimator<32>;
+
+TEST(RateEstimatorTest, NotValidUntilHalfWindow) {
+    Estimator re{};
+    for (uint32_t i = 0; i < Estimator::MIN_SAMPLES - 1; i++) {
+        re.push(i * 50, 1000 + static_cast<int32_t>(i));
+        EXPECT_FALSE(re.is_valid());
+        EXPECT_EQ(re.get_rate_x100(), 0);
+    }
+    re.push(1000, 1000);
+    EXPECT_TRUE(re.is_valid());
+}
+
+TEST(RateEstimatorTest, ExactOnRamp) {
+    Estimator re{};
+    // 2.5 °C/s => 25 x10 per second, 50 ms ticks with jitter
+    uint32_t t = 0;
+    for (uint32_t i = 0; i < 100; i++) {
+        t += 45 + (i % 3) * 5;
+        re.push(t, 1000 + static_cast<int32_t>(t) * 25 / 1000);
+    }
+    EXPECT_NEAR(re.get_rate_x100(), 250, 2);
+    EXPECT_NEAR(re.get_residual_x10(), 0, 1);
+
+    // Cooling
+    re.reset();
+    for (uint32_t i = 0; i < 100; i++) { re.push(i * 50, 3000 - static_cast<int32_t>(i) * 5); }
+    EXPECT_EQ(re.get_rate_x100(), -1000);
+}
+
+TEST(RateEstimatorTest, RepeatedTimestampIgnored) {
+    Estimator re{};
+    for (uint32_t i = 0; i < 40; i++) { re.push(i * 40, 500); }
+    // Same measurement with a different value must not be fitted twice
+    re.push(39 * 40, 900);
+    EXPECT_EQ(re.get_rate_x100(), 0);
+    EXPECT_EQ(re.get_residual_x10(), 0);
+}
+
+TEST(RateEstimatorTest, GapRestarts) {
+    Estimator re{};
+    for (uint32_t i = 0; i < 40; i++) { re.push(i * 50, 500 + static_cast<int32_t>(i)); }
+    EXPECT_TRUE(re.is_valid());
+    re.push(40 * 50 + Estimator::MAX_GAP_MS + 1, 500);
+    EXPECT_FALSE(re.is_valid());
+}
+
+TEST(RateEstimatorTest, GlitchShowsInResidual) {
+    Estimator re{};
+    for (uint32_t i = 0; i < 40; i++) { re.push(i * 50, 2000 + static_cast<int32_t>(i) * 2); }
+    re.push(40 * 50, 2080 + 60);
+
+    // 6 °C spike over the trend is visible almost fully, rate barely moves
+    EXPECT_GT(re.get_residual_x10(), 50);
+    EXPECT_LT(re.get_rate_x100(), 400 + 100);
+}
+
+TEST(RateEstimatorTest, NoiseSuppression) {
+    // 0.5 °C noise (TCR-like), constant 3 °C/s heating
+    Estimator re{};
+    std::mt19937 rng(3);
+    std::normal_distribution<double> noise(0, 5.0);
+
+    double err_sq = 0, diff_err_sq = 0;
+    uint32_t count = 0;
+    int32_t prev = 0;
+    for (uint32_t i = 0; i < 2000; i++) {
+        const auto v = static_cast<int32_t>(std::lround(1000 + i * 1.5 + noise(rng)));
+        re.push(i * 50, v);
+        if (i > 100) {
+            const double e = re.get_rate_x100() - 300.0;
+            // Naive two-point difference, as used before
+            const double d = (v - prev) * 20 * 10 - 300.0;
+            err_sq += e * e;
+            diff_err_sq += d * d;
+            count++;
+        }
+        prev = v;
+    }
+    const double rms = std::sqrt(err_sq / count);
+    const double diff_rms = std::sqrt(diff_err_sq / count);
+    printf("Rate noise: fit %.1f, difference %.1f (x100 °C/s)\n", rms, diff_rms);
+    EXPECT_LT(rms, 50);
+    EXPECT_LT(rms, diff_rms / 20);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include "lib/reflow_forecast.hpp"
+
+class ConstantEnvelope : public ReflowForecast {
+public:
+    uint32_t max_mw{0};
+    uint32_t calls{0};
+    uint32_t last_load{0};
+
+    auto get_max_power_mw(uint32_t load_mohms) -> uint32_t override {
+        calls++;
+        last_load = load_mohms;
+        return max_mw;
+    }
+};
+
+static auto make_profile(std::initializer_list<Segment> segments) -> Profile {
+    Profile p = Profile_init_zero;
+    for (const auto& s : segments) { p.segments[p.segments_count++] = s; }
+    return p;
+}
+
+static auto default_config() -> ReflowForecast::Config {
+    return {
+        .adrc_b0 = 0.0536f,
+        .adrc_response = 113.0f,
+        .adrc_n_coeff = 55.0f,
+        .adrc_m_coeff = 5.0f,
+        .start_temperature = 30.0f,
+        .ambient_temperature = 25.0f,
+        .load_mohms = 4000,
+        .load_temperature = 30.0f,
+        .tcr = 0.00393f,
+        .liquidus = 217.0f,
+        .accel_max_x100 = 0
+    };
+}
+
+// Typical SAC305 profile
+static const Profile PROFILE = make_profile({{150, 90}, {180, 90}, {245, 40}, {245, 20}, {100, 40}});
+
+TEST(ReflowForecastTest, FeasibleWithEnoughPower) {
+    ConstantEnvelope f;
+    f.max_mw = 150'000;
+
+    const auto r = f.run(PROFILE, default_config());
+
+    EXPECT_TRUE(r.feasible);
+    EXPECT_EQ(r.eta_s, 280u);
+    EXPECT_NEAR(r.peak_x10, 2450, 30);
+    EXPECT_LE(r.max_lag_x10, ReflowForecast::MAX_LAG_X10);
+    EXPECT_GT(r.energy_j, 0u);
+    EXPECT_GT(r.tal_s, 30u);
+    EXPECT_LT(std::abs(r.tal_deviation_s), 10);
+
+    ASSERT_EQ(r.segments.size(), 5u);
+    EXPECT_EQ(r.segments[0].requested_x100, 133);
+    // Ramp up is tracked
+    EXPECT_NEAR(r.segments[2].achieved_x100, r.segments[2].requested_x100, 30);
+    // Cooling is passive, it is slower than requested
+    EXPECT_GT(r.segments[4].achieved_x100, r.segments[4].requested_x100);
+}
+
+TEST(ReflowForecastTest, InfeasibleWithWeakCharger) {
+    ConstantEnvelope f;
+    f.max_mw = 20'000;
+
+    const auto r = f.run(PROFILE, default_config());
+
+    EXPECT_FALSE(r.feasible);
+    // 20W * 6C/W = 120C above ambient max
+    EXPECT_LT(r.peak_x10, 1500);
+    EXPECT_LT(r.peak_deviation_x10, -ReflowForecast::MAX_PEAK_DEVIATION_X10);
+    EXPECT_EQ(r.tal_s, 0u);
+    EXPECT_LT(r.segments[2].achieved_x100, r.segments[2].requested_x100);
+}
+
+TEST(ReflowForecastTest, LoadFollowsTemperature) {
+    ConstantEnvelope f;
+    f.max_mw = 150'000;
+
+    f.run(make_profile({{200, 200}}), default_config());
+
+    // Envelope is polled once per second, resistance grows with temperature
+    EXPECT_LE(f.calls, 202u);
+    EXPECT_GT(f.last_load, 6000u);
+}
+
+TEST(ReflowForecastTest, EmptyProfile) {
+    ConstantEnvelope f;
+    f.max_mw = 150'000;
+
+    const auto r = f.run(make_profile({}), default_config());
+    EXPECT_FALSE(r.feasible);
+    EXPECT_EQ(r.eta_s, 0u);
+    EXPECT_TRUE(r.segments.empty());
+}
+
+TEST(ReflowForecastTest, LongProfileIsBounded) {
+    ConstantEnvelope f;
+    f.max_mw = 150'000;
+
+    Profile p = Profile_init_zero;
+    p.segments_count = SharedConstants::MAX_REFLOW_SEGMENTS;
+    for (size_t i = 0; i < p.segments_count; i++) { p.segments[i] = {100, 3600}; }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto r = f.run(p, default_config());
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(r.eta_s, 36'000u);
+    EXPECT_TRUE(r.feasible);
+    EXPECT_NEAR(r.peak_x10, 1000, 30);
+    EXPECT_EQ(r.segments.size(), SharedConstants::MAX_REFLOW_SEGMENTS);
+    printf("10h profile forecast: %lld us (host)\n", static_cast<long long>(us));
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "lib/reflow_metrics.hpp"
+#include "lib/timeline.hpp"
+
+static auto make_profile(std::initializer_list<Segment> segments) -> Profile {
+    Profile p = Profile_init_zero;
+    for (const auto& s : segments) { p.segments[p.segments_count++] = s; }
+    return p;
+}
+
+// Typical SAC305 profile
+static auto sac305() -> Profile {
+    return make_profile({{150, 90}, {180, 90}, {245, 40}, {245, 10}, {180, 40}});
+}
+
+// Feeds profile setpoint, with temperature as function of (time, setpoint)
+template <typename Fn>
+static void feed(ReflowMetrics& m, const Profile& profile, Fn&& temperature_of) {
+    static constexpr uint32_t TICK_MS = 50;
+
+    Timeline timeline{};
+    timeline.load(profile);
+    for (int32_t t = 0; t <= timeline.get_max_time_x1000(); t += TICK_MS) {
+        const float sp = static_cast<float>(timeline.get_target_x100(t)) * 0.01f;
+        m.push(TICK_MS, temperature_of(t, sp), sp);
+    }
+}
+
+TEST(ReflowMetricsTest, PerfectTracking) {
+    ReflowMetrics m{};
+    m.start(ReflowMetrics::default_config());
+    feed(m, sac305(), [](int32_t, float sp) { return sp; });
+
+    const auto r = m.get_result(true);
+    EXPECT_TRUE(r.passed);
+    EXPECT_EQ(r.failures, ReflowMetrics::FAIL_NONE);
+    EXPECT_EQ(r.peak_x10, 2450);
+    EXPECT_EQ(r.profile_peak_x10, 2450);
+    EXPECT_EQ(r.tal_ms, r.profile_tal_ms);
+    EXPECT_EQ(r.soak_ms, r.profile_soak_ms);
+    EXPECT_EQ(r.max_lag_x10, 0);
+
+    // 180 -> 245 in 40s crosses liquidus at 22.77s (17.23s above), plus
+    // 10s hold, plus the same 17.23s on the way down
+    EXPECT_NEAR(static_cast<double>(r.tal_ms), 17230 + 10000 + 17230, 200);
+
+    // Soak band 150..200: 90s plateau 150 -> 180, plus 180 -> 200 on ramp.
+    EXPECT_NEAR(static_cast<double>(r.soak_ms), 90000 + 12300, 200);
+
+    // Fastest ramp 65°C / 40s = 1.63 °C/s, cooling same
+    EXPECT_NEAR(r.ramp_up_max_x100, 162, 3);
+    EXPECT_NEAR(r.ramp_down_max_x100, 162, 3);
+}
+
+TEST(ReflowMetricsTest, LowPeakFails) {
+    ReflowMetrics m{};
+    m.start(ReflowMetrics::default_config());
+    // Plate lags 15°C above 200°C
+    feed(m, sac305(), [](int32_t, float sp) { return sp > 200.0f ? sp - 15.0f : sp; });
+
+    const auto r = m.get_result(true);
+    EXPECT_FALSE(r.passed);
+    EXPECT_TRUE(r.failures & ReflowMetrics::FAIL_PEAK);
+    EXPECT_TRUE(r.failures & ReflowMetrics::FAIL_TAL);
+    EXPECT_NEAR(r.max_lag_x10, 150, 1);
+}
+
+TEST(ReflowMetricsTest, RampSpikeFails) {
+    ReflowMetrics m{};
+    m.start(ReflowMetrics::default_config());
+    // 30°C overshoot bump for 4 seconds in the middle of soak
+    feed(m, sac305(), [](int32_t t, float sp) {
+        return (t >= 100'000 && t < 104'000) ? sp + static_cast<float>(t - 100'000) * 0.0075f : sp;
+    });
+
+    const auto r = m.get_result(true);
+    EXPECT_TRUE(r.failures & ReflowMetrics::FAIL_RAMP_UP);
+    EXPECT_TRUE(r.failures & ReflowMetrics::FAIL_RAMP_DOWN);
+    EXPECT_FALSE(r.failures & ReflowMetrics::FAIL_PEAK);
+    EXPECT_GT(r.max_overshoot_x10, 250);
+}
+
+TEST(ReflowMetricsTest, CustomLiquidusAndIncompleteRun) {
+    auto cfg = ReflowMetrics::default_config(138 * 10);  // Sn42/Bi58
+    ReflowMetrics m{};
+    m.start(cfg);
+
+    const auto lts = make_profile({{100, 60}, {140, 60}, {180, 30}, {180, 30}, {140, 20}});
+    feed(m, lts, [](int32_t, float sp) { return sp; });
+
+    auto r = m.get_result(true);
+    EXPECT_EQ(r.liquidus_x10, 1380);
+    EXPECT_GT(r.tal_ms, 60000u);
+    EXPECT_TRUE(r.passed);
+
+    r = m.get_result(false);
+    EXPECT_FALSE(r.passed);
+    EXPECT_EQ(r.failures, ReflowMetrics::FAIL_NOT_COMPLETED);
+}
+
+TEST(ReflowMetricsTest, RestartResets) {
+    ReflowMetrics m{};
+    m.start(ReflowMetrics::default_config());
+    m.push(50, 250.0f, 100.0f);
+
+    m.start(ReflowMetrics::default_config());
+    const auto r = m.get_result(true);
+    EXPECT_EQ(r.duration_ms, 0u);
+    EXPECT_EQ(r.peak_x10, 0);
+    EXPECT_EQ(r.tal_ms, 0u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
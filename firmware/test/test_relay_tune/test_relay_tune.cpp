@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <deque>
+#include "lib/relay_tune.hpp"
+
+// FOPDT head with transport delay
+struct Plant {
+    float tau;
+    float b0;
+    float delay;
+    float ambient;
+    float temperature;
+    std::deque<float> pipe{};
+
+    auto step(float dt, float power) -> float {
+        const auto n = static_cast<size_t>(delay / dt);
+        pipe.push_back(power);
+        float u = 0;
+        if (pipe.size() > n) { u = pipe.front(); pipe.pop_front(); }
+        temperature += dt * (b0 * u - (temperature - ambient) / tau);
+        return temperature;
+    }
+};
+
+static auto run(Plant& plant, const RelayTune::Config& cfg, float max_time) -> RelayTune {
+    static constexpr float DT = 0.05f;
+
+    RelayTune tune{};
+    tune.start(cfg);
+    float power = cfg.power_high;
+    for (float t = 0; t < max_time && tune.get_status() == RelayTune::Status::Running; t += DT) {
+        power = tune.update(DT, plant.step(DT, power));
+    }
+    return tune;
+}
+
+TEST(RelayTuneTest, IdentifiesHead) {
+    Plant plant{113.0f, 0.0536f, 4.0f, 25.0f, 25.0f};
+    const RelayTune::Config cfg{150.0f, 0.5f, 40.0f, 0.0f, 25.0f};
+
+    const auto tune = run(plant, cfg, 2000.0f);
+    ASSERT_EQ(tune.get_status(), RelayTune::Status::Done);
+
+    const auto& r = tune.get_result();
+    EXPECT_NEAR(r.gain, 0.0536f * 113.0f, 0.0536f * 113.0f * 0.05f);
+    EXPECT_NEAR(r.tau, 113.0f, 113.0f * 0.05f);
+    EXPECT_NEAR(r.b0, 0.0536f, 0.0536f * 0.05f);
+    EXPECT_NEAR(r.delay, 4.0f, 0.5f);
+    EXPECT_GT(r.amplitude, 0.5f);
+}
+
+TEST(RelayTuneTest, FasterThanStepResponse) {
+    Plant plant{113.0f, 0.0536f, 4.0f, 25.0f, 25.0f};
+    const RelayTune::Config cfg{150.0f, 0.5f, 40.0f, 0.0f, 25.0f};
+
+    static constexpr float DT = 0.05f;
+    RelayTune tune{};
+    tune.start(cfg);
+    float power = cfg.power_high;
+    float t = 0;
+    for (; t < 2000.0f && tune.get_status() == RelayTune::Status::Running; t += DT) {
+        power = tune.update(DT, plant.step(DT, power));
+    }
+    // Heat-up to setpoint dominates, cycles themselves are short
+    EXPECT_LT(t, 5 * 113.0f);
+}
+
+TEST(RelayTuneTest, FailsWithoutOscillation) {
+    // Not enough power to reach setpoint
+    Plant plant{113.0f, 0.0536f, 4.0f, 25.0f, 25.0f};
+    const RelayTune::Config cfg{150.0f, 0.5f, 10.0f, 0.0f, 25.0f};
+
+    const auto tune = run(plant, cfg, 2000.0f);
+    EXPECT_EQ(tune.get_status(), RelayTune::Status::Running);
+    EXPECT_EQ(tune.get_cycles(), 0u);
+}
+
+TEST(RelayTuneTest, OutputFollowsRelay) {
+    RelayTune tune{};
+    tune.start({100.0f, 1.0f, 30.0f, 5.0f, 25.0f});
+
+    EXPECT_EQ(tune.update(0.1f, 90.0f), 30.0f);
+    EXPECT_EQ(tune.update(0.1f, 100.5f), 30.0f);  // Inside hysteresis
+    EXPECT_EQ(tune.update(0.1f, 101.5f), 5.0f);
+    EXPECT_EQ(tune.update(0.1f, 99.5f), 5.0f);
+    EXPECT_EQ(tune.update(0.1f, 98.5f), 30.0f);
+    EXPECT_EQ(tune.get_cycles(), 1u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,578 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "lib/sample_trace.hpp"
+#include "lib/trace_replay.hpp"
+
+template <size_t BufferSize>
+class TestWriter : public SampleTraceWriter<BufferSize> {
+public:
+    uint32_t time{1000};
+    auto now_ms() -> uint32_t override { return time; }
+
+    auto drain() -> std::vector<uint8_t> {
+        std::vector<uint8_t> out;
+        uint8_t chunk[100];
+        size_t n;
+        while ((n = this->read(chunk, sizeof(chunk))) > 0) { out.insert(out.end(), chunk, chunk + n); }
+        return out;
+    }
+};
+
+using Record = SampleTraceReader::Record;
+using RecordType = SampleTrace::RecordType;
+
+TEST(SampleTraceTest, DisabledByDefault) {
+    TestWriter<1024> w;
+    const int32_t cic[] = { 12345 };
+    w.adc_cic(cic, 1);
+    w.sensor_update();
+    EXPECT_TRUE(w.drain().empty());
+}
+
+TEST(SampleTraceTest, Roundtrip) {
+    TestWriter<1024> w;
+    w.start(2);
+
+    struct Point { uint16_t raw; uint16_t mV; };
+    std::vector<Point> lut{{0, 0}, {2048, 500}, {4095, 1000}};
+    w.adc_lut(lut);
+
+    w.time += 10;
+    // Deltas wrap around
+    const int32_t cic[] = { 123456, -5, INT32_MAX, INT32_MIN };
+    w.adc_cic(cic, 4);
+    w.time += 3;
+    w.ina_sample(4000, 0xFFFE, 300);
+    w.pwm_edge(SampleTrace::PwmEvent::PulseEnd);
+    w.sensor_config({true, 25.0f, 3000.0f, 200.0f, 5000.0f, 30.0f, 0.5f, 5.0f, 3.0f,
+                     2, { 25.0f, 250.0f }, { 3000.0f, 5300.0f }});
+    w.time += 50;
+    w.control_tick({50, -123, 150.0f, 1.5f, 60.0f, 12.5f, 85});
+    w.thermal_tick({50, 123456});
+
+    auto data = w.drain();
+    SampleTraceReader reader(data.data(), data.size());
+    Record r{};
+
+    ASSERT_TRUE(reader.next(r));
+    EXPECT_EQ(r.type, RecordType::Start);
+    EXPECT_EQ(r.ina_chip, 2);
+    EXPECT_EQ(r.ts_ms, 1000u);
+
+    ASSERT_TRUE(reader.next(r));
+    EXPECT_EQ(r.type, RecordType::AdcLut);
+    ASSERT_EQ(r.lut_count, 3u);
+    EXPECT_EQ(r.lut_data[4] | (r.lut_data[5] << 8), 2048);
+    EXPECT_EQ(r.lut_data[6] | (r.lut_data[7] << 8), 500);
+
+    ASSERT_TRUE(reader.next(r));
+    EXPECT_EQ(r.type, RecordType::AdcCic);
+    ASSERT_EQ(r.adc_count, 4u);
+    for (size_t i = 0; i < 4; i++) { EXPECT_EQ(r.adc_values[i], cic[i]); }
+    EXPECT_EQ(r.ts_ms, 1010u);
+
+    ASSERT_TRUE(reader.next(r));
+    EXPECT_EQ(r.type, RecordType::InaSample);
+    EXPECT_EQ(r.v_raw, 4000);
+    EXPECT_EQ(r.i_raw, 0xFFFE);
+    EXPECT_EQ(r.ctx_idx, 300u);
+    EXPECT_EQ(r.ts_ms, 1013u);
+
+    ASSERT_TRUE(reader.next(r));
+    EXPECT_EQ(r.type, RecordType::PwmEdge);
+    EXPECT_EQ(r.pwm_event, SampleTrace::PwmEvent::PulseEnd);
+
+    ASSERT_TRUE(reader.next(r));
+    EXPECT_EQ(r.type, RecordType::SensorConfig);
+    EXPECT_TRUE(r.sensor_config.is_tcr);
+    EXPECT_EQ(r.sensor_config.p1_value, 5000.0f);
+    EXPECT_EQ(r.sensor_config.adrc_m_coeff, 3.0f);
+    EXPECT_EQ(r.sensor_config.tcr_count, 2);
+    EXPECT_EQ(r.sensor_config.tcr_at[1], 250.0f);
+    EXPECT_EQ(r.sensor_config.tcr_value[1], 5300.0f);
+
+    ASSERT_TRUE(reader.next(r));
+    EXPECT_EQ(r.type, RecordType::ControlTick);
+    EXPECT_EQ(r.control.dt_ms, 50u);
+    EXPECT_EQ(r.control.temperature_x10, -123);
+    EXPECT_EQ(r.control.setpoint_rate, 1.5f);
+    EXPECT_EQ(r.control.power_out, 12.5f);
+    EXPECT_EQ(r.control.temperature_age_ms, 85u);
+    EXPECT_EQ(r.ts_ms, 1063u);
+
+    ASSERT_TRUE(reader.next(r));
+    EXPECT_EQ(r.type, RecordType::ThermalTick);
+    EXPECT_EQ(r.thermal.dt_ms, 50u);
+    EXPECT_EQ(r.thermal.power_mw, 123456u);
+
+    EXPECT_FALSE(reader.next(r));
+    EXPECT_EQ(reader.offset(), data.size());
+}
+
+TEST(SampleTraceTest, SplitReads) {
+    TestWriter<1024> w;
+    w.start(1);
+    for (int32_t i = 0; i < 50; i++) {
+        const int32_t cic[] = { i * 1000, i * 1000 + 7 };
+        w.adc_cic(cic, 2);
+    }
+
+    std::vector<uint8_t> data;
+    uint8_t chunk[7];
+    size_t n;
+    while ((n = w.read(chunk, sizeof(chunk))) > 0) { data.insert(data.end(), chunk, chunk + n); }
+
+    SampleTraceReader reader(data.data(), data.size());
+    Record r{};
+    ASSERT_TRUE(reader.next(r));
+    for (int32_t i = 0; i < 50; i++) {
+        ASSERT_TRUE(reader.next(r));
+        ASSERT_EQ(r.adc_count, 2u);
+        EXPECT_EQ(r.adc_values[0], i * 1000);
+        EXPECT_EQ(r.adc_values[1], i * 1000 + 7);
+    }
+    EXPECT_FALSE(reader.next(r));
+}
+
+TEST(SampleTraceTest, WrappedRead) {
+    TestWriter<1024> w;
+    w.start(1);
+    // Move ring position close to the end, then wrap with new records
+    const int32_t fill[] = { 100000 };
+    for (uint32_t i = 0; i < 150; i++) { w.adc_cic(fill, 1); }
+    auto data = w.drain();
+    for (int32_t i = 0; i < 100; i++) {
+        const int32_t cic[] = { i };
+        w.adc_cic(cic, 1);
+    }
+
+    // Single read takes both contiguous parts
+    std::vector<uint8_t> tail(1024);
+    tail.resize(w.read(tail.data(), tail.size()));
+    EXPECT_EQ(w.read(tail.data(), 1), 0u);
+    data.insert(data.end(), tail.begin(), tail.end());
+
+    SampleTraceReader reader(data.data(), data.size());
+    Record r{};
+    ASSERT_TRUE(reader.next(r));
+    for (uint32_t i = 0; i < 150; i++) { ASSERT_TRUE(reader.next(r)); }
+    for (int32_t i = 0; i < 100; i++) {
+        ASSERT_TRUE(reader.next(r));
+        EXPECT_EQ(r.adc_values[0], i);
+    }
+    EXPECT_FALSE(reader.next(r));
+}
+
+// Restart from the writer side while reader copies bytes outside of lock
+class RestartingWriter : public TestWriter<1024> {
+public:
+    bool restart_armed{false};
+
+    void unlock() override {
+        if (!restart_armed) { return; }
+        restart_armed = false;
+        start(2);
+    }
+};
+
+TEST(SampleTraceTest, RestartDuringReadDropsStaleChunk) {
+    RestartingWriter w;
+    w.start(1);
+    const int32_t cic[] = { 100000 };
+    for (uint32_t i = 0; i < 10; i++) { w.adc_cic(cic, 1); }
+
+    uint8_t chunk[100];
+    w.restart_armed = true;
+    EXPECT_EQ(w.read(chunk, sizeof(chunk)), 0u);
+
+    // New stream is intact, starts with its own Start record
+    auto data = w.drain();
+    SampleTraceReader reader(data.data(), data.size());
+    Record r{};
+    ASSERT_TRUE(reader.next(r));
+    EXPECT_EQ(r.type, RecordType::Start);
+    EXPECT_EQ(r.ina_chip, 2u);
+    EXPECT_FALSE(reader.next(r));
+}
+
+TEST(SampleTraceTest, OverflowEmitsGap) {
+    TestWriter<1024> w;
+    w.start(1);
+    // Each record is 1 + 1 + 1 + 3 bytes
+    const int32_t cic[] = { 100000 };
+    for (uint32_t i = 0; i < 300; i++) { w.adc_cic(cic, 1); }
+    EXPECT_GT(w.get_dropped(), 0u);
+    const auto dropped = w.get_dropped();
+
+    auto data = w.drain();
+    const int32_t last[] = { 7 };
+    w.adc_cic(last, 1);
+    auto tail = w.drain();
+    data.insert(data.end(), tail.begin(), tail.end());
+
+    SampleTraceReader reader(data.data(), data.size());
+    Record r{};
+    uint32_t frames = 0;
+    bool gap_found = false;
+    while (reader.next(r)) {
+        if (r.type == RecordType::AdcCic) { frames++; }
+        if (r.type == RecordType::Gap) {
+            gap_found = true;
+            EXPECT_EQ(r.value, dropped);
+            // Gap must be followed by the next stored record
+            ASSERT_TRUE(reader.next(r));
+            EXPECT_EQ(r.type, RecordType::AdcCic);
+            EXPECT_EQ(r.adc_values[0], 7);
+            frames++;
+        }
+    }
+    EXPECT_TRUE(gap_found);
+    EXPECT_EQ(frames + dropped, 301u);
+}
+
+TEST(SampleTraceTest, TruncatedStream) {
+    TestWriter<1024> w;
+    w.start(1);
+    w.control_tick({50, 250, 150.0f, 0.0f, 60.0f, 12.5f, 0});
+    auto data = w.drain();
+
+    SampleTraceReader reader(data.data(), data.size() - 1);
+    Record r{};
+    ASSERT_TRUE(reader.next(r));
+    EXPECT_FALSE(reader.next(r));
+    EXPECT_LT(reader.offset(), data.size() - 1);
+}
+
+TEST(SampleTraceTest, StateRoundtrip) {
+    TestWriter<4096> w;
+    w.start(1);
+    EXPECT_FALSE(w.is_pulse_recorded());
+
+    InaFilter::Result info{};
+    info.peak_mv = 20000;
+    info.peak_ma = 4000;
+    info.load_valid = true;
+    info.ctx_idx = 3;
+    info.samples = 7;
+    info.seq = 1234;
+    info.timestamp_ms = 999;
+    w.drain_info(info);
+    TraceReplay::AdcFilter filter{};
+    for (uint32_t n = 0; n < 5000; n++) { filter.push(static_cast<uint16_t>(1500 + n % 7)); }
+    w.adc_state(filter, true);
+    w.tcr_state({true, -5, 70000, 1233});
+    w.pwm_edge(SampleTrace::PwmEvent::PulseStart);
+    EXPECT_TRUE(w.is_pulse_recorded());
+
+    auto data = w.drain();
+    SampleTraceReader reader(data.data(), data.size());
+    Record r{};
+
+    ASSERT_TRUE(reader.next(r));
+    ASSERT_TRUE(reader.next(r));
+    EXPECT_EQ(r.type, RecordType::DrainInfo);
+    EXPECT_EQ(r.drain.peak_mv, 20000u);
+    EXPECT_EQ(r.drain.peak_ma, 4000u);
+    EXPECT_TRUE(r.drain.load_valid);
+    EXPECT_EQ(r.drain.ctx_idx, 3u);
+    EXPECT_EQ(r.drain.samples, 7u);
+    EXPECT_EQ(r.drain.seq, 1234u);
+    EXPECT_EQ(r.drain.timestamp_ms, 999u);
+
+    ASSERT_TRUE(reader.next(r));
+    EXPECT_EQ(r.type, RecordType::AdcState);
+    EXPECT_TRUE(r.adc.valid);
+    const auto fs = filter.get_fir_state();
+    EXPECT_EQ(r.adc.output_x100, fs.output);
+    EXPECT_EQ(r.adc.phase, fs.phase);
+    EXPECT_EQ(r.adc.pos, fs.pos);
+    EXPECT_EQ(r.adc.warmup, fs.warmup);
+    ASSERT_EQ(r.adc_count, TraceReplay::AdcFilter::TAPS);
+    for (size_t i = 0; i < r.adc_count; i++) { EXPECT_EQ(r.adc_values[i], filter.get_fir_line()[i]); }
+
+    ASSERT_TRUE(reader.next(r));
+    EXPECT_EQ(r.type, RecordType::TcrState);
+    EXPECT_TRUE(r.tcr.valid);
+    EXPECT_EQ(r.tcr.x_q, -5);
+    EXPECT_EQ(r.tcr.p_q, 70000u);
+    EXPECT_EQ(r.tcr.seq, 1233u);
+
+    // Restart forgets recorded pulse
+    w.start(1);
+    EXPECT_FALSE(w.is_pulse_recorded());
+}
+
+// Simulates device side: real chain produces control outputs, which are
+// recorded together with raw inputs. Replay must reproduce them exactly.
+class ReplayFixture : public ::testing::Test {
+protected:
+    TestWriter<64 * 1024> w;
+    InaFilter ina{};
+    InaFilter::Result info{};
+    TemperatureProcessor tcr{};
+    TcrKalman kf{};
+    uint32_t kf_seq{0};
+    ADRC adrc{};
+    float power{0};
+
+    void SetUp() override {
+        tcr.set_sensor_type(SensorType_TCR);
+        tcr.set_cal_points(25.0f, 3000.0f, 200.0f, 5000.0f);
+        kf.set_params(0.5f, 30.0f);
+        adrc.set_params(0.5f, 30.0f, 5.0f, 3.0f);
+
+        w.start(static_cast<uint8_t>(InaFilter::Chip::INA226));
+        w.sensor_config({true, 25.0f, 3000.0f, 200.0f, 5000.0f, 30.0f, 0.5f, 5.0f, 3.0f, 0, {}, {}});
+    }
+
+    auto temperature_x10() -> int32_t {
+        if (!kf.is_valid()) { return TraceReplay::UNKNOWN_TEMPERATURE_X10; }
+        return kf.get_temperature_x10();
+    }
+
+    // Like Head::update_temperature_estimate()
+    void thermal(uint32_t dt_ms) {
+        const auto power_mw = static_cast<uint32_t>(power * 1000);
+        w.thermal_tick({dt_ms, power_mw});
+        if (!info.load_valid) {
+            kf.reset();
+            return;
+        }
+        kf.predict(dt_ms, power_mw);
+        if (info.seq != kf_seq || !kf.is_valid()) {
+            kf_seq = info.seq;
+            kf.update(tcr.get_temperature_x10(info.peak_mv * 1000 / info.peak_ma), info.samples);
+        }
+    }
+
+    void pulse(uint16_t v_raw, int16_t i_ma) {
+        ina.clear();
+        w.pwm_edge(SampleTrace::PwmEvent::PulseStart);
+        for (int i = 0; i < 10; i++) {
+            const uint16_t v = static_cast<uint16_t>(v_raw + (i % 3));
+            ina.push({v, i_ma, 0});
+            w.ina_sample(v, static_cast<uint16_t>(i_ma), 0);
+        }
+        pulse_end();
+    }
+
+    // Like DrainTracker::process_collected_data()
+    void pulse_end() {
+        w.pwm_edge(SampleTrace::PwmEvent::PulseEnd);
+        if (ina.process(InaFilter::Chip::INA226, info, w.time) && !w.is_pulse_recorded()) { w.drain_info(info); }
+    }
+
+    // Like SampleRecorder::start(), with filter states recorded by tasks
+    void start_trace() {
+        w.start(static_cast<uint8_t>(InaFilter::Chip::INA226));
+        w.sensor_config({true, 25.0f, 3000.0f, 200.0f, 5000.0f, 30.0f, 0.5f, 5.0f, 3.0f, 0, {}, {}});
+        w.drain_info(info);
+        const auto s = kf.get_state();
+        w.tcr_state({s.valid, s.x_q, s.p_q, kf_seq});
+    }
+
+    void control(float setpoint) {
+        w.time += 50;
+        thermal(50);
+        const float t = static_cast<float>(temperature_x10()) * 0.1f;
+        power = adrc.iterate(t, setpoint, 60.0f, 50 * (1.0F / 1000), 0.5f, 80 * (1.0F / 1000));
+        w.control_tick({50, static_cast<int32_t>(lroundf(t * 10.0f)), setpoint, 0.5f, 60.0f, power, 80});
+    }
+
+    void run_session() {
+        pulse(16000, 4000);
+        thermal(50);
+        adrc.reset_to(static_cast<float>(temperature_x10()) * 0.1f);
+        w.control_reset();
+
+        for (int i = 0; i < 200; i++) {
+            pulse(static_cast<uint16_t>(16000 - i * 3), static_cast<int16_t>(4000 - i * 5));
+            control(220.0f + static_cast<float>(i) * 0.25f);
+        }
+    }
+};
+
+TEST_F(ReplayFixture, BitExact) {
+    run_session();
+    auto data = w.drain();
+
+    TraceReplay replay;
+    ASSERT_TRUE(replay.run(data.data(), data.size()));
+    EXPECT_EQ(replay.stats.control_ticks, 200u);
+    EXPECT_EQ(replay.stats.temperature_mismatches, 0u);
+    EXPECT_EQ(replay.stats.power_mismatches, 0u);
+    EXPECT_EQ(replay.stats.gaps, 0u);
+    // Filtered estimate is available and close to the raw one
+    EXPECT_NE(replay.get_temperature_x10(), TraceReplay::UNKNOWN_TEMPERATURE_X10);
+    EXPECT_NEAR(replay.get_temperature_x10(), replay.get_raw_temperature_x10(), 20);
+    EXPECT_GT(replay.get_temperature_variance_x100(), 0u);
+}
+
+TEST_F(ReplayFixture, MultiPointTcrBitExact) {
+    // Curve differs from p0/p1 line, replay must use the same one
+    const float at[] = { 25.0f, 120.0f, 250.0f };
+    const float value[] = { 3000.0f, 4000.0f, 5300.0f };
+    tcr.set_tcr_points(at, value, 3);
+    w.sensor_config({true, 25.0f, 3000.0f, 200.0f, 5000.0f, 30.0f, 0.5f, 5.0f, 3.0f,
+                     3, { 25.0f, 120.0f, 250.0f }, { 3000.0f, 4000.0f, 5300.0f }});
+    run_session();
+    auto data = w.drain();
+
+    TraceReplay replay;
+    ASSERT_TRUE(replay.run(data.data(), data.size()));
+    EXPECT_EQ(replay.stats.control_ticks, 200u);
+    EXPECT_EQ(replay.stats.temperature_mismatches, 0u);
+    EXPECT_EQ(replay.stats.power_mismatches, 0u);
+}
+
+TEST_F(ReplayFixture, StartMidSession) {
+    run_session();
+
+    // Recording starts in the middle of a pulse
+    ina.clear();
+    w.pwm_edge(SampleTrace::PwmEvent::PulseStart);
+    for (int i = 0; i < 4; i++) { ina.push({15000, 3000, 0}); }
+    start_trace();
+    for (int i = 0; i < 4; i++) {
+        ina.push({15002, 3000, 0});
+        w.ina_sample(15002, 3000, 0);
+    }
+    pulse_end();
+    control(270.0f);
+
+    for (int i = 0; i < 50; i++) {
+        pulse(static_cast<uint16_t>(15000 - i * 3), static_cast<int16_t>(3000 - i * 5));
+        control(270.0f);
+    }
+    auto data = w.drain();
+
+    TraceReplay replay;
+    ASSERT_TRUE(replay.run(data.data(), data.size()));
+    EXPECT_EQ(replay.stats.control_ticks, 51u);
+    // ADRC state is not recorded, only its input is checked
+    EXPECT_EQ(replay.stats.temperature_mismatches, 0u);
+    EXPECT_EQ(replay.get_drain_info().seq, info.seq);
+}
+
+TEST_F(ReplayFixture, DetectsDivergence) {
+    // Controller on "device" uses different tuning than recorded in config
+    adrc.set_params(0.5f, 30.0f, 6.0f, 3.0f);
+    run_session();
+    auto data = w.drain();
+
+    TraceReplay replay;
+    ASSERT_TRUE(replay.run(data.data(), data.size()));
+    EXPECT_EQ(replay.stats.temperature_mismatches, 0u);
+    EXPECT_GT(replay.stats.power_mismatches, 0u);
+}
+
+// Like Head ADC task: CIC outputs are flushed before each filter output
+class AdcFixture : public ::testing::Test {
+protected:
+    struct Point { uint16_t raw; uint16_t mV; };
+
+    TestWriter<64 * 1024> w;
+    TraceReplay::AdcFilter filter{};
+    bool has_output{false};
+    GridAdcInterpolator<2> interp{};
+    std::vector<uint32_t> sensor_uv{};  // Device values, per update
+
+    void SetUp() override {
+        interp.points.push_back({0, 0});
+        interp.points.push_back({4095, 1000});
+        interp.rebuild();
+    }
+
+    void start_trace() {
+        w.start(1);
+        std::vector<Point> lut{{0, 0}, {4095, 1000}};
+        w.adc_lut(lut);
+    }
+
+    void feed(uint32_t samples) {
+        int32_t cic[SampleTrace::MAX_CIC_BATCH];
+        size_t cic_count = 0;
+        for (uint32_t n = 0; n < samples; n++) {
+            const auto sample = static_cast<uint16_t>(1500 + (n * 7919) % 41);
+            if (!filter.push_cic(sample)) { continue; }
+
+            cic[cic_count++] = filter.get_cic_output();
+            const bool ready = filter.push_fir(filter.get_cic_output());
+            if (ready || cic_count == SampleTrace::MAX_CIC_BATCH) {
+                w.adc_cic(cic, cic_count);
+                cic_count = 0;
+            }
+            if (!ready) { continue; }
+
+            has_output = true;
+            sensor_uv.push_back(interp.to_uv(filter.get_output(), TraceReplay::ADC_VALUE_SCALE));
+            w.sensor_update();
+        }
+        if (cic_count) { w.adc_cic(cic, cic_count); }
+    }
+
+    // Replayed sensor values, per update
+    auto replay() -> std::vector<uint32_t> {
+        auto data = w.drain();
+        TraceReplay replay;
+        SampleTraceReader reader(data.data(), data.size());
+        Record r{};
+        std::vector<uint32_t> out;
+        while (reader.next(r)) {
+            replay.process(r);
+            if (r.type == RecordType::SensorUpdate) { out.push_back(replay.get_sensor_uv()); }
+        }
+        EXPECT_EQ(reader.offset(), data.size());
+        return out;
+    }
+};
+
+TEST_F(AdcFixture, FromStart) {
+    start_trace();
+    w.adc_state(filter, has_output);
+    feed(20'000);
+
+    ASSERT_GT(sensor_uv.size(), 20u);
+    EXPECT_EQ(replay(), sensor_uv);
+}
+
+TEST_F(AdcFixture, MidStream) {
+    feed(12'345);
+    sensor_uv.clear();
+
+    start_trace();
+    // Batch before filter state is recorded can't be replayed
+    const int32_t garbage[] = { 1, 2, 3 };
+    w.adc_cic(garbage, 3);
+    w.adc_state(filter, has_output);
+    feed(20'000);
+
+    ASSERT_GT(sensor_uv.size(), 20u);
+    EXPECT_EQ(replay(), sensor_uv);
+}
+
+TEST_F(AdcFixture, StateWithoutFrames) {
+    start_trace();
+    w.adc_state(filter, false);
+    auto data = w.drain();
+    TraceReplay replay;
+    ASSERT_TRUE(replay.run(data.data(), data.size()));
+    // No filter output yet, sensor keeps initial value
+    EXPECT_EQ(replay.get_sensor_uv(), TraceReplay::INITIAL_SENSOR_UV);
+
+    // Sensor value follows filter state, without a new frame
+    feed(20'000);
+    sensor_uv.clear();
+    start_trace();
+    w.adc_state(filter, true);
+    data = w.drain();
+    TraceReplay replay2;
+    ASSERT_TRUE(replay2.run(data.data(), data.size()));
+    EXPECT_EQ(replay2.get_sensor_uv(), interp.to_uv(filter.get_output(), TraceReplay::ADC_VALUE_SCALE));
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include "lib/scratch_arena.hpp"
+
+static int alive = 0;
+
+struct Small {
+    int value;
+    explicit Small(int v) : value{v} { alive++; }
+    ~Small() { alive--; }
+};
+
+struct Big {
+    double data[16]{};
+    Big() { alive++; }
+    ~Big() { alive--; }
+};
+
+struct alignas(16) Aligned {
+    uint8_t b;
+};
+
+TEST(ScratchArenaTest, SizedByLargestType) {
+    using Arena = ScratchArena<Small, Big, Aligned>;
+    EXPECT_EQ(Arena::SIZE, sizeof(Big));
+    EXPECT_GE(sizeof(Arena), sizeof(Big));
+    EXPECT_LE(sizeof(Arena), sizeof(Big) + 2 * alignof(Aligned));
+}
+
+TEST(ScratchArenaTest, AcquireRelease) {
+    alive = 0;
+    ScratchArena<Small, Big> arena{};
+    EXPECT_FALSE(arena.in_use());
+
+    auto& s = arena.acquire<Small>(42);
+    EXPECT_EQ(s.value, 42);
+    EXPECT_EQ(alive, 1);
+    EXPECT_TRUE(arena.in_use());
+
+    arena.release();
+    EXPECT_EQ(alive, 0);
+    EXPECT_FALSE(arena.in_use());
+
+    // Double release is harmless
+    arena.release();
+    EXPECT_EQ(alive, 0);
+}
+
+TEST(ScratchArenaTest, ReacquireDestroysPrevious) {
+    alive = 0;
+    ScratchArena<Small, Big> arena{};
+
+    auto& s = arena.acquire<Small>(1);
+    auto& b = arena.acquire<Big>();
+    EXPECT_EQ(alive, 1);
+    EXPECT_EQ(static_cast<void*>(&s), static_cast<void*>(&b));
+    EXPECT_EQ(b.data[15], 0.0);
+}
+
+TEST(ScratchArenaTest, DestructorReleases) {
+    alive = 0;
+    {
+        ScratchArena<Small> arena{};
+        arena.acquire<Small>(5);
+        EXPECT_EQ(alive, 1);
+    }
+    EXPECT_EQ(alive, 0);
+}
+
+TEST(ScratchArenaTest, Alignment) {
+    ScratchArena<Small, Aligned> arena{};
+    auto& a = arena.acquire<Aligned>();
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&a) % alignof(Aligned), 0u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include "lib/spsc_accumulator.hpp"
+
+namespace {
+void relax() { std::this_thread::yield(); }
+} // namespace
+
+TEST(SpscAccumulatorTest, InitialState) {
+    SpscAccumulator acc(800000);
+    const auto s = acc.snapshot(relax);
+    EXPECT_EQ(s.last, 800000u);
+    EXPECT_EQ(s.count, 0u);
+    EXPECT_EQ(s.sum, 0u);
+    EXPECT_EQ(acc.get_last(), 800000u);
+}
+
+TEST(SpscAccumulatorTest, RunningSumAndMean) {
+    SpscAccumulator acc{};
+    acc.push(10, 100);
+    const auto a = acc.snapshot(relax);
+    acc.push(20, 140);
+    acc.push(30, 180);
+    const auto b = acc.snapshot(relax);
+
+    EXPECT_EQ(b.last, 30u);
+    EXPECT_EQ(b.count, 3u);
+    EXPECT_EQ(b.sum, 60u);
+    EXPECT_EQ(b.timestamp_ms, 180u);
+
+    uint32_t mean = 0;
+    ASSERT_TRUE(SpscAccumulator::mean(a, b, mean));
+    EXPECT_EQ(mean, 25u);
+    EXPECT_FALSE(SpscAccumulator::mean(b, b, mean));
+}
+
+TEST(SpscAccumulatorTest, SumCarriesOver32Bits) {
+    SpscAccumulator acc{};
+    for (int i = 0; i < 3; i++) { acc.push(0xF0000000u, 0); }
+    EXPECT_EQ(acc.snapshot(relax).sum, 3ull * 0xF0000000u);
+}
+
+// Producer thread emulates ADC task, pushes value == sequence number, so every
+// consistent snapshot satisfies exact invariants.
+TEST(SpscAccumulatorTest, StressConcurrentReader) {
+    constexpr uint32_t TOTAL = 2'000'000;
+    SpscAccumulator acc{};
+    std::atomic<bool> done{false};
+
+    std::thread producer([&] {
+        for (uint32_t i = 1; i <= TOTAL; i++) { acc.push(i, i * 3); }
+        done.store(true);
+    });
+
+    uint32_t snapshots = 0;
+    uint32_t torn = 0;
+    uint32_t prev_count = 0;
+    bool monotonic = true;
+    auto prev = acc.snapshot(relax);
+
+    // At least one pass, producer may finish before reader starts
+    do {
+        const auto s = acc.snapshot(relax);
+        snapshots++;
+
+        const uint64_t n = s.count;
+        if (s.sum != n * (n + 1) / 2 || (n && (s.last != n || s.timestamp_ms != n * 3))) { torn++; }
+        if (s.count < prev_count) { monotonic = false; }
+        prev_count = s.count;
+
+        // Mean of interval is exact for consecutive integers
+        uint32_t mean = 0;
+        if (SpscAccumulator::mean(prev, s, mean)) {
+            const uint64_t expected = (static_cast<uint64_t>(prev.count) + 1 + s.count) / 2;
+            if (mean != expected) { torn++; }
+        }
+        prev = s;
+    } while (!done.load());
+    producer.join();
+
+    EXPECT_EQ(torn, 0u);
+    EXPECT_TRUE(monotonic);
+    EXPECT_GT(snapshots, 0u);
+    EXPECT_EQ(acc.snapshot(relax).count, TOTAL);
+    printf("Snapshots taken during stress: %u\n", snapshots);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <math.h>
+#include "lib/tcr_calibration.hpp"
+
+// Head settles exponentially to ambient + K * power. Resistance follows
+// linear TCR, reading is uncalibrated but monotonic.
+struct Plant {
+    static constexpr float TAU = 100.0f;
+    static constexpr float K = 6.0f;     // °C/W
+    static constexpr float AMBIENT = 25.0f;
+    float temperature{AMBIENT};
+
+    void step(float dt, float power) {
+        temperature += dt * (AMBIENT + K * power - temperature) / TAU;
+    }
+    auto mohms() const -> float { return 3000.0f * (1 + 0.0039f * (temperature - AMBIENT)); }
+    auto reading_x10() const -> int32_t { return static_cast<int32_t>(temperature * 10); }
+};
+
+// Runs until plateau, returns time spent, ms
+static auto settle(TcrCalibration& cal, Plant& plant, uint32_t& now_ms) -> uint32_t {
+    const uint32_t started = now_ms;
+    while (now_ms - started < 3'600'000) {
+        plant.step(1.0f, cal.get_power());
+        now_ms += 1000;
+        if (cal.update(now_ms, plant.reading_x10(), plant.mohms())) { break; }
+    }
+    return now_ms - started;
+}
+
+TEST(TcrCalibrationTest, RejectsBadParams) {
+    TcrCalibration cal{};
+    EXPECT_FALSE(cal.start(0.0f, 4));
+    EXPECT_FALSE(cal.start(30.0f, 1));
+    EXPECT_FALSE(cal.start(30.0f, TcrCalibration::MAX_POINTS + 1));
+    EXPECT_EQ(cal.get_phase(), TcrCalibration::Phase::Inactive);
+}
+
+TEST(TcrCalibrationTest, SweepCollectsPlateaus) {
+    TcrCalibration cal{};
+    Plant plant{};
+    uint32_t now_ms = 0;
+
+    ASSERT_TRUE(cal.start(30.0f, 3));
+
+    for (uint32_t i = 0; i < 3; i++) {
+        EXPECT_EQ(cal.get_phase(), TcrCalibration::Phase::Settling);
+        EXPECT_FLOAT_EQ(cal.get_power(), 10.0f * static_cast<float>(i + 1));
+
+        // Reference is not accepted before plateau
+        EXPECT_FALSE(cal.add_reference(plant.temperature));
+
+        const auto t = settle(cal, plant, now_ms);
+        ASSERT_EQ(cal.get_phase(), TcrCalibration::Phase::Ready);
+        // Not earlier than ~6τ (0.01 °C/s of 60 °C rise), not too late
+        EXPECT_GT(t, 400'000u);
+        EXPECT_LT(t, 1'200'000u);
+
+        // Residual drift is rate * τ, ~1°C. Not a problem, because reference
+        // and resistance are taken at the same time.
+        const float expected = Plant::AMBIENT + Plant::K * cal.get_power();
+        EXPECT_NEAR(plant.temperature, expected, 1.5f);
+
+        // Keeps tracking while waiting for reference
+        for (int j = 0; j < 60; j++) {
+            plant.step(1.0f, cal.get_power());
+            now_ms += 1000;
+            cal.update(now_ms, plant.reading_x10(), plant.mohms());
+        }
+        EXPECT_EQ(cal.get_phase(), TcrCalibration::Phase::Ready);
+
+        // External thermometer reading
+        ASSERT_TRUE(cal.add_reference(plant.temperature));
+        EXPECT_EQ(cal.get_step(), i + 1);
+    }
+
+    EXPECT_EQ(cal.get_phase(), TcrCalibration::Phase::Done);
+
+    const auto& points = cal.get_points();
+    ASSERT_EQ(points.size(), 3u);
+    for (const auto& p : points) {
+        EXPECT_NEAR(p.value, 3000.0f * (1 + 0.0039f * (p.at - Plant::AMBIENT)), 3.0f);
+    }
+    EXPECT_LT(points[0].value, points[1].value);
+    EXPECT_LT(points[1].value, points[2].value);
+}
+
+TEST(TcrCalibrationTest, RestartResets) {
+    TcrCalibration cal{};
+    Plant plant{};
+    uint32_t now_ms = 0;
+
+    ASSERT_TRUE(cal.start(20.0f, 2));
+    settle(cal, plant, now_ms);
+    ASSERT_TRUE(cal.add_reference(plant.temperature));
+
+    ASSERT_TRUE(cal.start(20.0f, 2));
+    EXPECT_EQ(cal.get_step(), 0u);
+    EXPECT_EQ(cal.get_rate_x100(), INT32_MIN);
+    EXPECT_FLOAT_EQ(cal.get_power(), 10.0f);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
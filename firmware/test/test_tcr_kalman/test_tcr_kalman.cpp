@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <functional>
+#include <random>
+#include "lib/tcr_kalman.hpp"
+
+TEST(TcrKalmanTest, FirstMeasurementInitializes) {
+    TcrKalman kf{};
+    kf.set_params(0.05f, 60);
+    EXPECT_FALSE(kf.is_valid());
+
+    // Prediction before init is ignored
+    kf.predict(50, 10000);
+    EXPECT_FALSE(kf.is_valid());
+
+    kf.update(1234, 8);
+    EXPECT_TRUE(kf.is_valid());
+    EXPECT_EQ(kf.get_temperature_x10(), 1234);
+    EXPECT_EQ(kf.get_variance_x100(), TcrKalman::MEASUREMENT_VARIANCE_X100);
+
+    // Fewer samples => proportionally bigger variance
+    kf.reset();
+    kf.update(1234, 2);
+    EXPECT_EQ(kf.get_variance_x100(), TcrKalman::MEASUREMENT_VARIANCE_X100 * 4);
+}
+
+TEST(TcrKalmanTest, ConvergesOnConstantTemperature) {
+    TcrKalman kf{};
+    kf.set_params(0.0f, 0);  // No model, random walk only
+    kf.update(1000, 8);
+    for (int i = 0; i < 50; i++) {
+        kf.predict(100, 0);
+        kf.update(1010, 8);
+    }
+    EXPECT_NEAR(kf.get_temperature_x10(), 1010, 1);
+    // Steady state variance is below single measurement variance
+    EXPECT_LT(kf.get_variance_x100(), TcrKalman::MEASUREMENT_VARIANCE_X100);
+}
+
+TEST(TcrKalmanTest, ModelPredictsHeatingAndCooling) {
+    TcrKalman kf{};
+    kf.set_params(0.05f, 60);
+    kf.update(250, 8);
+
+    // 20 W for 1 s => +1 °C, no loss at ambient
+    for (int i = 0; i < 20; i++) { kf.predict(50, 20000); }
+    EXPECT_NEAR(kf.get_temperature_x10(), 260, 1);
+
+    // 200 °C above ambient, loses 1/60 of it per second
+    kf.reset();
+    kf.update(2250, 8);
+    kf.predict(1000, 0);
+    EXPECT_NEAR(kf.get_temperature_x10(), 2250 - 33, 1);
+}
+
+TEST(TcrKalmanTest, VarianceGrowsWithoutMeasurements) {
+    TcrKalman kf{};
+    kf.set_params(0.0f, 0);
+    kf.update(1000, 8);
+
+    uint32_t prev = kf.get_variance_x100();
+    for (int i = 0; i < 10; i++) {
+        kf.predict(1000, 0);
+        EXPECT_GT(kf.get_variance_x100(), prev);
+        prev = kf.get_variance_x100();
+    }
+    for (int i = 0; i < 1000; i++) { kf.predict(1000, 0); }
+    EXPECT_EQ(kf.get_variance_x100(), TcrKalman::MAX_VARIANCE_X100);
+}
+
+TEST(TcrKalmanTest, OutlierRestartsFromMeasurement) {
+    TcrKalman kf{};
+    kf.set_params(0.05f, 60);
+    kf.update(250, 8);
+    kf.predict(50, 0);
+    kf.update(2000, 8);
+    EXPECT_EQ(kf.get_temperature_x10(), 2000);
+}
+
+// First order plant, driven by 10 Hz PWM with INA sampling like DrainTracker:
+// samples start after stabilization ticks and are averaged (up to 8) at pulse
+// end. Filter model params are deliberately off vs the plant.
+namespace {
+
+struct SimResult {
+    double raw_rms;
+    double kf_rms;
+    double raw_lag_ms;
+    double kf_lag_ms;
+};
+
+auto simulate(const std::function<double(double)>& duty_at, double duration_s) -> SimResult {
+    constexpr double PLANT_B0 = 0.055;    // °C/s per W
+    constexpr double PLANT_TAU = 70;      // s
+    constexpr double PLANT_AMBIENT = 22;
+    constexpr double MAX_POWER_W = 80;
+    constexpr double SAMPLE_NOISE_C = 2.0;
+    constexpr uint32_t PERIOD_MS = 100;
+    constexpr uint32_t STABILIZATION_MS = 4;
+    constexpr uint32_t MIN_PULSE_MS = 6;
+    constexpr uint32_t TICK_MS = 50;
+
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0, SAMPLE_NOISE_C);
+
+    TcrKalman kf{};
+    kf.set_params(0.05f, 60);
+
+    double t_true = 25;
+    double raw = 0;
+    bool raw_valid = false;
+    bool fresh = false;
+    uint32_t fresh_samples = 0;
+
+    double pulse_buf[TcrKalman::MEASUREMENT_FULL_SAMPLES]{};
+    uint32_t pulse_samples = 0;
+    uint32_t pulse_ms = 0;
+    double duty = 0;
+
+    double raw_err = 0, raw_err_sq = 0, kf_err = 0, kf_err_sq = 0;
+    double slope_sum = 0;
+    uint32_t count = 0;
+    double prev_true = t_true;
+
+    const auto total_ms = static_cast<uint32_t>(duration_s * 1000);
+    for (uint32_t ms = 0; ms < total_ms; ms++) {
+        const double t = ms / 1000.0;
+        const uint32_t phase = ms % PERIOD_MS;
+
+        if (phase == 0) {
+            duty = duty_at(t);
+            pulse_ms = std::max(MIN_PULSE_MS, static_cast<uint32_t>(std::lround(duty * PERIOD_MS)));
+            pulse_samples = 0;
+        }
+
+        const bool on = phase < pulse_ms;
+        const double power = on ? MAX_POWER_W : 0;
+        t_true += (PLANT_B0 * power - (t_true - PLANT_AMBIENT) / PLANT_TAU) / 1000;
+
+        if (on && phase >= STABILIZATION_MS) {
+            pulse_buf[pulse_samples++ % TcrKalman::MEASUREMENT_FULL_SAMPLES] = t_true + noise(rng);
+        }
+        if (phase == pulse_ms - 1) {
+            // INA filter keeps up to 8 last samples
+            fresh_samples = std::min(pulse_samples, TcrKalman::MEASUREMENT_FULL_SAMPLES);
+            raw = 0;
+            for (uint32_t i = 0; i < fresh_samples; i++) { raw += pulse_buf[i]; }
+            raw /= fresh_samples;
+            raw_valid = true;
+            fresh = true;
+        }
+
+        if (ms % TICK_MS != TICK_MS - 1) { continue; }
+
+        // Control tick, same order as firmware: predict, then fuse new data
+        const double avg_power_mw = MAX_POWER_W * 1000 * pulse_ms / PERIOD_MS;
+        kf.predict(TICK_MS, static_cast<uint32_t>(avg_power_mw));
+        if (fresh) {
+            kf.update(static_cast<int32_t>(std::lround(raw * 10)), fresh_samples);
+            fresh = false;
+        }
+        if (!raw_valid || t < 5) {
+            prev_true = t_true;
+            continue;
+        }
+
+        const double e_raw = t_true - raw;
+        const double e_kf = t_true - kf.get_temperature_x10() / 10.0;
+        raw_err += e_raw;
+        raw_err_sq += e_raw * e_raw;
+        kf_err += e_kf;
+        kf_err_sq += e_kf * e_kf;
+        slope_sum += (t_true - prev_true) * 1000 / TICK_MS;
+        prev_true = t_true;
+        count++;
+    }
+
+    const double slope = slope_sum / count;
+    return {
+        .raw_rms = std::sqrt(raw_err_sq / count),
+        .kf_rms = std::sqrt(kf_err_sq / count),
+        .raw_lag_ms = slope != 0 ? raw_err / count / slope * 1000 : 0,
+        .kf_lag_ms = slope != 0 ? kf_err / count / slope * 1000 : 0
+    };
+}
+
+} // namespace
+
+TEST(TcrKalmanTest, SimLowDutyHold) {
+    // Idle-like short pulses: 2 INA samples per measurement
+    const auto r = simulate([](double) { return 0.0; }, 60);
+    printf("Low duty:  raw RMS %.3f °C, filtered RMS %.3f °C\n", r.raw_rms, r.kf_rms);
+    EXPECT_LT(r.kf_rms, r.raw_rms * 0.5);
+}
+
+TEST(TcrKalmanTest, SimHeatingRamp) {
+    const auto r = simulate([](double) { return 0.6; }, 60);
+    printf("Heating:   raw RMS %.3f °C (lag %.0f ms), filtered RMS %.3f °C (lag %.0f ms)\n",
+        r.raw_rms, r.raw_lag_ms, r.kf_rms, r.kf_lag_ms);
+    EXPECT_LT(r.kf_rms, r.raw_rms * 0.75);
+    EXPECT_LT(std::abs(r.kf_lag_ms), std::abs(r.raw_lag_ms));
+}
+
+TEST(TcrKalmanTest, SimDutySteps) {
+    const auto r = simulate([](double t) {
+        if (t < 40) { return 0.8; }
+        if (t < 80) { return 0.0; }
+        return 0.3;
+    }, 120);
+    printf("Steps:     raw RMS %.3f °C, filtered RMS %.3f °C\n", r.raw_rms, r.kf_rms);
+    EXPECT_LT(r.kf_rms, r.raw_rms * 0.75);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
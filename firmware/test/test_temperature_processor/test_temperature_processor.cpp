@@ -212,6 +212,53 @@ TEST(TemperatureProcessorTest, TCR_TwoPointCalibration) {
     EXPECT_GT(result_4500_after, result_4500_before);
 }
 
+TEST(TemperatureProcessorTest, TCR_MultiPointCalibration) {
+    TemperatureProcessor proc;
+    proc.set_sensor_type(SensorType_TCR);
+    proc.set_cal_points(50.0f, 3000.0f, 250.0f, 4800.0f);
+
+    // Slightly nonlinear heater, unsorted input
+    const float at[] = { 150.0f, 50.0f, 250.0f, 100.0f };
+    const float value[] = { 3950.0f, 3000.0f, 4800.0f, 3480.0f };
+    proc.set_tcr_points(at, value, 4);
+
+    // Exact at every point
+    for (size_t i = 0; i < 4; i++) {
+        EXPECT_NEAR(proc.get_temperature_x10(static_cast<uint32_t>(value[i])), static_cast<int32_t>(at[i] * 10), 1);
+    }
+
+    // Interpolation inside segment 150..250
+    EXPECT_NEAR(proc.get_temperature_x10(4375), 200 * 10, 2);
+    // 2-point line would give (4375-3000)/9 + 50 = 202.8°C
+    EXPECT_GT(std::abs(proc.get_temperature_x10(4375) - 2028), 20);
+
+    // Extrapolation with edge segments slopes
+    EXPECT_NEAR(proc.get_temperature_x10(2520), 0, 2);
+    EXPECT_NEAR(proc.get_temperature_x10(5650), 350 * 10, 2);
+}
+
+TEST(TemperatureProcessorTest, TCR_MultiPointInvalidFallsBack) {
+    TemperatureProcessor proc;
+    proc.set_sensor_type(SensorType_TCR);
+    proc.set_cal_points(50.0f, 3000.0f, 200.0f, 4500.0f);
+
+    // Non-monotonic: resistance grows while temperature drops
+    const float at[] = { 50.0f, 150.0f, 100.0f };
+    const float value[] = { 3000.0f, 3500.0f, 4000.0f };
+    proc.set_tcr_points(at, value, 3);
+    EXPECT_NEAR(proc.get_temperature_x10(3750), 125 * 10, 10);
+
+    // Single valid pair (others unset) is not enough
+    const float at1[] = { 80.0f, 0.0f };
+    const float value1[] = { 3300.0f, 0.0f };
+    proc.set_tcr_points(at1, value1, 2);
+    EXPECT_NEAR(proc.get_temperature_x10(3750), 125 * 10, 10);
+
+    // Clearing multi-point data restores 2-point model
+    proc.set_tcr_points(nullptr, nullptr, 0);
+    EXPECT_NEAR(proc.get_temperature_x10(4500), 200 * 10, 5);
+}
+
 //=============================================================================
 // Division by Zero Protection Tests
 //=============================================================================
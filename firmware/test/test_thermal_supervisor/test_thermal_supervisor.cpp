@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include "lib/thermal_supervisor.hpp"
+
+using Fault = ThermalSupervisor::Fault;
+
+// Reflow-like run: head with sensor lag, P controller with feed-forward,
+// fan cooling at the end. Faults are injected at `fault_at_s`.
+namespace {
+
+enum class Inject : uint8_t {
+    None,
+    OpenHeater,      // Heater wire broken: no current, no heat
+    ResistanceJump,  // Bad contact: +40% resistance
+    FrozenReading,   // ADC value stuck, timestamps go on
+    StaleReading,    // Measurements stop
+    SensorDetached,  // Sensor loses thermal contact, cools to ambient
+    SensorDrift      // Reading creeps up by itself
+};
+
+struct Plant {
+    double b0 = 0.055;  // °C/s per W
+    double tau = 70;    // s
+    double sensor_tau = 1.0;
+    double ambient = 22;
+};
+
+struct Model {
+    float b0 = 0.05f;
+    float tau = 60;
+};
+
+struct SimResult {
+    Fault fault;
+    double latency_s;  // From injection to trip, negative if tripped before
+};
+
+auto simulate(Inject inject, double fault_at_s, const Plant& plant = {}, const Model& model = {},
+              double duration_s = 400) -> SimResult {
+    constexpr uint32_t TICK_MS = 50;
+    constexpr double MAX_POWER_W = 80;
+    constexpr double R20_MOHM = 2000;
+    constexpr double ALPHA = 0.0039;
+    constexpr double RAMP_RATE = 1.5;
+    constexpr double PEAK = 230;
+    constexpr double HOLD_S = 60;
+
+    std::mt19937 rng(11);
+    std::normal_distribution<double> t_noise(0, 0.15);
+    std::normal_distribution<double> r_noise(0, 0.003);
+
+    ThermalSupervisor sv{};
+    sv.set_params(model.b0, model.tau);
+    sv.reset();
+
+    double core = 25;
+    double sensor = 25;
+    double drift = 0;
+    double power = 0;
+    int32_t frozen_x10 = 0;
+    uint32_t last_ts = 0;
+    uint32_t last_r = 0;
+
+    const double ramp_end = (PEAK - 25) / RAMP_RATE;
+    const auto total_ms = static_cast<uint32_t>(duration_s * 1000);
+
+    for (uint32_t ms = TICK_MS; ms <= total_ms; ms += TICK_MS) {
+        const double t = ms / 1000.0;
+        const double dt = TICK_MS / 1000.0;
+        const bool faulty = inject != Inject::None && t >= fault_at_s;
+
+        double setpoint = 25;
+        if (t < ramp_end) { setpoint = 25 + RAMP_RATE * t; }
+        else if (t < ramp_end + HOLD_S) { setpoint = PEAK; }
+        const bool cooling = t >= ramp_end + HOLD_S;
+
+        // Plant, with power from the previous tick
+        const bool open = faulty && inject == Inject::OpenHeater;
+        const double delivered = open ? 0 : power;
+        const double loss_k = cooling ? 2.0 / plant.tau : 1.0 / plant.tau;  // Fan doubles losses
+        core += (plant.b0 * delivered - (core - plant.ambient) * loss_k) * dt;
+
+        const double sensor_target = faulty && inject == Inject::SensorDetached ? plant.ambient : core;
+        const double sensor_tau = faulty && inject == Inject::SensorDetached ? 30 : plant.sensor_tau;
+        sensor += (sensor_target - sensor) * dt / sensor_tau;
+        if (faulty && inject == Inject::SensorDrift) { drift += 3.0 * dt; }
+
+        // Measurements
+        auto t_x10 = static_cast<int32_t>(std::lround((sensor + drift + t_noise(rng)) * 10));
+        if (faulty && inject == Inject::FrozenReading) {
+            if (!frozen_x10) { frozen_x10 = t_x10; }
+            t_x10 = frozen_x10;
+        }
+        if (!(faulty && inject == Inject::StaleReading)) { last_ts = ms - 40; }
+
+        // Resistance comes once per 100 ms PWM period
+        if (ms % 100 == 0) {
+            double r = R20_MOHM * (1 + ALPHA * (core - 20)) * (1 + r_noise(rng));
+            if (faulty && inject == Inject::ResistanceJump) { r *= 1.4; }
+            last_r = open ? 0 : static_cast<uint32_t>(r);
+        }
+
+        const auto fault = sv.update({
+            .now_ms = ms,
+            .dt_ms = TICK_MS,
+            .temperature_x10 = t_x10,
+            .temperature_ts_ms = last_ts,
+            .power_mw = static_cast<uint32_t>(delivered * 1000),
+            .resistance_mohm = last_r
+        });
+        if (fault != Fault::None) { return { fault, t - fault_at_s }; }
+
+        // Controller
+        const double measured = t_x10 / 10.0;
+        const double ff = (setpoint - plant.ambient) / (model.b0 * model.tau) + (t < ramp_end ? RAMP_RATE / model.b0 : 0);
+        power = cooling ? 0 : std::clamp(10 * (setpoint - measured) + ff, 0.0, MAX_POWER_W);
+    }
+    return { Fault::None, 0 };
+}
+
+void expect_trip(const char* name, Inject inject, double at_s, Fault expected, double max_latency_s) {
+    const auto r = simulate(inject, at_s);
+    printf("%-16s at %3.0f s: %-26s in %.2f s\n", name, at_s,
+        ThermalSupervisor::get_fault_name(r.fault), r.latency_s);
+    EXPECT_EQ(r.fault, expected) << name;
+    EXPECT_GE(r.latency_s, 0) << name;
+    EXPECT_LE(r.latency_s, max_latency_s) << name;
+}
+
+} // namespace
+
+TEST(ThermalSupervisorTest, NoFalseTrips) {
+    // Model params deliberately off vs plant, both ways
+    const Model models[] = { {0.05f, 60}, {0.066f, 84}, {0.044f, 56}, {0.06f, 60}, {0.05f, 80} };
+    for (const auto& m : models) {
+        const auto r = simulate(Inject::None, 0, {}, m);
+        EXPECT_EQ(r.fault, Fault::None) << "b0 " << m.b0 << ", tau " << m.tau << ": "
+            << ThermalSupervisor::get_fault_name(r.fault) << " at " << r.latency_s << " s";
+    }
+    // Slow sensor, colder room
+    Plant slow{};
+    slow.sensor_tau = 2.5;
+    slow.ambient = 15;
+    EXPECT_EQ(simulate(Inject::None, 0, slow).fault, Fault::None);
+}
+
+TEST(ThermalSupervisorTest, NoModelOnlyElectricalChecks) {
+    ThermalSupervisor sv{};
+    sv.set_params(0, 0);
+    sv.reset();
+    EXPECT_FALSE(sv.has_model());
+
+    // Temperature flies up at full power, no model => no opinion
+    for (uint32_t i = 1; i < 200; i++) {
+        const auto f = sv.update({ i * 50, 50, static_cast<int32_t>(250 + i * 10), i * 50, 80000, 2000 });
+        EXPECT_EQ(f, Fault::None);
+    }
+    // Stale reading is still detected
+    Fault f = Fault::None;
+    for (uint32_t i = 200; i < 250 && f == Fault::None; i++) {
+        f = sv.update({ i * 50, 50, 2250, 199 * 50, 0, 2000 });
+    }
+    EXPECT_EQ(f, Fault::StuckReading);
+}
+
+TEST(ThermalSupervisorTest, FaultLatchedUntilReset) {
+    ThermalSupervisor sv{};
+    sv.set_params(0.05f, 60);
+    sv.reset();
+    for (uint32_t i = 1; i <= 20; i++) { sv.update({ i * 50, 50, 250, i * 50, 0, 0 }); }
+    EXPECT_EQ(sv.get_fault(), Fault::OpenHeater);
+    // Good data doesn't clear it
+    EXPECT_EQ(sv.update({ 1050, 50, 250, 1050, 0, 2000 }), Fault::OpenHeater);
+    sv.reset();
+    EXPECT_EQ(sv.update({ 1100, 50, 250, 1100, 0, 2000 }), Fault::None);
+}
+
+TEST(ThermalSupervisorTest, DetectionLatency) {
+    // Heating ramp ends at ~137 s, hold until ~197 s
+    expect_trip("open heater", Inject::OpenHeater, 60, Fault::OpenHeater, 0.6);
+    expect_trip("resistance jump", Inject::ResistanceJump, 60, Fault::ResistanceJump, 0.4);
+    expect_trip("stale reading", Inject::StaleReading, 60, Fault::StuckReading, 1.1);
+    expect_trip("frozen (ramp)", Inject::FrozenReading, 60, Fault::StuckReading, 5);
+    expect_trip("frozen (cool)", Inject::FrozenReading, 210, Fault::StuckReading, 6);
+    expect_trip("detached (ramp)", Inject::SensorDetached, 60, Fault::NoHeating, 6);
+    expect_trip("detached (hold)", Inject::SensorDetached, 160, Fault::NoHeating, 8);
+    expect_trip("drift (hold)", Inject::SensorDrift, 160, Fault::HeatingWithoutPower, 5);
+    // Fan cooling is not modelled and hides part of the drift
+    expect_trip("drift (cool)", Inject::SensorDrift, 210, Fault::HeatingWithoutPower, 10);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
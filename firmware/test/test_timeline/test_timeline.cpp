@@ -0,0 +1,341 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "lib/timeline.hpp"
+
+static Profile make_profile(std::initializer_list<Segment> segments) {
+    Profile p = Profile_init_zero;
+    for (const auto& s : segments) { p.segments[p.segments_count++] = s; }
+    return p;
+}
+
+// Previous implementation (linear scan, float rates), to check equivalence.
+// Interpolation product is widened to 64 bits, to avoid overflow on long
+// segments.
+class ScanTimeline {
+public:
+    struct Point { int32_t time_x1000; int32_t value_x100; };
+
+    std::vector<Point> points{};
+    std::vector<float> rates{};
+
+    void load(const Profile& profile) {
+        points.clear();
+        rates.clear();
+        points.push_back({0, SharedConstants::START_TEMPERATURE * 100});
+
+        for (size_t i = 0; i < profile.segments_count; ++i) {
+            const auto& segment = profile.segments[i];
+            points.push_back({points[i].time_x1000 + segment.duration * 1000, segment.target * 100});
+        }
+
+        for (size_t i = 1; i < points.size(); ++i) {
+            float delta_time = static_cast<float>(points[i].time_x1000 - points[i - 1].time_x1000) / 1000;
+            float delta_value = static_cast<float>(points[i].value_x100 - points[i - 1].value_x100) / 100;
+            float rate = 0.0f;
+
+            if (delta_time > 0.001f) { rate = delta_value / delta_time; }
+            else if (delta_value > 0.0f) { rate = 100.0f; }
+            else if (delta_value < 0.0f) { rate = -100.0f; }
+
+            rates.push_back(etl::clamp(rate, -100.0f, 100.0f));
+        }
+    }
+
+    auto get_target(int32_t offset_x1000) const -> float {
+        if (offset_x1000 < 0) { return 0; }
+
+        for (size_t i = 1; i < points.size(); ++i) {
+            const auto& p0 = points[i - 1];
+            const auto& p1 = points[i];
+
+            if (p0.time_x1000 <= offset_x1000 && p1.time_x1000 >= offset_x1000) {
+                int32_t dt = p1.time_x1000 - p0.time_x1000;
+                if (dt <= 0) { return static_cast<float>(p1.value_x100) * 0.01f; }
+                int32_t y = p0.value_x100 + static_cast<int32_t>(
+                    static_cast<int64_t>(p1.value_x100 - p0.value_x100) * (offset_x1000 - p0.time_x1000) / dt);
+                return static_cast<float>(y) * 0.01f;
+            }
+        }
+        return 0;
+    }
+
+    auto get_rate(int32_t offset_x1000) const -> float {
+        if (offset_x1000 < 0) { return 0; }
+
+        for (size_t i = 1; i < points.size(); ++i) {
+            if (points[i].time_x1000 >= offset_x1000) { return rates[i - 1]; }
+        }
+        return 0;
+    }
+};
+
+TEST(TimelineTest, Empty) {
+    Timeline t;
+    t.load(make_profile({}));
+    EXPECT_EQ(t.get_max_time_x1000(), 0);
+    EXPECT_EQ(t.get_target_x100(0), 0);
+    EXPECT_EQ(t.get_rate_x100(0), 0);
+}
+
+TEST(TimelineTest, Interpolation) {
+    Timeline t;
+    // Start is at 30C
+    t.load(make_profile({{150, 60}, {180, 60}, {245, 40}}));
+
+    EXPECT_EQ(t.get_max_time_x1000(), 160'000);
+
+    EXPECT_EQ(t.get_target_x100(0), 3000);
+    EXPECT_EQ(t.get_target_x100(30'000), 9000);
+    EXPECT_EQ(t.get_target_x100(60'000), 15000);
+    EXPECT_EQ(t.get_target_x100(90'000), 16500);
+    EXPECT_EQ(t.get_target_x100(160'000), 24500);
+
+    EXPECT_EQ(t.get_rate_x100(10'000), 200);
+    EXPECT_EQ(t.get_rate_x100(100'000), 50);
+    EXPECT_EQ(t.get_rate_x100(150'000), 163);
+}
+
+TEST(TimelineTest, OutOfRange) {
+    Timeline t;
+    t.load(make_profile({{150, 60}}));
+
+    EXPECT_EQ(t.get_target_x100(-1), 0);
+    EXPECT_EQ(t.get_rate_x100(-1), 0);
+    EXPECT_EQ(t.get_target_x100(60'001), 0);
+    EXPECT_EQ(t.get_rate_x100(60'001), 0);
+}
+
+TEST(TimelineTest, ZeroDurationStep) {
+    Timeline t;
+    t.load(make_profile({{100, 10}, {200, 0}, {200, 10}}));
+
+    EXPECT_EQ(t.get_segments()[1].kind, Timeline::SegmentKind::Step);
+
+    EXPECT_EQ(t.get_target_x100(10'000), 10000);
+    EXPECT_EQ(t.get_rate_x100(10'000), 700);
+    EXPECT_EQ(t.get_rate_x100(10'001), 0);
+    EXPECT_EQ(t.get_target_x100(15'000), 20000);
+}
+
+TEST(TimelineTest, StepAtStart) {
+    Timeline t;
+    t.load(make_profile({{100, 0}, {100, 10}}));
+
+    EXPECT_EQ(t.get_target_x100(0), 10000);
+    EXPECT_EQ(t.get_rate_x100(0), Timeline::RATE_MAX_X100);
+}
+
+TEST(TimelineTest, RateClamp) {
+    Timeline t;
+    t.load(make_profile({{300, 1}, {100, 1}}));
+
+    EXPECT_EQ(t.get_rate_x100(500), Timeline::RATE_MAX_X100);
+    EXPECT_EQ(t.get_rate_x100(1500), -Timeline::RATE_MAX_X100);
+}
+
+TEST(TimelineTest, CursorRewind) {
+    Timeline t;
+    t.load(make_profile({{150, 60}, {180, 60}, {245, 40}}));
+
+    EXPECT_EQ(t.get_target_x100(150'000), 22875);
+    EXPECT_EQ(t.get_target_x100(30'000), 9000);
+    EXPECT_EQ(t.get_target_x100(90'000), 16500);
+
+    // Reload resets cursor
+    t.load(make_profile({{100, 10}}));
+    EXPECT_EQ(t.get_target_x100(5'000), 6500);
+}
+
+TEST(TimelineTest, ShapedKeepsProfilePoints) {
+    const auto profile = make_profile({{150, 90}, {180, 90}, {245, 40}, {245, 20}, {100, 60}});
+    Timeline t;
+    t.load(profile, 150);  // 1.5 C/s²
+
+    EXPECT_EQ(t.get_max_time_x1000(), 300'000);
+
+    int32_t time = 0;
+    EXPECT_EQ(t.get_target_x100(0), 3000);
+    for (size_t i = 0; i < profile.segments_count; i++) {
+        time += profile.segments[i].duration * 1000;
+        EXPECT_NEAR(t.get_target_x100(time), profile.segments[i].target * 100, 1) << "point " << i;
+    }
+
+    // Starts from rest, peak plateau is flat
+    EXPECT_EQ(t.get_rate_x100(0), 0);
+    EXPECT_EQ(t.get_rate_x100(220'000), 0);
+    EXPECT_NEAR(t.get_target_x100(230'000), 24500, 1);
+}
+
+TEST(TimelineTest, ShapedIsSmoothAndBounded) {
+    const auto profile = make_profile({{150, 90}, {180, 90}, {245, 40}, {100, 60}});
+    constexpr int32_t ACCEL_X100 = 150;
+
+    Timeline t;
+    t.load(profile, ACCEL_X100);
+
+    int32_t peak = 0;
+    int32_t prev_rate = t.get_rate_x100(0);
+    int32_t prev_target = t.get_target_x100(0);
+
+    for (int32_t ms = 50; ms <= t.get_max_time_x1000(); ms += 50) {
+        const int32_t rate = t.get_rate_x100(ms);
+        const int32_t target = t.get_target_x100(ms);
+
+        // Rate changes no faster than acceleration limit (+ rounding)
+        ASSERT_LE(std::abs(rate - prev_rate), ACCEL_X100 * 50 / 1000 + 2) << "ms " << ms;
+        // Target is continuous
+        ASSERT_LE(std::abs(target - prev_target), 10000 * 50 / 1000) << "ms " << ms;
+
+        peak = std::max(peak, target);
+        prev_rate = rate;
+        prev_target = target;
+    }
+
+    // Apex reached exactly, not exceeded
+    EXPECT_NEAR(peak, 24500, 1);
+    EXPECT_NEAR(t.get_target_x100(220'000), 24500, 1);
+}
+
+TEST(TimelineTest, ShapingDisabledOrInfeasible) {
+    const auto profile = make_profile({{150, 60}, {180, 60}, {245, 40}});
+
+    Timeline plain;
+    plain.load(profile);
+    Timeline zero;
+    zero.load(profile, 0);
+    EXPECT_EQ(zero.get_segments().size(), plain.get_segments().size());
+
+    // Tiny acceleration can't fit - falls back to linear segments, still
+    // passing through profile points.
+    Timeline slow;
+    slow.load(make_profile({{250, 2}, {30, 2}}), 1);
+    EXPECT_EQ(slow.get_target_x100(2'000), 25000);
+    EXPECT_EQ(slow.get_target_x100(4'000), 3000);
+}
+
+TEST(TimelineTest, ShapedRandomProfiles) {
+    std::mt19937 rng(777);
+    std::uniform_int_distribution<int32_t> target_dist(20, 300);
+    std::uniform_int_distribution<int32_t> duration_dist(0, 300);
+
+    for (int iter = 0; iter < 200; iter++) {
+        Profile p = Profile_init_zero;
+        p.segments_count = SharedConstants::MAX_REFLOW_SEGMENTS;
+        int32_t top = SharedConstants::START_TEMPERATURE;
+        for (size_t i = 0; i < p.segments_count; i++) {
+            p.segments[i] = {target_dist(rng), duration_dist(rng)};
+            top = std::max(top, p.segments[i].target);
+        }
+
+        Timeline t;
+        t.load(p, 100);
+        ScanTimeline ref;
+        ref.load(p);
+
+        int32_t time = 0;
+        for (size_t i = 0; i < p.segments_count; i++) {
+            time += p.segments[i].duration * 1000;
+            ASSERT_NEAR(t.get_target_x100(time) * 0.01f, ref.get_target(time), 0.0101f) << "iter " << iter;
+        }
+        ASSERT_EQ(t.get_max_time_x1000(), time);
+
+        for (int32_t ms = 0; ms <= time; ms += 50) {
+            ASSERT_LE(t.get_target_x100(ms), top * 100 + 1) << "iter " << iter << ", ms " << ms;
+        }
+    }
+}
+
+static auto random_profile(std::mt19937& rng) -> Profile {
+    std::uniform_int_distribution<int32_t> count_dist(0, SharedConstants::MAX_REFLOW_SEGMENTS);
+    std::uniform_int_distribution<int32_t> target_dist(0, 300);
+    std::uniform_int_distribution<int32_t> duration_dist(0, 600);
+    std::uniform_int_distribution<int32_t> zero_dist(0, 9);
+
+    Profile p = Profile_init_zero;
+    p.segments_count = static_cast<pb_size_t>(count_dist(rng));
+    for (size_t i = 0; i < p.segments_count; i++) {
+        p.segments[i].target = target_dist(rng);
+        p.segments[i].duration = zero_dist(rng) == 0 ? 0 : duration_dist(rng);
+    }
+    return p;
+}
+
+TEST(TimelineTest, EquivalentToScan) {
+    std::mt19937 rng(12345);
+
+    for (int iter = 0; iter < 300; iter++) {
+        const auto profile = random_profile(rng);
+
+        ScanTimeline ref;
+        ref.load(profile);
+        Timeline t;
+        t.load(profile);
+
+        const int32_t max_time = t.get_max_time_x1000();
+
+        // Reflow-like monotonic walk, with 50 ms tick, plus edges
+        for (int32_t ms = -100; ms <= max_time + 100; ms += 50) {
+            ASSERT_NEAR(t.get_target_x100(ms) * 0.01f, ref.get_target(ms), 0.0101f)
+                << "iter " << iter << ", ms " << ms;
+            ASSERT_NEAR(t.get_rate_x100(ms) * 0.01f, ref.get_rate(ms), 0.0051f)
+                << "iter " << iter << ", ms " << ms;
+        }
+
+        // Random access (cursor rewinds)
+        std::uniform_int_distribution<int32_t> ms_dist(-1000, max_time + 1000);
+        for (int i = 0; i < 200; i++) {
+            const int32_t ms = ms_dist(rng);
+            ASSERT_NEAR(t.get_target_x100(ms) * 0.01f, ref.get_target(ms), 0.0101f)
+                << "iter " << iter << ", ms " << ms;
+            ASSERT_NEAR(t.get_rate_x100(ms) * 0.01f, ref.get_rate(ms), 0.0051f)
+                << "iter " << iter << ", ms " << ms;
+        }
+    }
+}
+
+TEST(TimelineTest, Benchmark) {
+    // Full size profile, the worst case for scan
+    Profile profile = Profile_init_zero;
+    profile.segments_count = SharedConstants::MAX_REFLOW_SEGMENTS;
+    for (size_t i = 0; i < profile.segments_count; i++) {
+        profile.segments[i] = {static_cast<int32_t>(50 + i * 20), 60};
+    }
+
+    ScanTimeline ref;
+    ref.load(profile);
+    Timeline t;
+    t.load(profile);
+
+    const int32_t max_time = t.get_max_time_x1000();
+    constexpr int ROUNDS = 200;
+    volatile float sink_f = 0;
+    volatile int32_t sink_i = 0;
+
+    using clock = std::chrono::steady_clock;
+
+    auto start = clock::now();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int32_t ms = 0; ms <= max_time; ms += 50) { sink_f = ref.get_target(ms) + ref.get_rate(ms); }
+    }
+    const auto scan_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+
+    start = clock::now();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int32_t ms = 0; ms <= max_time; ms += 50) { sink_i = t.get_target_x100(ms) + t.get_rate_x100(ms); }
+    }
+    const auto cursor_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+
+    (void)sink_f;
+    (void)sink_i;
+
+    const auto ticks = static_cast<double>(ROUNDS) * (max_time / 50 + 1);
+    printf("Timeline per tick: scan %.1f ns, cursor %.1f ns\n",
+        static_cast<double>(scan_ns) / ticks, static_cast<double>(cursor_ns) / ticks);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "lib/ble_chunker.hpp"
+
+// C++ port of webapp/src/lib/ble/BleClientChunker.ts, keep in sync.
+//
+// Synchronous variant: IO calls block (in simulated time) until completed.
+class BleClientIO {
+public:
+    virtual ~BleClientIO() = default;
+    virtual void write(const std::vector<uint8_t>& chunk) = 0;
+    virtual auto read() -> std::vector<uint8_t> = 0;
+    virtual void sleep_ms(uint32_t ms) = 0;
+};
+
+class BleClientChunker {
+public:
+    enum class Status {
+        Ok,
+        SizeOverflow,   // 'Protocol error: size overflow'
+        NoData,         // 'Protocol error: received empty response twice'
+        BrokenResponse  // 'Protocol error: received empty response after first chunk'
+    };
+
+    static constexpr size_t MAX_BLOB_SIZE = 244;
+
+    explicit BleClientChunker(BleClientIO& io) : io(io) {}
+
+    static auto isNodata(const std::vector<uint8_t>& chunk) -> bool {
+        return chunk.size() < BleChunkHead::SIZE;
+    }
+
+    static auto isLastChunk(const std::vector<uint8_t>& chunk) -> bool {
+        return (BleChunkHead(chunk.data()).flags & BleChunkHead::FINAL_CHUNK_FLAG) != 0;
+    }
+
+    auto send(const std::vector<uint8_t>& data, std::vector<uint8_t>& response) -> Status {
+        while (true) {
+            const auto chunks = splitIntoChunks(data);
+
+            // Send all chunks
+            for (const auto& chunk : chunks) { io.write(chunk); }
+
+            // Read the first chunk of the response
+            auto responseChunk = io.read();
+
+            // If the response is empty, retry after 100ms
+            if (isNodata(responseChunk)) {
+                io.sleep_ms(100);
+                responseChunk = io.read();
+
+                if (isNodata(responseChunk)) { return Status::NoData; }
+            }
+
+            const BleChunkHead head(responseChunk.data());
+
+            if (head.flags & BleChunkHead::SIZE_OVERFLOW_FLAG) { return Status::SizeOverflow; }
+
+            if (head.flags & BleChunkHead::MISSED_CHUNKS_FLAG) {
+                // If missed chunks, retry the entire process
+                retries++;
+                continue;
+            }
+
+            response.clear();
+            response.insert(response.end(), responseChunk.begin() + BleChunkHead::SIZE, responseChunk.end());
+
+            while (!isLastChunk(responseChunk)) {
+                responseChunk = io.read();
+
+                // If server has response for us, next chunks can't be empty
+                if (isNodata(responseChunk)) { return Status::BrokenResponse; }
+
+                response.insert(response.end(), responseChunk.begin() + BleChunkHead::SIZE, responseChunk.end());
+            }
+
+            return Status::Ok;
+        }
+    }
+
+    uint32_t retries{0};
+
+private:
+    BleClientIO& io;
+    uint8_t messageIdCounter{0};
+
+    auto splitIntoChunks(const std::vector<uint8_t>& message) -> std::vector<std::vector<uint8_t>> {
+        std::vector<std::vector<uint8_t>> chunks;
+        const size_t totalSize = message.size();
+        const size_t chunkSize = MAX_BLOB_SIZE - BleChunkHead::SIZE;
+
+        // Increment the messageId counter, wrapping around at 255
+        messageIdCounter = static_cast<uint8_t>(messageIdCounter + 1);
+
+        for (size_t i = 0; i < totalSize; i += chunkSize) {
+            const size_t end = std::min(i + chunkSize, totalSize);
+            std::vector<uint8_t> chunk(BleChunkHead::SIZE);
+            BleChunkHead(
+                messageIdCounter,
+                static_cast<uint16_t>(i / chunkSize),
+                (end == totalSize) ? BleChunkHead::FINAL_CHUNK_FLAG : 0
+            ).fillTo(chunk.data());
+            chunk.insert(chunk.end(), message.begin() + static_cast<std::ptrdiff_t>(i),
+                         message.begin() + static_cast<std::ptrdiff_t>(end));
+            chunks.push_back(std::move(chunk));
+        }
+
+        return chunks;
+    }
+};
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <random>
+#include <vector>
+
+#include "ble_client_chunker.hpp"
+#include "lib/ble_chunker.hpp"
+#include "proto/generated/shared_constants.hpp"
+
+// Simplified BLE link model, in simulated time (us).
+//
+// - Connection events happen every `conn_interval_us`. Each event can carry
+//   a limited number of LL packets per direction.
+// - LL packet loss is recovered by link layer ARQ: the lost packet is resent
+//   in the next slot, costing airtime only.
+// - Intermediate request chunks go as write-without-response (as the webapp
+//   does), so they may be dropped or reordered by host stack queues. The final
+//   chunk is a write-with-response, always delivered.
+// - ATT requests (read, write-with-response) get their response at the next
+//   connection event after the server finished processing.
+struct BleLinkConfig {
+    uint32_t conn_interval_us = 7'500;
+    bool dle = true;                      // LL payload 251 bytes vs 27
+    uint32_t max_packets_per_event = 6;   // Controller/central limit
+    double ll_loss = 0.0;                 // Per LL packet
+    double att_drop = 0.0;                // Per write-without-response
+    double att_reorder = 0.0;             // Per write-without-response
+};
+
+class BleLinkSim : public BleClientIO {
+public:
+    using Server = BleChunker<SharedConstants::MAX_RPC_MESSAGE_SIZE>;
+
+    // L2CAP (4) + ATT opcode/handle (3)
+    static constexpr size_t ATT_OVERHEAD = 7;
+    // 1M PHY: preamble + access address + header + MIC + CRC, in bytes
+    static constexpr uint32_t LL_PACKET_OVERHEAD = 1 + 4 + 2 + 4 + 3;
+    static constexpr uint32_t T_IFS_US = 150;
+    static constexpr uint32_t EMPTY_PACKET_US = 80;
+
+    BleLinkSim(const BleLinkConfig& cfg, Server& server, uint32_t seed)
+        : cfg(cfg), server(server), rng(seed) {}
+
+    // Server-side handler time for the current request.
+    uint32_t server_processing_us{0};
+
+    auto now_us() const -> uint64_t { return time_us; }
+
+    void write(const std::vector<uint8_t>& chunk) override {
+        const bool with_response = BleClientChunker::isLastChunk(chunk);
+
+        if (!with_response) {
+            if (chance(cfg.att_drop)) {
+                dropped++;
+                return;
+            }
+            time_us = uplink.transmit(*this, time_us, packets_for(chunk.size()));
+
+            if (!held.empty()) {
+                // Deliver previously held chunk after this one
+                server.consumeChunk(chunk.data(), chunk.size());
+                server.consumeChunk(held.data(), held.size());
+                held.clear();
+                return;
+            }
+            if (chance(cfg.att_reorder)) {
+                reordered++;
+                held = chunk;
+                return;
+            }
+            server.consumeChunk(chunk.data(), chunk.size());
+            return;
+        }
+
+        const uint64_t arrived = uplink.transmit(*this, time_us, packets_for(chunk.size()));
+        server.consumeChunk(chunk.data(), chunk.size());
+        if (!held.empty()) {
+            server.consumeChunk(held.data(), held.size());
+            held.clear();
+        }
+        // Write response (empty payload) after handler finished
+        time_us = respond(arrived + server_processing_us, 0);
+    }
+
+    auto read() -> std::vector<uint8_t> override {
+        const uint64_t arrived = uplink.transmit(*this, time_us, packets_for(0));
+        const auto view = server.getResponseChunk();
+        std::vector<uint8_t> chunk(view.data, view.data + view.size);
+        time_us = respond(arrived, chunk.size());
+        return chunk;
+    }
+
+    void sleep_ms(uint32_t ms) override { time_us += static_cast<uint64_t>(ms) * 1000; }
+
+    uint32_t dropped{0};
+    uint32_t reordered{0};
+
+private:
+    class Channel {
+    public:
+        // Returns completion time of the last packet
+        auto transmit(BleLinkSim& sim, uint64_t ready_us, uint32_t packets) -> uint64_t {
+            uint64_t t = ready_us;
+            while (true) {
+                const uint64_t event = sim.next_event(t);
+                if (event != current_event) {
+                    current_event = event;
+                    slots_used = 0;
+                }
+
+                const uint32_t slots = sim.slots_per_event();
+                while (slots_used < slots && packets > 0) {
+                    slots_used++;
+                    if (!sim.chance(sim.cfg.ll_loss)) { packets--; }
+                }
+
+                if (packets == 0) { return current_event + static_cast<uint64_t>(slots_used) * sim.slot_us(); }
+                t = current_event + sim.cfg.conn_interval_us;
+            }
+        }
+
+    private:
+        uint64_t current_event{UINT64_MAX};
+        uint32_t slots_used{0};
+    };
+
+    BleLinkConfig cfg;
+    Server& server;
+    std::mt19937 rng;
+    uint64_t time_us{0};
+    Channel uplink{};
+    Channel downlink{};
+    std::vector<uint8_t> held{};
+
+    auto chance(double p) -> bool {
+        if (p <= 0) { return false; }
+        return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < p;
+    }
+
+    auto ll_payload() const -> uint32_t { return cfg.dle ? 251 : 27; }
+
+    auto packets_for(size_t att_value_size) const -> uint32_t {
+        const auto bytes = static_cast<uint32_t>(att_value_size + ATT_OVERHEAD);
+        return (bytes + ll_payload() - 1) / ll_payload();
+    }
+
+    auto slot_us() const -> uint32_t {
+        // Data packet + IFS + empty ack + IFS
+        return (ll_payload() + LL_PACKET_OVERHEAD) * 8 + T_IFS_US + EMPTY_PACKET_US + T_IFS_US;
+    }
+
+    auto slots_per_event() const -> uint32_t {
+        const uint32_t fit = cfg.conn_interval_us / slot_us();
+        const uint32_t slots = fit < cfg.max_packets_per_event ? fit : cfg.max_packets_per_event;
+        return slots > 0 ? slots : 1;
+    }
+
+    auto next_event(uint64_t t) const -> uint64_t {
+        const uint64_t ci = cfg.conn_interval_us;
+        return ((t + ci - 1) / ci) * ci;
+    }
+
+    // Peripheral answers in the connection event following request arrival.
+    auto respond(uint64_t ready_us, size_t value_size) -> uint64_t {
+        return downlink.transmit(*this, next_event(ready_us + 1), packets_for(value_size));
+    }
+};
@@ -0,0 +1,167 @@
+// BLE transport benchmark: client chunker (webapp port) vs firmware BleChunker
+// over a simulated link.
+//
+// Build & run:
+//   pio run -e ble_bench
+//   .pio/build/ble_bench/program [iterations]
+//
+// Reports goodput (RPC payload bytes in both directions per second) and
+// latency percentiles for typical RPC calls, for a matrix of link settings.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "ble_link_sim.hpp"
+#include "proto/generated/types.pb.h"
+
+namespace {
+
+// Rough CBOR envelope of RPC request/response (method name, id, framing)
+constexpr size_t RPC_ENVELOPE = 24;
+
+struct RpcScenario {
+    const char* name;
+    size_t request_size;
+    size_t response_size;
+    uint32_t calls;             // Calls per iteration (e.g. history chunks)
+    uint32_t processing_us;     // Handler time on device
+};
+
+const RpcScenario scenarios[] = {
+    { "get_status", RPC_ENVELOPE, DeviceInfo_size + RPC_ENVELOPE, 1, 500 },
+    // 2000 points max / 100 per chunk
+    { "history (full)", RPC_ENVELOPE + 8, HistoryChunk_size + RPC_ENVELOPE, 20, 2'000 },
+    { "save_profiles_data", ProfilesData_size + RPC_ENVELOPE, RPC_ENVELOPE, 1, 20'000 },
+};
+
+struct LinkPreset {
+    const char* name;
+    BleLinkConfig cfg;
+};
+
+auto make_presets() -> std::vector<LinkPreset> {
+    std::vector<LinkPreset> presets;
+    const uint32_t intervals[] = { 7'500, 15'000, 30'000, 45'000 };
+
+    for (bool dle : { true, false }) {
+        for (uint32_t ci : intervals) {
+            for (double loss : { 0.0, 0.05 }) {
+                BleLinkConfig cfg{};
+                cfg.conn_interval_us = ci;
+                cfg.dle = dle;
+                cfg.ll_loss = loss;
+                presets.push_back({ "", cfg });
+            }
+        }
+    }
+
+    // Lossy host queues, to exercise MISSED_CHUNKS retries
+    BleLinkConfig cfg{};
+    cfg.conn_interval_us = 15'000;
+    cfg.att_drop = 0.02;
+    cfg.att_reorder = 0.02;
+    presets.push_back({ "att drop/reorder 2%", cfg });
+    return presets;
+}
+
+class EchoServer {
+public:
+    BleLinkSim::Server chunker{};
+    size_t response_size{0};
+
+    EchoServer() {
+        chunker.setMessageHandler(
+            BleLinkSim::Server::MessageHandler::create<EchoServer, &EchoServer::onMessage>(*this));
+    }
+
+    void onMessage(const BleLinkSim::Server::MessageBuffer& message, BleLinkSim::Server::MessageBuffer& response) {
+        response.clear();
+        const uint8_t seed = message.empty() ? 0 : message[0];
+        for (size_t i = 0; i < response_size; i++) { response.push_back(static_cast<uint8_t>(seed + i)); }
+    }
+};
+
+auto percentile(std::vector<double> v, double p) -> double {
+    if (v.empty()) { return 0; }
+    std::sort(v.begin(), v.end());
+    const auto idx = static_cast<size_t>(p * static_cast<double>(v.size() - 1) + 0.5);
+    return v[idx];
+}
+
+void run(const LinkPreset& preset, const RpcScenario& rpc, uint32_t iterations, uint32_t seed) {
+    EchoServer server;
+    server.response_size = rpc.response_size;
+    BleLinkSim link(preset.cfg, server.chunker, seed);
+    link.server_processing_us = rpc.processing_us;
+    BleClientChunker client(link);
+
+    std::vector<double> latencies_ms;
+    uint32_t failures = 0;
+    uint32_t corrupted = 0;
+    const uint64_t t0 = link.now_us();
+
+    for (uint32_t it = 0; it < iterations; it++) {
+        const uint64_t started = link.now_us();
+
+        for (uint32_t call = 0; call < rpc.calls; call++) {
+            std::vector<uint8_t> request(rpc.request_size);
+            for (size_t i = 0; i < request.size(); i++) { request[i] = static_cast<uint8_t>(it + call + i); }
+
+            std::vector<uint8_t> response;
+            // Transport errors are retried by RPC client
+            while (client.send(request, response) != BleClientChunker::Status::Ok) { failures++; }
+
+            bool ok = response.size() == rpc.response_size;
+            for (size_t i = 0; ok && i < response.size(); i++) {
+                ok = response[i] == static_cast<uint8_t>(request[0] + i);
+            }
+            if (!ok) { corrupted++; }
+        }
+
+        latencies_ms.push_back(static_cast<double>(link.now_us() - started) / 1000.0);
+    }
+
+    const double total_s = static_cast<double>(link.now_us() - t0) / 1e6;
+    const double bytes = static_cast<double>((rpc.request_size + rpc.response_size) * rpc.calls) * iterations;
+
+    char link_name[64];
+    if (preset.name[0]) {
+        snprintf(link_name, sizeof(link_name), "%s", preset.name);
+    } else {
+        snprintf(link_name, sizeof(link_name), "CI %4.1fms %s loss %2.0f%%",
+            preset.cfg.conn_interval_us / 1000.0, preset.cfg.dle ? "DLE" : "27B", preset.cfg.ll_loss * 100);
+    }
+
+    printf("%-20s %-28s %9.1f %8.1f %8.1f %8.1f %7u %7u%s\n",
+        rpc.name, link_name,
+        bytes / total_s / 1024.0,
+        percentile(latencies_ms, 0.5),
+        percentile(latencies_ms, 0.99),
+        *std::max_element(latencies_ms.begin(), latencies_ms.end()),
+        client.retries,
+        failures,
+        corrupted ? "  CORRUPTED" : "");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const uint32_t iterations = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 200;
+    if (iterations == 0) {
+        fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return 2;
+    }
+
+    printf("%-20s %-28s %9s %8s %8s %8s %7s %7s\n",
+        "rpc", "link", "KB/s", "p50 ms", "p99 ms", "max ms", "retries", "errors");
+
+    const auto presets = make_presets();
+    for (const auto& rpc : scenarios) {
+        for (const auto& preset : presets) { run(preset, rpc, iterations, 1); }
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,286 @@
+// USB-PD source simulator for Power FSM / ProfileSelector.
+//
+// Build & run:
+//   pio run -e pd_sim
+//   .pio/build/pd_sim/program
+//
+// Runs a simulated reflow (ADRC + thermal plant with copper TCR heater)
+// against several charger models and reports:
+// - load-off time per contract switch (PWM disabled in WaitContractChange)
+// - APDO renegotiations per profile
+// - delivered vs requested energy
+
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "lib/adrc.hpp"
+#include "pd_source_sim.hpp"
+
+namespace {
+
+constexpr uint32_t SIM_STEP_MS = 1;
+constexpr uint32_t CONTROL_TICK_MS = 50;   // HeaterControl tick, sends SysTick to Power
+constexpr uint32_t PWM_PERIOD_MS = 100;    // Pwm::PWM_PERIOD_TICKS
+
+// Hotplate, roughly matching default head params (b0 = 1/C, tau = C * Rth)
+struct Plant {
+    float heat_capacity = 18.7f;   // J/K
+    float thermal_resistance = 6.0f; // K/W
+    float ambient = 25.0f;
+    float r25_mohm = 3000.0f;
+    float tcr = 0.00393f;
+
+    float temperature = 25.0f;
+
+    auto resistance_mohm() const -> uint32_t {
+        return static_cast<uint32_t>(r25_mohm * (1.0f + tcr * (temperature - 25.0f)));
+    }
+
+    void step(float power_w, float dt) {
+        temperature += dt * (power_w - (temperature - ambient) / thermal_resistance) / heat_capacity;
+    }
+};
+
+// Simplified reflow profile: (time s, temperature C) breakpoints
+struct ProfilePoint { float t; float temperature; };
+
+const ProfilePoint reflow_profile[] = {
+    { 0, 30 }, { 90, 150 }, { 180, 180 }, { 220, 245 }, { 250, 245 }, { 300, 150 }
+};
+
+auto profile_at(float t, float& rate) -> float {
+    const size_t n = sizeof(reflow_profile) / sizeof(reflow_profile[0]);
+    for (size_t i = 1; i < n; i++) {
+        const auto& a = reflow_profile[i - 1];
+        const auto& b = reflow_profile[i];
+        if (t <= b.t) {
+            rate = (b.temperature - a.temperature) / (b.t - a.t);
+            return a.temperature + rate * (t - a.t);
+        }
+    }
+    rate = 0;
+    return reflow_profile[n - 1].temperature;
+}
+
+class Metrics {
+public:
+    explicit Metrics(uint64_t& now_ms) : now_ms(now_ms) {}
+
+    void on_state(PowerFsm::State state) {
+        if (state == PowerFsm::State::WaitContractChange) {
+            switches++;
+        }
+        if (state == PowerFsm::State::Initializing && reflow_active) { aborts++; }
+    }
+
+    void on_apdo_update(uint32_t profile_idx) {
+        if (apdo_updates.size() <= profile_idx) { apdo_updates.resize(profile_idx + 1); }
+        apdo_updates[profile_idx]++;
+    }
+
+    // Track load-off intervals caused by contract switches
+    void on_pwm(bool enabled, PowerFsm::State state) {
+        if (!enabled && pwm_was_enabled && state == PowerFsm::State::WaitContractChange) {
+            off_started_ms = now_ms;
+            off_active = true;
+        }
+        if (enabled && off_active) {
+            off_times_ms.push_back(static_cast<double>(now_ms - off_started_ms));
+            off_active = false;
+        }
+        pwm_was_enabled = enabled;
+    }
+
+    uint64_t& now_ms;
+    bool reflow_active{false};
+    uint32_t switches{0};
+    uint32_t aborts{0};
+    std::vector<uint32_t> apdo_updates{};
+    std::vector<double> off_times_ms{};
+    double requested_j{0};
+    double delivered_j{0};
+    double abs_error_j{0};
+    double max_temp_error{0};
+    uint32_t overcurrent_ms{0};
+
+private:
+    bool pwm_was_enabled{false};
+    bool off_active{false};
+    uint64_t off_started_ms{0};
+};
+
+// Board side of Power: DPM goes to the simulated source, drain info comes
+// from the plant, PWM state is read back by the simulation loop.
+class SimBoard : public PowerFsm::Io {
+public:
+    SimBoard(PdSourceSim& source, Metrics& metrics) : source(source), metrics(metrics) {}
+
+    void trigger_by_position(uint32_t position, uint32_t mv) override { source.trigger_by_position(position, mv); }
+    void clear_trigger_to(uint32_t position, uint32_t mv) override { source.clear_trigger_to(position, mv); }
+    auto is_handshake_reported() -> bool override { return source.is_handshake_reported(); }
+
+    auto get_drain_info() -> PowerFsm::DrainInfo override { return drain_info; }
+    void drain_reset() override { drain_info = {}; }
+
+    void pwm_enable(bool enable) override { pwm_enabled = enable; }
+    void pwm_set(PwmScheduler::Modulation, uint32_t duty_x1000) override { pwm_duty_x1000 = duty_x1000; }
+
+    void on_state(PowerFsm::State state) override { metrics.on_state(state); }
+    void on_apdo_update(uint32_t profile_idx, uint32_t) override { metrics.on_apdo_update(profile_idx); }
+
+    PowerFsm::DrainInfo drain_info{};
+    bool pwm_enabled{false};
+    uint32_t pwm_duty_x1000{0};
+
+private:
+    PdSourceSim& source;
+    Metrics& metrics;
+};
+
+void run(const PdSourceConfig& cfg) {
+    uint64_t now_ms = 0;
+    Metrics metrics(now_ms);
+    PdSourceSim source(cfg, 1);
+    ProfileSelector ps{};
+    SimBoard board(source, metrics);
+    PowerFsm power(ps, board);
+    source.connect(power);
+    power.start();
+
+    Plant plant{};
+    ADRC adrc{};
+    adrc.set_params(0.0536f, 113.0f, 55.0f, 5.0f);
+
+    source.attach(0);
+
+    // Wait for Ready before reflow start
+    constexpr uint64_t REFLOW_START_MS = 3000;
+    constexpr uint64_t REFLOW_END_MS = REFLOW_START_MS + 300 * 1000;
+
+    for (now_ms = 0; now_ms < REFLOW_END_MS; now_ms += SIM_STEP_MS) {
+        source.run_until(now_ms);
+
+        // Load measurements: DrainTracker updates at the end of each PWM pulse
+        if (board.pwm_enabled && source.bus_mv > 0 && now_ms % PWM_PERIOD_MS == 0) {
+            const uint32_t r = plant.resistance_mohm();
+            board.drain_info.peak_mv = source.bus_mv;
+            board.drain_info.peak_ma = source.bus_mv * 1000 / r;
+            board.drain_info.load_valid = true;
+        }
+
+        if (now_ms % CONTROL_TICK_MS == 0) {
+            if (now_ms == REFLOW_START_MS) {
+                if (power.get_state() != PowerFsm::State::Ready) {
+                    printf("%-24s power not ready at reflow start\n", cfg.name);
+                    return;
+                }
+                metrics.reflow_active = true;
+                adrc.reset_to(plant.temperature);
+            }
+
+            if (metrics.reflow_active) {
+                float rate = 0;
+                const float t = static_cast<float>(now_ms - REFLOW_START_MS) / 1000.0f;
+                const float setpoint = profile_at(t, rate);
+                const float max_power = static_cast<float>(power.get_max_power_mw()) * 0.001f;
+                const float power_w = adrc.iterate(plant.temperature, setpoint, max_power,
+                                                   CONTROL_TICK_MS * 0.001f, rate);
+                power.target_power_mw = static_cast<uint32_t>(power_w * 1000);
+                metrics.max_temp_error = std::max(metrics.max_temp_error,
+                    static_cast<double>(fabsf(setpoint - plant.temperature)));
+            }
+
+            power.on_sys_tick();
+            if (metrics.reflow_active && power.get_state() == PowerFsm::State::Initializing) {
+                // Firmware stops the task on power re-init
+                break;
+            }
+        }
+
+        metrics.on_pwm(board.pwm_enabled, power.get_state());
+
+        // Delivered power
+        float delivered_w = 0;
+        if (board.pwm_enabled && source.bus_mv > 0) {
+            const float v = static_cast<float>(source.bus_mv) * 0.001f;
+            const float r = static_cast<float>(plant.resistance_mohm()) * 0.001f;
+            delivered_w = v * v / r * static_cast<float>(board.pwm_duty_x1000) * 0.001f;
+            if (v / r * 1000.0f > static_cast<float>(source.contract_ma)) { metrics.overcurrent_ms++; }
+        }
+        plant.step(delivered_w, SIM_STEP_MS * 0.001f);
+
+        if (metrics.reflow_active) {
+            const double dt = SIM_STEP_MS * 0.001;
+            const double requested = power.target_power_mw * 0.001;
+            metrics.requested_j += requested * dt;
+            metrics.delivered_j += delivered_w * dt;
+            metrics.abs_error_j += fabs(requested - delivered_w) * dt;
+        }
+    }
+
+    auto& off = metrics.off_times_ms;
+    std::sort(off.begin(), off.end());
+    const double off_avg = off.empty() ? 0 : std::accumulate(off.begin(), off.end(), 0.0) / off.size();
+
+    printf("%-24s switches %3u  load-off avg %6.0f ms max %6.0f ms  requests %4u rejects %3u%s\n",
+        cfg.name, metrics.switches, off_avg, off.empty() ? 0.0 : off.back(),
+        source.requests, source.rejects, metrics.aborts ? "  ABORTED" : "");
+
+    printf("%-24s energy requested %7.0f J delivered %7.0f J (%5.1f%%), abs error %5.1f%%, max T error %5.1f C\n",
+        "", metrics.requested_j, metrics.delivered_j,
+        metrics.requested_j > 0 ? metrics.delivered_j / metrics.requested_j * 100 : 0.0,
+        metrics.requested_j > 0 ? metrics.abs_error_j / metrics.requested_j * 100 : 0.0,
+        metrics.max_temp_error);
+
+    printf("%-24s APDO updates per profile:", "");
+    for (size_t i = 0; i < metrics.apdo_updates.size(); i++) {
+        if (metrics.apdo_updates[i]) { printf(" [%zu] %u", i + 1, metrics.apdo_updates[i]); }
+    }
+    if (metrics.overcurrent_ms) { printf("  overcurrent %u ms", metrics.overcurrent_ms); }
+    printf("\n\n");
+}
+
+auto make_sources() -> std::vector<PdSourceConfig> {
+    using S = PdSourceSim;
+    std::vector<PdSourceConfig> sources;
+
+    PdSourceConfig fixed{};
+    fixed.name = "45W fixed only";
+    fixed.pdos = { S::fixed_pdo(5000, 3000), S::fixed_pdo(9000, 3000), S::fixed_pdo(15000, 3000) };
+    sources.push_back(fixed);
+
+    PdSourceConfig pps{};
+    pps.name = "65W with PPS";
+    pps.pdos = { S::fixed_pdo(5000, 3000), S::fixed_pdo(9000, 3000), S::fixed_pdo(15000, 3000),
+                 S::fixed_pdo(20000, 3250), S::pps_pdo(3300, 21000, 3250) };
+    sources.push_back(pps);
+
+    PdSourceConfig slow = pps;
+    slow.name = "65W PPS, slow switch";
+    slow.fixed_switch_ms = 800;
+    slow.pps_switch_ms = 250;
+    sources.push_back(slow);
+
+    PdSourceConfig caps = pps;
+    caps.name = "65W PPS, caps resend";
+    caps.caps_resend_ms = 20'000;
+    sources.push_back(caps);
+
+    PdSourceConfig reject = pps;
+    reject.name = "65W PPS, 1% rejects";
+    reject.reject_probability = 0.01;
+    sources.push_back(reject);
+
+    return sources;
+}
+
+} // namespace
+
+int main() {
+    for (const auto& src : make_sources()) { run(src); }
+    return 0;
+}
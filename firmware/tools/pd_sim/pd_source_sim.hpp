@@ -0,0 +1,148 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <functional>
+#include <map>
+#include <random>
+
+#include "lib/power_fsm.hpp"
+
+// Simulated USB-PD source (charger) + sink policy engine, at DPM level.
+//
+// Emits the same DPM event sequence as pdsink does on contract negotiation:
+// SrcCapsReceived -> (request) -> SelectCapDone -> SnkReady [-> HandshakeDone]
+// or NewPowerLevelRejected. Bus voltage switches at PS_RDY.
+struct PdSourceConfig {
+    const char* name = "";
+    pd::PDO_LIST pdos{};
+    uint32_t fixed_switch_ms = 300;   // Request to PS_RDY, new fixed voltage
+    uint32_t pps_switch_ms = 60;      // Request to PS_RDY, APDO adjustment
+    uint32_t attach_ms = 400;         // Attach to first caps
+    double reject_probability = 0.0;  // Per request
+    uint32_t caps_resend_ms = 0;      // Unsolicited caps period, 0 - never
+};
+
+class PdSourceSim {
+public:
+    PdSourceSim(const PdSourceConfig& cfg, uint32_t seed) : cfg(cfg), rng(seed) {}
+
+    void connect(PowerFsm& fsm) { power = &fsm; }
+
+    // Fixed PDO, raw PD encoding
+    static auto fixed_pdo(uint32_t mv, uint32_t ma) -> uint32_t {
+        return ((mv / 50) << 10) | (ma / 10);
+    }
+
+    // SPR PPS APDO, raw PD encoding
+    static auto pps_pdo(uint32_t mv_min, uint32_t mv_max, uint32_t ma) -> uint32_t {
+        return (3u << 30) | ((mv_max / 100) << 17) | ((mv_min / 100) << 8) | (ma / 50);
+    }
+
+    // DPM triggers
+    void trigger_by_position(uint32_t position, uint32_t mv) {
+        set_trigger(position, mv);
+        schedule_request();
+    }
+
+    void clear_trigger_to(uint32_t position, uint32_t mv) { set_trigger(position, mv); }
+
+    auto is_handshake_reported() const -> bool { return handshake_done; }
+
+    void attach(uint64_t now_ms) {
+        schedule(now_ms, [this]() { power->on_startup(); });
+        schedule(now_ms + cfg.attach_ms, [this]() { send_caps(); });
+    }
+
+    // Process events up to `now_ms`
+    void run_until(uint64_t now_ms) {
+        this->now_ms = now_ms;
+        while (!events.empty() && events.begin()->first <= now_ms) {
+            auto fn = events.begin()->second;
+            events.erase(events.begin());
+            fn();
+        }
+        if (cfg.caps_resend_ms && now_ms >= next_caps_ms) {
+            next_caps_ms = now_ms + cfg.caps_resend_ms;
+            send_caps();
+        }
+    }
+
+    // Contract state, as seen on VBUS
+    uint32_t bus_mv{0};
+    uint32_t contract_ma{0};
+    uint32_t requests{0};
+    uint32_t rejects{0};
+
+private:
+    PdSourceConfig cfg;
+    std::mt19937 rng;
+    PowerFsm* power{nullptr};
+    std::multimap<uint64_t, std::function<void()>> events{};
+    uint64_t now_ms{0};
+    uint64_t next_caps_ms{UINT64_MAX};
+    uint32_t trigger_position{1};
+    uint32_t trigger_mv{5000};
+    bool handshake_done{false};
+    bool request_pending{false};
+
+    void schedule(uint64_t at_ms, std::function<void()> fn) { events.emplace(at_ms, std::move(fn)); }
+
+    void set_trigger(uint32_t position, uint32_t mv) {
+        trigger_position = position;
+        trigger_mv = mv;
+    }
+
+    void send_caps() {
+        if (cfg.caps_resend_ms && next_caps_ms == UINT64_MAX) { next_caps_ms = now_ms + cfg.caps_resend_ms; }
+        power->on_src_caps_received(cfg.pdos);
+        // PE answers caps with request by current trigger
+        schedule_request();
+    }
+
+    void schedule_request() {
+        if (request_pending) { return; }
+        request_pending = true;
+        requests++;
+
+        // Evaluate request at send time, DPM may update trigger meanwhile
+        // only until PE picks it up.
+        const uint32_t position = trigger_position;
+        const uint32_t mv = trigger_mv;
+        const bool valid = position >= 1 && position <= cfg.pdos.size();
+        const auto variant = valid ? pd::dobj_utils::get_src_pdo_variant(cfg.pdos[position - 1])
+                                   : pd::PDO_VARIANT::UNKNOWN;
+        const auto limits = valid ? pd::dobj_utils::get_src_pdo_limits(cfg.pdos[position - 1])
+                                  : pd::dobj_utils::SRC_PDO_LIMITS{};
+
+        const bool reject = !valid ||
+            std::uniform_real_distribution<double>(0.0, 1.0)(rng) < cfg.reject_probability;
+
+        const uint32_t new_mv = variant == pd::PDO_VARIANT::FIXED ? limits.mv_min
+            : (mv < limits.mv_min ? limits.mv_min : (mv > limits.mv_max ? limits.mv_max : mv));
+        const bool same_pdo_adjust = variant != pd::PDO_VARIANT::FIXED && bus_mv != 0 &&
+            position == current_position;
+
+        const uint32_t delay = same_pdo_adjust ? cfg.pps_switch_ms : cfg.fixed_switch_ms;
+
+        schedule(now_ms + delay, [this, reject, position, new_mv, limits]() {
+            request_pending = false;
+            if (reject) {
+                rejects++;
+                power->on_new_power_level_rejected();
+                return;
+            }
+            current_position = position;
+            bus_mv = new_mv;
+            contract_ma = limits.ma;
+            power->on_select_cap_done(position);
+            power->on_snk_ready();
+            if (!handshake_done) {
+                handshake_done = true;
+                power->on_handshake_done();
+            }
+        });
+    }
+
+    uint32_t current_position{0};
+};
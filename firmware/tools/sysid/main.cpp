@@ -0,0 +1,185 @@
+// Offline system identification from exported runs.
+//
+// Fits FOPDT and two-node thermal models to (temperature, power) logs, and
+// suggests ADRC head params. Input is CSV with header, one or many files
+// (each file - separate run). Columns are detected by name:
+//
+//   - time:        ts_ms | time_ms
+//   - temperature: temp_rec | temperature | temp
+//   - power:       power_rec | power
+//
+// That matches `trace_replay --csv` output. Files are streamed line by line,
+// so batch size is not limited by memory. Use `-` to read stdin.
+//
+// Usage: sysid [--step-ms 500] [--max-delay-ms 20000] [--m 2] <run.csv>...
+//
+// Build & run:
+//   pio run -e sysid
+//   .pio/build/sysid/program runs/*.csv
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "thermal_fit.hpp"
+
+namespace {
+
+struct Columns {
+    int time = -1;
+    int temperature = -1;
+    int power = -1;
+};
+
+auto match(const char* name, const char* const* variants) -> bool {
+    for (; *variants; variants++) {
+        if (strcmp(name, *variants) == 0) { return true; }
+    }
+    return false;
+}
+
+auto parse_header(char* line, Columns& cols) -> bool {
+    static const char* const TIME[] = { "ts_ms", "time_ms", nullptr };
+    static const char* const TEMPERATURE[] = { "temp_rec", "temperature", "temp", nullptr };
+    static const char* const POWER[] = { "power_rec", "power", nullptr };
+
+    int idx = 0;
+    for (char* tok = strtok(line, ",\r\n"); tok; tok = strtok(nullptr, ",\r\n"), idx++) {
+        if (cols.time < 0 && match(tok, TIME)) { cols.time = idx; }
+        if (cols.temperature < 0 && match(tok, TEMPERATURE)) { cols.temperature = idx; }
+        if (cols.power < 0 && match(tok, POWER)) { cols.power = idx; }
+    }
+    return cols.time >= 0 && cols.temperature >= 0 && cols.power >= 0;
+}
+
+// Returns false on read/format error.
+auto process_file(const char* path, ThermalFit& fit, size_t& lines) -> bool {
+    FILE* f = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Can't open %s\n", path);
+        return false;
+    }
+
+    char line[1024];
+    Columns cols{};
+    bool ok = fgets(line, sizeof(line), f) && parse_header(line, cols);
+
+    if (!ok) {
+        fprintf(stderr, "%s: no time/temperature/power columns in header\n", path);
+    } else {
+        while (fgets(line, sizeof(line), f)) {
+            // Empty line - explicit run separator
+            if (line[0] == '\n' || line[0] == '\r') {
+                fit.end_run();
+                continue;
+            }
+
+            double ts = 0, temperature = 0, power = 0;
+            int found = 0;
+            int idx = 0;
+            for (char* p = line; p; idx++) {
+                if (idx == cols.time) { ts = strtod(p, nullptr); found++; }
+                if (idx == cols.temperature) { temperature = strtod(p, nullptr); found++; }
+                if (idx == cols.power) { power = strtod(p, nullptr); found++; }
+                p = strchr(p, ',');
+                if (p) { p++; }
+            }
+            if (found != 3) { continue; }
+
+            fit.add(static_cast<uint32_t>(ts), static_cast<float>(temperature), static_cast<float>(power));
+            lines++;
+        }
+        fit.end_run();
+    }
+
+    if (f != stdin) { fclose(f); }
+    return ok;
+}
+
+void usage(const char* name) {
+    fprintf(stderr, "Usage: %s [--step-ms 500] [--max-delay-ms 20000] [--m 2] <run.csv>...\n", name);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ThermalFit::Config cfg{};
+    float m_coeff = 2;
+    int first_file = 1;
+
+    for (; first_file < argc; first_file++) {
+        const char* arg = argv[first_file];
+        if (strncmp(arg, "--", 2) != 0) { break; }
+        if (first_file + 1 >= argc) {
+            usage(argv[0]);
+            return 2;
+        }
+        const char* value = argv[++first_file];
+
+        if (strcmp(arg, "--step-ms") == 0) { cfg.step_ms = static_cast<uint32_t>(atoi(value)); }
+        else if (strcmp(arg, "--max-delay-ms") == 0) { cfg.max_delay_ms = static_cast<uint32_t>(atoi(value)); }
+        else if (strcmp(arg, "--m") == 0) { m_coeff = static_cast<float>(atof(value)); }
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (first_file >= argc || cfg.step_ms == 0 || m_coeff <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    ThermalFit fit{cfg};
+    size_t lines = 0;
+    bool ok = true;
+
+    for (int i = first_file; i < argc; i++) { ok = process_file(argv[i], fit, lines) && ok; }
+
+    const auto fopdt = fit.get_fopdt();
+    const auto two_node = fit.get_two_node();
+
+    printf("Input: %u runs, %zu samples\n\n", fit.get_runs(), lines);
+
+    if (fopdt.valid) {
+        printf("FOPDT:    tau = %.2fs, delay = %.2fs, gain = %.3f C/W, ambient = %.1fC\n",
+            static_cast<double>(fopdt.tau), static_cast<double>(fopdt.delay),
+            static_cast<double>(fopdt.gain), static_cast<double>(fopdt.ambient));
+        printf("          b0 = %.6f, residual RMS = %.4fC (%zu steps)\n",
+            static_cast<double>(fopdt.b0), static_cast<double>(fopdt.rms), fopdt.samples);
+    } else {
+        printf("FOPDT:    fit failed (not enough data or excitation)\n");
+    }
+
+    if (two_node.valid) {
+        printf("Two-node: tau slow = %.2fs, tau fast = %.2fs, delay = %.2fs, gain = %.3f C/W\n",
+            static_cast<double>(two_node.tau_slow), static_cast<double>(two_node.tau_fast),
+            static_cast<double>(two_node.delay), static_cast<double>(two_node.gain));
+        printf("          b0 = %.6f, residual RMS = %.4fC (%zu steps)\n",
+            static_cast<double>(two_node.b0), static_cast<double>(two_node.rms), two_node.samples);
+    } else {
+        printf("Two-node: fit failed (not enough data or excitation)\n");
+    }
+
+    if (!fopdt.valid) { return 1; }
+
+    // - response & b0 - from FOPDT, same meaning as in step response test.
+    // - N - limit observer bandwidth (M·N/τ) by effective delay. Fast node
+    //   acts as extra lag, when available. Clamp to sane range, fine tune
+    //   by jitter as described in calibration docs.
+    const float step_s = static_cast<float>(cfg.step_ms) / 1000.0f;
+    float l_eff = two_node.valid ? two_node.delay + two_node.tau_fast : fopdt.delay;
+    if (l_eff < step_s) { l_eff = step_s; }
+
+    float n_coeff = fopdt.tau / (m_coeff * l_eff);
+    if (n_coeff < 10) { n_coeff = 10; }
+    if (n_coeff > 100) { n_coeff = 100; }
+
+    printf("\nRecommended head params:\n");
+    printf("  adrc_response = %.2f\n", static_cast<double>(fopdt.tau));
+    printf("  adrc_b0       = %.6f\n", static_cast<double>(fopdt.b0));
+    printf("  adrc_n_coeff  = %.0f\n", static_cast<double>(n_coeff));
+    printf("  adrc_m_coeff  = %.0f\n", static_cast<double>(m_coeff));
+
+    return ok ? 0 : 1;
+}
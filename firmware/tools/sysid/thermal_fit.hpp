@@ -0,0 +1,217 @@
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "lib/least_squares.hpp"
+
+// Fits thermal models of the head to (temperature, power) logs.
+//
+// Input is resampled to fixed step (window averages), then fitted as
+// discrete ARX models, exact for zero-order-hold input:
+//
+// - FOPDT:    T[k+1] = a·T[k] + b·u[k-d] + c
+// - Two-node: T[k+1] = a1·T[k] + a2·T[k-1] + b1·u[k-d] + b2·u[k-d-1] + c
+//
+// Two-node = heater + plate, with only heater temperature measured. Dead time
+// `d` is searched over grid, one accumulator per candidate, so everything is
+// single pass and memory does not depend on log length.
+//
+// Runs are independent (regressors never cross run boundary), but share the
+// same model, including ambient temperature.
+class ThermalFit {
+public:
+    struct Config {
+        uint32_t step_ms = 500;
+        uint32_t max_delay_ms = 20'000;
+        uint32_t max_gap_ms = 5'000;  // Bigger gap in timestamps starts new run
+    };
+
+    struct FopdtResult {
+        bool valid = false;
+        float delay = 0;      // Dead time, s
+        float tau = 0;        // Time constant, s
+        float gain = 0;       // Steady state gain, °C/W
+        float ambient = 0;    // °C
+        float b0 = 0;         // gain / tau, °C/(W·s)
+        float rms = 0;        // One-step prediction residual, °C
+        size_t samples = 0;
+    };
+
+    struct TwoNodeResult {
+        bool valid = false;
+        float delay = 0;      // Dead time, s
+        float tau_slow = 0;   // s
+        float tau_fast = 0;   // s
+        float gain = 0;       // Steady state gain, °C/W
+        float b0 = 0;         // gain / tau_slow, °C/(W·s)
+        float rms = 0;        // One-step prediction residual, °C
+        size_t samples = 0;
+    };
+
+    explicit ThermalFit(const Config& cfg) : cfg{cfg} {
+        delays = cfg.max_delay_ms / cfg.step_ms + 1;
+        fopdt.resize(delays);
+        two_node.resize(delays);
+        u_hist.resize(delays + 2);
+    }
+
+    // Feed samples in time order. `power` is the heater power applied from
+    // this timestamp.
+    void add(uint32_t ts_ms, float temperature, float power) {
+        if (has_last_ts && (ts_ms < last_ts || ts_ms - last_ts > cfg.max_gap_ms)) { end_run(); }
+
+        if (!has_last_ts) {
+            window_start = ts_ms;
+            has_last_ts = true;
+        }
+        last_ts = ts_ms;
+
+        // Close all completed windows. Empty windows (small gaps) repeat last values.
+        while (ts_ms >= window_start + cfg.step_ms) {
+            if (w_count > 0) {
+                w_temp = w_temp_sum / w_count;
+                w_power = w_power_sum / w_count;
+            }
+            if (w_count > 0 || has_window) { push_step(w_temp, w_power); }
+            has_window = has_window || w_count > 0;
+            w_temp_sum = w_power_sum = 0;
+            w_count = 0;
+            window_start += cfg.step_ms;
+        }
+
+        w_temp_sum += temperature;
+        w_power_sum += power;
+        w_count++;
+    }
+
+    // Call between independent logs (and at the end of input).
+    void end_run() {
+        has_last_ts = false;
+        has_window = false;
+        w_temp_sum = w_power_sum = 0;
+        w_count = 0;
+        steps = 0;
+        runs++;
+    }
+
+    auto get_fopdt() const -> FopdtResult {
+        FopdtResult best{};
+        double best_sse = INFINITY;
+        const double h = cfg.step_ms / 1000.0;
+
+        for (uint32_t d = 0; d < delays; d++) {
+            const auto& ls = fopdt[d];
+            double th[3];
+            if (ls.size() < 10 || !ls.solve(th)) { continue; }
+
+            const double sse = ls.sse(th);
+            if (sse >= best_sse) { continue; }
+
+            const double a = 1 + th[0];
+            if (a <= 0 || a >= 1) { continue; }
+
+            best_sse = sse;
+            best.valid = true;
+            best.delay = static_cast<float>(d * h);
+            best.tau = static_cast<float>(-h / log(a));
+            best.gain = static_cast<float>(th[1] / (1 - a));
+            best.ambient = static_cast<float>(th[2] / (1 - a));
+            best.b0 = best.gain / best.tau;
+            best.rms = static_cast<float>(sqrt(sse / ls.size()));
+            best.samples = ls.size();
+        }
+        return best;
+    }
+
+    auto get_two_node() const -> TwoNodeResult {
+        TwoNodeResult best{};
+        double best_sse = INFINITY;
+        const double h = cfg.step_ms / 1000.0;
+
+        for (uint32_t d = 0; d < delays; d++) {
+            const auto& ls = two_node[d];
+            double th[5];
+            if (ls.size() < 20 || !ls.solve(th)) { continue; }
+
+            const double sse = ls.sse(th);
+            if (sse >= best_sse) { continue; }
+
+            // Poles of z² - a1·z - a2. Physical system has both real, in (0, 1).
+            const double a1 = 1 + th[0];
+            const double a2 = th[1];
+            const double disc = a1 * a1 + 4 * a2;
+            if (disc < 0) { continue; }
+
+            const double z_slow = (a1 + sqrt(disc)) / 2;
+            const double z_fast = (a1 - sqrt(disc)) / 2;
+            if (z_slow <= 0 || z_slow >= 1 || z_fast <= 0 || z_fast >= 1) { continue; }
+
+            best_sse = sse;
+            best.valid = true;
+            best.delay = static_cast<float>(d * h);
+            best.tau_slow = static_cast<float>(-h / log(z_slow));
+            best.tau_fast = static_cast<float>(-h / log(z_fast));
+            best.gain = static_cast<float>((th[2] + th[3]) / (1 - a1 - a2));
+            best.b0 = best.gain / best.tau_slow;
+            best.rms = static_cast<float>(sqrt(sse / ls.size()));
+            best.samples = ls.size();
+        }
+        return best;
+    }
+
+    auto get_runs() const -> uint32_t { return runs; }
+
+private:
+    Config cfg;
+    uint32_t delays;
+
+    std::vector<LeastSquares<3>> fopdt;
+    std::vector<LeastSquares<5>> two_node;
+
+    // Resampling window
+    bool has_last_ts{false};
+    bool has_window{false};
+    uint32_t last_ts{0};
+    uint32_t window_start{0};
+    double w_temp_sum{0};
+    double w_power_sum{0};
+    uint32_t w_count{0};
+    double w_temp{0};
+    double w_power{0};
+
+    // Resampled history of current run
+    std::vector<double> u_hist;  // Ring, u_hist[steps % size] - latest
+    double t_prev{0};            // T[k-1]
+    double t_curr{0};            // T[k]
+    uint32_t steps{0};
+    uint32_t runs{0};
+
+    auto u_at(uint32_t back) const -> double {
+        return u_hist[(steps - 1 - back) % u_hist.size()];
+    }
+
+    // Every new resampled point T[k+1] closes regression rows for step k
+    void push_step(double temperature, double power) {
+        if (steps >= 1) {
+            const double y = temperature - t_curr;  // T[k+1] - T[k]
+
+            for (uint32_t d = 0; d < delays; d++) {
+                if (steps < d + 1) { break; }
+                const double x[3] = { t_curr, u_at(d), 1.0 };
+                fopdt[d].add(x, y);
+
+                if (steps < d + 2 || steps < 2) { continue; }
+                const double x2[5] = { t_curr, t_prev, u_at(d), u_at(d + 1), 1.0 };
+                two_node[d].add(x2, y);
+            }
+        }
+
+        t_prev = t_curr;
+        t_curr = temperature;
+        u_hist[steps % u_hist.size()] = power;
+        steps++;
+    }
+};
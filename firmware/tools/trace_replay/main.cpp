@@ -0,0 +1,75 @@
+// Host-side replay of traces, recorded via `trace_start` / `trace_read` RPC.
+//
+// Usage: trace_replay <trace.bin> [--csv]
+//
+// Build & run:
+//   pio run -e trace_replay
+//   .pio/build/trace_replay/program trace.bin --csv > out.csv
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "lib/trace_replay.hpp"
+
+namespace {
+
+class CsvReplay : public TraceReplay {
+public:
+    bool csv{false};
+
+    void on_control_tick(uint32_t ts_ms, const SampleTrace::ControlTick& recorded,
+                         int32_t temperature_x10, float power) override
+    {
+        if (!csv) { return; }
+        printf("%u,%.1f,%.1f,%.2f,%.3f,%.3f,%.3f\n",
+            ts_ms,
+            static_cast<double>(recorded.temperature_x10) * 0.1,
+            static_cast<double>(temperature_x10) * 0.1,
+            static_cast<double>(recorded.setpoint),
+            static_cast<double>(recorded.power_max),
+            static_cast<double>(recorded.power_out),
+            static_cast<double>(power));
+    }
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <trace.bin> [--csv]\n", argv[0]);
+        return 2;
+    }
+
+    FILE* f = fopen(argv[1], "rb");
+    if (!f) {
+        fprintf(stderr, "Can't open %s\n", argv[1]);
+        return 2;
+    }
+
+    std::vector<uint8_t> data;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) { data.insert(data.end(), chunk, chunk + n); }
+    fclose(f);
+
+    CsvReplay replay;
+    replay.csv = argc > 2 && strcmp(argv[2], "--csv") == 0;
+
+    if (replay.csv) { printf("ts_ms,temp_rec,temp_replay,setpoint,power_max,power_rec,power_replay\n"); }
+
+    const bool complete = replay.run(data.data(), data.size());
+    const auto& s = replay.stats;
+
+    fprintf(stderr, "records: %u, gaps: %u (dropped %u), control ticks: %u\n",
+        s.records, s.gaps, s.dropped, s.control_ticks);
+    fprintf(stderr, "mismatches: temperature %u, power %u\n",
+        s.temperature_mismatches, s.power_mismatches);
+
+    if (!complete) {
+        fprintf(stderr, "Trace is truncated or broken\n");
+        return 1;
+    }
+    return (s.temperature_mismatches || s.power_mismatches) ? 1 : 0;
+}
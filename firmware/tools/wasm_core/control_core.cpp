@@ -0,0 +1,157 @@
+// Thin C ABI over the firmware control core, for WebAssembly builds.
+//
+// Exposes the real ADRC, ProfileSelector, Timeline, SparseHistory and
+// TemperatureProcessor, so the virtual backend and offline tools can run
+// exactly the same math as the device. Objects are created on the wasm heap
+// and passed around as opaque handles.
+//
+// Build: `npm run build:wasm` in `webapp/` (needs emcc in PATH).
+
+#include <stdint.h>
+
+#include "components/temperature_processor.hpp"
+#include "heater/profile_selector.hpp"
+#include "lib/adrc.hpp"
+#include "lib/sparse_history.hpp"
+#include "lib/timeline.hpp"
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/emscripten.h>
+#define CC_EXPORT extern "C" EMSCRIPTEN_KEEPALIVE
+#else
+#define CC_EXPORT extern "C"
+#endif
+
+//
+// ADRC
+//
+
+CC_EXPORT auto adrc_create() -> ADRC* { return new ADRC(); }
+CC_EXPORT void adrc_destroy(ADRC* adrc) { delete adrc; }
+
+CC_EXPORT void adrc_set_params(ADRC* adrc, float b0, float tau, float N, float M) {
+    adrc->set_params(b0, tau, N, M);
+}
+
+CC_EXPORT void adrc_set_params_raw(ADRC* adrc, float b0, float omega_o, float kp) {
+    adrc->set_params_raw(b0, omega_o, kp);
+}
+
+CC_EXPORT auto adrc_iterate(ADRC* adrc, float y, float y_ref, float u_max, float dt, float y_ref_rate) -> float {
+    return adrc->iterate(y, y_ref, u_max, dt, y_ref_rate);
+}
+
+CC_EXPORT void adrc_reset_to(ADRC* adrc, float y) { adrc->reset_to(y); }
+
+//
+// ProfileSelector
+//
+
+CC_EXPORT auto profile_selector_create() -> ProfileSelector* { return new ProfileSelector(); }
+CC_EXPORT void profile_selector_destroy(ProfileSelector* ps) { delete ps; }
+
+// `pdos` - raw 32-bit source capabilities, as received from PD source.
+CC_EXPORT void profile_selector_load_pdos(ProfileSelector* ps, const uint32_t* pdos, uint32_t count) {
+    pd::PDO_LIST list{};
+    for (uint32_t i = 0; i < count && !list.full(); i++) { list.push_back(pdos[i]); }
+    ps->load_pdos(list);
+}
+
+CC_EXPORT void profile_selector_set_pdo_index(ProfileSelector* ps, int32_t index) { ps->set_pdo_index(index); }
+CC_EXPORT auto profile_selector_get_pdo_index(ProfileSelector* ps) -> uint32_t { return ps->current_index; }
+CC_EXPORT auto profile_selector_get_default_position(ProfileSelector* ps) -> uint32_t { return ps->default_position; }
+CC_EXPORT auto profile_selector_get_default_mv(ProfileSelector* ps) -> uint32_t { return ps->default_mv; }
+
+CC_EXPORT auto profile_selector_mw_max(ProfileSelector* ps, uint32_t idx, uint32_t load_mohms) -> uint32_t {
+    return ps->mw_max(idx, load_mohms);
+}
+
+// Writes plan to `out` as [profile_idx, mv, duty_x1000, ctx_target_mw]
+CC_EXPORT void profile_selector_plan_power(ProfileSelector* ps, uint32_t target_power_mw,
+                                           uint32_t peak_mv, uint32_t peak_ma,
+                                           uint32_t req_mv, uint32_t req_idx,
+                                           uint32_t* out) {
+    ProfileSelector::FEEDBACK_PARAMS feedback{};
+    feedback.peak_mv = peak_mv;
+    feedback.peak_ma = peak_ma;
+    feedback.req_mv = req_mv;
+    feedback.req_idx = req_idx;
+
+    const auto plan = ps->plan_power(target_power_mw, feedback);
+    out[0] = plan.profile_idx;
+    out[1] = plan.mv;
+    out[2] = plan.duty_x1000;
+    out[3] = plan.ctx_target_mw;
+}
+
+//
+// Timeline
+//
+
+CC_EXPORT auto timeline_create() -> Timeline* { return new Timeline(); }
+CC_EXPORT void timeline_destroy(Timeline* tl) { delete tl; }
+
+// `segments` - flat [target, duration, target, duration, ...] array
+// `accel_max_x100` - corner shaping acceleration, 0 to disable
+CC_EXPORT void timeline_load(Timeline* tl, const int32_t* segments, uint32_t count, int32_t accel_max_x100) {
+    Profile profile = Profile_init_zero;
+    for (uint32_t i = 0; i < count && i < sizeof(profile.segments) / sizeof(profile.segments[0]); i++) {
+        profile.segments[i].target = segments[i * 2];
+        profile.segments[i].duration = segments[i * 2 + 1];
+        profile.segments_count++;
+    }
+    tl->load(profile, accel_max_x100);
+}
+
+CC_EXPORT auto timeline_get_max_time_x1000(Timeline* tl) -> int32_t { return tl->get_max_time_x1000(); }
+CC_EXPORT auto timeline_get_target(Timeline* tl, int32_t offset_x1000) -> float {
+    return static_cast<float>(tl->get_target_x100(offset_x1000)) * 0.01f;
+}
+CC_EXPORT auto timeline_get_rate(Timeline* tl, int32_t offset_x1000) -> float {
+    return static_cast<float>(tl->get_rate_x100(offset_x1000)) * 0.01f;
+}
+
+//
+// SparseHistory
+//
+
+// No virtual destructor in base, seal to make deletion via handle safe.
+class SparseHistoryHandle final : public SparseHistory {};
+
+CC_EXPORT auto sparse_history_create() -> SparseHistoryHandle* { return new SparseHistoryHandle(); }
+CC_EXPORT void sparse_history_destroy(SparseHistoryHandle* h) { delete h; }
+
+CC_EXPORT void sparse_history_set_params(SparseHistory* h, int32_t x_threshold, int32_t y_threshold, int32_t x_scale_after) {
+    h->set_params(x_threshold, y_threshold, x_scale_after);
+}
+
+CC_EXPORT void sparse_history_reset(SparseHistory* h) { h->reset(); }
+CC_EXPORT auto sparse_history_add(SparseHistory* h, int32_t x, int32_t y) -> bool { return h->add(x, y); }
+CC_EXPORT auto sparse_history_size(SparseHistory* h) -> uint32_t { return h->data.size(); }
+
+// Direct pointer to [x, y, x, y, ...] storage, valid until next add/reset.
+CC_EXPORT auto sparse_history_data(SparseHistory* h) -> const int32_t* {
+    static_assert(sizeof(SparseHistory::Point) == 2 * sizeof(int32_t), "Point must be packed as 2 x int32");
+    return reinterpret_cast<const int32_t*>(h->data.data());
+}
+
+//
+// TemperatureProcessor
+//
+
+CC_EXPORT auto temperature_processor_create() -> TemperatureProcessor* { return new TemperatureProcessor(); }
+CC_EXPORT void temperature_processor_destroy(TemperatureProcessor* tp) { delete tp; }
+
+// `type` - SensorType enum value from proto (RTD = 0, TCR = 1)
+CC_EXPORT void temperature_processor_set_sensor_type(TemperatureProcessor* tp, int32_t type) {
+    tp->set_sensor_type(static_cast<SensorType>(type));
+}
+
+CC_EXPORT void temperature_processor_set_cal_points(TemperatureProcessor* tp, float at_0, float value_0, float at_1, float value_1) {
+    tp->set_cal_points(at_0, value_0, at_1, value_1);
+}
+
+// `sensor_value` - uV for RTD, mOhms for TCR
+CC_EXPORT auto temperature_processor_get_temperature_x10(TemperatureProcessor* tp, uint32_t sensor_value) -> int32_t {
+    return tp->get_temperature_x10(sensor_value);
+}
@@ -6,6 +6,7 @@ export class ADRC {
     private kp: number = 0.0;
     private z1: number = 0.0;
     private z2: number = 0.0;
+    private u_last: number = 0.0;
 
     set_params(b0: number, τ: number, N: number, M: number): void {
         const ω_c = N / τ
@@ -21,7 +22,9 @@ export class ADRC {
         this.kp = kp;
     }
 
-    iterate(y: number, y_ref: number, u_max: number, dt: number, y_ref_rate = 0): number {
+    // `y_age` is how old measurement is, in the same units as `dt`.
+    // Measurement is extrapolated to "now" with observer's rate estimate.
+    iterate(y: number, y_ref: number, u_max: number, dt: number, y_ref_rate = 0, y_age = 0): number {
         const e = y_ref - this.z1;
         const u = (this.kp * e + y_ref_rate - this.z2) / this.b0;
 
@@ -29,15 +32,18 @@ export class ADRC {
         const u_output = Math.max(0, Math.min(u, u_max));
 
         // ESO update, with respect to real output
-        const e_obs = y - this.z1;
+        const y_now = y_age > 0 ? y + y_age * (this.b0 * this.u_last + this.z2) : y;
+        const e_obs = y_now - this.z1;
         this.z1 += dt * (this.b0 * u_output + this.z2 + this.beta1 * e_obs);
         this.z2 += dt * (this.beta2 * e_obs);
 
+        this.u_last = u_output;
         return u_output;
     }
 
     reset_to(y: number): void {
         this.z1 = y;
         this.z2 = 0.0;
+        this.u_last = 0.0;
     }
 }
@@ -17,6 +17,8 @@ export class HeaterControl {
   temperature_control_enabled = false
   temperature_setpoint = 0
   temperature_setpoint_rate = 0
+  // Simulated head has no noise, plain difference is exact enough
+  temperature_rate = 0
 
   // History management (private, managed internally like in firmware)
   private history = new SparseHistory()
@@ -76,7 +78,9 @@ export class HeaterControl {
     // 1. PHYSICS: Apply power from previous tick, simulate temperature change
     const max_power_mw = this.power.get_max_power_mw()
     const actual_power_mw = Math.min(this.power.selector.target_power_mw, max_power_mw)
+    const prev_temperature = this.head.temperature
     this.head.iterate(actual_power_mw / 1000, dt_ms / 1000)
+    if (dt_ms > 0) this.temperature_rate = (this.head.temperature - prev_temperature) * 1000 / dt_ms
 
     // 2. POWER: Update ProfileSelector with new resistance (may switch PDO)
     this.power.tick()
@@ -182,6 +186,10 @@ export class HeaterControl {
     return this.head.temperature
   }
 
+  get_temperature_rate(): number {
+    return this.temperature_rate
+  }
+
   get_max_power(): number {
     return this.power.get_max_power_mw() / 1000
   }
@@ -267,7 +275,9 @@ export class HeaterControl {
     return {
       type: this.history_task_id,
       version: this.history_version,
-      data: data.slice(from_idx, from_idx + chunk_length)
+      data: data.slice(from_idx, from_idx + chunk_length),
+      // Rate is not kept in emulated history
+      rate_x100: []
     }
   }
 }
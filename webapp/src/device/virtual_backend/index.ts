@@ -81,7 +81,8 @@ export class VirtualBackend implements IBackend {
       peak_ma: Math.round(this.heater_control.get_peak_ma()),
       duty_x1000: this.heater_control.get_duty_x1000(),
       resistance_mohms: Math.round(this.heater_control.get_resistance_mohms()),
-      max_mw: Math.round(this.heater_control.get_max_power() * 1000)
+      max_mw: Math.round(this.heater_control.get_max_power() * 1000),
+      rate_x100: Math.round(this.heater_control.get_temperature_rate() * 100)
     })
   }
 
@@ -3,16 +3,108 @@ import { HeaterTask } from './heater_task'
 import { DeviceActivityStatus } from '@/proto/generated/types'
 import { SharedConstants as Constants } from '@/lib/shared_constants'
 
-const LOG_INTERVAL_MS = 500
+const SAMPLE_INTERVAL_MS = 500
 const MAX_TRANSPORT_DELAY_MS = 10_000
-const STABILITY_CHECK_PERIOD_MS = 30_000
-const STABILITY_THRESHOLD_TEMP = 1.0
-const MAX_LOG_SIZE = 2000
-
-interface LogEntry {
-  temperature: number
-  power: number
-  time_ms: number
+const MAX_DURATION_MS = 1_000_000
+const CONVERGED_REL_SD = 0.02
+const CONVERGED_CHECKS = 10
+
+interface FopdtResult {
+  tau: number
+  b0: number
+  delay: number
+  tau_rel_sd: number
+  b0_rel_sd: number
+}
+
+// Mirror of firmware FopdtFit: streaming least squares over integrated
+// step response, y - y0 = -1/τ·∫(y - y0) + b0·∫u - b0·L·u
+class FopdtFit {
+  private ata = [[0, 0, 0], [0, 0, 0], [0, 0, 0]]
+  private aty = [0, 0, 0]
+  private yty = 0
+  private count = 0
+
+  private y_integral = 0
+  private u_integral = 0
+  private prev_dy = 0
+  private prev_u = 0
+  elapsed = 0
+
+  constructor(private y0: number) {}
+
+  add(dt: number, temperature: number, power: number) {
+    const dy = temperature - this.y0
+    this.y_integral += (dy + this.prev_dy) * 0.5 * dt
+    this.u_integral += (power + (this.elapsed > 0 ? this.prev_u : power)) * 0.5 * dt
+    this.prev_dy = dy
+    this.prev_u = power
+    this.elapsed += dt
+
+    const x = [-this.y_integral, this.u_integral, power]
+    for (let i = 0; i < 3; i++) {
+      for (let j = 0; j < 3; j++) this.ata[i][j] += x[i] * x[j]
+      this.aty[i] += x[i] * dy
+    }
+    this.yty += dy * dy
+    this.count++
+  }
+
+  solve(): FopdtResult | null {
+    const theta = this.solve_for(this.aty)
+    if (!theta || theta[0] <= 0 || theta[1] <= 0 || this.count <= 3) return null
+
+    let sse = this.yty
+    for (let i = 0; i < 3; i++) {
+      sse -= 2 * theta[i] * this.aty[i]
+      for (let j = 0; j < 3; j++) sse += theta[i] * theta[j] * this.ata[i][j]
+    }
+    const sigma2 = Math.max(sse, 0) / (this.count - 3)
+
+    const var_of = (i: number) => {
+      const e = [0, 0, 0]
+      e[i] = 1
+      const col = this.solve_for(e)
+      return col ? sigma2 * col[i] : Infinity
+    }
+
+    return {
+      tau: 1 / theta[0],
+      b0: theta[1],
+      delay: -theta[2] / theta[1],
+      tau_rel_sd: Math.sqrt(var_of(0)) / theta[0],
+      b0_rel_sd: Math.sqrt(var_of(1)) / theta[1]
+    }
+  }
+
+  // Gaussian elimination with partial pivoting
+  private solve_for(b: number[]): number[] | null {
+    const m = this.ata.map((row, i) => [...row, b[i]])
+
+    for (let col = 0; col < 3; col++) {
+      let pivot = col
+      for (let r = col + 1; r < 3; r++) {
+        if (Math.abs(m[r][col]) > Math.abs(m[pivot][col])) pivot = r
+      }
+      if (Math.abs(m[pivot][col]) < 1e-12 * (Math.abs(this.ata[col][col]) + 1e-300)) return null
+      const tmp = m[col]
+      m[col] = m[pivot]
+      m[pivot] = tmp
+
+      for (let r = col + 1; r < 3; r++) {
+        const f = m[r][col] / m[col][col]
+        for (let j = col; j <= 3; j++) m[r][j] -= f * m[col][j]
+      }
+    }
+
+    const x = [0, 0, 0]
+    for (let i = 2; i >= 0; i--) {
+      let s = m[i][3]
+      for (let j = i + 1; j < 3; j++) s -= m[i][j] * x[j]
+      x[i] = s / m[i][i]
+    }
+    return x
+  }
 }
 
 export class TaskStepResponse extends HeaterTask {
@@ -33,125 +125,59 @@ export class TaskStepResponse extends HeaterTask {
 
   get iterator(): Generator<void, void, number> {
     const heater = this.heater
+    const watts = this.watts
     return (function* () {
-      let next_record_ts = 0
-      const temperature_log: LogEntry[] = []
+      let last_sample_ms = 0
+      let last_temperature = heater.get_temperature()
+      let converged_count = 0
+      let result: FopdtResult | null = null
+
+      const fit = new FopdtFit(last_temperature)
+      fit.add(0, last_temperature, watts)
 
       while (true) {
         const task_time_ms: number = yield
-        const probe = heater.get_temperature()
 
-        if (task_time_ms >= next_record_ts) {
-          next_record_ts += LOG_INTERVAL_MS
-
-          // Check for abnormal temperature jitter
-          if (temperature_log.length > 0) {
-            const last_temp = temperature_log[temperature_log.length - 1].temperature
-            if (Math.abs(probe - last_temp) > 5.0) {
-              console.error(`Abnormal temperature jitter detected: ${last_temp.toFixed(1)} -> ${probe.toFixed(1)}`)
-            }
-          }
-
-          // Record new log entry
-          temperature_log.push({
-            temperature: probe,
-            power: heater.get_power(),
-            time_ms: task_time_ms
-          })
-
-          if (temperature_log.length >= MAX_LOG_SIZE) {
-            console.log('Max log size reached')
-            return
-          }
-
-          // Skip transport delay period
-          if (task_time_ms < MAX_TRANSPORT_DELAY_MS) {
-            continue
-          }
-
-          // Check stability
-          const offset_entries = STABILITY_CHECK_PERIOD_MS / LOG_INTERVAL_MS
-          if (temperature_log.length > offset_entries) {
-            const old_entry = temperature_log[temperature_log.length - offset_entries - 1]
-            const current_entry = temperature_log[temperature_log.length - 1]
-
-            if (Math.abs(current_entry.temperature - old_entry.temperature) <= STABILITY_THRESHOLD_TEMP) {
-              break
-            }
-          }
-        }
-      }
-
-      // Analyze the log to find the response time and b0.
-      const t_initial = temperature_log[0].temperature
+        if (task_time_ms < last_sample_ms + SAMPLE_INTERVAL_MS) continue
 
-      // Find maximum temperature in log
-      let t_max = temperature_log[0].temperature
-      for (let i = 1; i < temperature_log.length; i++) {
-        if (temperature_log[i].temperature > t_max) {
-          t_max = temperature_log[i].temperature
+        if (task_time_ms >= MAX_DURATION_MS) {
+          console.log('Max duration reached')
+          return
         }
-      }
 
-      // Helper to find the index for a given ratio of (t_max - t_initial).
-      const find_t_idx_of = (ratio: number): number => {
-        if (ratio >= 1.0) {
-          let max_idx = 0
-          for (let i = 1; i < temperature_log.length; i++) {
-            if (temperature_log[i].temperature > temperature_log[max_idx].temperature) {
-              max_idx = i
-            }
-          }
-          return max_idx
+        // Check for abnormal temperature jitter
+        const probe = heater.get_temperature()
+        if (Math.abs(probe - last_temperature) > 5.0) {
+          console.error(`Abnormal temperature jitter detected: ${last_temperature.toFixed(1)} -> ${probe.toFixed(1)}`)
         }
 
-        const target_temp = t_initial + (t_max - t_initial) * ratio
-
-        let idx = temperature_log.length - 1
-        for (let i = 0; i < temperature_log.length; i++) {
-          if (temperature_log[i].temperature >= target_temp) {
-            idx = i
-            break
-          }
-        }
+        fit.add((task_time_ms - last_sample_ms) / 1000, probe, heater.get_power())
+        last_sample_ms = task_time_ms
+        last_temperature = probe
 
-        if (idx > 0) {
-          const diff_curr = Math.abs(temperature_log[idx].temperature - target_temp)
-          const diff_prev = Math.abs(temperature_log[idx - 1].temperature - target_temp)
+        // Skip transport delay period
+        if (task_time_ms < MAX_TRANSPORT_DELAY_MS) continue
 
-          if (diff_prev < diff_curr) {
-            idx = idx - 1
-          }
-        }
+        result = fit.solve()
+        const converged = result !== null &&
+          fit.elapsed >= result.tau + result.delay &&
+          result.tau_rel_sd <= CONVERGED_REL_SD &&
+          result.b0_rel_sd <= CONVERGED_REL_SD
 
-        return idx
+        converged_count = converged ? converged_count + 1 : 0
+        if (converged_count >= CONVERGED_CHECKS) break
       }
 
-      const idx_28 = find_t_idx_of(0.28)
-      const idx_63 = find_t_idx_of(0.63)
-
-      const c_28 = temperature_log[idx_28].temperature
-      const t_28 = temperature_log[idx_28].time_ms / 1000
-      const c_63 = temperature_log[idx_63].temperature
-      const t_63 = temperature_log[idx_63].time_ms / 1000
-
-      const τ = 1.502069 * (t_63 - t_28)
-      const L = 1.493523 * t_28 - 0.493523 * t_63
-
-      console.log('Step response analysis:')
-      console.log(`  t max = ${t_max.toFixed(0)}°C`)
-      console.log(`  28% point = ${c_28.toFixed(0)}°C, ${t_28.toFixed(0)} sec`);
-      console.log(`  63% point = ${c_63.toFixed(0)}°C, ${t_63.toFixed(0)} sec`);
-      console.log(`  response = ${τ.toFixed(2)}s, effective delay = ${L.toFixed(2)}s`)
-
-      const du = temperature_log[idx_63].power
-      const b0 = (c_63 - c_28) / ((0.63 - 0.28) * τ * du)
-      console.log(`  b0 = ${b0.toFixed(6)}`)
+      const r = result!
+      console.log(`Step response analysis (${(last_sample_ms / 1000).toFixed(0)} sec):`)
+      console.log(`  response = ${r.tau.toFixed(2)}s, effective delay = ${r.delay.toFixed(2)}s`)
+      console.log(`  b0 = ${r.b0.toFixed(6)}`)
+      console.log(`  rel. SD: τ ${(r.tau_rel_sd * 1000).toFixed(0)}‰, b0 ${(r.b0_rel_sd * 1000).toFixed(0)}‰`)
 
       // Update head params
       const head_params = heater.get_head_params()
-      head_params.adrc_response = τ
-      head_params.adrc_b0 = b0
+      head_params.adrc_response = r.tau
+      head_params.adrc_b0 = r.b0
       heater.set_head_params(head_params)
     })()
   }
@@ -7,10 +7,13 @@ export const SharedConstants = {
   HISTORY_ID_SENSOR_BAKE_MODE: 4000,
   HISTORY_ID_ADRC_TEST_MODE: 4001,
   HISTORY_ID_STEP_RESPONSE: 4002,
+  HISTORY_ID_RELAY_TUNE: 4003,
+  HISTORY_ID_TCR_CALIBRATION: 4004,
   MAX_RPC_MESSAGE_SIZE: 4096,
   MAX_AUTH_RPC_MESSAGE_SIZE: 1024,
   MAX_PROFILE_NAME_LENGTH: 50,
   MAX_REFLOW_SEGMENTS: 10,
   MAX_REFLOW_PROFILES: 10,
   MAX_HISTORY_CHUNK: 100,
+  MAX_TCR_CAL_POINTS: 8,
 }
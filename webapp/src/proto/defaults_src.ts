@@ -48,5 +48,7 @@ export const head_default: HeadParams = {
   adrc_response: 113,
   adrc_b0: 0.0536,
   adrc_n_coeff: 55,
-  adrc_m_coeff: 5
+  adrc_m_coeff: 5,
+  sensor_tcr_at: [],
+  sensor_tcr_value: []
 }
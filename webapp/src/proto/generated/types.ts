@@ -24,6 +24,8 @@ export enum ConstantsBase {
   HISTORY_ID_SENSOR_BAKE_MODE = 4000,
   HISTORY_ID_ADRC_TEST_MODE = 4001,
   HISTORY_ID_STEP_RESPONSE = 4002,
+  HISTORY_ID_RELAY_TUNE = 4003,
+  HISTORY_ID_TCR_CALIBRATION = 4004,
   UNRECOGNIZED = -1,
 }
 
@@ -67,6 +69,21 @@ export enum DeviceActivityStatus {
   ADRC_TEST = 3,
   STEP_RESPONSE = 4,
   BONDING = 5,
+  BATCH_COOLDOWN = 6,
+  RELAY_TUNE = 7,
+  TCR_CALIBRATION = 8,
+  UNRECOGNIZED = -1,
+}
+
+/** Reason of the last task stop by heater fault supervisor */
+export enum HeaterFault {
+  FAULT_NONE = 0,
+  FAULT_OPEN_HEATER = 1,
+  FAULT_RESISTANCE_JUMP = 2,
+  FAULT_STUCK_READING = 3,
+  /** FAULT_NO_HEATING - Power delivered, but temperature does not follow */
+  FAULT_NO_HEATING = 4,
+  FAULT_HEATING_WITHOUT_POWER = 5,
   UNRECOGNIZED = -1,
 }
 
@@ -84,6 +101,8 @@ export interface Profile {
   name: string;
   /** Temperature segments sequence */
   segments: Segment[];
+  /** Solder liquidus, Celsius. Used for quality metrics, SAC305 if not set */
+  liquidus?: number | undefined;
 }
 
 export interface ProfilesData {
@@ -102,6 +121,11 @@ export interface HistoryChunk {
   type: number;
   version: number;
   data: Point[];
+  /**
+   * Temperature rate of change at each point, °C/s x100. Same length as
+   * `data`, or empty if not supported.
+   */
+  rate_x100: number[];
 }
 
 export interface HeadParams {
@@ -124,6 +148,12 @@ export interface HeadParams {
    * 3 is a good starting point. Changes are probably not required.
    */
   adrc_m_coeff: number;
+  /**
+   * Multi-point TCR calibration (temperature / heater resistance pairs),
+   * piecewise linear. Overrides p0/p1 points, when 2+ pairs set.
+   */
+  sensor_tcr_at: number[];
+  sensor_tcr_value: number[];
 }
 
 export interface DeviceInfo {
@@ -144,6 +174,12 @@ export interface DeviceInfo {
    * at current PD profile
    */
   max_mw: number;
+  /** Temperature estimate variance, °C² x100 (TCR Kalman filter) */
+  temperature_variance_x100: number;
+  /** Temperature rate of change, °C/s x100 */
+  rate_x100: number;
+  /** Cleared on next task start */
+  fault: HeaterFault;
 }
 
 function createBaseSegment(): Segment {
@@ -205,7 +241,7 @@ export const Segment: MessageFns<Segment> = {
 };
 
 function createBaseProfile(): Profile {
-  return { id: 0, name: "", segments: [] };
+  return { id: 0, name: "", segments: [], liquidus: undefined };
 }
 
 export const Profile: MessageFns<Profile> = {
@@ -219,6 +255,9 @@ export const Profile: MessageFns<Profile> = {
     for (const v of message.segments) {
       Segment.encode(v!, writer.uint32(26).fork()).join();
     }
+    if (message.liquidus !== undefined) {
+      writer.uint32(37).float(message.liquidus);
+    }
     return writer;
   },
 
@@ -253,6 +292,14 @@ export const Profile: MessageFns<Profile> = {
           message.segments.push(Segment.decode(reader, reader.uint32()));
           continue;
         }
+        case 4: {
+          if (tag !== 37) {
+            break;
+          }
+
+          message.liquidus = reader.float();
+          continue;
+        }
       }
       if ((tag & 7) === 4 || tag === 0) {
         break;
@@ -270,6 +317,7 @@ export const Profile: MessageFns<Profile> = {
     message.id = object.id ?? 0;
     message.name = object.name ?? "";
     message.segments = object.segments?.map((e) => Segment.fromPartial(e)) || [];
+    message.liquidus = object.liquidus ?? undefined;
     return message;
   },
 };
@@ -391,7 +439,7 @@ export const Point: MessageFns<Point> = {
 };
 
 function createBaseHistoryChunk(): HistoryChunk {
-  return { type: 0, version: 0, data: [] };
+  return { type: 0, version: 0, data: [], rate_x100: [] };
 }
 
 export const HistoryChunk: MessageFns<HistoryChunk> = {
@@ -405,6 +453,11 @@ export const HistoryChunk: MessageFns<HistoryChunk> = {
     for (const v of message.data) {
       Point.encode(v!, writer.uint32(26).fork()).join();
     }
+    writer.uint32(34).fork();
+    for (const v of message.rate_x100) {
+      writer.sint32(v);
+    }
+    writer.join();
     return writer;
   },
 
@@ -439,6 +492,24 @@ export const HistoryChunk: MessageFns<HistoryChunk> = {
           message.data.push(Point.decode(reader, reader.uint32()));
           continue;
         }
+        case 4: {
+          if (tag === 32) {
+            message.rate_x100.push(reader.sint32());
+
+            continue;
+          }
+
+          if (tag === 34) {
+            const end2 = reader.uint32() + reader.pos;
+            while (reader.pos < end2) {
+              message.rate_x100.push(reader.sint32());
+            }
+
+            continue;
+          }
+
+          break;
+        }
       }
       if ((tag & 7) === 4 || tag === 0) {
         break;
@@ -456,6 +527,7 @@ export const HistoryChunk: MessageFns<HistoryChunk> = {
     message.type = object.type ?? 0;
     message.version = object.version ?? 0;
     message.data = object.data?.map((e) => Point.fromPartial(e)) || [];
+    message.rate_x100 = object.rate_x100?.map((e) => e) || [];
     return message;
   },
 };
@@ -470,6 +542,8 @@ function createBaseHeadParams(): HeadParams {
     adrc_b0: 0,
     adrc_n_coeff: 0,
     adrc_m_coeff: 0,
+    sensor_tcr_at: [],
+    sensor_tcr_value: [],
   };
 }
 
@@ -499,6 +573,16 @@ export const HeadParams: MessageFns<HeadParams> = {
     if (message.adrc_m_coeff !== 0) {
       writer.uint32(69).float(message.adrc_m_coeff);
     }
+    writer.uint32(74).fork();
+    for (const v of message.sensor_tcr_at) {
+      writer.float(v);
+    }
+    writer.join();
+    writer.uint32(82).fork();
+    for (const v of message.sensor_tcr_value) {
+      writer.float(v);
+    }
+    writer.join();
     return writer;
   },
 
@@ -573,6 +657,42 @@ export const HeadParams: MessageFns<HeadParams> = {
           message.adrc_m_coeff = reader.float();
           continue;
         }
+        case 9: {
+          if (tag === 77) {
+            message.sensor_tcr_at.push(reader.float());
+
+            continue;
+          }
+
+          if (tag === 74) {
+            const end2 = reader.uint32() + reader.pos;
+            while (reader.pos < end2) {
+              message.sensor_tcr_at.push(reader.float());
+            }
+
+            continue;
+          }
+
+          break;
+        }
+        case 10: {
+          if (tag === 85) {
+            message.sensor_tcr_value.push(reader.float());
+
+            continue;
+          }
+
+          if (tag === 82) {
+            const end2 = reader.uint32() + reader.pos;
+            while (reader.pos < end2) {
+              message.sensor_tcr_value.push(reader.float());
+            }
+
+            continue;
+          }
+
+          break;
+        }
       }
       if ((tag & 7) === 4 || tag === 0) {
         break;
@@ -595,6 +715,8 @@ export const HeadParams: MessageFns<HeadParams> = {
     message.adrc_b0 = object.adrc_b0 ?? 0;
     message.adrc_n_coeff = object.adrc_n_coeff ?? 0;
     message.adrc_m_coeff = object.adrc_m_coeff ?? 0;
+    message.sensor_tcr_at = object.sensor_tcr_at?.map((e) => e) || [];
+    message.sensor_tcr_value = object.sensor_tcr_value?.map((e) => e) || [];
     return message;
   },
 };
@@ -611,6 +733,9 @@ function createBaseDeviceInfo(): DeviceInfo {
     duty_x1000: 0,
     resistance_mohms: 0,
     max_mw: 0,
+    temperature_variance_x100: 0,
+    rate_x100: 0,
+    fault: 0,
   };
 }
 
@@ -646,6 +771,15 @@ export const DeviceInfo: MessageFns<DeviceInfo> = {
     if (message.max_mw !== 0) {
       writer.uint32(80).uint32(message.max_mw);
     }
+    if (message.temperature_variance_x100 !== 0) {
+      writer.uint32(88).uint32(message.temperature_variance_x100);
+    }
+    if (message.rate_x100 !== 0) {
+      writer.uint32(96).sint32(message.rate_x100);
+    }
+    if (message.fault !== 0) {
+      writer.uint32(104).int32(message.fault);
+    }
     return writer;
   },
 
@@ -736,6 +870,30 @@ export const DeviceInfo: MessageFns<DeviceInfo> = {
           message.max_mw = reader.uint32();
           continue;
         }
+        case 11: {
+          if (tag !== 88) {
+            break;
+          }
+
+          message.temperature_variance_x100 = reader.uint32();
+          continue;
+        }
+        case 12: {
+          if (tag !== 96) {
+            break;
+          }
+
+          message.rate_x100 = reader.sint32();
+          continue;
+        }
+        case 13: {
+          if (tag !== 104) {
+            break;
+          }
+
+          message.fault = reader.int32() as any;
+          continue;
+        }
       }
       if ((tag & 7) === 4 || tag === 0) {
         break;
@@ -760,6 +918,9 @@ export const DeviceInfo: MessageFns<DeviceInfo> = {
     message.duty_x1000 = object.duty_x1000 ?? 0;
     message.resistance_mohms = object.resistance_mohms ?? 0;
     message.max_mw = object.max_mw ?? 0;
+    message.temperature_variance_x100 = object.temperature_variance_x100 ?? 0;
+    message.rate_x100 = object.rate_x100 ?? 0;
+    message.fault = object.fault ?? 0;
     return message;
   },
 };
@@ -0,0 +1,113 @@
+// Compares TS ports of virtual backend with WebAssembly build of firmware
+// control core: simulation speed and numerical parity.
+//
+// Run: `npm run build:wasm && npm run bench:wasm`
+
+import { ADRC } from '../../src/device/virtual_backend/adrc'
+import { loadControlCore, WasmADRC, WasmSparseHistory, WasmTimeline } from './control_core'
+
+// Same defaults as firmware Head
+const B0 = 0.0536
+const RESPONSE = 113
+const N = 55
+const M = 5
+
+// Simple first order plant, close to MCH 80x70x3
+const LOSS_W_PER_K = 0.216
+const T_AMBIENT = 25
+const U_MAX = 60
+
+const DT_MS = 50
+const PROFILE = [
+  { target: 150, duration: 90 },
+  { target: 180, duration: 90 },
+  { target: 245, duration: 60 },
+  { target: 245, duration: 20 },
+  { target: 50, duration: 60 }
+]
+
+interface Controller {
+  iterate(y: number, y_ref: number, u_max: number, dt: number, y_ref_rate?: number): number
+  reset_to(y: number): void
+}
+
+// Setpoint/rate are shared (from wasm Timeline), to compare controllers only.
+function simulate(ctrl: Controller, timeline: WasmTimeline, runs: number, trace?: number[]): void {
+  const max_time = timeline.get_max_time_x1000()
+  const dt = DT_MS / 1000
+
+  for (let run = 0; run < runs; run++) {
+    let t = T_AMBIENT
+    ctrl.reset_to(t)
+
+    for (let offset = 0; offset <= max_time; offset += DT_MS) {
+      const u = ctrl.iterate(t, timeline.get_target(offset), U_MAX, dt, timeline.get_rate(offset))
+      t += dt * B0 * (u - LOSS_W_PER_K * (t - T_AMBIENT))
+      if (trace) trace.push(u)
+    }
+  }
+}
+
+function measure(name: string, fn: () => void): number {
+  fn() // warmup
+  const start = performance.now()
+  fn()
+  const ms = performance.now() - start
+  console.log(`${name.padEnd(28)} ${ms.toFixed(1).padStart(8)} ms`)
+  return ms
+}
+
+async function main() {
+  await loadControlCore()
+
+  const timeline = new WasmTimeline()
+  timeline.load(PROFILE)
+
+  const ts_adrc = new ADRC()
+  ts_adrc.set_params(B0, RESPONSE, N, M)
+  const wasm_adrc = new WasmADRC()
+  wasm_adrc.set_params(B0, RESPONSE, N, M)
+
+  //
+  // Parity: single reflow run, compare power output per tick
+  //
+  const ts_trace: number[] = []
+  const wasm_trace: number[] = []
+  simulate(ts_adrc, timeline, 1, ts_trace)
+  simulate(wasm_adrc, timeline, 1, wasm_trace)
+
+  let max_diff = 0
+  let max_diff_idx = 0
+  for (let i = 0; i < ts_trace.length; i++) {
+    const diff = Math.abs(ts_trace[i] - wasm_trace[i])
+    if (diff > max_diff) { max_diff = diff; max_diff_idx = i }
+  }
+
+  console.log(`Ticks per run: ${ts_trace.length}`)
+  console.log(`Max power diff, TS (f64) vs firmware (f32): ${max_diff.toExponential(3)} W ` +
+    `at ${(max_diff_idx * DT_MS / 1000).toFixed(2)} s`)
+  console.log()
+
+  //
+  // Speed
+  //
+  const RUNS = 200
+  const ts_ms = measure(`ADRC TS, ${RUNS} runs`, () => simulate(ts_adrc, timeline, RUNS))
+  const wasm_ms = measure(`ADRC WASM, ${RUNS} runs`, () => simulate(wasm_adrc, timeline, RUNS))
+  console.log(`WASM / TS: ${(wasm_ms / ts_ms).toFixed(2)}x`)
+  console.log()
+
+  const history = new WasmSparseHistory()
+  history.set_params(10, 1, 400)
+  measure('SparseHistory WASM, 1M adds', () => {
+    history.reset()
+    for (let i = 0; i < 1_000_000; i++) history.add(i, Math.round(100 * Math.sin(i / 5000)))
+  })
+  console.log(`SparseHistory points kept: ${history.size}`)
+
+  history.destroy()
+  wasm_adrc.destroy()
+  timeline.destroy()
+}
+
+main()
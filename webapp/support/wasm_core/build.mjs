@@ -0,0 +1,82 @@
+// Builds firmware control core (ADRC, ProfileSelector, Timeline,
+// SparseHistory, TemperatureProcessor) to WebAssembly.
+//
+// Requires `emcc` in PATH and firmware dependencies, fetched by PlatformIO:
+//
+//   cd firmware && pio pkg install -e native_test
+//
+import { execFileSync } from 'node:child_process'
+import { existsSync, mkdirSync, readdirSync, statSync } from 'node:fs'
+import { dirname, join } from 'node:path'
+import { fileURLToPath } from 'node:url'
+
+const __dirname = dirname(fileURLToPath(import.meta.url))
+const FIRMWARE_DIR = join(__dirname, '../../../firmware')
+const LIBDEPS_DIR = join(FIRMWARE_DIR, '.pio/libdeps/native_test')
+const OUT_DIR = join(__dirname, 'dist')
+
+// Locate dirs, containing specified headers (libs layouts differ)
+function findIncludeDirs(root, markers) {
+  const found = new Map()
+
+  function walk(dir, depth) {
+    if (depth > 4) return
+    for (const name of readdirSync(dir)) {
+      const path = join(dir, name)
+      if (!statSync(path).isDirectory()) continue
+      for (const marker of markers) {
+        if (!found.has(marker) && existsSync(join(path, marker))) found.set(marker, path)
+      }
+      walk(path, depth + 1)
+    }
+  }
+
+  walk(root, 0)
+  return found
+}
+
+if (!existsSync(LIBDEPS_DIR)) {
+  console.error(`Dependencies not found at ${LIBDEPS_DIR}`)
+  console.error('Run `pio pkg install -e native_test` in firmware folder first.')
+  process.exit(1)
+}
+
+const markers = ['etl/vector.h', 'pb.h', 'pd/pd.h']
+const includes = findIncludeDirs(LIBDEPS_DIR, markers)
+
+for (const marker of markers) {
+  if (!includes.has(marker)) {
+    console.error(`Can not find include dir for <${marker}> in ${LIBDEPS_DIR}`)
+    process.exit(1)
+  }
+}
+
+// PDO decoders are not header-only in pdsink
+const pdsinkSources = [...findIncludeDirs(LIBDEPS_DIR, ['pd/dobj_utils.cpp']).values()]
+  .map(dir => join(dir, 'pd/dobj_utils.cpp'))
+
+mkdirSync(OUT_DIR, { recursive: true })
+
+const args = [
+  join(FIRMWARE_DIR, 'tools/wasm_core/control_core.cpp'),
+  ...pdsinkSources,
+  '-std=gnu++17',
+  '-O3',
+  // Keep float math identical to firmware (no fused multiply-add)
+  '-ffp-contract=off',
+  '-fno-exceptions',
+  `-I${join(FIRMWARE_DIR, 'src')}`,
+  ...[...includes.values()].map(dir => `-I${dir}`),
+  '-sMODULARIZE=1',
+  '-sEXPORT_ES6=1',
+  '-sEXPORT_NAME=createControlCore',
+  '-sENVIRONMENT=web,node',
+  '-sALLOW_MEMORY_GROWTH=1',
+  '-sEXPORTED_FUNCTIONS=_malloc,_free',
+  '-sEXPORTED_RUNTIME_METHODS=HEAP32,HEAPU32',
+  '-o', join(OUT_DIR, 'control_core.mjs'),
+]
+
+console.log(`emcc ${args.join(' ')}`)
+execFileSync('emcc', args, { stdio: 'inherit' })
+console.log(`Done: ${join(OUT_DIR, 'control_core.mjs')}`)
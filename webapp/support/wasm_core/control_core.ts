@@ -0,0 +1,170 @@
+// Typed wrappers over WebAssembly build of firmware control core.
+// API mirrors C++ classes, and TS ports from virtual backend where possible.
+//
+// Objects live on wasm heap, call `destroy()` when not needed anymore.
+
+// Generated by `npm run build:wasm`
+// @ts-expect-error no typings for emscripten output
+import createControlCore from './dist/control_core.mjs'
+
+/* eslint-disable @typescript-eslint/no-explicit-any */
+type Module = any
+
+let core: Module | null = null
+
+export async function loadControlCore(): Promise<Module> {
+  if (!core) core = await createControlCore()
+  return core
+}
+
+function getCore(): Module {
+  if (!core) throw new Error('Control core not loaded, call loadControlCore() first')
+  return core
+}
+
+export class WasmADRC {
+  private m = getCore()
+  private ptr: number = this.m._adrc_create()
+
+  set_params(b0: number, τ: number, N: number, M: number): void {
+    this.m._adrc_set_params(this.ptr, b0, τ, N, M)
+  }
+
+  set_params_raw(b0: number, ω_o: number, kp: number): void {
+    this.m._adrc_set_params_raw(this.ptr, b0, ω_o, kp)
+  }
+
+  iterate(y: number, y_ref: number, u_max: number, dt: number, y_ref_rate = 0): number {
+    return this.m._adrc_iterate(this.ptr, y, y_ref, u_max, dt, y_ref_rate)
+  }
+
+  reset_to(y: number): void { this.m._adrc_reset_to(this.ptr, y) }
+
+  destroy(): void { this.m._adrc_destroy(this.ptr) }
+}
+
+export interface PowerPlan {
+  profile_idx: number
+  mv: number
+  duty_x1000: number
+  ctx_target_mw: number
+}
+
+export interface FeedbackParams {
+  peak_mv: number
+  peak_ma: number
+  req_mv: number
+  req_idx: number
+}
+
+export class WasmProfileSelector {
+  private m = getCore()
+  private ptr: number = this.m._profile_selector_create()
+
+  // Raw 32-bit PDOs, as sent by source in Source_Capabilities
+  load_pdos(pdos: number[]): void {
+    const buf = this.m._malloc(pdos.length * 4)
+    this.m.HEAPU32.set(pdos, buf >> 2)
+    this.m._profile_selector_load_pdos(this.ptr, buf, pdos.length)
+    this.m._free(buf)
+  }
+
+  set_pdo_index(index: number): void { this.m._profile_selector_set_pdo_index(this.ptr, index) }
+
+  get current_index(): number { return this.m._profile_selector_get_pdo_index(this.ptr) }
+  get default_position(): number { return this.m._profile_selector_get_default_position(this.ptr) }
+  get default_mv(): number { return this.m._profile_selector_get_default_mv(this.ptr) }
+
+  mw_max(idx: number, load_mohms: number): number {
+    return this.m._profile_selector_mw_max(this.ptr, idx, load_mohms) >>> 0
+  }
+
+  plan_power(target_power_mw: number, feedback: FeedbackParams): PowerPlan {
+    const out = this.m._malloc(4 * 4)
+    this.m._profile_selector_plan_power(this.ptr, target_power_mw,
+      feedback.peak_mv, feedback.peak_ma, feedback.req_mv, feedback.req_idx, out)
+
+    const base = out >> 2
+    const heap = this.m.HEAPU32
+    const plan = {
+      profile_idx: heap[base],
+      mv: heap[base + 1],
+      duty_x1000: heap[base + 2],
+      ctx_target_mw: heap[base + 3]
+    }
+    this.m._free(out)
+    return plan
+  }
+
+  destroy(): void { this.m._profile_selector_destroy(this.ptr) }
+}
+
+export class WasmTimeline {
+  private m = getCore()
+  private ptr: number = this.m._timeline_create()
+
+  // `accel_max_x100` - corner shaping acceleration (0.01°C/s²), 0 to disable
+  load(segments: { target: number, duration: number }[], accel_max_x100 = 0): void {
+    const buf = this.m._malloc(segments.length * 8)
+    segments.forEach((s, i) => {
+      this.m.HEAP32[(buf >> 2) + i * 2] = s.target
+      this.m.HEAP32[(buf >> 2) + i * 2 + 1] = s.duration
+    })
+    this.m._timeline_load(this.ptr, buf, segments.length, accel_max_x100)
+    this.m._free(buf)
+  }
+
+  get_max_time_x1000(): number { return this.m._timeline_get_max_time_x1000(this.ptr) }
+  get_target(offset_x1000: number): number { return this.m._timeline_get_target(this.ptr, offset_x1000) }
+  get_rate(offset_x1000: number): number { return this.m._timeline_get_rate(this.ptr, offset_x1000) }
+
+  destroy(): void { this.m._timeline_destroy(this.ptr) }
+}
+
+export class WasmSparseHistory {
+  private m = getCore()
+  private ptr: number = this.m._sparse_history_create()
+
+  set_params(x_threshold: number, y_threshold: number, x_scale_after: number): void {
+    this.m._sparse_history_set_params(this.ptr, x_threshold, y_threshold, x_scale_after)
+  }
+
+  reset(): void { this.m._sparse_history_reset(this.ptr) }
+
+  // Returns false when storage is full
+  add(x: number, y: number): boolean { return !!this.m._sparse_history_add(this.ptr, x, y) }
+
+  get size(): number { return this.m._sparse_history_size(this.ptr) }
+
+  get data(): { x: number, y: number }[] {
+    const size = this.size
+    const base = this.m._sparse_history_data(this.ptr) >> 2
+    const heap = this.m.HEAP32
+    const result = []
+    for (let i = 0; i < size; i++) result.push({ x: heap[base + i * 2], y: heap[base + i * 2 + 1] })
+    return result
+  }
+
+  destroy(): void { this.m._sparse_history_destroy(this.ptr) }
+}
+
+export const SENSOR_TYPE_RTD = 0
+export const SENSOR_TYPE_TCR = 1
+
+export class WasmTemperatureProcessor {
+  private m = getCore()
+  private ptr: number = this.m._temperature_processor_create()
+
+  set_sensor_type(type: number): void { this.m._temperature_processor_set_sensor_type(this.ptr, type) }
+
+  set_cal_points(at_0: number, value_0: number, at_1: number, value_1: number): void {
+    this.m._temperature_processor_set_cal_points(this.ptr, at_0, value_0, at_1, value_1)
+  }
+
+  // `sensor_value` - uV for RTD, mOhms for TCR
+  get_temperature_x10(sensor_value: number): number {
+    return this.m._temperature_processor_get_temperature_x10(this.ptr, sensor_value)
+  }
+
+  destroy(): void { this.m._temperature_processor_destroy(this.ptr) }
+}